@@ -1,7 +1,11 @@
 #include "Transform.h"
+#include <atomic>
 
 namespace CU
 {
+	// Shared by all transforms so a version never repeats, even when transforms are copied over each other
+	static std::atomic<uint64_t> staticNextVersion = 1;
+
 	Transform::Transform(Vector3f aTranslation, Vector3f aRotation, Vector3f aScale) : myTranslation(aTranslation), myRotationEuler(aRotation), myRotationQuat(aRotation), myScale(aScale), myIsDirty(true) {}
 
 	Transform::Transform(const Matrix4x4f& aMatrix) : myMatrix(aMatrix)
@@ -31,6 +35,7 @@ namespace CU
 		aMatrix.Decompose(myTranslation, myRotationQuat, myScale);
 		myRotationEuler = myRotationQuat.GetEulerAngles();
 		myMatrix = aMatrix;
+		MarkModified();
 		myIsDirty = false;
 	}
 
@@ -41,13 +46,14 @@ namespace CU
 		myScale = aTransform.myScale;
 		myRotationQuat = aTransform.myRotationQuat;
 		myMatrix = aTransform.myMatrix;
+		MarkModified();
 		myIsDirty = aTransform.myIsDirty;
 	}
 
 	void Transform::SetTranslation(const Vector3f& aTranslation)
 	{
 		myTranslation = aTranslation;
-		myIsDirty = true;
+		MarkModified();
 	}
 
 	void Transform::SetTranslation(float aX, float aY, float aZ)
@@ -55,34 +61,34 @@ namespace CU
 		myTranslation.x = aX;
 		myTranslation.y = aY;
 		myTranslation.z = aZ;
-		myIsDirty = true;
+		MarkModified();
 	}
 
 	void Transform::SetRotation(const Vector3f& aRotation)
 	{
 		myRotationEuler = aRotation;
 		myRotationQuat = Quatf(myRotationEuler);
-		myIsDirty = true;
+		MarkModified();
 	}
 
 	void Transform::SetRotation(float aX, float aY, float aZ)
 	{
 		myRotationEuler = Vector3f(aX, aY, aZ);
 		myRotationQuat = Quatf(myRotationEuler);
-		myIsDirty = true;
+		MarkModified();
 	}
 
 	void Transform::SetRotation(const CU::Quatf& aOrientation)
 	{
 		myRotationQuat = aOrientation;
 		myRotationEuler = aOrientation.GetEulerAngles();
-		myIsDirty = true;
+		MarkModified();
 	}
 
 	void Transform::SetScale(const Vector3f& aScale)
 	{
 		myScale = aScale;
-		myIsDirty = true;
+		MarkModified();
 	}
 
 	void Transform::SetScale(float aX, float aY, float aZ)
@@ -90,26 +96,26 @@ namespace CU
 		myScale.x = aX;
 		myScale.y = aY;
 		myScale.z = aZ;
-		myIsDirty = true;
+		MarkModified();
 	}
 
 	void Transform::Translate(const Vector3f& aTranslation)
 	{
 		myTranslation += aTranslation;
-		myIsDirty = true;
+		MarkModified();
 	}
 
 	void Transform::Rotate(const Vector3f& aRotation)
 	{
 		myRotationEuler += aRotation;
 		myRotationQuat = Quatf(myRotationEuler);
-		myIsDirty = true;
+		MarkModified();
 	}
 
 	void Transform::Scale(const Vector3f& aScale)
 	{
 		myScale += aScale;
-		myIsDirty = true;
+		MarkModified();
 	}
 
 	void Transform::RotateAround(const Vector3f& aPoint, const Vector3f& aAxis, float aAngle)
@@ -119,7 +125,7 @@ namespace CU
 		myRotationEuler += quat.GetEulerAngles();
 
 		myTranslation = Quatf::RotateVectorByQuaternion((myTranslation - aPoint), quat) + aPoint;
-		myIsDirty = true;
+		MarkModified();
 	}
 
 	void Transform::LookAt(const Vector3f& aTarget, const Vector3f& aUp)
@@ -134,6 +140,22 @@ namespace CU
 		const Matrix3x3f rotationMatrix = Matrix4x4f::CreateRotationMatrix(rightDir, upDir, forwardDir);
 		myRotationQuat = Quatf(rotationMatrix);
 		myRotationEuler = myRotationQuat.GetEulerAngles();
+		MarkModified();
+	}
+
+	void Transform::MarkModified()
+	{
 		myIsDirty = true;
+		myVersion.Bump();
+	}
+
+	uint64_t Transform::GetNextVersion()
+	{
+		return staticNextVersion.load(std::memory_order_relaxed);
+	}
+
+	void Transform::Version::Bump()
+	{
+		value = staticNextVersion.fetch_add(1, std::memory_order_relaxed);
 	}
 }
@@ -45,6 +45,25 @@ namespace CU
 		void RotateAround(const Vector3f& aPoint, const Vector3f& aAxis, float aAngle);
 		void LookAt(const Vector3f& aTarget, const Vector3f& aUp = Vector3f::Up);
 
+		// Changes every time the transform is modified through its setters, equal versions mean equal transforms
+		uint64_t GetVersion() const { return myVersion.value; }
+		// Versions only increase, every transform modified from here on gets a version at or above this
+		static uint64_t GetNextVersion();
+
+	private:
+		void MarkModified();
+
+		// Copies take a new version as well, so assigning an older transform over this one still counts as a modification
+		struct Version
+		{
+			Version() { Bump(); }
+			Version(const Version&) { Bump(); }
+			Version& operator=(const Version&) { Bump(); return *this; }
+			void Bump();
+
+			uint64_t value;
+		};
+
 	private:
 		Vector3f myTranslation;
 		Vector3f myRotationEuler;
@@ -53,5 +72,7 @@ namespace CU
 
 		bool myIsDirty = false;
 		Matrix4x4f myMatrix;
+
+		Version myVersion;
 	};
 }
@@ -108,6 +108,22 @@ namespace Epoch
         [MethodImpl(MethodImplOptions.InternalCall)]
         internal static extern ulong Scene_InstantiatePrefabWithTransformWithParent(ref AssetHandle aPrefabHandle, ulong aParentId, ref Vector3 aTranslation, ref Vector3 aRotation, ref Vector3 aScale);
 
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        internal static extern void Scene_CreatePrefabPool(ref AssetHandle aPrefabHandle, uint aCount);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        internal static extern ulong Scene_SpawnFromPool(ref AssetHandle aPrefabHandle);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        internal static extern ulong Scene_SpawnFromPoolWithTranslation(ref AssetHandle aPrefabHandle, ref Vector3 aTranslation);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        internal static extern ulong Scene_SpawnFromPoolWithTranslationAndRotation(ref AssetHandle aPrefabHandle, ref Vector3 aTranslation, ref Vector3 aRotation);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        internal static extern bool Scene_DespawnToPool(ulong aEntityID);
+
         #endregion
 
         #region Entity
@@ -472,6 +488,16 @@ namespace Epoch
         internal static extern Entity[] Physics_OverlapSphere(ref Vector3 aOrigin, float aRadius);
 
 
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        internal static extern uint Physics_RaycastBatch(Physics.RaycastQuery[] aQueries, Physics.HitInfo[] outHits);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        internal static extern uint Physics_ShapeCastBatch(Physics.ShapeCastQuery[] aQueries, Physics.HitInfo[] outHits);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        internal static extern uint Physics_OverlapShapeBatch(Physics.ShapeOverlapQuery[] aQueries, ulong[] outEntityIDs, uint[] outHitCounts, uint aMaxHitsPerQuery);
+
+
         [MethodImpl(MethodImplOptions.InternalCall)]
         internal static extern void Physics_GetGravity(out Vector3 outGravity);
 
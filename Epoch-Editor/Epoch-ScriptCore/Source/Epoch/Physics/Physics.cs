@@ -60,6 +60,65 @@ namespace Epoch
             public Entity Entity => Scene.GetEntityByID(entityID);
         };
 
+        public enum ShapeType
+        {
+            Box,
+            Sphere
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        public struct RaycastQuery
+        {
+            public Vector3 origin;
+            public Vector3 direction;
+            public float maxDistance;
+            public LayerMask layerMask;
+
+            public RaycastQuery(Vector3 aOrigin, Vector3 aDirection, float aMaxDistance = Mathf.Infinity)
+            {
+                origin = aOrigin;
+                direction = aDirection;
+                maxDistance = aMaxDistance;
+                layerMask = new LayerMask(0u);
+            }
+
+            public RaycastQuery(Vector3 aOrigin, Vector3 aDirection, LayerMask aLayerMask, float aMaxDistance = Mathf.Infinity)
+            {
+                origin = aOrigin;
+                direction = aDirection;
+                maxDistance = aMaxDistance;
+                layerMask = aLayerMask;
+            }
+        };
+
+        [StructLayout(LayoutKind.Sequential)]
+        public struct ShapeCastQuery
+        {
+            public ShapeType shape;
+            public Vector3 origin;
+            public Vector3 direction;
+            public Vector3 halfExtent;
+            public float radius;
+            public float maxDistance;
+            public LayerMask layerMask;
+
+            public static ShapeCastQuery Sphere(Vector3 aOrigin, Vector3 aDirection, float aRadius, float aMaxDistance) => new ShapeCastQuery { shape = ShapeType.Sphere, origin = aOrigin, direction = aDirection, radius = aRadius, maxDistance = aMaxDistance, layerMask = new LayerMask(0u) };
+            public static ShapeCastQuery Box(Vector3 aOrigin, Vector3 aDirection, Vector3 aHalfExtent, float aMaxDistance) => new ShapeCastQuery { shape = ShapeType.Box, origin = aOrigin, direction = aDirection, halfExtent = aHalfExtent, maxDistance = aMaxDistance, layerMask = new LayerMask(0u) };
+        };
+
+        [StructLayout(LayoutKind.Sequential)]
+        public struct ShapeOverlapQuery
+        {
+            public ShapeType shape;
+            public Vector3 origin;
+            public Vector3 halfExtent;
+            public float radius;
+            public LayerMask layerMask;
+
+            public static ShapeOverlapQuery Sphere(Vector3 aOrigin, float aRadius) => new ShapeOverlapQuery { shape = ShapeType.Sphere, origin = aOrigin, radius = aRadius, layerMask = new LayerMask(0u) };
+            public static ShapeOverlapQuery Box(Vector3 aOrigin, Vector3 aHalfExtent) => new ShapeOverlapQuery { shape = ShapeType.Box, origin = aOrigin, halfExtent = aHalfExtent, layerMask = new LayerMask(0u) };
+        };
+
 
         public static bool Raycast(Vector3 aOrigin, Vector3 aDirection, float aMaxDistance = Mathf.Infinity) => InternalCalls.Physics_Raycast(ref aOrigin, ref aDirection, aMaxDistance, out _);
 
@@ -79,6 +138,16 @@ namespace Epoch
         public static Entity[] OverlapSphere(Vector3 aOrigin, float aRadius) => InternalCalls.Physics_OverlapSphere(ref aOrigin, aRadius);
 
 
+        // Batched queries. The result arrays are provided by the caller and can be reused between frames.
+        // outHits gets one entry per query, a miss has an entityID of 0. Returns the number of hits.
+        public static uint RaycastBatch(RaycastQuery[] aQueries, HitInfo[] outHits) => InternalCalls.Physics_RaycastBatch(aQueries, outHits);
+
+        public static uint ShapeCastBatch(ShapeCastQuery[] aQueries, HitInfo[] outHits) => InternalCalls.Physics_ShapeCastBatch(aQueries, outHits);
+
+        // outEntityIDs holds aMaxHitsPerQuery entries per query and outHitCounts the number of hits for each query.
+        public static uint OverlapShapeBatch(ShapeOverlapQuery[] aQueries, ulong[] outEntityIDs, uint[] outHitCounts, uint aMaxHitsPerQuery) => InternalCalls.Physics_OverlapShapeBatch(aQueries, outEntityIDs, outHitCounts, aMaxHitsPerQuery);
+
+
         public static void AddRadialImpulse(Vector3 aOrigin, float aRadius, float aStrength) => InternalCalls.Physics_AddRadialImpulse(ref aOrigin, aRadius, aStrength);
     }
 }
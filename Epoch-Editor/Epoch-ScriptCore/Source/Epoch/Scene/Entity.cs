@@ -47,6 +47,9 @@ namespace Epoch
         protected virtual void OnCreate() { }
         protected virtual void OnDestroy() { }
 
+        protected virtual void OnSpawn() { } //Pooled prefab instances
+        protected virtual void OnDespawn() { }
+
         protected virtual void OnDebug() { }
 
         private void OnDestroyInternal()
@@ -153,6 +153,36 @@ namespace Epoch
         }
 
 
+        // Pooled instances are created deactivated, OnSpawn and OnDespawn are called when they are taken from and returned to the pool
+        public static void CreatePrefabPool(Prefab aPrefab, uint aCount)
+        {
+            InternalCalls.Scene_CreatePrefabPool(ref aPrefab.myHandle, aCount);
+        }
+
+        public static Entity SpawnFromPool(Prefab aPrefab)
+        {
+            ulong entityID = InternalCalls.Scene_SpawnFromPool(ref aPrefab.myHandle);
+            return entityID == 0 ? null : new Entity(entityID);
+        }
+
+        public static Entity SpawnFromPool(Prefab aPrefab, Vector3 aTranslation)
+        {
+            ulong entityID = InternalCalls.Scene_SpawnFromPoolWithTranslation(ref aPrefab.myHandle, ref aTranslation);
+            return entityID == 0 ? null : new Entity(entityID);
+        }
+
+        public static Entity SpawnFromPool(Prefab aPrefab, Vector3 aTranslation, Vector3 aRotation)
+        {
+            ulong entityID = InternalCalls.Scene_SpawnFromPoolWithTranslationAndRotation(ref aPrefab.myHandle, ref aTranslation, ref aRotation);
+            return entityID == 0 ? null : new Entity(entityID);
+        }
+
+        public static bool DespawnToPool(Entity aEntity)
+        {
+            return InternalCalls.Scene_DespawnToPool(aEntity.id);
+        }
+
+
         public override bool Equals(object obj) => obj is Scene other && Equals(other);
 
         public bool Equals(Scene other)
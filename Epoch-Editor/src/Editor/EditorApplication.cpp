@@ -31,6 +31,7 @@ namespace Epoch
 		applicationSpecification.cacheDirectory = "Resources/cache";
 	
 		applicationSpecification.scriptEngineConfig.coreAssemblyPath = "Resources/Scripts/Epoch-ScriptCore.dll";
+		ApplyCommandLineArgs(applicationSpecification, aArgc, aArgv);
 	
 		return new Editor(applicationSpecification);
 	}
@@ -205,6 +205,11 @@ namespace Epoch
 	{
 		EPOCH_PROFILE_FUNC();
 
+		if (auto assetManager = Project::GetEditorAssetManager())
+		{
+			assetManager->FlushAssetRegistry();
+		}
+
 		if (!myActiveScene) return;
 
 		myEditorCamera.SetActive(mySceneViewport->AllowEditorCameraMovement());
@@ -770,6 +775,34 @@ namespace Epoch
 
 	Entity EditorLayer::GetHoveredEntity()
 	{
+		auto [mx, my] = mySceneViewport->GetMouseViewportSpace();
+
+		// Unprojecting the mouse onto the near and far planes gives the ray through the pixel
+		const CU::Matrix4x4f inverseViewProjection = (myEditorCamera.GetViewMatrix() * myEditorCamera.GetProjectionMatrix()).GetInverse();
+		CU::Vector4f nearPoint = CU::Vector4f(mx, my, 0.0f, 1.0f) * inverseViewProjection;
+		CU::Vector4f farPoint = CU::Vector4f(mx, my, 1.0f, 1.0f) * inverseViewProjection;
+		nearPoint = nearPoint / nearPoint.w;
+		farPoint = farPoint / farPoint.w;
+
+		const CU::Vector3f rayOrigin = CU::Vector3f(nearPoint);
+		const CU::Vector3f rayDirection = CU::Vector3f(farPoint) - rayOrigin;
+		const float rayLength = rayDirection.Length();
+
+		if (rayLength > 0.0f)
+		{
+			Entity pickedEntity = myActiveScene->PickEntity(rayOrigin, rayDirection / rayLength, rayLength);
+			if (pickedEntity)
+			{
+				return pickedEntity;
+			}
+		}
+
+		// Reading back stalls until the GPU has caught up, so it's only done when there is something only the ID buffer knows about
+		if (!NeedsEntityIDReadback())
+		{
+			return Entity();
+		}
+
 		auto [px, py] = mySceneViewport->GetMouseViewportCord();
 
 		auto sceneRenderer = mySceneViewport->GetSceneRenderer();
@@ -791,6 +824,11 @@ namespace Epoch
 		return Entity((entt::entity)(id - 1), myActiveScene.get());
 	}
 
+	bool EditorLayer::NeedsEntityIDReadback()
+	{
+		return !myActiveScene->GetAllEntitiesWith<TextRendererComponent>().empty() || !myActiveScene->GetAllEntitiesWith<RectComponent>().empty();
+	}
+
 	void EditorLayer::HandleAssetDrop()
 	{
 		if (mySceneState == SceneState::Play) return;
@@ -1071,7 +1109,7 @@ namespace Epoch
 			for (auto entityID : entities)
 			{
 				Entity entity = { entityID, myActiveScene.get() };
-				if (!entity.IsActive() || myActiveScene->WasEntityFrustumCulled(entity.GetUUID())) continue;
+				if (!entity.IsActive() || myActiveScene->WasEntityFrustumCulled((entt::entity)entity)) continue;
 
 				if (myShowCollidersMode == DebugLinesDrawMode::Selected)
 				{
@@ -1108,7 +1146,7 @@ namespace Epoch
 			{
 				Entity entity = { entityID, myActiveScene.get() };
 				auto& mrc = entity.GetComponent<MeshRendererComponent>();
-				if (!entity.IsActive() || myActiveScene->WasEntityFrustumCulled(entity.GetUUID()) || !mrc.isActive) continue;
+				if (!entity.IsActive() || myActiveScene->WasEntityFrustumCulled((entt::entity)entity) || !mrc.isActive) continue;
 
 				if (myShowBoundingBoxesMode == DebugLinesDrawMode::Selected)
 				{
@@ -2540,38 +2578,54 @@ namespace Epoch
 			const CU::Vector2f boxSize = selectionBoxMax - selectionBoxMin;
 			if (boxSize.x > 0 && boxSize.y > 0)
 			{
-				auto sceneRenderer = mySceneViewport->GetSceneRenderer();
-				auto IDBuffer = sceneRenderer->GetEntityIDTexture();
-				auto pixelData = IDBuffer->ReadData((uint32_t)boxSize.x, (uint32_t)boxSize.y, (uint32_t)selectionBoxMin.x, (uint32_t)selectionBoxMin.y);
-				if (pixelData)
+				std::unordered_set<uint32_t> ids;
+
+				const CU::Vector2f viewportSize = CU::Vector2f((float)mySceneViewport->Size().x, (float)mySceneViewport->Size().y);
+				const CU::Vector2f boxMinNDC = { selectionBoxMin.x / viewportSize.x * 2.0f - 1.0f, selectionBoxMin.y / viewportSize.y * 2.0f - 1.0f };
+				const CU::Vector2f boxMaxNDC = { selectionBoxMax.x / viewportSize.x * 2.0f - 1.0f, selectionBoxMax.y / viewportSize.y * 2.0f - 1.0f };
+				const Frustum boxFrustum = Frustum::CreateFromViewProjection(myEditorCamera.GetViewMatrix() * myEditorCamera.GetProjectionMatrix(), boxMinNDC, boxMaxNDC);
+
+				std::vector<Entity> boxedEntities;
+				myActiveScene->PickEntitiesInFrustum(boxFrustum, boxedEntities);
+				for (Entity entity : boxedEntities)
 				{
-					std::unordered_set<uint32_t> ids;
-					for (size_t i = 0; i < pixelData.size; i += 4)
+					ids.insert((uint32_t)entity);
+				}
+
+				if (NeedsEntityIDReadback())
+				{
+					auto sceneRenderer = mySceneViewport->GetSceneRenderer();
+					auto IDBuffer = sceneRenderer->GetEntityIDTexture();
+					auto pixelData = IDBuffer->ReadData((uint32_t)boxSize.x, (uint32_t)boxSize.y, (uint32_t)selectionBoxMin.x, (uint32_t)selectionBoxMin.y);
+					if (pixelData)
 					{
-						uint32_t id = pixelData.Read<uint32_t>(i);
-						if (id == 0) continue;
-						ids.insert(id - 1);
+						for (size_t i = 0; i < pixelData.size; i += 4)
+						{
+							uint32_t id = pixelData.Read<uint32_t>(i);
+							if (id == 0) continue;
+							ids.insert(id - 1);
+						}
+						pixelData.Release();
 					}
-					pixelData.Release();
+				}
+		
+				if (!ctrlDown)
+				{
+					SelectionManager::DeselectAll(SelectionContext::Scene);
+				}
+		
+				for (uint32_t id : ids)
+				{
+					Entity clickedEntity = Entity((entt::entity)id, myActiveScene.get());
+					if (!clickedEntity || !myActiveScene->IsEntityValid(clickedEntity)) continue;
 		
-					if (!ctrlDown)
+					if (ctrlDown && SelectionManager::IsSelected(SelectionContext::Scene, clickedEntity.GetUUID()))
 					{
-						SelectionManager::DeselectAll(SelectionContext::Scene);
+						SelectionManager::Deselect(SelectionContext::Scene, clickedEntity.GetUUID());
 					}
-		
-					for (uint32_t id : ids)
+					else
 					{
-						Entity clickedEntity = Entity((entt::entity)id, myActiveScene.get());
-						if (!clickedEntity || !myActiveScene->IsEntityValid(clickedEntity)) continue;
-		
-						if (ctrlDown && SelectionManager::IsSelected(SelectionContext::Scene, clickedEntity.GetUUID()))
-						{
-							SelectionManager::Deselect(SelectionContext::Scene, clickedEntity.GetUUID());
-						}
-						else
-						{
-							SelectionManager::Select(SelectionContext::Scene, clickedEntity.GetUUID());
-						}
+						SelectionManager::Select(SelectionContext::Scene, clickedEntity.GetUUID());
 					}
 				}
 			}
@@ -46,6 +46,8 @@ namespace Epoch
 		void RecursivePanelMenuItem(const std::vector<std::string>& aNameParts, uint32_t aDepth, bool& aIsOpen);
 
 		Entity GetHoveredEntity();
+		// Meshes and sprites are picked on the CPU, text and UI can only be picked by reading back the entity ID buffer
+		bool NeedsEntityIDReadback();
 
 		void HandleAssetDrop();
 
@@ -346,8 +346,8 @@ namespace Epoch
 
 		SelectionManager::DeselectAll();
 
-		AssetHandle baseDirectoryHandle = ProcessDirectory(Project::GetAssetDirectory().string(), nullptr);
-		myBaseDirectory = myDirectories[baseDirectoryHandle];
+		// The asset manager scanned the directory when the project was loaded
+		BuildDirectories(Project::GetEditorAssetManager()->GetLastAssetDirectoryScan());
 		ChangeDirectory(myBaseDirectory);
 
 		memset(mySearchBuffer, 0, MAX_INPUT_BUFFER_LENGTH);
@@ -371,60 +371,43 @@ namespace Epoch
 		return nullptr;
 	}
 
-	AssetHandle ContentBrowserPanel::ProcessDirectory(const std::filesystem::path& aDirectoryPath, const std::shared_ptr<DirectoryInfo>& aParent)
+	void ContentBrowserPanel::BuildDirectories(const AssetDirectoryScan& aScan)
 	{
-		const auto& directory = GetDirectory(aDirectoryPath);
-		if (directory)
-		{
-			return directory->handle;
-		}
+		EPOCH_PROFILE_FUNC();
 
-		std::shared_ptr<DirectoryInfo> directoryInfo = std::make_shared<DirectoryInfo>();
-		directoryInfo->handle = AssetHandle(Hash::GenerateFNVHash(aDirectoryPath.string()));
-		directoryInfo->parent = aParent;
+		const std::filesystem::path assetDirectory = Project::GetAssetDirectory();
 
-		if (aDirectoryPath == Project::GetAssetDirectory())
-		{
-			directoryInfo->filePath = "";
-		}
-		else
+		// Parents come before their subdirectories in the scan, so every parent exists by the time it's needed
+		std::vector<std::shared_ptr<DirectoryInfo>> directories(aScan.directories.size());
+		for (size_t i = 0; i < aScan.directories.size(); i++)
 		{
-			directoryInfo->filePath = std::filesystem::relative(aDirectoryPath, Project::GetAssetDirectory());
-		}
+			const AssetDirectoryScan::Directory& scannedDirectory = aScan.directories[i];
 
-		for (auto entry : std::filesystem::directory_iterator(aDirectoryPath))
-		{
-			if (entry.is_directory())
+			std::shared_ptr<DirectoryInfo> directoryInfo = std::make_shared<DirectoryInfo>();
+			directoryInfo->filePath = scannedDirectory.filePath;
+			directoryInfo->handle = AssetHandle(Hash::GenerateFNVHash(scannedDirectory.filePath.empty() ? assetDirectory.string() : (assetDirectory / scannedDirectory.filePath).string()));
+
+			if (scannedDirectory.parent != AssetDirectoryScan::InvalidIndex)
 			{
-				AssetHandle subdirHandle = ProcessDirectory(entry.path(), directoryInfo);
-				directoryInfo->subDirectories[subdirHandle] = myDirectories[subdirHandle];
-				continue;
+				directoryInfo->parent = directories[scannedDirectory.parent];
+				directoryInfo->parent->subDirectories[directoryInfo->handle] = directoryInfo;
 			}
 
-			auto metadata = Project::GetEditorAssetManager()->GetMetadata(std::filesystem::relative(entry.path(), Project::GetAssetDirectory()));
-			if (!metadata.IsValid())
+			directoryInfo->assets.reserve(scannedDirectory.files.size());
+			for (uint32_t fileIndex : scannedDirectory.files)
 			{
-				AssetType type = Project::GetEditorAssetManager()->GetAssetTypeFromPath(entry.path());
-				if (type == AssetType::None)
+				// Files that failed to import have no handle
+				if (const AssetHandle handle = aScan.files[fileIndex].handle; handle != 0)
 				{
-					continue;
+					directoryInfo->assets.push_back(handle);
 				}
-
-				Project::GetEditorAssetManager()->ImportAsset(entry.path());
-				metadata = Project::GetEditorAssetManager()->GetMetadata(std::filesystem::relative(entry.path(), Project::GetAssetDirectory()));
-			}
-
-			// Failed to import
-			if (!metadata.IsValid())
-			{
-				continue;
 			}
 
-			directoryInfo->assets.push_back(metadata.handle);
+			myDirectories[directoryInfo->handle] = directoryInfo;
+			directories[i] = directoryInfo;
 		}
 
-		myDirectories[directoryInfo->handle] = directoryInfo;
-		return directoryInfo->handle;
+		myBaseDirectory = directories.front();
 	}
 
 	void ContentBrowserPanel::ChangeDirectory(std::shared_ptr<DirectoryInfo>& aDirectory)
@@ -1113,8 +1096,7 @@ namespace Epoch
 		myDirectories.clear();
 
 		std::shared_ptr<DirectoryInfo> currentDirectory = myCurrentDirectory;
-		AssetHandle baseDirectoryHandle = ProcessDirectory(Project::GetAssetDirectory().string(), nullptr);
-		myBaseDirectory = myDirectories[baseDirectoryHandle];
+		BuildDirectories(Project::GetEditorAssetManager()->ScanAssetDirectory());
 		myCurrentDirectory = GetDirectory(currentDirectory->filePath);
 
 		if (!myCurrentDirectory)
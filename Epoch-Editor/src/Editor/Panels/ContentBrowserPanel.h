@@ -4,6 +4,7 @@
 #include <Epoch/Utils/FileSystem.h>
 #include <Epoch/Rendering/Texture.h>
 #include <Epoch/Assets/AssetMetadata.h>
+#include <Epoch/Assets/AssetDirectoryScanner.h>
 #include <Epoch/Editor/EditorPanel.h>
 #include <Epoch/Core/Events/MouseEvent.h>
 #include <Epoch/Core/Events/KeyEvent.h>
@@ -114,7 +115,7 @@ namespace Epoch
 		void Import(const std::vector<std::filesystem::path>& aPaths);
 
 		void Refresh();
-		AssetHandle ProcessDirectory(const std::filesystem::path& aDirectoryPath, const std::shared_ptr<DirectoryInfo>& aParent);
+		void BuildDirectories(const AssetDirectoryScan& aScan);
 
 		void ChangeDirectory(std::shared_ptr<DirectoryInfo>& aDirectory);
 		void OnBrowseBack();
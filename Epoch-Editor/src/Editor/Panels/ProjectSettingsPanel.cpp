@@ -77,6 +77,9 @@ namespace Epoch
 			modified = true;
 		}
 
+		modified |= UI::Property_Checkbox("Async Simulation", settings.asyncSimulation, "Overlaps the simulation with the rest of the frame, scripts see the results of the previous step");
+		modified |= UI::Property_Checkbox("Interpolate Transforms", settings.interpolateTransforms, "Renders dynamic bodies between the last two fixed steps to hide stutter at low fixed rates");
+
 		UI::EndPropertyGrid();
 
 		UI::Spacing();
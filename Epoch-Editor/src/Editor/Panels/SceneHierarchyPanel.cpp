@@ -20,7 +20,13 @@ namespace Epoch
 	static bool staticPopupHovered = false;
 	static bool staticOpenPopup = false;
 
-	static int staticRowIndex = -1; //TODO: Remove
+	static std::string PrepareSearchString(const std::string& aString)
+	{
+		// Same normalization as UI::IsMatchingSearch, done once per name instead of once per comparison
+		std::string result = aString;
+		result.erase(std::remove_if(result.begin(), result.end(), ::isspace), result.end());
+		return CU::ToLower(result);
+	}
 
 	SceneHierarchyPanel::SceneHierarchyPanel(const std::string& aName) : EditorPanel(aName)
 	{
@@ -44,10 +50,11 @@ namespace Epoch
 
 		if (myContext)
 		{
-			static std::string searchString;
-
 			ImGui::SetNextItemWidth(windowRect.GetWidth());
-			ImGui::InputTextWithHint("##EntitySearch", "Search...", &searchString);
+			if (ImGui::InputTextWithHint("##EntitySearch", "Search...", &mySearchFilter))
+			{
+				mySearchDirty = true;
+			}
 			UI::Spacing();
 			ImGui::Separator();
 
@@ -57,30 +64,46 @@ namespace Epoch
 			ImGui::PushStyleColor(ImGuiCol_ChildBg, ImVec4(0.1f, 0.1f, 0.1f, 1.0f));
 			ImGui::BeginChild("Entity List");
 
-			//ImRect listRect = UI::GetItemRect();
-			//listRect.Max.y += ImGui::GetContentRegionAvail().y;
-
-			//ImGui::PushClipRect(ImGui::GetCursorScreenPos(), ImGui::GetCursorScreenPos() + ImVec2(ImGui::GetContentRegionAvail()), false);
-
 			{
 				EPOCH_PROFILE_SCOPE("SceneHierarchyPanel::OnImGuiRender::EntityList");
 
-				staticRowIndex = -1;
-				auto view = myContext->GetAllEntitiesWith<IDComponent, RelationshipComponent>();
-				for (auto entityID : view)
+				if (myHierarchyVersion != myContext->GetHierarchyVersion())
+				{
+					RebuildHierarchyModel();
+				}
+
+				if (myNameVersion != myContext->GetNameVersion())
+				{
+					// Renames can come from anywhere (scripts, undo, prefabs), so the cached names are only trusted while the version matches
+					myNameVersion = myContext->GetNameVersion();
+					mySearchNames.clear();
+					mySearchDirty = true;
+				}
+
+				if (mySearchDirty)
+				{
+					UpdateSearchMatches();
+				}
+
+				ExpandToSelection();
+
+				if (myRowsDirty)
 				{
-					if (view.get<RelationshipComponent>(entityID).parentHandle != 0)
+					RebuildRows();
+				}
+
+				// Only the rows in view are drawn, the clipper skips the rest by their height
+				ImGuiListClipper clipper;
+				clipper.Begin((int)myRows.size());
+				while (clipper.Step())
+				{
+					for (int rowIndex = clipper.DisplayStart; rowIndex < clipper.DisplayEnd; rowIndex++)
 					{
-						continue;
+						DrawEntityRow(rowIndex);
 					}
-
-					Entity entity{ entityID, myContext.get() };
-					DrawEntityNode(entity, searchString);
 				}
 			}
 
-			//ImGui::PopClipRect();
-
 			if (ImGui::IsWindowHovered())
 			{
 				if (!ImGui::IsAnyItemHovered())
@@ -146,114 +169,243 @@ namespace Epoch
 	void SceneHierarchyPanel::OnSceneChanged(const std::shared_ptr<Scene>& aScene)
 	{
 		myContext = aScene;
+
+		myNodes.clear();
+		myRows.clear();
+		myExpandedEntities.clear();
+		myLastSelections.clear();
+		myHierarchyVersion = UINT64_MAX;
+		myNameVersion = UINT64_MAX;
+		myShiftSelectionAnchor = 0;
 	}
 
-	bool SceneHierarchyPanel::ChildMatchesSearchRecursively(Entity aEntity, const std::string& aSearchFilter)
+	void SceneHierarchyPanel::RebuildHierarchyModel()
 	{
-		if (aSearchFilter.empty())
+		EPOCH_PROFILE_FUNC();
+
+		myHierarchyVersion = myContext->GetHierarchyVersion();
+
+		myNodes.clear();
+		mySearchNames.clear();
+		mySearchDirty = true;
+		myRowsDirty = true;
+
+		struct HierarchyStackEntry
 		{
-			return false;
-		}
+			uint32_t node;
+			uint32_t nextChild;
+		};
 
-		for (auto childId : aEntity.Children())
+		// Walked with an explicit stack, long bone chains would otherwise recurse very deep
+		std::vector<HierarchyStackEntry> stack;
+
+		auto addNode = [&](Entity aEntity, uint32_t aParent)
+			{
+				const uint32_t index = (uint32_t)myNodes.size();
+
+				HierarchyNode& node = myNodes.emplace_back();
+				node.entity = aEntity;
+				node.id = aEntity.GetUUID();
+				node.parent = aParent;
+				node.depth = aParent == UINT32_MAX ? 0 : myNodes[aParent].depth + 1;
+
+				stack.push_back({ index, 0 });
+			};
+
+		auto view = myContext->GetAllEntitiesWith<IDComponent, RelationshipComponent>();
+		myNodes.reserve(view.size());
+
+		for (auto entityID : view)
 		{
-			Entity child = myContext->GetEntityWithUUID(childId);
-			if (UI::IsMatchingSearch(child.GetName(), aSearchFilter))
+			if (view.get<RelationshipComponent>(entityID).parentHandle != 0)
 			{
-				return true;
+				continue;
 			}
 
-			bool found = ChildMatchesSearchRecursively(child, aSearchFilter);
-			if (found)
+			addNode(Entity{ entityID, myContext.get() }, UINT32_MAX);
+
+			while (!stack.empty())
+			{
+				const uint32_t nodeIndex = stack.back().node;
+				const auto& children = myContext->myRegistry.get<RelationshipComponent>(myNodes[nodeIndex].entity).children;
+
+				if (stack.back().nextChild >= children.size())
+				{
+					myNodes[nodeIndex].subtreeEnd = (uint32_t)myNodes.size();
+					stack.pop_back();
+					continue;
+				}
+
+				const UUID childID = children[stack.back().nextChild++];
+				if (Entity child = myContext->TryGetEntityWithUUID(childID))
+				{
+					addNode(child, nodeIndex);
+				}
+			}
+		}
+	}
+
+	void SceneHierarchyPanel::UpdateSearchMatches()
+	{
+		EPOCH_PROFILE_FUNC();
+
+		mySearchDirty = false;
+		myRowsDirty = true;
+
+		mySearchMatches.assign(myNodes.size(), SearchMatch_None);
+
+		if (mySearchFilter.empty())
+		{
+			return;
+		}
+
+		if (mySearchNames.size() != myNodes.size())
+		{
+			mySearchNames.resize(myNodes.size());
+			for (size_t i = 0; i < myNodes.size(); i++)
 			{
-				return true;
+				mySearchNames[i] = PrepareSearchString(myContext->myRegistry.get<NameComponent>(myNodes[i].entity).name);
 			}
 		}
 
-		return false;
+		const std::string query = PrepareSearchString(mySearchFilter);
+
+		for (uint32_t i = 0; i < (uint32_t)myNodes.size(); i++)
+		{
+			if (mySearchNames[i].empty() || mySearchNames[i].find(query) == std::string::npos)
+			{
+				continue;
+			}
+
+			mySearchMatches[i] |= SearchMatch_Self;
+
+			// Stops at the first ancestor that is already marked, so every node is marked at most once
+			for (uint32_t parent = myNodes[i].parent; parent != UINT32_MAX && !(mySearchMatches[parent] & SearchMatch_Descendant); parent = myNodes[parent].parent)
+			{
+				mySearchMatches[parent] |= SearchMatch_Descendant;
+			}
+		}
 	}
 
-	bool SceneHierarchyPanel::IsAnyDescendantSelected(Entity aEntity, bool aFirst)
+	void SceneHierarchyPanel::ExpandToSelection()
 	{
-		if (!aFirst && SelectionManager::IsSelected(SelectionContext::Scene, aEntity.GetUUID()))
+		const auto& selections = SelectionManager::GetSelections(SelectionContext::Scene);
+		if (selections == myLastSelections)
 		{
-			return true;
+			return;
 		}
 
-		if (!aEntity.Children().empty())
+		myLastSelections = selections;
+
+		// Entities selected elsewhere, like in the viewport, should show up in the list
+		for (UUID selectionID : selections)
 		{
-			for (auto& childEntityID : aEntity.Children())
+			Entity entity = myContext->TryGetEntityWithUUID(selectionID);
+			if (!entity)
 			{
-				Entity childEntity = myContext->GetEntityWithUUID(childEntityID);
-				if (IsAnyDescendantSelected(childEntity))
+				continue;
+			}
+
+			for (Entity parent = entity.GetParent(); parent; parent = parent.GetParent())
+			{
+				if (!myExpandedEntities.insert(parent.GetUUID()).second)
 				{
-					return true;
+					break;
 				}
+
+				myRowsDirty = true;
 			}
 		}
-
-		return false;
 	}
 
-	void SceneHierarchyPanel::DrawEntityNode(Entity aEntity, const std::string& aSearchFilter)
+	void SceneHierarchyPanel::RebuildRows()
 	{
-		staticRowIndex++;
+		EPOCH_PROFILE_FUNC();
+
+		myRowsDirty = false;
+		myRows.clear();
 
-		std::string& entityName = aEntity.GetComponent<NameComponent>().name;
+		const bool isSearching = !mySearchFilter.empty();
 
-		const bool childMatchesSearch = ChildMatchesSearchRecursively(aEntity, aSearchFilter);
-		if (!childMatchesSearch && !UI::IsMatchingSearch(entityName, aSearchFilter)) return;
+		uint32_t nodeIndex = 0;
+		while (nodeIndex < (uint32_t)myNodes.size())
+		{
+			const HierarchyNode& node = myNodes[nodeIndex];
 
-		bool isSelected = SelectionManager::IsSelected(SelectionContext::Scene, aEntity.GetUUID());
+			if (isSearching && mySearchMatches[nodeIndex] == SearchMatch_None)
+			{
+				nodeIndex = node.subtreeEnd;
+				continue;
+			}
 
-		ImGuiTreeNodeFlags flags = ((isSelected) ? ImGuiTreeNodeFlags_Selected : 0) | ImGuiTreeNodeFlags_SpanAvailWidth;
-		aEntity.Children().empty() ? flags |= ImGuiTreeNodeFlags_Leaf : flags |= ImGuiTreeNodeFlags_OpenOnArrow;
+			myRows.push_back(nodeIndex);
 
-		const bool anyDescendantSelected = IsAnyDescendantSelected(aEntity, true);
+			// While searching, everything leading to a match is open
+			const bool isExpanded = isSearching ? (mySearchMatches[nodeIndex] & SearchMatch_Descendant) != 0 : myExpandedEntities.contains(node.id);
+			nodeIndex = isExpanded ? nodeIndex + 1 : node.subtreeEnd;
+		}
+	}
+
+	void SceneHierarchyPanel::DrawEntityRow(int aRowIndex)
+	{
+		const HierarchyNode& node = myNodes[myRows[aRowIndex]];
 
-		if ((anyDescendantSelected || (!aSearchFilter.empty() && childMatchesSearch)) && (!ImGui::IsMouseDown(ImGuiMouseButton_Left) && !ImGui::IsMouseReleased(ImGuiMouseButton_Left)))
+		// The list is rebuilt next frame, entities destroyed during this one are skipped until then
+		if (!myContext->myRegistry.valid(node.entity))
 		{
-			ImGui::SetNextItemOpen(true);
+			return;
 		}
+
+		Entity entity{ node.entity, myContext.get() };
+		std::string& entityName = entity.GetComponent<NameComponent>().name;
+
+		bool isSelected = SelectionManager::IsSelected(SelectionContext::Scene, node.id);
+
+		ImGuiTreeNodeFlags flags = ((isSelected) ? ImGuiTreeNodeFlags_Selected : 0) | ImGuiTreeNodeFlags_SpanAvailWidth | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+		entity.Children().empty() ? flags |= ImGuiTreeNodeFlags_Leaf : flags |= ImGuiTreeNodeFlags_OpenOnArrow;
+
+		const bool isSearching = !mySearchFilter.empty();
+		const bool isExpanded = isSearching ? (mySearchMatches[myRows[aRowIndex]] & SearchMatch_Descendant) != 0 : myExpandedEntities.contains(node.id);
+		ImGui::SetNextItemOpen(isExpanded);
 		
-		bool isActive = aEntity.IsActive();
-		bool isPrefab = aEntity.HasComponent<PrefabComponent>();
+		bool isActive = entity.IsActive();
+		bool isPrefab = entity.HasComponent<PrefabComponent>();
 		bool isValid = true;
 		{
-			if (isPrefab && !AssetManager::IsAssetHandleValid(aEntity.GetComponent<PrefabComponent>().prefabID))
+			if (isPrefab && !AssetManager::IsAssetHandleValid(entity.GetComponent<PrefabComponent>().prefabID))
 			{
 				isValid = false;
 			}
 
-			if (aEntity.HasComponent<SpriteRendererComponent>())
+			if (entity.HasComponent<SpriteRendererComponent>())
 			{
-				auto& src = aEntity.GetComponent<SpriteRendererComponent>();
+				auto& src = entity.GetComponent<SpriteRendererComponent>();
 				if (src.texture != 0 && !AssetManager::IsAssetHandleValid(src.texture))
 				{
 					isValid = false;
 				}
 			}
 
-			if (aEntity.HasComponent<MeshRendererComponent>())
+			if (entity.HasComponent<MeshRendererComponent>())
 			{
-				if (!AssetManager::IsAssetHandleValid(aEntity.GetComponent<MeshRendererComponent>().mesh))
+				if (!AssetManager::IsAssetHandleValid(entity.GetComponent<MeshRendererComponent>().mesh))
 				{
 					isValid = false;
 				}
 			}
 
-			if (aEntity.HasComponent<SkinnedMeshRendererComponent>())
+			if (entity.HasComponent<SkinnedMeshRendererComponent>())
 			{
-				auto& smrc = aEntity.GetComponent<SkinnedMeshRendererComponent>();
+				auto& smrc = entity.GetComponent<SkinnedMeshRendererComponent>();
 				if (!AssetManager::IsAssetHandleValid(smrc.mesh) || smrc.boneEntityIds.empty() || !myContext->TryGetEntityWithUUID(smrc.boneEntityIds[0]))
 				{
 					isValid = false;
 				}
 			}
 
-			if (aEntity.HasComponent<ScriptComponent>())
+			if (entity.HasComponent<ScriptComponent>())
 			{
-				auto& sc = aEntity.GetComponent<ScriptComponent>();
+				auto& sc = entity.GetComponent<ScriptComponent>();
 				if (!ScriptEngine::IsModuleValid(sc.scriptClassHandle))
 				{
 					isValid = false;
@@ -278,7 +430,7 @@ namespace Epoch
 				colorToPush = Colors::Theme::disabled;
 			}
 
-			if (!isActive && aEntity.IsActive(false))
+			if (!isActive && entity.IsActive(false))
 			{
 				colorToPush = UI::ColorWithMultipliedValue(colorToPush, 1.3f);
 			}
@@ -286,21 +438,36 @@ namespace Epoch
 			ImGui::PushStyleColor(ImGuiCol_Text, (ImU32)colorToPush);
 		}
 
-		bool opened = ImGui::TreeNodeEx((void*)(uint64_t)(uint32_t)aEntity, flags, entityName.c_str());
+		const float indent = node.depth * ImGui::GetStyle().IndentSpacing;
+		if (indent > 0.0f)
+		{
+			ImGui::Indent(indent);
+		}
+
+		bool opened = ImGui::TreeNodeEx((void*)(uint64_t)(uint32_t)entity, flags, entityName.c_str());
+
+		if (indent > 0.0f)
+		{
+			ImGui::Unindent(indent);
+		}
 
 		if (!isValid || isPrefab || !isActive)
 		{
 			ImGui::PopStyleColor();
 		}
 
-		if (staticRowIndex >= myFirstSelectedRow && staticRowIndex <= myLastSelectedRow && !SelectionManager::IsSelected(SelectionContext::Scene, aEntity.GetUUID()) && myShiftSelectionRunning)
+		if (opened != isExpanded && !isSearching)
 		{
-			SelectionManager::Select(SelectionContext::Scene, aEntity.GetUUID());
-
-			if (SelectionManager::GetSelectionCount(SelectionContext::Scene) == (myLastSelectedRow - myFirstSelectedRow) + 1)
+			if (opened)
 			{
-				myShiftSelectionRunning = false;
+				myExpandedEntities.insert(node.id);
 			}
+			else
+			{
+				myExpandedEntities.erase(node.id);
+			}
+
+			myRowsDirty = true;
 		}
 
 		if (!staticPopupHovered && ImGui::IsItemHovered(ImGuiHoveredFlags_RectOnly))
@@ -311,38 +478,35 @@ namespace Epoch
 			bool shiftDown = ImGui::IsKeyDown(ImGuiKey_LeftShift);
 			if (leftUp || rightUp)
 			{
-				if (shiftDown && SelectionManager::GetSelectionCount(SelectionContext::Scene) > 0)
+				auto anchorIt = std::find_if(myRows.begin(), myRows.end(), [&](uint32_t aNodeIndex) { return myNodes[aNodeIndex].id == myShiftSelectionAnchor; });
+
+				if (shiftDown && SelectionManager::GetSelectionCount(SelectionContext::Scene) > 0 && anchorIt != myRows.end())
 				{
 					SelectionManager::DeselectAll(SelectionContext::Scene);
 
-					if (staticRowIndex < myFirstSelectedRow)
+					const int anchorRow = (int)(anchorIt - myRows.begin());
+					const int firstRow = CU::Math::Min(anchorRow, aRowIndex);
+					const int lastRow = CU::Math::Max(anchorRow, aRowIndex);
+					for (int row = firstRow; row <= lastRow; row++)
 					{
-						myLastSelectedRow = myFirstSelectedRow;
-						myFirstSelectedRow = staticRowIndex;
+						SelectionManager::Select(SelectionContext::Scene, myNodes[myRows[row]].id);
 					}
-					else
-					{
-						myLastSelectedRow = staticRowIndex;
-					}
-
-					myShiftSelectionRunning = true;
 				}
 				else if (!ctrlDown || shiftDown)
 				{
 					SelectionManager::DeselectAll(SelectionContext::Scene);
-					SelectionManager::Select(SelectionContext::Scene, aEntity.GetUUID());
-					myFirstSelectedRow = staticRowIndex;
-					myLastSelectedRow = -1;
+					SelectionManager::Select(SelectionContext::Scene, node.id);
+					myShiftSelectionAnchor = node.id;
 				}
 				else
 				{
 					if (isSelected)
 					{
-						SelectionManager::Deselect(SelectionContext::Scene, aEntity.GetUUID());
+						SelectionManager::Deselect(SelectionContext::Scene, node.id);
 					}
 					else
 					{
-						SelectionManager::Select(SelectionContext::Scene, aEntity.GetUUID());
+						SelectionManager::Select(SelectionContext::Scene, node.id);
 					}
 				}
 
@@ -356,19 +520,19 @@ namespace Epoch
 		if (ImGui::BeginDragDropSource(ImGuiDragDropFlags_SourceAllowNullID))
 		{
 			const auto& selectedEntities = SelectionManager::GetSelections(SelectionContext::Scene);
-			UUID entityID = aEntity.GetUUID();
+			UUID entityID = node.id;
 
 			if (!SelectionManager::IsSelected(SelectionContext::Scene, entityID))
 			{
-				ImGui::Text(aEntity.GetName().c_str());
+				ImGui::Text(entity.GetName().c_str());
 				ImGui::SetDragDropPayload("scene_entity_hierarchy", &entityID, 1 * sizeof(UUID));
 			}
 			else
 			{
 				for (const auto& selectedEntity : selectedEntities)
 				{
-					Entity entity = myContext->GetEntityWithUUID(selectedEntity);
-					ImGui::Text(entity.GetName().c_str());
+					Entity selected = myContext->GetEntityWithUUID(selectedEntity);
+					ImGui::Text(selected.GetName().c_str());
 				}
 
 				ImGui::SetDragDropPayload("scene_entity_hierarchy", selectedEntities.data(), selectedEntities.size() * sizeof(UUID));
@@ -389,24 +553,14 @@ namespace Epoch
 				{
 					UUID droppedEntityID = *(((UUID*)payload->Data) + i);
 					Entity droppedEntity = myContext->GetEntityWithUUID(droppedEntityID);
-					myContext->ParentEntity(droppedEntity, aEntity);
+					myContext->ParentEntity(droppedEntity, entity);
 				}
 			}
 
-			HandleAssetDrop(aEntity);
+			HandleAssetDrop(entity);
 
 			ImGui::EndDragDropTarget();
 		}
-
-		if (opened)
-		{
-			for (auto child : aEntity.Children())
-			{
-				DrawEntityNode(myContext->GetEntityWithUUID(child), aSearchFilter);
-			}
-
-			ImGui::TreePop();
-		}
 	}
 
 	static bool DrawVec3Control(const std::string& aLabel, CU::Vector3f& aValues, float aSpeed, bool& aManuallyEdited, float aResetValue = 0.0f, uint32_t aRenderMultiSelectAxes = 0)
@@ -522,7 +676,7 @@ namespace Epoch
 					for (auto entityID : aEntityIDs)
 					{
 						Entity entity = myContext->GetEntityWithUUID(entityID);
-						entity.GetComponent<NameComponent>().name = name;
+						entity.SetName(name);
 					}
 				}
 			}
@@ -1119,7 +1273,7 @@ namespace Epoch
 						for (size_t i = 0; i < aFirstComponent.fieldIDs.size(); i++)
 						{
 							FieldInfo* field = ScriptCache::GetFieldByID(aFirstComponent.fieldIDs[i]);
-							std::shared_ptr<FieldStorageBase> storage = ScriptEngine::GetFieldStorage(firstEntity, field->id);
+							FieldStorageBase storage = ScriptEngine::GetFieldStorage(firstEntity, field->id);
 
 							if (field->spacing > 0)
 							{
@@ -1163,14 +1317,14 @@ namespace Epoch
 							{
 								UI::EndPropertyGrid();
 
-								auto arrayFieldStorage = std::dynamic_pointer_cast<ArrayFieldStorage>(storage);
+								ArrayFieldStorage arrayFieldStorage = storage.AsArray();
 								UI::DrawFieldArray(myContext, fieldName, arrayFieldStorage, field->tooltip.c_str());
 
 								UI::BeginPropertyGrid();
 							}
 							else
 							{
-								auto fieldStorage = std::dynamic_pointer_cast<FieldStorage>(storage);
+								FieldStorage fieldStorage = storage.AsField();
 								UI::DrawFieldValue(myContext, fieldName, fieldStorage, field->tooltip.c_str());
 							}
 						}
@@ -2,6 +2,7 @@
 #include <memory>
 #include <string>
 #include <functional>
+#include <unordered_set>
 #include <Epoch/Scene/Scene.h>
 #include <Epoch/Scene/Entity.h>
 #include <Epoch/ImGui/ImGui.h>
@@ -41,10 +42,29 @@ namespace Epoch
 		void AddEntityPopupPlugin(const std::string& aName, const std::function<void(Entity)>& aFunc) { myEntityPopupPlugins.emplace_back(aName, aFunc); }
 
 	private:
-		bool ChildMatchesSearchRecursively(Entity aEntity, const std::string& aSearchFilter);
-		bool IsAnyDescendantSelected(Entity aEntity, bool aFirst = false);
+		// The hierarchy flattened in draw order. The descendants of a node are the nodes up to its subtree end.
+		struct HierarchyNode
+		{
+			entt::entity entity = entt::null;
+			UUID id = 0;
+			uint32_t parent = UINT32_MAX;
+			uint32_t subtreeEnd = 0;
+			uint32_t depth = 0;
+		};
+
+		enum SearchMatch : uint8_t
+		{
+			SearchMatch_None = 0,
+			SearchMatch_Self = BIT(0),
+			SearchMatch_Descendant = BIT(1)
+		};
 
-		void DrawEntityNode(Entity aEntity, const std::string& aSearchFilter);
+		void RebuildHierarchyModel();
+		void UpdateSearchMatches();
+		void ExpandToSelection();
+		void RebuildRows();
+
+		void DrawEntityRow(int aRowIndex);
 		void DrawComponents(const std::vector<UUID>& aEntityIDs);
 
 		template<typename TVectorType, typename TComponent, typename GetOtherFunc>
@@ -426,9 +446,23 @@ namespace Epoch
 		std::shared_ptr<Scene> myComponentCopyScene;
 		Entity myComponentCopyEntity;
 
-		bool myShiftSelectionRunning = false;
-		int myFirstSelectedRow = -1;
-		int myLastSelectedRow = -1;
+		std::vector<HierarchyNode> myNodes;
+		uint64_t myHierarchyVersion = UINT64_MAX;
+		uint64_t myNameVersion = UINT64_MAX;
+
+		std::string mySearchFilter;
+		// Lowercase without whitespace, filled in the first time the nodes are searched
+		std::vector<std::string> mySearchNames;
+		std::vector<uint8_t> mySearchMatches;
+		bool mySearchDirty = true;
+
+		// Indices of the nodes that are currently in the list, only these get drawn
+		std::vector<uint32_t> myRows;
+		std::unordered_set<UUID> myExpandedEntities;
+		std::vector<UUID> myLastSelections;
+		bool myRowsDirty = true;
+
+		UUID myShiftSelectionAnchor = 0;
 
 		std::function<void(Entity)> myEntityCreationCallback;
 		std::vector<EntityPopupPlugin> myEntityPopupPlugins;
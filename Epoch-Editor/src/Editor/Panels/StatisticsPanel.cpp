@@ -4,6 +4,8 @@
 #include <Epoch/ImGui/ImGui.h>
 #include <Epoch/Core/GraphicsEngine.h> //TODO: Remove
 #include <Epoch/Debug/Timer.h>
+#include <Epoch/Debug/MemoryTracker.h>
+#include <Epoch/Core/FrameAllocator.h>
 #include <Epoch/Scene/SceneRenderer.h>
 #include <Epoch/Rendering/DebugRenderer.h>
 #include <Epoch/Rendering/Font.h>
@@ -165,6 +167,72 @@ namespace Epoch
 			ImGui::Separator();
 			ImGui::Spacing();
 
+			//CPU Profiler
+			{
+				static double time = 0.0;
+				time += CU::Timer::GetDeltaTime();
+
+				if (time > 0.2)
+				{
+					FrameProfiler::GetLastFrameTimings(myZoneTimings);
+					time = 0.0;
+				}
+
+				ImGui::Text("CPU Frame: %.3fms", FrameProfiler::GetLastFrameTime());
+
+				if (FrameProfiler::IsCapturing())
+				{
+					ImGui::TextUnformatted("Capturing...");
+				}
+				else if (ImGui::Button("Capture 120 Frames"))
+				{
+					FrameProfiler::RequestCapture(120, "Profiling/Capture.json");
+				}
+
+				ImGui::Spacing();
+
+				const size_t shownZones = CU::Math::Min(myZoneTimings.size(), (size_t)15);
+				for (size_t i = 0; i < shownZones; i++)
+				{
+					const auto& timing = myZoneTimings[i];
+					ImGui::Text("%.3fms (%u) %s", timing.milliseconds, timing.calls, timing.name);
+				}
+			}
+
+			ImGui::Spacing();
+			ImGui::Separator();
+			ImGui::Spacing();
+
+			//Memory
+			{
+				const auto toMB = [](uint64_t aBytes) { return (float)((double)aBytes / (1024.0 * 1024.0)); };
+
+				const auto total = MemoryTracker::GetTotalStats();
+				const auto lastFrame = MemoryTracker::GetLastFrameStats();
+
+				ImGui::Text("Heap: %.2fMB (Peak %.2fMB)", toMB(total.currentBytes), toMB(total.peakBytes));
+				ImGui::Text(("Allocations Last Frame: " + CU::NumberFormat(lastFrame.allocations)).c_str());
+				ImGui::Text("Allocated Last Frame: %.3fMB", toMB(lastFrame.bytes));
+				ImGui::Text("Frame Arena: %.3fMB (Capacity %.2fMB)", toMB(FrameAllocator::GetLastFrameUsedBytes()), toMB(FrameAllocator::GetCapacity()));
+
+				ImGui::Spacing();
+
+				for (size_t i = 0; i < (size_t)MemoryTag::Count; i++)
+				{
+					const auto stats = MemoryTracker::GetTagStats((MemoryTag)i);
+					if (stats.peakBytes == 0)
+					{
+						continue;
+					}
+
+					ImGui::Text("%s: %.2fMB (Peak %.2fMB)", MemoryTagToString((MemoryTag)i), toMB(stats.currentBytes), toMB(stats.peakBytes));
+				}
+			}
+
+			ImGui::Spacing();
+			ImGui::Separator();
+			ImGui::Spacing();
+
 			//Scene
 			{
 				EPOCH_PROFILE_SCOPE("Epoch::StatisticsPanel::OnImGuiRender::SceneStats");
@@ -274,6 +342,11 @@ namespace Epoch
 				ImGui::Text(("Meshes: " + CU::NumberFormat(stats.meshes)).c_str());
 				ImGui::Text(("Sub meshes: " + CU::NumberFormat(stats.submeshes)).c_str());
 
+				UI::Spacing();
+
+				ImGui::Text(("State Binds: " + CU::NumberFormat(stats.stateBinds)).c_str());
+				ImGui::Text(("Skipped Binds: " + CU::NumberFormat(stats.skippedStateBinds)).c_str());
+
 				//UI::Spacing(2);
 
 				//if (UI::PropertyGridHeader("Render Statistics", true))
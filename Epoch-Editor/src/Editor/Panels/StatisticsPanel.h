@@ -1,6 +1,8 @@
 #pragma once
 #include <memory>
+#include <vector>
 #include <Epoch/Editor/EditorPanel.h>
+#include <Epoch/Debug/FrameProfiler.h>
 
 namespace Epoch
 {
@@ -25,5 +27,7 @@ namespace Epoch
 		std::weak_ptr<DebugRenderer> myDebugRendererReference;
 
 		bool myShowAdvanced = false;
+
+		std::vector<FrameProfiler::ZoneTiming> myZoneTimings;
 	};
 }
@@ -27,6 +27,7 @@ namespace Epoch
 		applicationSpecification.cacheDirectory = "cache";
 		applicationSpecification.scriptEngineConfig.coreAssemblyPath = "Epoch-ScriptCore.dll";
 		applicationSpecification.rendererConfig.shaderPackPath = "Assets/ShaderPack.esp";
+		ApplyCommandLineArgs(applicationSpecification, aArgc, aArgv);
 
 		std::string projectPath = "Project.eproj";
 
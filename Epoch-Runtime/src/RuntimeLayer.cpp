@@ -4,14 +4,18 @@
 #include <Epoch/Core/GraphicsEngine.h>
 #include <Epoch/Rendering/RenderPipeline.h>
 #include <Epoch/Rendering/Renderer.h>
+#include <Epoch/Rendering/TextureStreamer.h>
+#include <Epoch/Assets/AssetManager.h>
 #include <Epoch/Project/ProjectSerializer.h>
 #include <Epoch/Assets/AssetPack/AssetPack.h>
 #include <Epoch/Scene/SceneRenderer.h>
 #include <Epoch/Scene/SceneSerializer.h>
+#include <Epoch/Scene/SceneLoader.h>
 #include <Epoch/Script/ScriptEngine.h>
 #include <Epoch/Rendering/RHI.h>
 #include <Epoch/Core/Input.h>
 #include <Epoch/Debug/Profiler.h>
+#include <CommonUtilities/Timer.h>
 
 namespace Epoch
 {
@@ -19,6 +23,8 @@ namespace Epoch
 	{
 	}
 
+	RuntimeLayer::~RuntimeLayer() = default;
+
 	void RuntimeLayer::OnAttach()
 	{
 		mySceneRenderer = std::make_shared<SceneRenderer>();
@@ -38,6 +44,9 @@ namespace Epoch
 
 	void RuntimeLayer::OnDetach()
 	{
+		mySceneLoader = nullptr;
+		myIsStartingScene = false;
+
 		OnSceneStop();
 		ScriptEngine::SetSceneContext(nullptr, nullptr);
 
@@ -67,9 +76,19 @@ namespace Epoch
 		my = (float)myViewportHeight - my;
 		myRuntimeScene->SetMousePos({ mx, my });
 
-		myRuntimeScene->OnUpdateRuntime();
+		// A scene that is still being started is shown as loaded until it's running
+		if (!myIsStartingScene)
+		{
+			myRuntimeScene->OnUpdateRuntime();
+		}
 		myRuntimeScene->OnRenderGame(mySceneRenderer);
 
+		// Picks up the mips this frame's rendering asked for
+		if (TextureStreamer* textureStreamer = AssetManager::GetTextureStreamer())
+		{
+			textureStreamer->Update();
+		}
+
 
 		//Render (copy scene texture to back buffer)
 		{
@@ -99,6 +118,11 @@ namespace Epoch
 		{
 			fn();
 		}
+
+		if (mySceneLoader)
+		{
+			UpdateSceneTransition();
+		}
 	}
 
 	void RuntimeLayer::OpenProject()
@@ -143,9 +167,72 @@ namespace Epoch
 	{
 		myPostSceneUpdateQueue.push_back([this, aScene]()
 		{
-			myRuntimeScene->OnRuntimeStop();
-			LoadScene(aScene);
-			OnScenePlay();
+			// Scripts can ask for another transition while one is in progress, the first one wins
+			if (mySceneLoader)
+			{
+				LOG_WARNING("Ignoring transition to scene {}, already transitioning to scene {}", aScene, mySceneLoader->GetSceneHandle());
+				return;
+			}
+
+			mySceneLoader = std::make_unique<SceneLoader>(Project::GetRuntimeAssetManager());
+			if (!mySceneLoader->Start(aScene))
+			{
+				mySceneLoader = nullptr;
+				return;
+			}
+
+			myTransitionFrameCount = 0;
+			myLongestTransitionFrame = 0.0f;
 		});
 	}
+
+	void RuntimeLayer::UpdateSceneTransition()
+	{
+		EPOCH_PROFILE_FUNC();
+
+		myTransitionFrameCount++;
+		myLongestTransitionFrame = std::max(myLongestTransitionFrame, CU::Timer::GetDeltaTime() * 1000.0f);
+
+		if (!myIsStartingScene)
+		{
+			if (!mySceneLoader->Update())
+			{
+				if (mySceneLoader->GetState() == SceneLoader::State::Failed)
+				{
+					mySceneLoader = nullptr;
+				}
+				return;
+			}
+
+			// The old scene has to be stopped before the new one starts, physics and scripts only run one scene at a time
+			OnSceneStop();
+
+			myRuntimeScene = mySceneLoader->GetScene();
+			myRuntimeScene->SetViewportSize(myViewportWidth, myViewportHeight);
+			myRuntimeScene->SetSceneTransitionCallback([this](AssetHandle handle) { QueueSceneTransition(handle); });
+			mySceneRenderer->SetScene(myRuntimeScene);
+			ScriptEngine::SetSceneContext(myRuntimeScene, mySceneRenderer);
+			Project::GetRuntimeAssetManager()->SetActiveScene(mySceneLoader->GetSceneHandle());
+
+			myIsStartingScene = true;
+			return;
+		}
+
+		if (!mySceneLoader->InitializeScripts())
+		{
+			return;
+		}
+
+		if (!myRuntimeScene->OnRuntimeStartSliced(mySceneLoader->GetSettings().frameBudgetMilliseconds))
+		{
+			return;
+		}
+
+		const SceneLoader::Stats& stats = mySceneLoader->GetStats();
+		LOG_INFO("Transitioned to scene {} over {} frames, longest frame {:.2f} ms (loaded {} assets and {} scripts in {:.1f} ms)",
+			mySceneLoader->GetSceneHandle(), myTransitionFrameCount, myLongestTransitionFrame, stats.assetCount, stats.scriptCount, stats.totalTime);
+
+		myIsStartingScene = false;
+		mySceneLoader = nullptr;
+	}
 }
\ No newline at end of file
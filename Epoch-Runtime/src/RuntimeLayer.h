@@ -10,12 +10,13 @@ namespace Epoch
 	class SceneRenderer;
 	class RenderPipeline;
 	class AssetPack;
+	class SceneLoader;
 
 	class RuntimeLayer : public Layer
 	{
 	public:
 		RuntimeLayer(std::string_view aProjectPath);
-		~RuntimeLayer() = default;
+		~RuntimeLayer();
 
 		void OnAttach() override;
 		void OnDetach() override;
@@ -30,6 +31,7 @@ namespace Epoch
 		void OnSceneStop();
 		
 		void QueueSceneTransition(uint64_t aScene);
+		void UpdateSceneTransition();
 
 	private:
 		std::shared_ptr<RenderPipeline> myCompositePipeline;
@@ -42,6 +44,12 @@ namespace Epoch
 
 		std::vector<std::function<void()>> myPostSceneUpdateQueue;
 
+		// The next scene is loaded while the current one keeps running, then started over a few frames without being updated
+		std::unique_ptr<SceneLoader> mySceneLoader;
+		bool myIsStartingScene = false;
+		uint32_t myTransitionFrameCount = 0;
+		float myLongestTransitionFrame = 0.0f;
+
 		uint32_t myViewportWidth = 0;
 		uint32_t myViewportHeight = 0;
 	};
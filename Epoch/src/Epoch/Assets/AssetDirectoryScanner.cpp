@@ -0,0 +1,107 @@
+#include "epch.h"
+#include "AssetDirectoryScanner.h"
+#include "Epoch/Core/Application.h"
+#include "Epoch/Assets/AssetExtensions.h"
+
+namespace Epoch
+{
+	struct DirectoryListing
+	{
+		std::vector<std::filesystem::path> subDirectories;
+		std::vector<AssetDirectoryScan::File> files;
+	};
+
+	static void ListDirectory(const std::filesystem::path& aRootPath, const std::filesystem::path& aRelativePath, DirectoryListing& outListing)
+	{
+		std::error_code error;
+		for (const auto& entry : std::filesystem::directory_iterator(aRelativePath.empty() ? aRootPath : aRootPath / aRelativePath, error))
+		{
+			const std::filesystem::path filename = entry.path().filename();
+
+			std::error_code entryError;
+			if (entry.is_directory(entryError))
+			{
+				outListing.subDirectories.push_back(aRelativePath / filename);
+				continue;
+			}
+
+			auto it = staticAssetExtensionMap.find(CU::ToLower(filename.extension().string()));
+			if (it == staticAssetExtensionMap.end())
+			{
+				continue;
+			}
+
+			AssetDirectoryScan::File& file = outListing.files.emplace_back();
+			file.filePath = aRelativePath / filename;
+			file.type = it->second;
+		}
+
+		if (error)
+		{
+			LOG_WARNING_TAG("AssetManager", "Failed to list '{}': {}", (aRootPath / aRelativePath).string(), error.message());
+		}
+	}
+
+	void AssetDirectoryScanner::Scan(const std::filesystem::path& aRootPath, AssetDirectoryScan& outScan)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		constexpr uint32_t DirectoryBatchSize = 4;
+
+		outScan.directories.clear();
+		outScan.files.clear();
+		outScan.directories.emplace_back();
+
+		if (!std::filesystem::exists(aRootPath))
+		{
+			return;
+		}
+
+		std::vector<uint32_t> level = { 0 };
+		std::vector<uint32_t> nextLevel;
+		std::vector<DirectoryListing> listings;
+
+		// The tree is crawled one level at a time. The directories of a level are listed in parallel
+		// and merged in order afterwards, so the result doesn't depend on how the jobs were scheduled.
+		while (!level.empty())
+		{
+			listings.clear();
+			listings.resize(level.size());
+
+			Application::Get().GetJobSystem().ParallelFor((uint32_t)level.size(), DirectoryBatchSize, [&](uint32_t aBegin, uint32_t aEnd)
+				{
+					for (uint32_t i = aBegin; i < aEnd; i++)
+					{
+						ListDirectory(aRootPath, outScan.directories[level[i]].filePath, listings[i]);
+					}
+				});
+
+			nextLevel.clear();
+			for (size_t i = 0; i < level.size(); i++)
+			{
+				const uint32_t directoryIndex = level[i];
+				DirectoryListing& listing = listings[i];
+
+				for (AssetDirectoryScan::File& file : listing.files)
+				{
+					outScan.directories[directoryIndex].files.push_back((uint32_t)outScan.files.size());
+					outScan.files.push_back(std::move(file));
+				}
+
+				for (std::filesystem::path& subDirectoryPath : listing.subDirectories)
+				{
+					const uint32_t subDirectoryIndex = (uint32_t)outScan.directories.size();
+
+					AssetDirectoryScan::Directory& subDirectory = outScan.directories.emplace_back();
+					subDirectory.filePath = std::move(subDirectoryPath);
+					subDirectory.parent = directoryIndex;
+
+					outScan.directories[directoryIndex].subDirectories.push_back(subDirectoryIndex);
+					nextLevel.push_back(subDirectoryIndex);
+				}
+			}
+
+			std::swap(level, nextLevel);
+		}
+	}
+}
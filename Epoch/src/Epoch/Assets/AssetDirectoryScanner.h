@@ -0,0 +1,42 @@
+#pragma once
+#include <filesystem>
+#include <vector>
+#include "Asset.h"
+
+namespace Epoch
+{
+	// Everything with a known asset extension under a directory.
+	// Paths are relative to the scanned directory, the first directory is the root itself and parents always come before their subdirectories.
+	struct AssetDirectoryScan
+	{
+		static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+		struct Directory
+		{
+			std::filesystem::path filePath;
+			uint32_t parent = InvalidIndex;
+
+			std::vector<uint32_t> subDirectories;
+			std::vector<uint32_t> files;
+		};
+
+		struct File
+		{
+			std::filesystem::path filePath;
+			AssetType type = AssetType::None;
+
+			// Filled in by the asset manager, 0 if the file couldn't be imported
+			AssetHandle handle = 0;
+		};
+
+		std::vector<Directory> directories;
+		std::vector<File> files;
+	};
+
+	class AssetDirectoryScanner
+	{
+	public:
+		// Lists every directory of a level in parallel on the job system, so it must not be called from inside a job
+		static void Scan(const std::filesystem::path& aRootPath, AssetDirectoryScan& outScan);
+	};
+}
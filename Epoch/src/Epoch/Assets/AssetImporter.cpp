@@ -3,9 +3,28 @@
 #include "Epoch/Assets/AssetExtensions.h"
 #include "Epoch/Assets/AssetManager.h"
 #include "Epoch/Project/Project.h"
+#include "Epoch/Debug/MemoryTracker.h"
 
 namespace Epoch
 {
+	static MemoryTag GetAssetMemoryTag(AssetType aType)
+	{
+		switch (aType)
+		{
+		case AssetType::Scene:		return MemoryTag::AssetScene;
+		case AssetType::Prefab:		return MemoryTag::AssetPrefab;
+		case AssetType::Texture:
+		case AssetType::EnvTexture:	return MemoryTag::AssetTexture;
+		case AssetType::Mesh:		return MemoryTag::AssetMesh;
+		case AssetType::Animation:	return MemoryTag::AssetAnimation;
+		case AssetType::Material:	return MemoryTag::AssetMaterial;
+		case AssetType::Audio:		return MemoryTag::AssetAudio;
+		case AssetType::Font:		return MemoryTag::AssetFont;
+		}
+
+		return MemoryTag::AssetOther;
+	}
+
 	void Epoch::AssetImporter::Init()
 	{
 		staticSerializers.clear();
@@ -45,6 +64,7 @@ namespace Epoch
 			return false;
 		}
 
+		MemoryTagScope memoryTag(GetAssetMemoryTag(aMetadata.type));
 		return staticSerializers[aMetadata.type]->TryLoadData(aMetadata, aAsset);
 	}
 
@@ -74,6 +94,7 @@ namespace Epoch
 			return nullptr;
 		}
 
+		MemoryTagScope memoryTag(GetAssetMemoryTag(assetType));
 		return staticSerializers[assetType]->DeserializeFromAssetPack(aStream, aAssetInfo);
 	}
 
@@ -86,6 +107,7 @@ namespace Epoch
 			return nullptr;
 		}
 
+		MemoryTagScope memoryTag(MemoryTag::AssetScene);
 		SceneAssetSerializer* sceneAssetSerializer = (SceneAssetSerializer*)staticSerializers[assetType].get();
 		return sceneAssetSerializer->DeserializeSceneFromAssetPack(aStream, aSceneInfo);
 	}
@@ -22,6 +22,8 @@ namespace Epoch
 
 		static AssetType GetAssetType(AssetHandle aAssetHandle) { return Project::GetAssetManager()->GetAssetType(aAssetHandle); }
 
+		static TextureStreamer* GetTextureStreamer() { return Project::GetAssetManager() ? Project::GetAssetManager()->GetTextureStreamer() : nullptr; }
+
 		template<typename T>
 		static std::shared_ptr<T> GetAsset(AssetHandle aAssetHandle)
 		{
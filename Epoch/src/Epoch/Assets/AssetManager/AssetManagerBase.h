@@ -5,6 +5,8 @@
 
 namespace Epoch
 {
+	class TextureStreamer;
+
 	using AssetMap = std::unordered_map<AssetHandle, std::shared_ptr<Asset>>;
 
 	class AssetManagerBase
@@ -28,5 +30,8 @@ namespace Epoch
 
 		virtual std::unordered_set<AssetHandle> GetAllAssetsWithType(AssetType aType) = 0;
 		virtual const std::unordered_map<AssetHandle, std::shared_ptr<Asset>>& GetLoadedAssets() = 0;
+
+		// Only asset managers loading cooked textures stream them
+		virtual TextureStreamer* GetTextureStreamer() { return nullptr; }
 	};
 }
@@ -7,26 +7,65 @@
 #include "Epoch/Project/Project.h"
 #include "Epoch/Assets/AssetManager.h"
 #include "Epoch/Assets/AssetExtensions.h"
+#include "Epoch/Assets/DerivedDataCache.h"
 #include "Epoch/Rendering/MeshFactory.h"
 #include "Epoch/Rendering/Material.h"
+#include "Epoch/Serialization/FileStream.h"
+#include "Epoch/Debug/Timer.h"
 
 namespace Epoch
 {
 	static AssetMetadata staticNullMetadata;
 
+	struct AssetRegistryCacheHeader
+	{
+		uint32_t magic = 0;
+		uint32_t version = 0;
+		// The registry file the cache was written next to, the cache is only used while these match
+		int64_t registryWriteTime = 0;
+		uint64_t registrySize = 0;
+		uint64_t assetCount = 0;
+	};
+
+	static constexpr uint32_t AssetRegistryCacheMagic = 0x43524145; // "EARC"
+	static constexpr uint32_t AssetRegistryCacheVersion = 1;
+
+	static std::filesystem::path GetAssetRegistryCachePath()
+	{
+		return Project::GetCacheDirectory() / "AssetRegistry.cache";
+	}
+
+	static bool GetAssetRegistryFileStamp(int64_t& outWriteTime, uint64_t& outSize)
+	{
+		std::error_code error;
+		const auto writeTime = std::filesystem::last_write_time(Project::GetAssetRegistryPath(), error);
+		if (error)
+		{
+			return false;
+		}
+
+		outSize = std::filesystem::file_size(Project::GetAssetRegistryPath(), error);
+		outWriteTime = (int64_t)writeTime.time_since_epoch().count();
+		return !error;
+	}
+
 	EditorAssetManager::EditorAssetManager()
 	{
 		EPOCH_PROFILE_FUNC();
 
 		AssetImporter::Init();
 
+		const ProjectConfig& config = Project::GetActive()->GetConfig();
+		const std::filesystem::path sharedDerivedDataDirectory = config.sharedDerivedDataDirectory.empty() ? std::filesystem::path() : Project::GetProjectDirectory() / config.sharedDerivedDataDirectory;
+		DerivedDataCache::Configure(Project::GetCacheDirectory() / "DerivedData", sharedDerivedDataDirectory, (uint64_t)config.derivedDataCacheSizeMB * 1024 * 1024);
+
 		DeserializeAssetRegistry();
 		ReloadAssets();
 	}
 
 	EditorAssetManager::~EditorAssetManager()
 	{
-		SerializeAssetRegistry();
+		FlushAssetRegistry();
 
 		//for (auto [handle, asset] : myLoadedAssets)
 		//{
@@ -138,7 +177,7 @@ namespace Epoch
 		metadata.isDataLoaded = true;
 		metadata.type = aAsset->GetAssetType();
 		metadata.isMemoryAsset = true;
-		myAssetRegistry[metadata.handle] = metadata;
+		myAssetRegistry.Set(metadata);
 
 		myMemoryAssets[aAsset->GetHandle()] = aAsset;
 	}
@@ -151,7 +190,7 @@ namespace Epoch
 		metadata.isDataLoaded = true;
 		metadata.type = aAsset->GetAssetType();
 		metadata.isMemoryAsset = true;
-		myAssetRegistry[metadata.handle] = metadata;
+		myAssetRegistry.Set(metadata);
 
 		myMemoryAssets[aAsset->GetHandle()] = aAsset;
 	}
@@ -247,37 +286,17 @@ namespace Epoch
 
 	const AssetMetadata& EditorAssetManager::GetMetadata(AssetHandle aHandle)
 	{
-		if (myAssetRegistry.Contains(aHandle))
-		{
-			return myAssetRegistry[aHandle];
-		}
-
-		return staticNullMetadata;
+		return GetMetadataInternal(aHandle);
 	}
 
 	AssetMetadata& EditorAssetManager::GetMutableMetadata(AssetHandle aHandle)
 	{
-		if (myAssetRegistry.Contains(aHandle))
-		{
-			return myAssetRegistry[aHandle];
-		}
-
-		return staticNullMetadata;
+		return GetMetadataInternal(aHandle);
 	}
 
 	const AssetMetadata& EditorAssetManager::GetMetadata(const std::filesystem::path& aFilepath)
 	{
-		const auto relativePath = GetRelativePath(aFilepath);
-
-		for (auto& [handle, metadata] : myAssetRegistry)
-		{
-			if (metadata.filePath == relativePath)
-			{
-				return metadata;
-			}
-		}
-
-		return staticNullMetadata;
+		return GetMetadataInternal(myAssetRegistry.GetHandleFromPath(GetRelativePath(aFilepath)));
 	}
 
 	const AssetMetadata& EditorAssetManager::GetMetadata(const std::shared_ptr<Asset>& aAsset)
@@ -305,7 +324,8 @@ namespace Epoch
 		metadata.filePath = path;
 		metadata.type = type;
 
-		myAssetRegistry[metadata.handle] = metadata;
+		myAssetRegistry.Set(metadata);
+		myAssetRegistryDirty = true;
 
 		LOG_INFO_TAG("AssetManager", "Asset imported '{}'", metadata.filePath.string());
 
@@ -365,14 +385,14 @@ namespace Epoch
 
 	void EditorAssetManager::OnAssetRenamed(AssetHandle aAssetHandle, const std::filesystem::path& aNewFilePath)
 	{
-		AssetMetadata& metadata = myAssetRegistry[aAssetHandle];
-		if (!metadata.IsValid())
+		AssetMetadata* metadata = myAssetRegistry.TryGet(aAssetHandle);
+		if (metadata == nullptr || !metadata->IsValid())
 		{
 			return;
 		}
 
-		metadata.filePath = GetRelativePath(aNewFilePath);
-		SerializeAssetRegistry();
+		myAssetRegistry.SetFilePath(aAssetHandle, GetRelativePath(aNewFilePath));
+		myAssetRegistryDirty = true;
 	}
 
 	void EditorAssetManager::OnAssetDeleted(AssetHandle aAssetHandle)
@@ -385,7 +405,15 @@ namespace Epoch
 
 		myAssetRegistry.Remove(aAssetHandle);
 		myLoadedAssets.erase(aAssetHandle);
-		SerializeAssetRegistry();
+		myAssetRegistryDirty = true;
+	}
+
+	void EditorAssetManager::FlushAssetRegistry()
+	{
+		if (myAssetRegistryDirty)
+		{
+			SerializeAssetRegistry();
+		}
 	}
 
 	void EditorAssetManager::SerializeAssetRegistry()
@@ -393,41 +421,44 @@ namespace Epoch
 		EPOCH_PROFILE_FUNC();
 
 		LOG_INFO_TAG("AssetManager", "Serializing asset registry");
-		uint32_t assetCount = 0;
 
-		YAML::Emitter out;
-
-		out << YAML::BeginMap;
-		out << YAML::Key << "Assets" << YAML::BeginSeq;
-		for (auto& [filepath, metadata] : myAssetRegistry)
+		// Sorted so the file doesn't change order between saves
+		std::vector<const AssetMetadata*> sortedMetadata;
+		sortedMetadata.reserve(myAssetRegistry.Count());
+		for (const auto& [handle, metadata] : myAssetRegistry)
 		{
-			if (metadata.isMemoryAsset)
+			if (!metadata.isMemoryAsset)
 			{
-				continue;
+				sortedMetadata.push_back(&metadata);
 			}
+		}
+		std::sort(sortedMetadata.begin(), sortedMetadata.end(), [](const AssetMetadata* aLhs, const AssetMetadata* aRhs) { return (uint64_t)aLhs->handle < (uint64_t)aRhs->handle; });
 
-			if (!FileSystem::Exists(GetFileSystemPath(metadata)))
-			{
-				LOG_WARNING_TAG("AssetManager", "Missing asset '{}' detected in registry", metadata.filePath.string());
-				continue;
-			}
+		YAML::Emitter out;
 
+		out << YAML::BeginMap;
+		out << YAML::Key << "Assets" << YAML::BeginSeq;
+		for (const AssetMetadata* metadata : sortedMetadata)
+		{
 			out << YAML::BeginMap;
-			out << YAML::Key << "Handle" << YAML::Value << metadata.handle;
-			out << YAML::Key << "FilePath" << YAML::Value << metadata.filePath.string();
-			out << YAML::Key << "Type" << YAML::Value << AssetTypeToString(metadata.type);
+			out << YAML::Key << "Handle" << YAML::Value << metadata->handle;
+			out << YAML::Key << "FilePath" << YAML::Value << metadata->filePath.string();
+			out << YAML::Key << "Type" << YAML::Value << AssetTypeToString(metadata->type);
 			out << YAML::EndMap;
-
-			assetCount++;
 		}
 		out << YAML::EndSeq;
 		out << YAML::EndMap;
 
-		const std::string& assetRegistryPath = Project::GetAssetRegistryPath().string();
-		std::ofstream fout(assetRegistryPath);
-		fout << out.c_str();
+		{
+			const std::string& assetRegistryPath = Project::GetAssetRegistryPath().string();
+			std::ofstream fout(assetRegistryPath);
+			fout << out.c_str();
+		}
 
-		LOG_INFO_TAG("AssetManager", "Serialized {} assets", assetCount);
+		SerializeAssetRegistryCache();
+		myAssetRegistryDirty = false;
+
+		LOG_INFO_TAG("AssetManager", "Serialized {} assets", sortedMetadata.size());
 	}
 
 	void EditorAssetManager::DeserializeAssetRegistry()
@@ -442,6 +473,12 @@ namespace Epoch
 			return;
 		}
 
+		if (DeserializeAssetRegistryCache())
+		{
+			LOG_INFO_TAG("AssetManager", "Imported {} assets from the registry cache", myAssetRegistry.Count());
+			return;
+		}
+
 		YAML::Node data;
 		try
 		{
@@ -460,6 +497,9 @@ namespace Epoch
 			return;
 		}
 
+		myAssetRegistry.Reserve(handles.size());
+
+		// Missing files are found by ReloadAssets while it scans the asset directory, instead of checking every entry here
 		for (auto entry : handles)
 		{
 			std::string filepath = entry["FilePath"].as<std::string>();
@@ -478,16 +518,10 @@ namespace Epoch
 			{
 				LOG_WARNING_TAG("AssetManager", "Mismatch between stored asset types ({}) and extension type ({}) when reading asset registry! '{}'", AssetTypeToString(metadata.type), AssetTypeToString(GetAssetTypeFromPath(filepath)), filepath);
 				metadata.type = GetAssetTypeFromPath(filepath);
+				myAssetRegistryDirty = true;
 			}
 
-			if (!FileSystem::Exists(GetFileSystemPath(metadata)))
-			{
-				LOG_WARNING_TAG("AssetManager", "Missing asset '{}' detected in registry file", metadata.filePath.string());
-				//LOG_WARNING("Missing asset '{}' detected in registry file, trying to locate...", metadata.filePath);
-				continue;
-			}
-
-			if (AssetMetadata otherMetadata = GetMetadata(filepath); otherMetadata.IsValid())
+			if (myAssetRegistry.GetHandleFromPath(metadata.filePath) != 0)
 			{
 				LOG_WARNING_TAG("AssetManager", "Asset with filename '{}' already loaded from registry file", metadata.filePath.string());
 			}
@@ -498,34 +532,209 @@ namespace Epoch
 				continue;
 			}
 
-			myAssetRegistry[metadata.handle] = metadata;
+			myAssetRegistry.Set(metadata);
 		}
 
 		LOG_INFO_TAG("AssetManager", "Imported {} assets", myAssetRegistry.Count());
+
+		// The cache was missing or out of date, the next start can use it again
+		SerializeAssetRegistryCache();
 	}
 
-	void EditorAssetManager::ProcessDirectory(const std::filesystem::path& aDirectoryPath)
+	void EditorAssetManager::SerializeAssetRegistryCache()
 	{
-		for (const auto entry : std::filesystem::directory_iterator(aDirectoryPath))
+		EPOCH_PROFILE_FUNC();
+
+		AssetRegistryCacheHeader header;
+		header.magic = AssetRegistryCacheMagic;
+		header.version = AssetRegistryCacheVersion;
+		if (!GetAssetRegistryFileStamp(header.registryWriteTime, header.registrySize))
 		{
-			if (entry.is_directory())
+			return;
+		}
+
+		const std::filesystem::path cachePath = GetAssetRegistryCachePath();
+		std::filesystem::create_directories(cachePath.parent_path());
+
+		// Written next to the cache and moved over it, so a half written cache is never picked up
+		std::filesystem::path tempPath = cachePath;
+		tempPath += ".tmp";
+
+		{
+			FileStreamWriter stream(tempPath);
+			if (!stream)
 			{
-				ProcessDirectory(entry.path());
+				LOG_WARNING_TAG("AssetManager", "Failed to write the asset registry cache '{}'", tempPath.string());
+				return;
 			}
-			else
+
+			for (const auto& [handle, metadata] : myAssetRegistry)
+			{
+				if (!metadata.isMemoryAsset)
+				{
+					header.assetCount++;
+				}
+			}
+
+			stream.WriteRaw(header);
+			for (const auto& [handle, metadata] : myAssetRegistry)
 			{
-				ImportAsset(entry.path());
+				if (metadata.isMemoryAsset)
+				{
+					continue;
+				}
+
+				stream.WriteRaw<uint64_t>(metadata.handle);
+				stream.WriteRaw<AssetType>(metadata.type);
+				stream.WriteString(metadata.filePath.string());
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(tempPath, cachePath, error);
+		if (error)
+		{
+			LOG_WARNING_TAG("AssetManager", "Failed to write the asset registry cache '{}': {}", cachePath.string(), error.message());
+		}
+	}
+
+	bool EditorAssetManager::DeserializeAssetRegistryCache()
+	{
+		EPOCH_PROFILE_FUNC();
+
+		const std::filesystem::path cachePath = GetAssetRegistryCachePath();
+
+		std::error_code error;
+		if (std::filesystem::file_size(cachePath, error) < sizeof(AssetRegistryCacheHeader) || error)
+		{
+			return false;
+		}
+
+		int64_t registryWriteTime = 0;
+		uint64_t registrySize = 0;
+		if (!GetAssetRegistryFileStamp(registryWriteTime, registrySize))
+		{
+			return false;
+		}
+
+		FileStreamReader stream(cachePath);
+
+		AssetRegistryCacheHeader header;
+		stream.ReadRaw(header);
+
+		if (header.magic != AssetRegistryCacheMagic || header.version != AssetRegistryCacheVersion ||
+			header.registryWriteTime != registryWriteTime || header.registrySize != registrySize)
+		{
+			return false;
+		}
+
+		// The cache is written from an already validated registry, so the entries are taken as they are
+		myAssetRegistry.Reserve(header.assetCount);
+		for (uint64_t i = 0; i < header.assetCount; i++)
+		{
+			AssetMetadata metadata;
+
+			uint64_t handle = 0;
+			stream.ReadRaw(handle);
+			stream.ReadRaw(metadata.type);
+
+			std::string filePath;
+			stream.ReadString(filePath);
+
+			if (!stream)
+			{
+				LOG_WARNING_TAG("AssetManager", "The asset registry cache '{}' is truncated, reading the registry instead", cachePath.string());
+				myAssetRegistry.Clear();
+				return false;
+			}
+
+			metadata.handle = handle;
+			metadata.filePath = filePath;
+			myAssetRegistry.Set(metadata);
+		}
+
+		return true;
+	}
+
+	const AssetDirectoryScan& EditorAssetManager::ScanAssetDirectory()
+	{
+		EPOCH_PROFILE_FUNC();
+
+		constexpr uint32_t FileBatchSize = 256;
+
+		Timer timer;
+
+		AssetDirectoryScan& scan = myLastAssetDirectoryScan;
+		AssetDirectoryScanner::Scan(Project::GetAssetDirectory(), scan);
+
+		// Registry lookups only read, so they run in parallel. Anything that changes the registry is done afterwards on this thread.
+		std::vector<uint8_t> typeMismatches(scan.files.size(), 0);
+		Application::Get().GetJobSystem().ParallelFor((uint32_t)scan.files.size(), FileBatchSize, [&](uint32_t aBegin, uint32_t aEnd)
+			{
+				for (uint32_t i = aBegin; i < aEnd; i++)
+				{
+					AssetDirectoryScan::File& file = scan.files[i];
+					file.handle = myAssetRegistry.GetHandleFromPath(file.filePath);
+
+					if (file.handle != 0)
+					{
+						typeMismatches[i] = myAssetRegistry.Get(file.handle).type != file.type;
+					}
+				}
+			});
+
+		for (size_t i = 0; i < scan.files.size(); i++)
+		{
+			AssetDirectoryScan::File& file = scan.files[i];
+
+			if (file.handle == 0)
+			{
+				file.handle = ImportAsset(file.filePath);
+			}
+			else if (typeMismatches[i])
+			{
+				LOG_WARNING_TAG("AssetManager", "Asset '{}' changed type, updating the registry", file.filePath.string());
+				myAssetRegistry.Get(file.handle).type = file.type;
+				myAssetRegistryDirty = true;
 			}
 		}
+
+		LOG_INFO_TAG("AssetManager", "Scanned {} files in {} directories in {:.2f} ms", scan.files.size(), scan.directories.size(), timer.ElapsedMillis());
+
+		return scan;
 	}
 
 	void EditorAssetManager::ReloadAssets()
 	{
+		const AssetDirectoryScan& scan = ScanAssetDirectory();
+
+		std::unordered_set<AssetHandle> foundAssets;
+		foundAssets.reserve(scan.files.size());
+		for (const AssetDirectoryScan::File& file : scan.files)
 		{
-			EPOCH_PROFILE_SCOPE("void Epoch::EditorAssetManager::ProcessDirectory(const std::filesystem::path &)");
-			ProcessDirectory(Project::GetAssetDirectory().string());
+			if (file.handle != 0)
+			{
+				foundAssets.insert(file.handle);
+			}
 		}
-		SerializeAssetRegistry();
+
+		std::vector<AssetHandle> missingAssets;
+		for (const auto& [handle, metadata] : myAssetRegistry)
+		{
+			if (!metadata.isMemoryAsset && !foundAssets.contains(handle))
+			{
+				LOG_WARNING_TAG("AssetManager", "Missing asset '{}' detected in registry", metadata.filePath.string());
+				missingAssets.push_back(handle);
+			}
+		}
+
+		for (AssetHandle handle : missingAssets)
+		{
+			myAssetRegistry.Remove(handle);
+			myAssetRegistryDirty = true;
+		}
+
+		FlushAssetRegistry();
 	}
 
 	std::shared_ptr<Asset> EditorAssetManager::GetAssetIncludingInvalid(AssetHandle aAssetHandle)
@@ -561,11 +770,7 @@ namespace Epoch
 
 	AssetMetadata& EditorAssetManager::GetMetadataInternal(AssetHandle aHandle)
 	{
-		if (myAssetRegistry.Contains(aHandle))
-		{
-			return myAssetRegistry[aHandle];
-		}
-
-		return staticNullMetadata;
+		AssetMetadata* metadata = myAssetRegistry.TryGet(aHandle);
+		return metadata ? *metadata : staticNullMetadata;
 	}
 }
@@ -5,6 +5,7 @@
 #include "AssetManagerBase.h"
 #include "Epoch/Assets/AssetRegistry.h"
 #include "Epoch/Assets/AssetImporter.h"
+#include "Epoch/Assets/AssetDirectoryScanner.h"
 
 namespace Epoch
 {
@@ -58,6 +59,13 @@ namespace Epoch
 		void OnAssetRenamed(AssetHandle aAssetHandle, const std::filesystem::path& aNewFilePath);
 		void OnAssetDeleted(AssetHandle aAssetHandle);
 
+		// Changes to the registry are batched, this writes them out if there are any
+		void FlushAssetRegistry();
+
+		// Crawls the asset directory and imports any files not in the registry yet
+		const AssetDirectoryScan& ScanAssetDirectory();
+		const AssetDirectoryScan& GetLastAssetDirectoryScan() const { return myLastAssetDirectoryScan; }
+
 		template<typename T, typename... Args>
 		std::shared_ptr<T> CreateNewAsset(const std::string& aFilename, const std::string& aDirectoryPath, Args&&... aArgs)
 		{
@@ -76,7 +84,7 @@ namespace Epoch
 			metadata.isDataLoaded = true;
 			metadata.type = T::GetStaticType();
 
-			myAssetRegistry[metadata.handle] = metadata;
+			myAssetRegistry.Set(metadata);
 
 			std::shared_ptr<T> asset = std::make_shared<T>(std::forward<Args>(aArgs)...);
 			asset->myHandle = metadata.handle;
@@ -84,7 +92,7 @@ namespace Epoch
 
 			AssetImporter::Serialize(metadata, asset);;
 
-			SerializeAssetRegistry();
+			myAssetRegistryDirty = true;
 
 			return asset;
 		}
@@ -92,8 +100,9 @@ namespace Epoch
 	private:
 		void SerializeAssetRegistry();
 		void DeserializeAssetRegistry();
+		void SerializeAssetRegistryCache();
+		bool DeserializeAssetRegistryCache();
 
-		void ProcessDirectory(const std::filesystem::path& aDirectoryPath);
 		void ReloadAssets();
 
 		std::shared_ptr<Asset> GetAssetIncludingInvalid(AssetHandle assetHandle);
@@ -103,6 +112,9 @@ namespace Epoch
 		AssetMap myLoadedAssets;
 		AssetMap myMemoryAssets;
 		AssetRegistry myAssetRegistry;
+		bool myAssetRegistryDirty = false;
+
+		AssetDirectoryScan myLastAssetDirectoryScan;
 
 		std::unordered_map<AssetHandle, std::future<std::shared_ptr<Asset>>> myLoadingAssets;
 	};
@@ -2,6 +2,7 @@
 #include "RuntimeAssetManager.h"
 #include "Epoch/Assets/AssetImporter.h"
 #include "Epoch/Assets/AssetManager.h"
+#include "Epoch/Assets/AssetPack/AssetPackTextureStreamingDevice.h"
 #include "Epoch/Core/Application.h"
 #include "Epoch/Rendering/MeshFactory.h"
 
@@ -34,6 +35,11 @@ namespace Epoch
 	}
 	
 	std::shared_ptr<Asset> RuntimeAssetManager::GetAsset(AssetHandle aHandle)
+	{
+		return GetAsset(myActiveScene, aHandle);
+	}
+
+	std::shared_ptr<Asset> RuntimeAssetManager::GetAsset(AssetHandle aSceneHandle, AssetHandle aHandle)
 	{
 		if (IsMemoryAsset(aHandle))
 		{
@@ -49,13 +55,14 @@ namespace Epoch
 		else
 		{
 			// Needs load
-			asset = myAssetPack->LoadAsset(myActiveScene, aHandle);
+			asset = myAssetPack->LoadAsset(aSceneHandle, aHandle);
 			if (!asset)
 			{
 				return nullptr;
 			}
 
 			myLoadedAssets[aHandle] = asset;
+			RegisterStreamedTexture(asset);
 		}
 
 		return asset;
@@ -82,6 +89,7 @@ namespace Epoch
 		if (asset)
 		{
 			myLoadedAssets[aAssetHandle] = asset;
+			RegisterStreamedTexture(asset);
 		}
 
 		return asset != nullptr;
@@ -92,7 +100,12 @@ namespace Epoch
 		if (myLoadedAssets.contains(aHandle))
 		{
 			myLoadedAssets.erase(aHandle);
-			
+
+			if (myTextureStreamer)
+			{
+				myTextureStreamer->Unregister(aHandle);
+				myTextureStreamingDevice->RemoveTexture(aHandle);
+			}
 		}
 		else if (myMemoryAssets.contains(aHandle))
 		{
@@ -132,6 +145,44 @@ namespace Epoch
 		return myLoadedAssets;
 	}
 
+	void RuntimeAssetManager::SetAssetPack(std::shared_ptr<AssetPack> aAssetPack)
+	{
+		myAssetPack = aAssetPack;
+
+		myTextureStreamer = nullptr;
+		myTextureStreamingDevice = nullptr;
+
+		const uint64_t streamingBudget = Application::Get().GetSpecification().rendererConfig.textureStreamingBudget;
+		if (myAssetPack && streamingBudget > 0)
+		{
+			auto device = std::make_unique<AssetPackTextureStreamingDevice>(myAssetPack);
+			myTextureStreamingDevice = device.get();
+
+			TextureStreamingSettings settings;
+			settings.memoryBudget = streamingBudget;
+			myTextureStreamer = std::make_unique<TextureStreamer>(std::move(device), settings);
+		}
+	}
+
+	void RuntimeAssetManager::RegisterStreamedTexture(const std::shared_ptr<Asset>& aAsset)
+	{
+		if (!myTextureStreamer || aAsset->GetAssetType() != AssetType::Texture)
+		{
+			return;
+		}
+
+		std::shared_ptr<Texture2D> texture = std::static_pointer_cast<Texture2D>(aAsset);
+		if (texture->GetResidentMip() == 0)
+		{
+			return;
+		}
+
+		if (myTextureStreamingDevice->AddTexture(texture))
+		{
+			myTextureStreamer->Register(texture->GetHandle(), texture->GetFormat(), texture->GetWidth(), texture->GetHeight(), texture->GetMipCount(), texture->GetResidentMip());
+		}
+	}
+
 	std::shared_ptr<Scene> RuntimeAssetManager::LoadScene(AssetHandle aHandle)
 	{
 		std::shared_ptr<Scene> scene = myAssetPack->LoadScene(aHandle);
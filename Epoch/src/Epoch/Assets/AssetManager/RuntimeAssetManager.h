@@ -1,9 +1,12 @@
 #pragma once
 #include "AssetManagerBase.h"
 #include "Epoch/Assets/AssetPack/AssetPack.h"
+#include "Epoch/Rendering/TextureStreamer.h"
 
 namespace Epoch
 {
+	class AssetPackTextureStreamingDevice;
+
 	class RuntimeAssetManager : public AssetManagerBase
 	{
 	public:
@@ -28,11 +31,20 @@ namespace Epoch
 		std::unordered_set<AssetHandle> GetAllAssetsWithType(AssetType aType) override;
 		const std::unordered_map<AssetHandle, std::shared_ptr<Asset>>& GetLoadedAssets() override;
 
+		TextureStreamer* GetTextureStreamer() override { return myTextureStreamer.get(); }
 
 		// Loads Scene and makes active
 		std::shared_ptr<Scene> LoadScene(AssetHandle aHandle);
+		// For scenes loaded by SceneLoader, which only makes them active once they are swapped in
+		void SetActiveScene(AssetHandle aHandle) { myActiveScene = aHandle; }
+		// Looks the asset up in the given scene's asset list instead of the active scene's, for preloading a scene that isn't active yet
+		std::shared_ptr<Asset> GetAsset(AssetHandle aSceneHandle, AssetHandle aHandle);
+
+		void SetAssetPack(std::shared_ptr<AssetPack> aAssetPack);
+		std::shared_ptr<AssetPack> GetAssetPack() const { return myAssetPack; }
 
-		void SetAssetPack(std::shared_ptr<AssetPack> aAssetPack) { myAssetPack = aAssetPack; }
+	private:
+		void RegisterStreamedTexture(const std::shared_ptr<Asset>& aAsset);
 
 	private:
 		AssetMap myLoadedAssets;
@@ -41,5 +53,8 @@ namespace Epoch
 		// TODO: Support multiple asset packs.
 		std::shared_ptr<AssetPack> myAssetPack;
 		AssetHandle myActiveScene = 0;
+
+		std::unique_ptr<TextureStreamer> myTextureStreamer;
+		AssetPackTextureStreamingDevice* myTextureStreamingDevice = nullptr;
 	};
 }
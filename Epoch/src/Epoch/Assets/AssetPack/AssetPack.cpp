@@ -5,6 +5,8 @@
 #include "Epoch/Core/Platform.h"
 #include "Epoch/Project/Project.h"
 #include "Epoch/Assets/AssetManager.h"
+#include "Epoch/Assets/TextureCooker.h"
+#include "Epoch/Rendering/Material.h"
 #include "Epoch/Scene/SceneSerializer.h"
 
 namespace Epoch
@@ -109,9 +111,43 @@ namespace Epoch
 			appBinary = FileSystem::ReadBytes(Project::GetScriptModuleFilePath());
 		}
 
+		// Textures are cooked differently depending on what the materials use them for
+		std::unordered_map<AssetHandle, TextureCookUsage> textureUsages;
+		for (AssetHandle assetHandle : fullAssetList)
+		{
+			const auto& metadata = Project::GetEditorAssetManager()->GetMetadata(assetHandle);
+			if (metadata.type != AssetType::Material)
+			{
+				continue;
+			}
+
+			std::shared_ptr<Material> material = AssetManager::GetAsset<Material>(assetHandle);
+			if (!material)
+			{
+				continue;
+			}
+
+			if (material->GetAlbedoTexture())
+			{
+				textureUsages.emplace(material->GetAlbedoTexture(), TextureCookUsage::Color);
+			}
+			if (material->GetNormalTexture())
+			{
+				textureUsages[material->GetNormalTexture()] = TextureCookUsage::NormalMap;
+			}
+			if (material->GetMaterialTexture())
+			{
+				textureUsages[material->GetMaterialTexture()] = TextureCookUsage::Linear;
+			}
+		}
+
+		TextureCooker::SetUsageHints(textureUsages);
+
 		AssetPackSerializer assetPackSerializer;
 		assetPackSerializer.Serialize(aDestination, assetPackFile, appBinary);
 
+		TextureCooker::ClearUsageHints();
+
 		return true;
 	}
 
@@ -191,9 +227,25 @@ namespace Epoch
 
 	std::shared_ptr<Asset> AssetPack::LoadAsset(AssetHandle aSceneHandle, AssetHandle aAssetHandle)
 	{
-		const AssetPackFile::AssetInfo* assetInfo = nullptr;
+		const AssetPackFile::AssetInfo* assetInfo = FindAssetInfo(aSceneHandle, aAssetHandle);
+		if (!assetInfo)
+		{
+			return nullptr;
+		}
 
-		bool foundAsset = false;
+		FileStreamReader stream(myPath);
+		std::shared_ptr<Asset> asset = AssetImporter::DeserializeFromAssetPack(stream, *assetInfo);
+		if (!asset)
+		{
+			return nullptr;
+		}
+
+		asset->myHandle = aAssetHandle;
+		return asset;
+	}
+
+	const AssetPackFile::AssetInfo* AssetPack::FindAssetInfo(AssetHandle aSceneHandle, AssetHandle aAssetHandle) const
+	{
 		if (aSceneHandle)
 		{
 			// Fast(er) path
@@ -204,40 +256,33 @@ namespace Epoch
 				auto assetIt = sceneInfo.assets.find(aAssetHandle);
 				if (assetIt != sceneInfo.assets.end())
 				{
-					foundAsset = true;
-					assetInfo = &assetIt->second;
+					return &assetIt->second;
 				}
 			}
 		}
 
-		if (!foundAsset)
+		// Slow(er) path
+		for (const auto& [handle, sceneInfo] : myFile.indexTable.scenes)
 		{
-			// Slow(er) path
-			for (const auto& [handle, sceneInfo] : myFile.indexTable.scenes)
-			{
-				auto assetIt = sceneInfo.assets.find(aAssetHandle);
-				if (assetIt != sceneInfo.assets.end())
-				{
-					assetInfo = &assetIt->second;
-					break;
-				}
-			}
-
-			if (!assetInfo)
+			auto assetIt = sceneInfo.assets.find(aAssetHandle);
+			if (assetIt != sceneInfo.assets.end())
 			{
-				return nullptr;
+				return &assetIt->second;
 			}
 		}
 
-		FileStreamReader stream(myPath);
-		std::shared_ptr<Asset> asset = AssetImporter::DeserializeFromAssetPack(stream, *assetInfo);
-		if (!asset)
+		return nullptr;
+	}
+
+	const AssetPackFile::SceneInfo* AssetPack::FindSceneInfo(AssetHandle aSceneHandle) const
+	{
+		auto it = myFile.indexTable.scenes.find(aSceneHandle);
+		if (it == myFile.indexTable.scenes.end())
 		{
 			return nullptr;
 		}
 
-		asset->myHandle = aAssetHandle;
-		return asset;
+		return &it->second;
 	}
 
 	bool AssetPack::IsAssetHandleValid(AssetHandle assetHandle) const
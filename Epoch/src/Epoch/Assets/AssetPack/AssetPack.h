@@ -25,6 +25,10 @@ namespace Epoch
 		std::shared_ptr<Asset> LoadAsset(AssetHandle aSceneHandle, AssetHandle aAssetHandle);
 
 		bool IsAssetHandleValid(AssetHandle assetHandle) const;
+		const AssetPackFile::AssetInfo* FindAssetInfo(AssetHandle aSceneHandle, AssetHandle aAssetHandle) const;
+		const AssetPackFile::SceneInfo* FindSceneInfo(AssetHandle aSceneHandle) const;
+
+		const std::filesystem::path& GetPath() const { return myPath; }
 
 		Buffer ReadAppBinary();
 
@@ -6,6 +6,9 @@ namespace Epoch
 {
 	struct AssetPackFile
 	{
+		// 2: Textures are stored cooked, with their mips and possibly block compressed
+		static constexpr uint32_t CurrentVersion = 2;
+
 		struct AssetInfo
 		{
 			uint64_t packedOffset;
@@ -30,7 +33,7 @@ namespace Epoch
 		struct FileHeader
 		{
 			const char HEADER[4] = { 'E','P','A','P' };
-			uint32_t version = 1;
+			uint32_t version = CurrentVersion;
 			uint64_t buildVersion = 0;
 		};
 
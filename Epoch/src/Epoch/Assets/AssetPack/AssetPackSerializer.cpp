@@ -63,7 +63,8 @@ namespace Epoch
 			}
 		}
 
-		CONSOLE_LOG_INFO("Serialized {} assets into asset pack", serializedAssets.size());
+		const uint64_t packSize = serializer.GetStreamPosition();
+		CONSOLE_LOG_INFO("Serialized {} assets into asset pack ({:.2f} MB)", serializedAssets.size(), (double)packSize / (1024.0 * 1024.0));
 
 		// Fill index table
 		serializer.SetStreamPosition(indexTablePos);
@@ -97,6 +98,12 @@ namespace Epoch
 			return false;
 		}
 
+		if (aFile.header.version != AssetPackFile::CurrentVersion)
+		{
+			LOG_ERROR("AssetPack {} has version {}, expected {}. Rebuild the asset pack.", aPath.string(), aFile.header.version, AssetPackFile::CurrentVersion);
+			return false;
+		}
+
 		// Read app binary info
 		stream.ReadRaw<uint64_t>(aFile.indexTable.packedAppBinaryOffset);
 		stream.ReadRaw<uint64_t>(aFile.indexTable.packedAppBinarySize);
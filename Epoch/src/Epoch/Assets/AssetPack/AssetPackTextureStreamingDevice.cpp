@@ -0,0 +1,90 @@
+#include "epch.h"
+#include "AssetPackTextureStreamingDevice.h"
+#include "Epoch/Serialization/FileStream.h"
+#include "Epoch/Assets/AssetSerializer/Runtime/TextureRuntimeSerializer.h"
+
+namespace Epoch
+{
+	bool AssetPackTextureStreamingDevice::AddTexture(std::shared_ptr<Texture2D> aTexture)
+	{
+		const AssetPackFile::AssetInfo* assetInfo = myAssetPack->FindAssetInfo(0, aTexture->GetHandle());
+		if (!assetInfo)
+		{
+			return false;
+		}
+
+		TextureSource source;
+		source.texture = aTexture;
+		source.format = aTexture->GetFormat();
+		source.width = aTexture->GetWidth();
+		source.height = aTexture->GetHeight();
+		source.mipCount = aTexture->GetMipCount();
+
+		// Texture data is written after the metadata and the size of the buffer
+		source.dataOffset = assetInfo->packedOffset + sizeof(TextureRuntimeSerializer::TextureMetadata) + sizeof(uint32_t);
+
+		std::lock_guard lock(mySourceMutex);
+		mySources[aTexture->GetHandle()] = source;
+		return true;
+	}
+
+	void AssetPackTextureStreamingDevice::RemoveTexture(AssetHandle aTexture)
+	{
+		std::lock_guard lock(mySourceMutex);
+		mySources.erase(aTexture);
+	}
+
+	Buffer AssetPackTextureStreamingDevice::ReadMips(AssetHandle aTexture, uint32_t aFirstMip)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		TextureSource source;
+		{
+			std::lock_guard lock(mySourceMutex);
+			auto it = mySources.find(aTexture);
+			if (it == mySources.end())
+			{
+				return Buffer();
+			}
+			source = it->second;
+		}
+
+		FileStreamReader stream(myAssetPack->GetPath());
+		if (!stream.IsStreamGood())
+		{
+			return Buffer();
+		}
+
+		stream.SetStreamPosition(source.dataOffset + GetMipChainMemorySize(source.format, source.width, source.height, aFirstMip));
+
+		Buffer mipData;
+		mipData.Allocate(GetMipTailMemorySize(source.format, source.width, source.height, aFirstMip, source.mipCount));
+		stream.ReadData((char*)mipData.data, mipData.size);
+		if (!stream.IsStreamGood())
+		{
+			LOG_ERROR("Failed to stream mips of texture {} from the asset pack", aTexture);
+			mipData.Release();
+		}
+
+		return mipData;
+	}
+
+	void AssetPackTextureStreamingDevice::SetResidentMips(AssetHandle aTexture, uint32_t aFirstMip, Buffer aMipData)
+	{
+		std::shared_ptr<Texture2D> texture;
+		{
+			std::lock_guard lock(mySourceMutex);
+			auto it = mySources.find(aTexture);
+			if (it == mySources.end())
+			{
+				return;
+			}
+			texture = it->second.texture.lock();
+		}
+
+		if (texture)
+		{
+			texture->SetResidentMips(aFirstMip, aMipData);
+		}
+	}
+}
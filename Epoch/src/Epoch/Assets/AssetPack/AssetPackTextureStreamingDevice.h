@@ -0,0 +1,39 @@
+#pragma once
+#include <mutex>
+#include "AssetPack.h"
+#include "Epoch/Rendering/TextureStreamer.h"
+
+namespace Epoch
+{
+	// Streams the mips of cooked textures straight out of the asset pack
+	class AssetPackTextureStreamingDevice : public TextureStreamingDevice
+	{
+	public:
+		AssetPackTextureStreamingDevice(std::shared_ptr<AssetPack> aAssetPack) : myAssetPack(aAssetPack) {}
+		~AssetPackTextureStreamingDevice() override = default;
+
+		bool AddTexture(std::shared_ptr<Texture2D> aTexture);
+		void RemoveTexture(AssetHandle aTexture);
+
+		Buffer ReadMips(AssetHandle aTexture, uint32_t aFirstMip) override;
+		void SetResidentMips(AssetHandle aTexture, uint32_t aFirstMip, Buffer aMipData) override;
+
+	private:
+		struct TextureSource
+		{
+			std::weak_ptr<Texture2D> texture;
+			TextureFormat format = TextureFormat::None;
+			uint32_t width = 0;
+			uint32_t height = 0;
+			uint32_t mipCount = 0;
+
+			// Where the first mip starts in the asset pack
+			uint64_t dataOffset = 0;
+		};
+
+		std::shared_ptr<AssetPack> myAssetPack;
+
+		std::unordered_map<AssetHandle, TextureSource> mySources;
+		std::mutex mySourceMutex;
+	};
+}
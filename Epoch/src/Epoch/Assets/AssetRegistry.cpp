@@ -3,9 +3,25 @@
 
 namespace Epoch
 {
-	AssetMetadata& AssetRegistry::operator[](const AssetHandle aHandle)
+	AssetMetadata& AssetRegistry::Set(const AssetMetadata& aMetadata)
 	{
-		return myAssetRegistry[aHandle];
+		auto [it, inserted] = myAssetRegistry.try_emplace(aMetadata.handle, aMetadata);
+		if (!inserted)
+		{
+			RemoveFromPathIndex(it->second);
+			it->second = aMetadata;
+		}
+
+		AddToPathIndex(it->second);
+		return it->second;
+	}
+
+	void AssetRegistry::SetFilePath(const AssetHandle aHandle, const std::filesystem::path& aFilePath)
+	{
+		AssetMetadata& metadata = Get(aHandle);
+		RemoveFromPathIndex(metadata);
+		metadata.filePath = aFilePath;
+		AddToPathIndex(metadata);
 	}
 
 	AssetMetadata& AssetRegistry::Get(const AssetHandle aHandle)
@@ -19,6 +35,30 @@ namespace Epoch
 		return myAssetRegistry.at(aHandle);
 	}
 
+	AssetMetadata* AssetRegistry::TryGet(const AssetHandle aHandle)
+	{
+		auto it = myAssetRegistry.find(aHandle);
+		return it != myAssetRegistry.end() ? &it->second : nullptr;
+	}
+
+	const AssetMetadata* AssetRegistry::TryGet(const AssetHandle aHandle) const
+	{
+		auto it = myAssetRegistry.find(aHandle);
+		return it != myAssetRegistry.end() ? &it->second : nullptr;
+	}
+
+	AssetHandle AssetRegistry::GetHandleFromPath(const std::filesystem::path& aFilePath) const
+	{
+		auto it = myPathIndex.find(GetPathKey(aFilePath));
+		return it != myPathIndex.end() ? it->second : AssetHandle(0);
+	}
+
+	void AssetRegistry::Reserve(size_t aCount)
+	{
+		myAssetRegistry.reserve(aCount);
+		myPathIndex.reserve(aCount);
+	}
+
 	bool AssetRegistry::Contains(const AssetHandle aHandle) const
 	{
 		return myAssetRegistry.find(aHandle) != myAssetRegistry.end();
@@ -26,11 +66,51 @@ namespace Epoch
 
 	size_t AssetRegistry::Remove(const AssetHandle aHandle)
 	{
-		return myAssetRegistry.erase(aHandle);
+		auto it = myAssetRegistry.find(aHandle);
+		if (it == myAssetRegistry.end())
+		{
+			return 0;
+		}
+
+		RemoveFromPathIndex(it->second);
+		myAssetRegistry.erase(it);
+		return 1;
 	}
 
 	void AssetRegistry::Clear()
 	{
 		myAssetRegistry.clear();
+		myPathIndex.clear();
+	}
+
+	std::string AssetRegistry::GetPathKey(const std::filesystem::path& aFilePath)
+	{
+		// Separators are unified so paths compare the same way std::filesystem::path does
+		return aFilePath.generic_string();
+	}
+
+	void AssetRegistry::AddToPathIndex(const AssetMetadata& aMetadata)
+	{
+		if (aMetadata.filePath.empty())
+		{
+			return;
+		}
+
+		// The first asset registered with a path keeps it
+		myPathIndex.try_emplace(GetPathKey(aMetadata.filePath), aMetadata.handle);
+	}
+
+	void AssetRegistry::RemoveFromPathIndex(const AssetMetadata& aMetadata)
+	{
+		if (aMetadata.filePath.empty())
+		{
+			return;
+		}
+
+		auto it = myPathIndex.find(GetPathKey(aMetadata.filePath));
+		if (it != myPathIndex.end() && (uint64_t)it->second == (uint64_t)aMetadata.handle)
+		{
+			myPathIndex.erase(it);
+		}
 	}
 }
@@ -1,20 +1,33 @@
 #pragma once
-#include <map>
+#include <string>
+#include <unordered_map>
 #include "AssetMetadata.h"
 
 namespace Epoch
 {
+	// Metadata of every known asset, indexed by handle and by file path.
+	// Entries are node based so references stay valid while other assets are added or removed.
+	// File paths have to be changed through SetFilePath so the path index stays in sync.
 	class AssetRegistry
 	{
 	public:
 		AssetRegistry() = default;
 		~AssetRegistry() = default;
 
-		AssetMetadata& operator[](const AssetHandle aHandle);
+		// Adds the asset or replaces the metadata already registered with the same handle
+		AssetMetadata& Set(const AssetMetadata& aMetadata);
+		void SetFilePath(const AssetHandle aHandle, const std::filesystem::path& aFilePath);
+
 		AssetMetadata& Get(const AssetHandle aHandle);
 		const AssetMetadata& Get(const AssetHandle aHandle) const;
+		AssetMetadata* TryGet(const AssetHandle aHandle);
+		const AssetMetadata* TryGet(const AssetHandle aHandle) const;
+
+		// Paths are compared the way they were registered, usually relative to the asset directory
+		AssetHandle GetHandleFromPath(const std::filesystem::path& aFilePath) const;
 
 		size_t Count() const { return myAssetRegistry.size(); }
+		void Reserve(size_t aCount);
 		bool Contains(const AssetHandle aHandle) const;
 		size_t Remove(const AssetHandle aHandle);
 		void Clear();
@@ -25,6 +38,12 @@ namespace Epoch
 		auto end() const { return myAssetRegistry.cend(); }
 
 	private:
-		std::map<AssetHandle, AssetMetadata> myAssetRegistry;
+		static std::string GetPathKey(const std::filesystem::path& aFilePath);
+
+		void AddToPathIndex(const AssetMetadata& aMetadata);
+		void RemoveFromPathIndex(const AssetMetadata& aMetadata);
+
+		std::unordered_map<AssetHandle, AssetMetadata> myAssetRegistry;
+		std::unordered_map<std::string, AssetHandle> myPathIndex;
 	};
 }
@@ -7,16 +7,22 @@
 #include "Epoch/Rendering/Renderer.h"
 #include "Epoch/Rendering/Environment.h"
 #include "Epoch/Rendering/Material.h"
+#include "Epoch/Rendering/RendererAPI.h"
 #include "Epoch/Script/ScriptAsset.h"
 #include "Epoch/Project/Project.h"
 #include "Epoch/Assets/AssetManager.h"
 #include "Epoch/Assets/AssimpMeshImporter.h"
+#include "Epoch/Assets/DerivedDataCache.h"
 #include "Epoch/Assets/AssetSerializer/Runtime/TextureRuntimeSerializer.h"
 #include "Epoch/Assets/AssetSerializer/Runtime/MeshRuntimeSerializer.h"
 #include "Epoch/Utils/YAMLSerializationHelpers.h"
 
 namespace Epoch
 {
+	// Bump these when an importer's output changes so stale derived data isn't used
+	static constexpr uint32_t TextureImporterVersion = 1;
+	static constexpr uint32_t MeshImporterVersion = 1;
+
 	void SceneAssetSerializer::Serialize(const AssetMetadata& aMetadata, const std::shared_ptr<Asset>& aAsset) const
 	{
 		std::shared_ptr<Scene> scene = std::static_pointer_cast<Scene>(aAsset);
@@ -181,7 +187,34 @@ namespace Epoch
 
 	bool TextureSerializer::TryLoadData(const AssetMetadata& aMetadata, std::shared_ptr<Asset>& aAsset) const
 	{
-		aAsset = Texture2D::Create(Project::GetEditorAssetManager()->GetFileSystemPath(aMetadata));
+		const std::filesystem::path filepath = Project::GetEditorAssetManager()->GetFileSystemPath(aMetadata);
+		const DerivedDataKey key = DerivedDataCache::MakeKey("texture", DerivedDataCache::HashFile(filepath), TextureImporterVersion);
+
+		std::shared_ptr<Texture2D> texture;
+		const bool cached = DerivedDataCache::Load(key, [&texture](FileStreamReader& aStream)
+			{
+				texture = TextureRuntimeSerializer::DeserializeTexture2D(aStream);
+				return texture && texture->Loaded();
+			});
+
+		if (!cached)
+		{
+			texture = Texture2D::Create(filepath);
+			if (texture->Loaded())
+			{
+				// Only the decoding is cached, mips are still generated on the GPU and nothing is compressed so the editor sees the source as is
+				TextureCookSettings cookSettings;
+				cookSettings.compression = TextureCompression::None;
+				cookSettings.generateMips = false;
+
+				DerivedDataCache::Store(key, [&texture, &cookSettings](FileStreamWriter& aStream)
+					{
+						return TextureRuntimeSerializer::SerializeTexture2DToFile(texture, aStream, cookSettings) > 0;
+					});
+			}
+		}
+
+		aAsset = texture;
 		aAsset->myHandle = aMetadata.handle;
 
 		const bool result = std::static_pointer_cast<Texture2D>(aAsset)->Loaded();
@@ -200,14 +233,16 @@ namespace Epoch
 
 		auto& metadata = Project::GetEditorAssetManager()->GetMetadata(aHandle);
 		std::shared_ptr<Texture2D> texture = AssetManager::GetAsset<Texture2D>(aHandle);
-		outInfo.size = TextureRuntimeSerializer::SerializeTexture2DToFile(texture, aStream);
+		TextureCookSettings cookSettings;
+		cookSettings.usage = TextureCooker::GetUsageHint(aHandle);
+		outInfo.size = TextureRuntimeSerializer::SerializeTexture2DToFile(texture, aStream, cookSettings);
 		return outInfo.size > 0;
 	}
 
 	std::shared_ptr<Asset> TextureSerializer::DeserializeFromAssetPack(FileStreamReader& aStream, const AssetPackFile::AssetInfo& aAssetInfo) const
 	{
 		aStream.SetStreamPosition(aAssetInfo.packedOffset);
-		return TextureRuntimeSerializer::DeserializeTexture2D(aStream);
+		return TextureRuntimeSerializer::DeserializeTexture2D(aStream, AssetManager::GetTextureStreamer() != nullptr);
 	}
 	
 
@@ -268,7 +303,9 @@ namespace Epoch
 
 		//auto& metadata = Project::GetEditorAssetManager()->GetMetadata(aHandle);
 		std::shared_ptr<Texture2D> envEquirect = Texture2D::Create(Project::GetEditorAssetManager()->GetFileSystemPath(aHandle));
-		outInfo.size = TextureRuntimeSerializer::SerializeTexture2DToFile(envEquirect, aStream);
+		TextureCookSettings cookSettings;
+		cookSettings.usage = TextureCookUsage::HDR;
+		outInfo.size = TextureRuntimeSerializer::SerializeTexture2DToFile(envEquirect, aStream, cookSettings);
 
 		//std::shared_ptr<Environment> environment = AssetManager::GetAsset<Environment>(aHandle);
 		//uint64_t size = TextureRuntimeSerializer::SerializeTextureCubeToFile(environment->GetRadianceMap(), aStream);
@@ -295,11 +332,34 @@ namespace Epoch
 	{
 		EPOCH_PROFILE_FUNC();
 
-		AssimpMeshImporter importer(Project::GetEditorAssetManager()->GetFileSystemPath(aMetadata).string());
-		aAsset = importer.ImportMesh();
+		const std::filesystem::path filepath = Project::GetEditorAssetManager()->GetFileSystemPath(aMetadata);
+		const DerivedDataKey key = DerivedDataCache::MakeKey("mesh", DerivedDataCache::HashFile(filepath), MeshImporterVersion, (uint64_t)RendererAPI::Current());
+
+		std::shared_ptr<Mesh> mesh;
+		const bool cached = DerivedDataCache::Load(key, [&mesh](FileStreamReader& aStream)
+			{
+				mesh = MeshRuntimeSerializer().DeserializeMesh(aStream);
+				return mesh && mesh->GetVertexBuffer() && mesh->GetIndexBuffer();
+			});
+
+		if (!cached)
+		{
+			AssimpMeshImporter importer(filepath.string());
+			mesh = importer.ImportMesh();
+
+			// The cached format has no skeletons or animations, those meshes are imported every time
+			if (mesh->GetVertexBuffer() && mesh->GetIndexBuffer() && !mesh->HasSkeleton() && mesh->GetAnimationCount() == 0)
+			{
+				DerivedDataCache::Store(key, [&mesh](FileStreamWriter& aStream)
+					{
+						return MeshRuntimeSerializer().SerializeMesh(mesh, aStream) > 0;
+					});
+			}
+		}
+
+		aAsset = mesh;
 		aAsset->myHandle = aMetadata.handle;
 		
-		auto mesh = std::static_pointer_cast<Mesh>(aAsset);
 		const bool result = mesh->GetVertexBuffer() && mesh->GetIndexBuffer();
 		if (!result)
 		{
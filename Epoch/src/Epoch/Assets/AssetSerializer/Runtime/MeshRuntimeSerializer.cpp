@@ -10,10 +10,20 @@ namespace Epoch
 {
     bool MeshRuntimeSerializer::SerializeToAssetPack(AssetHandle aHandle, FileStreamWriter& aStream, AssetSerializationInfo& outInfo)
     {
-        uint64_t streamOffset = aStream.GetStreamPosition();
-        outInfo.offset = streamOffset;
+        outInfo.offset = aStream.GetStreamPosition();
+        outInfo.size = SerializeMesh(AssetManager::GetAsset<Mesh>(aHandle), aStream);
+        return outInfo.size > 0;
+    }
+
+    std::shared_ptr<Asset> MeshRuntimeSerializer::DeserializeFromAssetPack(FileStreamReader& aStream, const AssetPackFile::AssetInfo& aAssetInfo)
+    {
+        aStream.SetStreamPosition(aAssetInfo.packedOffset);
+        return DeserializeMesh(aStream);
+    }
 
-        std::shared_ptr<Mesh> meshAsset = AssetManager::GetAsset<Mesh>(aHandle);
+    uint64_t MeshRuntimeSerializer::SerializeMesh(const std::shared_ptr<Mesh>& aMesh, FileStreamWriter& aStream)
+    {
+        const uint64_t streamOffset = aStream.GetStreamPosition();
 
         MeshFile file;
 
@@ -23,26 +33,26 @@ namespace Epoch
         uint64_t metadataAbsolutePosition = aStream.GetStreamPosition();
         aStream.WriteZero(sizeof(MeshFile::Metadata));
 
-        file.data.boundingBox = meshAsset->GetBoundingBox();
+        file.data.boundingBox = aMesh->GetBoundingBox();
 
         // Write nodes
         file.data.nodeArrayOffset = aStream.GetStreamPosition() - streamOffset;
-        aStream.WriteArray(meshAsset->myNodes);
+        aStream.WriteArray(aMesh->myNodes);
         file.data.nodeArraySize = (aStream.GetStreamPosition() - streamOffset) - file.data.nodeArrayOffset;
 
         // Write submeshes
         file.data.submeshArrayOffset = aStream.GetStreamPosition() - streamOffset;
-        aStream.WriteArray(meshAsset->mySubmeshes);
+        aStream.WriteArray(aMesh->mySubmeshes);
         file.data.submeshArraySize = (aStream.GetStreamPosition() - streamOffset) - file.data.submeshArrayOffset;
 
         // Write Vertex Buffer
         file.data.vertexBufferOffset = aStream.GetStreamPosition() - streamOffset;
-        aStream.WriteArray(meshAsset->myVertices);
+        aStream.WriteArray(aMesh->myVertices);
         file.data.vertexBufferSize = (aStream.GetStreamPosition() - streamOffset) - file.data.vertexBufferOffset;
 
         // Write Index Buffer
         file.data.indexBufferOffset = aStream.GetStreamPosition() - streamOffset;
-        aStream.WriteArray(meshAsset->myIndices);
+        aStream.WriteArray(aMesh->myIndices);
         file.data.indexBufferSize = (aStream.GetStreamPosition() - streamOffset) - file.data.indexBufferOffset;
 
         // Write Metadata
@@ -51,13 +61,11 @@ namespace Epoch
         aStream.WriteRaw<MeshFile::Metadata>(file.data);
         aStream.SetStreamPosition(endOfStream);
 
-        outInfo.size = aStream.GetStreamPosition() - outInfo.offset;
-        return outInfo.size > 0;
+        return aStream.GetStreamPosition() - streamOffset;
     }
 
-    std::shared_ptr<Asset> MeshRuntimeSerializer::DeserializeFromAssetPack(FileStreamReader& aStream, const AssetPackFile::AssetInfo& aAssetInfo)
+    std::shared_ptr<Mesh> MeshRuntimeSerializer::DeserializeMesh(FileStreamReader& aStream)
     {
-        aStream.SetStreamPosition(aAssetInfo.packedOffset);
         uint64_t streamOffset = aStream.GetStreamPosition();
 
         MeshFile file;
@@ -6,9 +6,15 @@
 
 namespace Epoch
 {
+	class Mesh;
+
 	class MeshRuntimeSerializer
 	{
 	public:
+		// Skeletons and animations aren't part of the format
+		uint64_t SerializeMesh(const std::shared_ptr<Mesh>& aMesh, FileStreamWriter& aStream);
+		std::shared_ptr<Mesh> DeserializeMesh(FileStreamReader& aStream);
+
 		bool SerializeToAssetPack(AssetHandle aHandle, FileStreamWriter& aStream, AssetSerializationInfo& outInfo);
 		std::shared_ptr<Asset> DeserializeFromAssetPack(FileStreamReader& aStream, const AssetPackFile::AssetInfo& aAssetInfo);
 	};
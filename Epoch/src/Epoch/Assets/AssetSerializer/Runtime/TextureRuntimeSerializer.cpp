@@ -1,15 +1,18 @@
 #include "epch.h"
 #include "TextureRuntimeSerializer.h"
+#include <magic_enum.hpp>
 #include "Epoch/Rendering/Texture.h"
+#include "Epoch/Rendering/TextureStreamer.h"
 
 namespace Epoch
 {
-    uint64_t TextureRuntimeSerializer::SerializeTexture2DToFile(std::shared_ptr<Texture2D> aTexture, FileStreamWriter& aStream)
+    uint64_t TextureRuntimeSerializer::SerializeTexture2DToFile(std::shared_ptr<Texture2D> aTexture, FileStreamWriter& aStream, const TextureCookSettings& aSettings)
     {
 		TextureMetadata metadata;
 		metadata.width = aTexture->GetWidth();
 		metadata.height = aTexture->GetHeight();
 		metadata.format = (uint16_t)aTexture->GetFormat();
+		metadata.mipCount = 1;
 
 		Buffer imageBuffer;
 
@@ -24,6 +27,27 @@ namespace Epoch
 			imageBuffer = aTexture->ReadData(aTexture->GetWidth(), aTexture->GetHeight(), 0, 0);
 		}
 
+		// Mips and compression are baked here so loading the pack is just an upload
+		const TextureFormat sourceFormat = aTexture->GetFormat();
+		if (sourceFormat == TextureFormat::RGBA || sourceFormat == TextureFormat::RGBA32F)
+		{
+			Timer timer;
+			CookedTexture cooked = TextureCooker::Cook(imageBuffer, sourceFormat, metadata.width, metadata.height, aSettings);
+
+			LOG_INFO("Cooked texture {}x{} to {} with {} mips in {:.1f} ms: {} -> {} bytes, PSNR {:.2f} dB", metadata.width, metadata.height,
+				magic_enum::enum_name(cooked.format), cooked.mipCount, timer.ElapsedMillis(), imageBuffer.size, cooked.data.size, cooked.psnr);
+
+			if (owningBuffer)
+			{
+				imageBuffer.Release();
+			}
+
+			owningBuffer = true;
+			imageBuffer = cooked.data;
+			metadata.format = (uint16_t)cooked.format;
+			metadata.mipCount = (uint16_t)cooked.mipCount;
+		}
+
 		uint64_t startPosition = aStream.GetStreamPosition();
 		aStream.WriteRaw(metadata);
 		aStream.WriteBuffer(imageBuffer);
@@ -36,19 +60,37 @@ namespace Epoch
 		return writtenSize;
     }
 
-    std::shared_ptr<Texture2D> TextureRuntimeSerializer::DeserializeTexture2D(FileStreamReader& aStream)
+    std::shared_ptr<Texture2D> TextureRuntimeSerializer::DeserializeTexture2D(FileStreamReader& aStream, bool aOnlyTailMips)
     {
 		TextureMetadata metadata;
 		aStream.ReadRaw<TextureMetadata>(metadata);
 
-		Buffer buffer;
-		aStream.ReadBuffer(buffer);
-
 		TextureSpecification spec;
 		spec.width = metadata.width;
 		spec.height = metadata.height;
 		spec.format = (TextureFormat)metadata.format;
-		spec.generateMips = true;
+		spec.mipCount = metadata.mipCount;
+		spec.generateMips = metadata.mipCount <= 1;
+
+		if (aOnlyTailMips)
+		{
+			spec.residentMip = TextureStreamer::GetTailMip(spec.format, spec.width, spec.height, spec.mipCount);
+		}
+
+		Buffer buffer;
+		if (spec.residentMip > 0)
+		{
+			uint32_t dataSize = 0;
+			aStream.ReadRaw<uint32_t>(dataSize);
+
+			const uint64_t skippedSize = GetMipChainMemorySize(spec.format, spec.width, spec.height, spec.residentMip);
+			aStream.SetStreamPosition(aStream.GetStreamPosition() + skippedSize);
+			aStream.ReadBuffer(buffer, (uint32_t)(dataSize - skippedSize));
+		}
+		else
+		{
+			aStream.ReadBuffer(buffer);
+		}
 
 		std::shared_ptr<Texture2D> texture = Texture2D::Create(spec, buffer);
 		buffer.Release();
@@ -61,6 +103,7 @@ namespace Epoch
 		metadata.width = aTexture->GetWidth();
 		metadata.height = aTexture->GetHeight();
 		metadata.format = (uint16_t)aTexture->GetFormat();
+		metadata.mipCount = 1;
 
 		Buffer imageBuffer;
 		imageBuffer = aTexture->ReadData();
@@ -1,5 +1,6 @@
 #pragma once
 #include "Epoch/Serialization/FileStream.h"
+#include "Epoch/Assets/TextureCooker.h"
 
 namespace Epoch
 {
@@ -14,11 +15,13 @@ namespace Epoch
 			uint32_t width;
 			uint32_t height;
 			uint16_t format;
+			uint16_t mipCount;
 		};
 
 	public:
-		static uint64_t SerializeTexture2DToFile(std::shared_ptr<Texture2D> aTexture, FileStreamWriter& aStream);
-		static std::shared_ptr<Texture2D> DeserializeTexture2D(FileStreamReader& aStream);
+		static uint64_t SerializeTexture2DToFile(std::shared_ptr<Texture2D> aTexture, FileStreamWriter& aStream, const TextureCookSettings& aSettings = {});
+		// With aOnlyTailMips the finest mips of cooked textures are skipped, they are streamed in later
+		static std::shared_ptr<Texture2D> DeserializeTexture2D(FileStreamReader& aStream, bool aOnlyTailMips = false);
 
 		static uint64_t SerializeTextureCubeToFile(std::shared_ptr<TextureCube> aTexture, FileStreamWriter& aStream);
 		static std::shared_ptr<TextureCube> DeserializeTextureCube(FileStreamReader& aStream);
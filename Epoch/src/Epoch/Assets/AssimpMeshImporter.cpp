@@ -9,6 +9,7 @@
 #include "Epoch/Rendering/IndexBuffer.h"
 #include "Epoch/Rendering/RendererAPI.h"
 #include "Epoch/Animation/Skeleton.h"
+#include "Epoch/Core/Application.h"
 
 namespace Epoch
 {
@@ -36,6 +37,67 @@ namespace Epoch
 		return result;
 	}
 
+	// Meshes are split into chunks of about this many vertices and faces, so a single large mesh still spreads over the job system
+	static constexpr uint32_t ImportChunkSize = 16384;
+
+	struct MeshImportChunk
+	{
+		uint32_t meshIndex = 0;
+
+		uint32_t firstVertex = 0;
+		uint32_t vertexCount = 0;
+		uint32_t firstFace = 0;
+		uint32_t faceCount = 0;
+
+		AABB boundingBox;
+	};
+
+	static void ConvertChunk(const aiMesh* aMesh, const Submesh& aSubmesh, MeshImportChunk& aChunk, std::vector<Vertex>& outVertices, std::vector<Index>& outIndices)
+	{
+		AABB& aabb = aChunk.boundingBox;
+		aabb.min = { FLT_MAX, FLT_MAX, FLT_MAX };
+		aabb.max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+		for (uint32_t i = aChunk.firstVertex; i < aChunk.firstVertex + aChunk.vertexCount; i++)
+		{
+			Vertex& vertex = outVertices[aSubmesh.baseVertex + i];
+			vertex.position = { aMesh->mVertices[i].x, aMesh->mVertices[i].y, aMesh->mVertices[i].z };
+			vertex.normal = { aMesh->mNormals[i].x, aMesh->mNormals[i].y, aMesh->mNormals[i].z };
+
+			aabb.min.x = CU::Math::Min(vertex.position.x, aabb.min.x);
+			aabb.min.y = CU::Math::Min(vertex.position.y, aabb.min.y);
+			aabb.min.z = CU::Math::Min(vertex.position.z, aabb.min.z);
+			aabb.max.x = CU::Math::Max(vertex.position.x, aabb.max.x);
+			aabb.max.y = CU::Math::Max(vertex.position.y, aabb.max.y);
+			aabb.max.z = CU::Math::Max(vertex.position.z, aabb.max.z);
+
+			if (aMesh->HasTangentsAndBitangents())
+			{
+				vertex.tangent = { aMesh->mTangents[i].x, aMesh->mTangents[i].y, aMesh->mTangents[i].z };
+			}
+
+			if (aMesh->HasTextureCoords(0))
+			{
+				vertex.uv = { aMesh->mTextureCoords[0][i].x, aMesh->mTextureCoords[0][i].y };
+			}
+
+			if (aMesh->HasVertexColors(0))
+			{
+				vertex.color = { aMesh->mColors[0][i].r, aMesh->mColors[0][i].g, aMesh->mColors[0][i].b };
+			}
+		}
+
+		for (uint32_t i = aChunk.firstFace; i < aChunk.firstFace + aChunk.faceCount; i++)
+		{
+			EPOCH_ASSERT(aMesh->mFaces[i].mNumIndices == 3, "A face must have 3 indices!");
+
+			Index* indices = &outIndices[aSubmesh.baseIndex + i * 3];
+			indices[0] = aMesh->mFaces[i].mIndices[0];
+			indices[1] = aMesh->mFaces[i].mIndices[1];
+			indices[2] = aMesh->mFaces[i].mIndices[2];
+		}
+	}
+
 	class BoneHierarchy
 	{
 	public:
@@ -146,6 +208,8 @@ namespace Epoch
 		meshAsset->mySkeleton = boneHierarchy.CreateSkeleton();
 		meshAsset->myAnimationCount = scene->mNumAnimations;
 		
+		JobSystem& jobSystem = Application::Get().GetJobSystem();
+
 		if (scene->HasMeshes())
 		{
 			uint32_t vertexCount = 0;
@@ -153,7 +217,9 @@ namespace Epoch
 
 			meshAsset->myBoundingBox.min = { FLT_MAX, FLT_MAX, FLT_MAX };
 			meshAsset->myBoundingBox.max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
-			
+
+			// Every submesh gets its range of the vertex and index arrays up front, so the chunks can fill them in any order
+			std::vector<MeshImportChunk> chunks;
 			meshAsset->mySubmeshes.reserve(scene->mNumMeshes);
 			for (unsigned m = 0; m < scene->mNumMeshes; m++)
 			{
@@ -169,59 +235,69 @@ namespace Epoch
 				submesh.vertexCount = mesh->mNumVertices;
 				submesh.indexCount = mesh->mNumFaces * 3;
 				submesh.meshName = mesh->mName.C_Str();
+				submesh.boundingBox.min = { FLT_MAX, FLT_MAX, FLT_MAX };
+				submesh.boundingBox.max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
 
 				vertexCount += submesh.vertexCount;
 				indexCount += submesh.indexCount;
 
-				auto& aabb = submesh.boundingBox;
-				aabb.min = { FLT_MAX, FLT_MAX, FLT_MAX };
-				aabb.max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
-				for (uint32_t i = 0; i < mesh->mNumVertices; i++)
+				meshAsset->myTriangleCache[m].resize(mesh->mNumFaces);
+
+				const uint32_t chunkCount = CU::Math::Max((CU::Math::Max(mesh->mNumVertices, mesh->mNumFaces) + ImportChunkSize - 1) / ImportChunkSize, 1u);
+				for (uint32_t c = 0; c < chunkCount; c++)
 				{
-					Vertex vertex;
-					vertex.position = { mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z };
-					vertex.normal = { mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z };
-
-					aabb.min.x = CU::Math::Min(vertex.position.x, aabb.min.x);
-					aabb.min.y = CU::Math::Min(vertex.position.y, aabb.min.y);
-					aabb.min.z = CU::Math::Min(vertex.position.z, aabb.min.z);
-					aabb.max.x = CU::Math::Max(vertex.position.x, aabb.max.x);
-					aabb.max.y = CU::Math::Max(vertex.position.y, aabb.max.y);
-					aabb.max.z = CU::Math::Max(vertex.position.z, aabb.max.z);
-
-					if (mesh->HasTangentsAndBitangents())
-					{
-						vertex.tangent = { mesh->mTangents[i].x, mesh->mTangents[i].y, mesh->mTangents[i].z };
-					}
+					MeshImportChunk& chunk = chunks.emplace_back();
+					chunk.meshIndex = m;
+					chunk.firstVertex = (uint32_t)((uint64_t)mesh->mNumVertices * c / chunkCount);
+					chunk.vertexCount = (uint32_t)((uint64_t)mesh->mNumVertices * (c + 1) / chunkCount) - chunk.firstVertex;
+					chunk.firstFace = (uint32_t)((uint64_t)mesh->mNumFaces * c / chunkCount);
+					chunk.faceCount = (uint32_t)((uint64_t)mesh->mNumFaces * (c + 1) / chunkCount) - chunk.firstFace;
+				}
+			}
+
+			meshAsset->myVertices.resize(vertexCount);
+			meshAsset->myIndices.resize(indexCount);
 
-					if (mesh->HasTextureCoords(0))
+			{
+				EPOCH_PROFILE_SCOPE("AssimpMeshImporter::ConvertMeshes");
+
+				jobSystem.ParallelFor((uint32_t)chunks.size(), 1, [&](uint32_t aBegin, uint32_t aEnd)
 					{
-						vertex.uv = { mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y };
-					}
+						for (uint32_t i = aBegin; i < aEnd; i++)
+						{
+							MeshImportChunk& chunk = chunks[i];
+							ConvertChunk(scene->mMeshes[chunk.meshIndex], meshAsset->mySubmeshes[chunk.meshIndex], chunk, meshAsset->myVertices, meshAsset->myIndices);
+						}
+					});
 
-					if (mesh->HasVertexColors(0))
+				// Faces can use vertices from any chunk of their mesh, so the triangles wait until every vertex is converted
+				jobSystem.ParallelFor((uint32_t)chunks.size(), 1, [&](uint32_t aBegin, uint32_t aEnd)
 					{
-						vertex.color = { mesh->mColors[0][i].r, mesh->mColors[0][i].g, mesh->mColors[0][i].b };
-					}
+						for (uint32_t i = aBegin; i < aEnd; i++)
+						{
+							const MeshImportChunk& chunk = chunks[i];
+							const Submesh& submesh = meshAsset->mySubmeshes[chunk.meshIndex];
+							const Vertex* vertices = &meshAsset->myVertices[submesh.baseVertex];
+							const Index* indices = &meshAsset->myIndices[submesh.baseIndex];
 
-					meshAsset->myVertices.push_back(vertex);
-				}
+							std::vector<Triangle>& triangles = meshAsset->myTriangleCache.at(chunk.meshIndex);
+							for (uint32_t f = chunk.firstFace; f < chunk.firstFace + chunk.faceCount; f++)
+							{
+								triangles[f] = Triangle(vertices[indices[f * 3 + 0]], vertices[indices[f * 3 + 1]], vertices[indices[f * 3 + 2]]);
+							}
+						}
+					});
+			}
 
-				for (uint32_t i = 0; i < mesh->mNumFaces; i++)
-				{
-					EPOCH_ASSERT(mesh->mFaces[i].mNumIndices == 3, "A face must have 3 indices!");
-
-					meshAsset->myIndices.push_back(mesh->mFaces[i].mIndices[0]);
-					meshAsset->myIndices.push_back(mesh->mFaces[i].mIndices[1]);
-					meshAsset->myIndices.push_back(mesh->mFaces[i].mIndices[2]);
-
-					meshAsset->myTriangleCache[m].emplace_back
-					(
-						meshAsset->myVertices[mesh->mFaces[i].mIndices[0]],
-						meshAsset->myVertices[mesh->mFaces[i].mIndices[1]],
-						meshAsset->myVertices[mesh->mFaces[i].mIndices[2]]
-					);
-				}
+			for (const MeshImportChunk& chunk : chunks)
+			{
+				AABB& aabb = meshAsset->mySubmeshes[chunk.meshIndex].boundingBox;
+				aabb.min.x = CU::Math::Min(chunk.boundingBox.min.x, aabb.min.x);
+				aabb.min.y = CU::Math::Min(chunk.boundingBox.min.y, aabb.min.y);
+				aabb.min.z = CU::Math::Min(chunk.boundingBox.min.z, aabb.min.z);
+				aabb.max.x = CU::Math::Max(chunk.boundingBox.max.x, aabb.max.x);
+				aabb.max.y = CU::Math::Max(chunk.boundingBox.max.y, aabb.max.y);
+				aabb.max.z = CU::Math::Max(chunk.boundingBox.max.z, aabb.max.z);
 			}
 
 			MeshNode& rootNode = meshAsset->myNodes.emplace_back();
@@ -244,57 +320,90 @@ namespace Epoch
 
 		if (meshAsset->HasSkeleton())
 		{
+			EPOCH_PROFILE_SCOPE("AssimpMeshImporter::BoneInfluences");
+
 			meshAsset->myBoneInfluences.resize(meshAsset->myVertices.size());
+
+			// Skeleton lookups are resolved up front, then every mesh scatters its weights into its own vertex range.
+			// Assimp vertex ids are local to their mesh, so they're offset by the submesh's base vertex.
+			std::vector<uint32_t> meshBoneOffsets(scene->mNumMeshes + 1, 0);
+			for (uint32_t m = 0; m < scene->mNumMeshes; m++)
+			{
+				meshBoneOffsets[m + 1] = meshBoneOffsets[m] + scene->mMeshes[m]->mNumBones;
+			}
+
+			std::vector<uint32_t> skeletonBoneIndices(meshBoneOffsets.back());
+			std::vector<uint8_t> bonesWithWeights(meshBoneOffsets.back(), 0);
 			for (uint32_t m = 0; m < scene->mNumMeshes; m++)
 			{
 				aiMesh* mesh = scene->mMeshes[m];
-				Submesh& submesh = meshAsset->mySubmeshes[m];
+				for (uint32_t i = 0; i < mesh->mNumBones; i++)
+				{
+					const uint32_t boneIndex = meshAsset->mySkeleton->GetBoneIndex(mesh->mBones[i]->mName.C_Str());
+					EPOCH_ASSERT(boneIndex != Skeleton::NullIndex, "Could not find mesh bone '{}' in skeleton!", mesh->mBones[i]->mName.C_Str());
+					skeletonBoneIndices[meshBoneOffsets[m] + i] = boneIndex;
+				}
+			}
 
-				if (mesh->mNumBones > 0)
+			jobSystem.ParallelFor(scene->mNumMeshes, 1, [&](uint32_t aBegin, uint32_t aEnd)
 				{
-					for (uint32_t i = 0; i < mesh->mNumBones; i++)
+					for (uint32_t m = aBegin; m < aEnd; m++)
 					{
-						aiBone* bone = mesh->mBones[i];
+						aiMesh* mesh = scene->mMeshes[m];
+						const uint32_t baseVertex = meshAsset->mySubmeshes[m].baseVertex;
 
-						bool hasNonZeroWeight = false;
-						for (size_t j = 0; j < bone->mNumWeights; j++)
+						for (uint32_t i = 0; i < mesh->mNumBones; i++)
 						{
-							if (bone->mWeights[j].mWeight > 0.000001f)
+							aiBone* bone = mesh->mBones[i];
+							const uint32_t boneIndex = skeletonBoneIndices[meshBoneOffsets[m] + i];
+							if (boneIndex == Skeleton::NullIndex)
 							{
-								hasNonZeroWeight = true;
+								continue;
 							}
-						}
-						if (!hasNonZeroWeight)
-						{
-							continue;
-						}
 
-						// Find bone in skeleton
-						uint32_t boneIndex = meshAsset->mySkeleton->GetBoneIndex(bone->mName.C_Str());
-						if (boneIndex == Skeleton::NullIndex)
-						{
-							EPOCH_ASSERT("Could not find mesh bone '{}' in skeleton!", bone->mName.C_Str());
-						}
+							bool hasNonZeroWeight = false;
+							for (size_t j = 0; j < bone->mNumWeights && !hasNonZeroWeight; j++)
+							{
+								hasNonZeroWeight = bone->mWeights[j].mWeight > 0.000001f;
+							}
 
-						auto& b = meshAsset->GetSkeleton()->GetBone(boneIndex);
-						b.invBindPose = Mat4FromAIMat4(bone->mOffsetMatrix);
+							if (!hasNonZeroWeight)
+							{
+								continue;
+							}
 
-						for (size_t j = 0; j < bone->mNumWeights; j++)
-						{
-							int VertexID = bone->mWeights[j].mVertexId;
-							float Weight = bone->mWeights[j].mWeight;
-							meshAsset->myBoneInfluences[VertexID].AddBoneData(boneIndex, Weight);
+							bonesWithWeights[meshBoneOffsets[m] + i] = 1;
+
+							for (size_t j = 0; j < bone->mNumWeights; j++)
+							{
+								meshAsset->myBoneInfluences[baseVertex + bone->mWeights[j].mVertexId].AddBoneData(boneIndex, bone->mWeights[j].mWeight);
+							}
 						}
 					}
-				}
-			}
+				});
 
-			for (auto& boneInfluence : meshAsset->myBoneInfluences)
+			// Bones can be shared between meshes, so the bind poses are written in mesh order
+			for (uint32_t m = 0; m < scene->mNumMeshes; m++)
 			{
-				boneInfluence.NormalizeWeights();
+				aiMesh* mesh = scene->mMeshes[m];
+				for (uint32_t i = 0; i < mesh->mNumBones; i++)
+				{
+					if (bonesWithWeights[meshBoneOffsets[m] + i])
+					{
+						meshAsset->mySkeleton->GetBone(skeletonBoneIndices[meshBoneOffsets[m] + i]).invBindPose = Mat4FromAIMat4(mesh->mBones[i]->mOffsetMatrix);
+					}
+				}
 			}
+
+			jobSystem.ParallelFor((uint32_t)meshAsset->myBoneInfluences.size(), ImportChunkSize, [&](uint32_t aBegin, uint32_t aEnd)
+				{
+					for (uint32_t i = aBegin; i < aEnd; i++)
+					{
+						meshAsset->myBoneInfluences[i].NormalizeWeights();
+					}
+				});
 		}
-		
+
 		meshAsset->myMaterialCount = scene->mNumMaterials;
 		//if (scene->HasMaterials())
 		//{
@@ -0,0 +1,365 @@
+#include "epch.h"
+#include "DerivedDataCache.h"
+#include <mutex>
+#include <thread>
+#include "Epoch/Core/Application.h"
+
+namespace Epoch
+{
+	struct DerivedDataHeader
+	{
+		uint32_t magic = 0;
+		uint32_t version = 0;
+		uint64_t key = 0;
+	};
+
+	static constexpr uint32_t DerivedDataMagic = 0x43444445; // "EDDC"
+	static constexpr uint32_t DerivedDataVersion = 1;
+
+	struct DerivedDataCacheState
+	{
+		std::mutex mutex;
+		bool configured = false;
+
+		std::filesystem::path localDirectory;
+		std::filesystem::path sharedDirectory;
+		uint64_t maxLocalSize = DerivedDataCache::DefaultMaxLocalSize;
+		uint64_t localSize = 0;
+	};
+
+	static DerivedDataCacheState staticState;
+
+	static std::filesystem::path GetEntryPath(const std::filesystem::path& aDirectory, const DerivedDataKey& aKey)
+	{
+		return aDirectory / fmt::format("{:016x}.{}", aKey.hash, aKey.type);
+	}
+
+	static std::filesystem::path GetTempPath(const std::filesystem::path& aDirectory, const DerivedDataKey& aKey)
+	{
+		// Other threads or editors sharing the directory may be writing the same entry
+		return aDirectory / fmt::format("{:016x}.{}.{:x}.tmp", aKey.hash, aKey.type, std::hash<std::thread::id>()(std::this_thread::get_id()));
+	}
+
+	// Expects the state to be locked
+	static void TrimLocalDirectory()
+	{
+		EPOCH_PROFILE_FUNC();
+
+		struct DerivedDataEntry
+		{
+			std::filesystem::path filePath;
+			std::filesystem::file_time_type lastUsed;
+			uint64_t size = 0;
+		};
+
+		std::vector<DerivedDataEntry> entries;
+		uint64_t totalSize = 0;
+
+		std::error_code error;
+		for (const auto& directoryEntry : std::filesystem::directory_iterator(staticState.localDirectory, error))
+		{
+			// Entries still being written are left alone
+			if (!directoryEntry.is_regular_file(error) || directoryEntry.path().extension() == ".tmp")
+			{
+				continue;
+			}
+
+			const uint64_t size = directoryEntry.file_size(error);
+			if (error)
+			{
+				continue;
+			}
+
+			DerivedDataEntry& entry = entries.emplace_back();
+			entry.filePath = directoryEntry.path();
+			entry.lastUsed = directoryEntry.last_write_time(error);
+			entry.size = size;
+			totalSize += size;
+		}
+
+		if (totalSize > staticState.maxLocalSize)
+		{
+			// Trimming a bit below the budget so the next few entries don't trigger another pass
+			const uint64_t targetSize = staticState.maxLocalSize / 10 * 9;
+			const uint64_t sizeBefore = totalSize;
+
+			std::sort(entries.begin(), entries.end(), [](const DerivedDataEntry& aLhs, const DerivedDataEntry& aRhs) { return aLhs.lastUsed < aRhs.lastUsed; });
+
+			size_t evictedCount = 0;
+			for (const DerivedDataEntry& entry : entries)
+			{
+				if (totalSize <= targetSize)
+				{
+					break;
+				}
+
+				if (std::filesystem::remove(entry.filePath, error))
+				{
+					totalSize -= entry.size;
+					evictedCount++;
+				}
+			}
+
+			LOG_INFO_TAG("AssetManager", "Evicted {} derived data entries, {} -> {} bytes", evictedCount, sizeBefore, totalSize);
+		}
+
+		staticState.localSize = totalSize;
+	}
+
+	// Expects the state to be locked
+	static void EnsureConfigured()
+	{
+		if (staticState.configured)
+		{
+			return;
+		}
+
+		staticState.localDirectory = Application::Get().GetSpecification().cacheDirectory + "/DerivedData";
+		staticState.configured = true;
+		TrimLocalDirectory();
+	}
+
+	static void GetDirectories(std::filesystem::path& outLocalDirectory, std::filesystem::path& outSharedDirectory)
+	{
+		std::scoped_lock lock(staticState.mutex);
+		EnsureConfigured();
+
+		outLocalDirectory = staticState.localDirectory;
+		outSharedDirectory = staticState.sharedDirectory;
+	}
+
+	static void AddToLocalSize(uint64_t aSize)
+	{
+		std::scoped_lock lock(staticState.mutex);
+
+		staticState.localSize += aSize;
+		if (staticState.localSize > staticState.maxLocalSize)
+		{
+			TrimLocalDirectory();
+		}
+	}
+
+	static bool CopyEntry(const std::filesystem::path& aSourcePath, const std::filesystem::path& aDirectory, const DerivedDataKey& aKey)
+	{
+		std::error_code error;
+		std::filesystem::create_directories(aDirectory, error);
+
+		const std::filesystem::path tempPath = GetTempPath(aDirectory, aKey);
+		if (!std::filesystem::copy_file(aSourcePath, tempPath, std::filesystem::copy_options::overwrite_existing, error))
+		{
+			LOG_WARNING_TAG("AssetManager", "Failed to copy derived data '{}' to '{}': {}", aSourcePath.string(), aDirectory.string(), error.message());
+			return false;
+		}
+
+		std::filesystem::rename(tempPath, GetEntryPath(aDirectory, aKey), error);
+		if (error)
+		{
+			std::filesystem::remove(tempPath, error);
+			return false;
+		}
+
+		return true;
+	}
+
+	void DerivedDataCache::Configure(const std::filesystem::path& aLocalDirectory, const std::filesystem::path& aSharedDirectory, uint64_t aMaxLocalSize)
+	{
+		std::scoped_lock lock(staticState.mutex);
+
+		staticState.localDirectory = aLocalDirectory;
+		staticState.sharedDirectory = aSharedDirectory;
+		staticState.maxLocalSize = aMaxLocalSize;
+		staticState.configured = true;
+
+		TrimLocalDirectory();
+
+		if (!aSharedDirectory.empty())
+		{
+			LOG_INFO_TAG("AssetManager", "Using shared derived data from '{}'", aSharedDirectory.string());
+		}
+	}
+
+	DerivedDataKey DerivedDataCache::MakeKey(const char* aType, uint64_t aSourceHash, uint32_t aVersion, uint64_t aSettingsHash)
+	{
+		DerivedDataKey key;
+		key.type = aType;
+
+		if (aSourceHash == 0)
+		{
+			return key;
+		}
+
+		uint64_t hash = HashData(aType, strlen(aType));
+		hash = HashData(&aSourceHash, sizeof(aSourceHash), hash);
+		hash = HashData(&aVersion, sizeof(aVersion), hash);
+		hash = HashData(&aSettingsHash, sizeof(aSettingsHash), hash);
+
+		key.hash = hash != 0 ? hash : 1;
+		return key;
+	}
+
+	uint64_t DerivedDataCache::HashFile(const std::filesystem::path& aFilepath)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		std::ifstream stream(aFilepath, std::ios::binary);
+		if (!stream)
+		{
+			return 0;
+		}
+
+		std::vector<char> chunk(64 * 1024);
+		uint64_t hash = 0;
+		while (stream)
+		{
+			stream.read(chunk.data(), chunk.size());
+			hash = HashData(chunk.data(), (size_t)stream.gcount(), hash);
+		}
+
+		return hash != 0 ? hash : 1;
+	}
+
+	uint64_t DerivedDataCache::HashData(const void* aData, size_t aSize, uint64_t aSeed)
+	{
+		// FNV-1a, same as Hash::GenerateFNVHash but able to continue from a previous hash
+		constexpr uint64_t FNV_offset_basis = 14695981039346656037ULL;
+		constexpr uint64_t FNV_prime = 1099511628211ULL;
+
+		uint64_t hash = aSeed != 0 ? aSeed : FNV_offset_basis;
+
+		const uint8_t* bytes = (const uint8_t*)aData;
+		for (size_t i = 0; i < aSize; i++)
+		{
+			hash ^= (uint64_t)bytes[i];
+			hash *= FNV_prime;
+		}
+
+		return hash;
+	}
+
+	bool DerivedDataCache::Load(const DerivedDataKey& aKey, const std::function<bool(FileStreamReader&)>& aReadFunction)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		if (!aKey.IsValid())
+		{
+			return false;
+		}
+
+		std::filesystem::path localDirectory, sharedDirectory;
+		GetDirectories(localDirectory, sharedDirectory);
+
+		std::error_code error;
+		const std::filesystem::path entryPath = GetEntryPath(localDirectory, aKey);
+		if (std::filesystem::exists(entryPath, error))
+		{
+			// Entries are evicted least recently used first
+			std::filesystem::last_write_time(entryPath, std::filesystem::file_time_type::clock::now(), error);
+		}
+		else
+		{
+			if (sharedDirectory.empty())
+			{
+				return false;
+			}
+
+			const std::filesystem::path sharedEntryPath = GetEntryPath(sharedDirectory, aKey);
+			if (!std::filesystem::exists(sharedEntryPath, error) || !CopyEntry(sharedEntryPath, localDirectory, aKey))
+			{
+				return false;
+			}
+
+			if (const uint64_t size = std::filesystem::file_size(entryPath, error); !error)
+			{
+				AddToLocalSize(size);
+			}
+		}
+
+		bool valid = false;
+		{
+			FileStreamReader stream(entryPath);
+
+			DerivedDataHeader header;
+			stream.ReadRaw<DerivedDataHeader>(header);
+
+			valid = stream.IsStreamGood() && header.magic == DerivedDataMagic && header.version == DerivedDataVersion && header.key == aKey.hash;
+			valid = valid && aReadFunction(stream);
+		}
+
+		if (!valid)
+		{
+			LOG_WARNING_TAG("AssetManager", "Derived data '{}' is corrupt, removing it", entryPath.string());
+			std::filesystem::remove(entryPath, error);
+		}
+
+		return valid;
+	}
+
+	bool DerivedDataCache::Store(const DerivedDataKey& aKey, const std::function<bool(FileStreamWriter&)>& aWriteFunction)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		if (!aKey.IsValid())
+		{
+			return false;
+		}
+
+		std::filesystem::path localDirectory, sharedDirectory;
+		GetDirectories(localDirectory, sharedDirectory);
+
+		std::error_code error;
+		std::filesystem::create_directories(localDirectory, error);
+
+		const std::filesystem::path entryPath = GetEntryPath(localDirectory, aKey);
+		const std::filesystem::path tempPath = GetTempPath(localDirectory, aKey);
+
+		bool written = false;
+		{
+			FileStreamWriter stream(tempPath);
+			if (!stream.IsStreamGood())
+			{
+				LOG_WARNING_TAG("AssetManager", "Failed to write derived data to '{}'", tempPath.string());
+				return false;
+			}
+
+			DerivedDataHeader header;
+			header.magic = DerivedDataMagic;
+			header.version = DerivedDataVersion;
+			header.key = aKey.hash;
+			stream.WriteRaw<DerivedDataHeader>(header);
+
+			written = aWriteFunction(stream) && stream.IsStreamGood();
+		}
+
+		// Written to a temporary file first so a crash never leaves a truncated entry behind
+		if (written)
+		{
+			std::filesystem::rename(tempPath, entryPath, error);
+			written = !error;
+		}
+
+		if (!written)
+		{
+			std::filesystem::remove(tempPath, error);
+			return false;
+		}
+
+		if (!sharedDirectory.empty() && !std::filesystem::exists(GetEntryPath(sharedDirectory, aKey), error))
+		{
+			CopyEntry(entryPath, sharedDirectory, aKey);
+		}
+
+		if (const uint64_t size = std::filesystem::file_size(entryPath, error); !error)
+		{
+			AddToLocalSize(size);
+		}
+
+		return true;
+	}
+
+	void DerivedDataCache::Trim()
+	{
+		std::scoped_lock lock(staticState.mutex);
+		EnsureConfigured();
+		TrimLocalDirectory();
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <functional>
+#include <filesystem>
+#include "Epoch/Serialization/FileStream.h"
+
+namespace Epoch
+{
+	// Identifies derived data by everything it was built from, so entries never have to be invalidated.
+	// The type ends up as the file extension of the entry.
+	struct DerivedDataKey
+	{
+		const char* type = "";
+		uint64_t hash = 0;
+
+		bool IsValid() const { return hash != 0; }
+	};
+
+	// Disk cache for data that is expensive to build from source assets, like imported meshes, decoded textures and font atlases.
+	// Entries missing locally are looked for in the shared directory, which a team can point at the same network drive.
+	// The local cache is kept within its size budget by evicting the least recently used entries, the shared directory is never trimmed.
+	// Safe to use from the asset loading threads.
+	class DerivedDataCache
+	{
+	public:
+		static constexpr uint64_t DefaultMaxLocalSize = 4ull * 1024 * 1024 * 1024;
+
+		// Until this is called entries are kept in the application cache directory
+		static void Configure(const std::filesystem::path& aLocalDirectory, const std::filesystem::path& aSharedDirectory = {}, uint64_t aMaxLocalSize = DefaultMaxLocalSize);
+
+		// aVersion should be bumped whenever the code producing the data changes, aSettingsHash covers the settings it was built with
+		static DerivedDataKey MakeKey(const char* aType, uint64_t aSourceHash, uint32_t aVersion, uint64_t aSettingsHash = 0);
+
+		// 0 if the file couldn't be read
+		static uint64_t HashFile(const std::filesystem::path& aFilepath);
+		// Pass the previous result as aSeed to hash data in pieces
+		static uint64_t HashData(const void* aData, size_t aSize, uint64_t aSeed = 0);
+
+		// aReadFunction returning false marks the entry as corrupt and removes it
+		static bool Load(const DerivedDataKey& aKey, const std::function<bool(FileStreamReader&)>& aReadFunction);
+		static bool Store(const DerivedDataKey& aKey, const std::function<bool(FileStreamWriter&)>& aWriteFunction);
+
+		static void Trim();
+	};
+}
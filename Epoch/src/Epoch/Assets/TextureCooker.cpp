@@ -0,0 +1,712 @@
+#include "epch.h"
+#include "TextureCooker.h"
+#include "Epoch/Core/Application.h"
+
+namespace Epoch
+{
+	static constexpr uint32_t RowBatchSize = 16;
+	static constexpr uint32_t BlockRowBatchSize = 4;
+
+	using BlockPixels = std::array<std::array<uint8_t, 4>, 16>;
+
+	static const std::array<float, 256>& GetSRGBToLinearTable()
+	{
+		static const std::array<float, 256> table = []()
+			{
+				std::array<float, 256> result;
+				for (uint32_t i = 0; i < 256; i++)
+				{
+					const float value = (float)i / 255.0f;
+					result[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+				}
+				return result;
+			}();
+
+		return table;
+	}
+
+	static uint8_t LinearToSRGB(float aValue)
+	{
+		aValue = CU::Math::Clamp(aValue, 0.0f, 1.0f);
+		const float value = aValue <= 0.0031308f ? aValue * 12.92f : 1.055f * std::pow(aValue, 1.0f / 2.4f) - 0.055f;
+		return (uint8_t)(value * 255.0f + 0.5f);
+	}
+
+	static void DownsampleRGBA8(const uint8_t* aSource, uint32_t aSourceWidth, uint32_t aSourceHeight, uint8_t* aDestination, uint32_t aWidth, uint32_t aHeight, TextureCookUsage aUsage)
+	{
+		const auto& toLinear = GetSRGBToLinearTable();
+
+		Application::Get().GetJobSystem().ParallelFor(aHeight, RowBatchSize, [&](uint32_t aBegin, uint32_t aEnd)
+			{
+				for (uint32_t y = aBegin; y < aEnd; y++)
+				{
+					const uint32_t y0 = CU::Math::Min(y * 2, aSourceHeight - 1);
+					const uint32_t y1 = CU::Math::Min(y * 2 + 1, aSourceHeight - 1);
+
+					for (uint32_t x = 0; x < aWidth; x++)
+					{
+						const uint32_t x0 = CU::Math::Min(x * 2, aSourceWidth - 1);
+						const uint32_t x1 = CU::Math::Min(x * 2 + 1, aSourceWidth - 1);
+
+						const uint8_t* samples[4] =
+						{
+							aSource + (y0 * aSourceWidth + x0) * 4,
+							aSource + (y0 * aSourceWidth + x1) * 4,
+							aSource + (y1 * aSourceWidth + x0) * 4,
+							aSource + (y1 * aSourceWidth + x1) * 4
+						};
+
+						uint8_t* output = aDestination + (y * aWidth + x) * 4;
+
+						if (aUsage == TextureCookUsage::Color)
+						{
+							for (uint32_t c = 0; c < 3; c++)
+							{
+								const float sum = toLinear[samples[0][c]] + toLinear[samples[1][c]] + toLinear[samples[2][c]] + toLinear[samples[3][c]];
+								output[c] = LinearToSRGB(sum * 0.25f);
+							}
+						}
+						else if (aUsage == TextureCookUsage::NormalMap)
+						{
+							// Averaged normals get shorter, renormalizing keeps the lower mips from looking flatter
+							CU::Vector3f normal;
+							for (const uint8_t* sample : samples)
+							{
+								normal += CU::Vector3f((float)sample[0], (float)sample[1], (float)sample[2]) / 127.5f - CU::Vector3f::One;
+							}
+
+							normal = normal.LengthSqr() > 0.0f ? normal.GetNormalized() : CU::Vector3f(0.0f, 0.0f, 1.0f);
+							output[0] = (uint8_t)CU::Math::Clamp((normal.x + 1.0f) * 127.5f + 0.5f, 0.0f, 255.0f);
+							output[1] = (uint8_t)CU::Math::Clamp((normal.y + 1.0f) * 127.5f + 0.5f, 0.0f, 255.0f);
+							output[2] = (uint8_t)CU::Math::Clamp((normal.z + 1.0f) * 127.5f + 0.5f, 0.0f, 255.0f);
+						}
+						else
+						{
+							for (uint32_t c = 0; c < 3; c++)
+							{
+								output[c] = (uint8_t)((samples[0][c] + samples[1][c] + samples[2][c] + samples[3][c] + 2) / 4);
+							}
+						}
+
+						output[3] = (uint8_t)((samples[0][3] + samples[1][3] + samples[2][3] + samples[3][3] + 2) / 4);
+					}
+				}
+			});
+	}
+
+	static void DownsampleRGBA32F(const float* aSource, uint32_t aSourceWidth, uint32_t aSourceHeight, float* aDestination, uint32_t aWidth, uint32_t aHeight)
+	{
+		Application::Get().GetJobSystem().ParallelFor(aHeight, RowBatchSize, [&](uint32_t aBegin, uint32_t aEnd)
+			{
+				for (uint32_t y = aBegin; y < aEnd; y++)
+				{
+					const uint32_t y0 = CU::Math::Min(y * 2, aSourceHeight - 1);
+					const uint32_t y1 = CU::Math::Min(y * 2 + 1, aSourceHeight - 1);
+
+					for (uint32_t x = 0; x < aWidth; x++)
+					{
+						const uint32_t x0 = CU::Math::Min(x * 2, aSourceWidth - 1);
+						const uint32_t x1 = CU::Math::Min(x * 2 + 1, aSourceWidth - 1);
+
+						float* output = aDestination + (y * aWidth + x) * 4;
+						for (uint32_t c = 0; c < 4; c++)
+						{
+							output[c] = 0.25f * (
+								aSource[(y0 * aSourceWidth + x0) * 4 + c] +
+								aSource[(y0 * aSourceWidth + x1) * 4 + c] +
+								aSource[(y1 * aSourceWidth + x0) * 4 + c] +
+								aSource[(y1 * aSourceWidth + x1) * 4 + c]);
+						}
+					}
+				}
+			});
+	}
+
+	static Buffer GenerateMipChain(Buffer aPixels, TextureFormat aFormat, uint32_t aWidth, uint32_t aHeight, uint32_t aMipCount, TextureCookUsage aUsage)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		Buffer mipChain;
+		mipChain.Allocate(GetMipChainMemorySize(aFormat, aWidth, aHeight, aMipCount));
+		memcpy(mipChain.data, aPixels.data, GetMemorySize(aFormat, aWidth, aHeight));
+
+		byte* source = (byte*)mipChain.data;
+		for (uint32_t mip = 1; mip < aMipCount; mip++)
+		{
+			const uint32_t sourceWidth = CU::Math::Max(aWidth >> (mip - 1), 1u);
+			const uint32_t sourceHeight = CU::Math::Max(aHeight >> (mip - 1), 1u);
+			const uint32_t width = CU::Math::Max(aWidth >> mip, 1u);
+			const uint32_t height = CU::Math::Max(aHeight >> mip, 1u);
+
+			byte* destination = source + GetMemorySize(aFormat, sourceWidth, sourceHeight);
+			if (aFormat == TextureFormat::RGBA32F)
+			{
+				DownsampleRGBA32F((const float*)source, sourceWidth, sourceHeight, (float*)destination, width, height);
+			}
+			else
+			{
+				DownsampleRGBA8(source, sourceWidth, sourceHeight, destination, width, height, aUsage);
+			}
+
+			source = destination;
+		}
+
+		return mipChain;
+	}
+
+	static uint32_t ColorDistance(const uint8_t* aA, const uint8_t* aB, uint32_t aChannels)
+	{
+		uint32_t distance = 0;
+		for (uint32_t c = 0; c < aChannels; c++)
+		{
+			const int32_t difference = (int32_t)aA[c] - (int32_t)aB[c];
+			distance += (uint32_t)(difference * difference);
+		}
+		return distance;
+	}
+
+	// Fits a line through the pixels along the direction they vary the most and returns the ends of their extent on it
+	static void FindEndpoints(const BlockPixels& aBlock, uint32_t aChannels, float outStart[4], float outEnd[4])
+	{
+		float mean[4] = {};
+		float minValue[4] = { 255.0f, 255.0f, 255.0f, 255.0f };
+		float maxValue[4] = {};
+		for (const auto& pixel : aBlock)
+		{
+			for (uint32_t c = 0; c < aChannels; c++)
+			{
+				mean[c] += pixel[c];
+				minValue[c] = CU::Math::Min(minValue[c], (float)pixel[c]);
+				maxValue[c] = CU::Math::Max(maxValue[c], (float)pixel[c]);
+			}
+		}
+
+		float covariance[4][4] = {};
+		for (uint32_t c = 0; c < aChannels; c++)
+		{
+			mean[c] /= 16.0f;
+		}
+
+		for (const auto& pixel : aBlock)
+		{
+			for (uint32_t i = 0; i < aChannels; i++)
+			{
+				for (uint32_t j = 0; j < aChannels; j++)
+				{
+					covariance[i][j] += (pixel[i] - mean[i]) * (pixel[j] - mean[j]);
+				}
+			}
+		}
+
+		// Power iteration, starting from the diagonal of the bounding box
+		float axis[4] = {};
+		for (uint32_t c = 0; c < aChannels; c++)
+		{
+			axis[c] = maxValue[c] - minValue[c];
+		}
+
+		for (uint32_t iteration = 0; iteration < 8; iteration++)
+		{
+			float next[4] = {};
+			float lengthSqr = 0.0f;
+			for (uint32_t i = 0; i < aChannels; i++)
+			{
+				for (uint32_t j = 0; j < aChannels; j++)
+				{
+					next[i] += covariance[i][j] * axis[j];
+				}
+				lengthSqr += next[i] * next[i];
+			}
+
+			if (lengthSqr < 1e-8f)
+			{
+				break;
+			}
+
+			const float invLength = 1.0f / std::sqrt(lengthSqr);
+			for (uint32_t c = 0; c < aChannels; c++)
+			{
+				axis[c] = next[c] * invLength;
+			}
+		}
+
+		float axisLengthSqr = 0.0f;
+		for (uint32_t c = 0; c < aChannels; c++)
+		{
+			axisLengthSqr += axis[c] * axis[c];
+		}
+
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			outStart[c] = c < aChannels ? mean[c] : 255.0f;
+			outEnd[c] = outStart[c];
+		}
+
+		// Every pixel in the block has the same colour
+		if (axisLengthSqr < 1e-8f)
+		{
+			return;
+		}
+
+		const float invAxisLength = 1.0f / std::sqrt(axisLengthSqr);
+		for (uint32_t c = 0; c < aChannels; c++)
+		{
+			axis[c] *= invAxisLength;
+		}
+
+		float minT = FLT_MAX;
+		float maxT = -FLT_MAX;
+		for (const auto& pixel : aBlock)
+		{
+			float t = 0.0f;
+			for (uint32_t c = 0; c < aChannels; c++)
+			{
+				t += (pixel[c] - mean[c]) * axis[c];
+			}
+			minT = CU::Math::Min(minT, t);
+			maxT = CU::Math::Max(maxT, t);
+		}
+
+		for (uint32_t c = 0; c < aChannels; c++)
+		{
+			outStart[c] = CU::Math::Clamp(mean[c] + axis[c] * minT, 0.0f, 255.0f);
+			outEnd[c] = CU::Math::Clamp(mean[c] + axis[c] * maxT, 0.0f, 255.0f);
+		}
+	}
+
+	static uint16_t ToRGB565(const float aColor[4])
+	{
+		const uint32_t r = (uint32_t)(aColor[0] * 31.0f / 255.0f + 0.5f);
+		const uint32_t g = (uint32_t)(aColor[1] * 63.0f / 255.0f + 0.5f);
+		const uint32_t b = (uint32_t)(aColor[2] * 31.0f / 255.0f + 0.5f);
+		return (uint16_t)((r << 11) | (g << 5) | b);
+	}
+
+	static void FromRGB565(uint16_t aColor, uint8_t outColor[4])
+	{
+		const uint32_t r = (aColor >> 11) & 31;
+		const uint32_t g = (aColor >> 5) & 63;
+		const uint32_t b = aColor & 31;
+		outColor[0] = (uint8_t)((r << 3) | (r >> 2));
+		outColor[1] = (uint8_t)((g << 2) | (g >> 4));
+		outColor[2] = (uint8_t)((b << 3) | (b >> 2));
+		outColor[3] = 255;
+	}
+
+	// Always uses the four colour mode, transparency is handled by BC3 or BC7 instead. Only writes RGB to outDecoded.
+	static void EncodeBC1Block(const BlockPixels& aBlock, uint8_t* outData, BlockPixels& outDecoded)
+	{
+		float start[4];
+		float end[4];
+		FindEndpoints(aBlock, 3, start, end);
+
+		uint16_t color0 = ToRGB565(end);
+		uint16_t color1 = ToRGB565(start);
+		if (color0 < color1)
+		{
+			std::swap(color0, color1);
+		}
+
+		uint8_t palette[4][4];
+		FromRGB565(color0, palette[0]);
+		FromRGB565(color1, palette[1]);
+		for (uint32_t c = 0; c < 3; c++)
+		{
+			palette[2][c] = (uint8_t)((2 * palette[0][c] + palette[1][c] + 1) / 3);
+			palette[3][c] = (uint8_t)((palette[0][c] + 2 * palette[1][c] + 1) / 3);
+		}
+
+		uint32_t indices = 0;
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			// Equal endpoints switch the block to the three colour mode, where only the first entry is still safe to use
+			uint32_t bestIndex = 0;
+			if (color0 != color1)
+			{
+				uint32_t bestDistance = UINT32_MAX;
+				for (uint32_t j = 0; j < 4; j++)
+				{
+					const uint32_t distance = ColorDistance(aBlock[i].data(), palette[j], 3);
+					if (distance < bestDistance)
+					{
+						bestDistance = distance;
+						bestIndex = j;
+					}
+				}
+			}
+
+			indices |= bestIndex << (i * 2);
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				outDecoded[i][c] = palette[bestIndex][c];
+			}
+		}
+
+		memcpy(outData, &color0, sizeof(uint16_t));
+		memcpy(outData + 2, &color1, sizeof(uint16_t));
+		memcpy(outData + 4, &indices, sizeof(uint32_t));
+	}
+
+	// Single channel block, also used for the alpha of BC3 and both channels of BC5
+	static void EncodeBC4Block(const BlockPixels& aBlock, uint32_t aChannel, uint8_t* outData, BlockPixels& outDecoded)
+	{
+		uint8_t minValue = 255;
+		uint8_t maxValue = 0;
+		for (const auto& pixel : aBlock)
+		{
+			minValue = CU::Math::Min(minValue, pixel[aChannel]);
+			maxValue = CU::Math::Max(maxValue, pixel[aChannel]);
+		}
+
+		// Eight value mode, the endpoints followed by six values between them
+		uint8_t palette[8];
+		palette[0] = maxValue;
+		palette[1] = minValue;
+		for (uint32_t i = 1; i < 7; i++)
+		{
+			palette[i + 1] = (uint8_t)(((7 - i) * maxValue + i * minValue + 3) / 7);
+		}
+
+		uint64_t indices = 0;
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			uint32_t bestIndex = 0;
+			uint32_t bestDistance = UINT32_MAX;
+			for (uint32_t j = 0; j < 8; j++)
+			{
+				const int32_t difference = (int32_t)aBlock[i][aChannel] - (int32_t)palette[j];
+				const uint32_t distance = (uint32_t)(difference * difference);
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					bestIndex = j;
+				}
+			}
+
+			indices |= (uint64_t)bestIndex << (i * 3);
+			outDecoded[i][aChannel] = palette[bestIndex];
+		}
+
+		outData[0] = maxValue;
+		outData[1] = minValue;
+		memcpy(outData + 2, &indices, 6);
+	}
+
+	class BlockBitWriter
+	{
+	public:
+		void Write(uint32_t aValue, uint32_t aBitCount)
+		{
+			for (uint32_t i = 0; i < aBitCount; i++)
+			{
+				if ((aValue >> i) & 1)
+				{
+					myData[myPosition >> 3] |= (uint8_t)(1 << (myPosition & 7));
+				}
+				myPosition++;
+			}
+		}
+
+		const uint8_t* GetData() const { return myData.data(); }
+
+	private:
+		std::array<uint8_t, 16> myData = {};
+		uint32_t myPosition = 0;
+	};
+
+	static constexpr std::array<uint32_t, 16> BC7Weights = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	// Quantizes an endpoint to 7 bits per channel plus a shared p-bit, picking the p-bit that reconstructs it best
+	static void QuantizeBC7Endpoint(const float aEndpoint[4], uint8_t outQuantized[4], uint32_t& outPBit)
+	{
+		float bestError = FLT_MAX;
+		for (uint32_t pBit = 0; pBit < 2; pBit++)
+		{
+			uint8_t quantized[4];
+			float error = 0.0f;
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				const int32_t value = (int32_t)std::round((aEndpoint[c] - (float)pBit) * 0.5f);
+				quantized[c] = (uint8_t)CU::Math::Clamp(value, 0, 127);
+
+				const float difference = (float)((quantized[c] << 1) | pBit) - aEndpoint[c];
+				error += difference * difference;
+			}
+
+			if (error < bestError)
+			{
+				bestError = error;
+				outPBit = pBit;
+				memcpy(outQuantized, quantized, 4);
+			}
+		}
+	}
+
+	// Mode 6 only: one subset, RGBA endpoints with 7 bits and a p-bit each, 4 bit indices
+	static void EncodeBC7Block(const BlockPixels& aBlock, uint8_t* outData, BlockPixels& outDecoded)
+	{
+		float start[4];
+		float end[4];
+		FindEndpoints(aBlock, 4, start, end);
+
+		uint8_t endpoints[2][4];
+		uint32_t pBits[2] = {};
+		QuantizeBC7Endpoint(start, endpoints[0], pBits[0]);
+		QuantizeBC7Endpoint(end, endpoints[1], pBits[1]);
+
+		uint8_t palette[16][4];
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				const uint32_t e0 = (endpoints[0][c] << 1) | pBits[0];
+				const uint32_t e1 = (endpoints[1][c] << 1) | pBits[1];
+				palette[i][c] = (uint8_t)(((64 - BC7Weights[i]) * e0 + BC7Weights[i] * e1 + 32) >> 6);
+			}
+		}
+
+		uint32_t indices[16];
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			uint32_t bestDistance = UINT32_MAX;
+			for (uint32_t j = 0; j < 16; j++)
+			{
+				const uint32_t distance = ColorDistance(aBlock[i].data(), palette[j], 4);
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					indices[i] = j;
+				}
+			}
+
+			memcpy(outDecoded[i].data(), palette[indices[i]], 4);
+		}
+
+		// The first index is stored without its top bit, swapping the endpoints mirrors the palette so that bit becomes zero
+		if (indices[0] & 8)
+		{
+			std::swap(endpoints[0], endpoints[1]);
+			std::swap(pBits[0], pBits[1]);
+			for (uint32_t& index : indices)
+			{
+				index = 15 - index;
+			}
+		}
+
+		BlockBitWriter writer;
+		writer.Write(1 << 6, 7);
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			writer.Write(endpoints[0][c], 7);
+			writer.Write(endpoints[1][c], 7);
+		}
+		writer.Write(pBits[0], 1);
+		writer.Write(pBits[1], 1);
+
+		writer.Write(indices[0], 3);
+		for (uint32_t i = 1; i < 16; i++)
+		{
+			writer.Write(indices[i], 4);
+		}
+
+		memcpy(outData, writer.GetData(), 16);
+	}
+
+	// Channels that are stored by the format, used to compute the compression error
+	static uint32_t GetStoredChannelCount(TextureFormat aFormat)
+	{
+		switch (aFormat)
+		{
+		case TextureFormat::BC1:	return 3;
+		case TextureFormat::BC4:	return 1;
+		case TextureFormat::BC5:	return 2;
+		}
+		return 4;
+	}
+
+	// Returns the summed squared error of the pixels inside the texture
+	static double CompressMip(const uint8_t* aPixels, uint32_t aWidth, uint32_t aHeight, TextureFormat aFormat, uint8_t* outData)
+	{
+		const uint32_t blocksX = (aWidth + 3) / 4;
+		const uint32_t blocksY = (aHeight + 3) / 4;
+		const size_t blockSize = GetBlockSize(aFormat);
+		const uint32_t channels = GetStoredChannelCount(aFormat);
+
+		std::vector<double> blockRowErrors(blocksY, 0.0);
+
+		Application::Get().GetJobSystem().ParallelFor(blocksY, BlockRowBatchSize, [&](uint32_t aBegin, uint32_t aEnd)
+			{
+				for (uint32_t blockY = aBegin; blockY < aEnd; blockY++)
+				{
+					double error = 0.0;
+					for (uint32_t blockX = 0; blockX < blocksX; blockX++)
+					{
+						// Blocks on the edge of textures that aren't a multiple of four repeat the last row and column
+						BlockPixels block;
+						for (uint32_t y = 0; y < 4; y++)
+						{
+							for (uint32_t x = 0; x < 4; x++)
+							{
+								const uint32_t pixelX = CU::Math::Min(blockX * 4 + x, aWidth - 1);
+								const uint32_t pixelY = CU::Math::Min(blockY * 4 + y, aHeight - 1);
+								memcpy(block[y * 4 + x].data(), aPixels + (pixelY * aWidth + pixelX) * 4, 4);
+							}
+						}
+
+						BlockPixels decoded = block;
+						uint8_t* output = outData + (blockY * blocksX + blockX) * blockSize;
+
+						switch (aFormat)
+						{
+						case TextureFormat::BC1:
+							EncodeBC1Block(block, output, decoded);
+							break;
+						case TextureFormat::BC3:
+							EncodeBC4Block(block, 3, output, decoded);
+							EncodeBC1Block(block, output + 8, decoded);
+							break;
+						case TextureFormat::BC4:
+							EncodeBC4Block(block, 0, output, decoded);
+							break;
+						case TextureFormat::BC5:
+							EncodeBC4Block(block, 0, output, decoded);
+							EncodeBC4Block(block, 1, output + 8, decoded);
+							break;
+						case TextureFormat::BC7:
+							EncodeBC7Block(block, output, decoded);
+							break;
+						}
+
+						for (uint32_t y = 0; y < 4 && blockY * 4 + y < aHeight; y++)
+						{
+							for (uint32_t x = 0; x < 4 && blockX * 4 + x < aWidth; x++)
+							{
+								error += ColorDistance(block[y * 4 + x].data(), decoded[y * 4 + x].data(), channels);
+							}
+						}
+					}
+
+					blockRowErrors[blockY] = error;
+				}
+			});
+
+		double totalError = 0.0;
+		for (double error : blockRowErrors)
+		{
+			totalError += error;
+		}
+		return totalError;
+	}
+
+	static bool HasTransparency(Buffer aPixels, uint32_t aWidth, uint32_t aHeight)
+	{
+		const uint8_t* pixels = (const uint8_t*)aPixels.data;
+		for (size_t i = 0; i < (size_t)aWidth * aHeight; i++)
+		{
+			if (pixels[i * 4 + 3] != 255)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static TextureFormat ResolveCookedFormat(Buffer aPixels, TextureFormat aFormat, uint32_t aWidth, uint32_t aHeight, const TextureCookSettings& aSettings)
+	{
+		// There is no BC6H encoder, HDR textures only get their mips
+		if (aFormat != TextureFormat::RGBA)
+		{
+			return aFormat;
+		}
+
+		// Block compressed textures need the full size mip to be made of whole blocks
+		if (aWidth % 4 != 0 || aHeight % 4 != 0)
+		{
+			return aFormat;
+		}
+
+		switch (aSettings.compression)
+		{
+		case TextureCompression::None:	return aFormat;
+		case TextureCompression::BC1:	return TextureFormat::BC1;
+		case TextureCompression::BC3:	return TextureFormat::BC3;
+		case TextureCompression::BC4:	return TextureFormat::BC4;
+		case TextureCompression::BC5:	return TextureFormat::BC5;
+		case TextureCompression::BC7:	return TextureFormat::BC7;
+		}
+
+		switch (aSettings.usage)
+		{
+		case TextureCookUsage::Color:		return HasTransparency(aPixels, aWidth, aHeight) ? TextureFormat::BC7 : TextureFormat::BC1;
+		case TextureCookUsage::Linear:		return TextureFormat::BC7;
+		case TextureCookUsage::NormalMap:	return TextureFormat::BC5;
+		}
+
+		return aFormat;
+	}
+
+	CookedTexture TextureCooker::Cook(Buffer aPixels, TextureFormat aFormat, uint32_t aWidth, uint32_t aHeight, const TextureCookSettings& aSettings)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		EPOCH_ASSERT(aFormat == TextureFormat::RGBA || aFormat == TextureFormat::RGBA32F, "Only RGBA and RGBA32F textures can be cooked!");
+
+		CookedTexture result;
+		result.width = aWidth;
+		result.height = aHeight;
+		result.mipCount = aSettings.generateMips ? CU::Math::FloorToUInt(log2f((float)CU::Math::Min(aWidth, aHeight))) + 1 : 1;
+		result.format = ResolveCookedFormat(aPixels, aFormat, aWidth, aHeight, aSettings);
+
+		Buffer mipChain = GenerateMipChain(aPixels, aFormat, aWidth, aHeight, result.mipCount, aSettings.usage);
+
+		if (result.format == aFormat)
+		{
+			result.data = mipChain;
+			result.psnr = std::numeric_limits<float>::infinity();
+			return result;
+		}
+
+		result.data.Allocate(GetMipChainMemorySize(result.format, aWidth, aHeight, result.mipCount));
+
+		size_t sourceOffset = 0;
+		size_t destinationOffset = 0;
+		double fullSizeError = 0.0;
+		for (uint32_t mip = 0; mip < result.mipCount; mip++)
+		{
+			const uint32_t width = CU::Math::Max(aWidth >> mip, 1u);
+			const uint32_t height = CU::Math::Max(aHeight >> mip, 1u);
+
+			const double error = CompressMip((const uint8_t*)mipChain.data + sourceOffset, width, height, result.format, (uint8_t*)result.data.data + destinationOffset);
+			if (mip == 0)
+			{
+				fullSizeError = error;
+			}
+
+			sourceOffset += GetMemorySize(aFormat, width, height);
+			destinationOffset += GetMemorySize(result.format, width, height);
+		}
+
+		mipChain.Release();
+
+		const double meanSquaredError = fullSizeError / ((double)aWidth * (double)aHeight * (double)GetStoredChannelCount(result.format));
+		result.psnr = meanSquaredError > 0.0 ? (float)(10.0 * std::log10(255.0 * 255.0 / meanSquaredError)) : std::numeric_limits<float>::infinity();
+
+		return result;
+	}
+
+	void TextureCooker::SetUsageHints(const std::unordered_map<AssetHandle, TextureCookUsage>& aHints)
+	{
+		staticUsageHints = aHints;
+	}
+
+	void TextureCooker::ClearUsageHints()
+	{
+		staticUsageHints.clear();
+	}
+
+	TextureCookUsage TextureCooker::GetUsageHint(AssetHandle aHandle)
+	{
+		auto it = staticUsageHints.find(aHandle);
+		return it != staticUsageHints.end() ? it->second : TextureCookUsage::Color;
+	}
+}
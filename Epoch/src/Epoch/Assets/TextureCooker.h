@@ -0,0 +1,65 @@
+#pragma once
+#include <unordered_map>
+#include "Epoch/Core/Buffer.h"
+#include "Epoch/Assets/Asset.h"
+#include "Epoch/Rendering/Texture.h"
+
+namespace Epoch
+{
+	enum class TextureCookUsage
+	{
+		Color,		// sRGB encoded, mips are filtered in linear space
+		Linear,		// Non colour data like roughness and metalness
+		NormalMap,	// Only X and Y are kept when compressed, the shaders reconstruct Z
+		HDR
+	};
+
+	enum class TextureCompression
+	{
+		Auto,
+		None,
+		BC1,
+		BC3,
+		BC4,
+		BC5,
+		BC7
+	};
+
+	struct TextureCookSettings
+	{
+		TextureCookUsage usage = TextureCookUsage::Color;
+		TextureCompression compression = TextureCompression::Auto;
+		bool generateMips = true;
+	};
+
+	struct CookedTexture
+	{
+		TextureFormat format = TextureFormat::None;
+		uint32_t width = 0;
+		uint32_t height = 0;
+		uint32_t mipCount = 0;
+
+		// Tightly packed mips, starting with the full size one
+		Buffer data;
+
+		// Of the full size mip compared to the source, infinite when the format is lossless
+		float psnr = 0.0f;
+	};
+
+	// Prepares textures for the asset pack so the runtime can upload them as is.
+	// Generates the mip chain on the CPU and optionally block compresses every mip.
+	class TextureCooker
+	{
+	public:
+		// aPixels has to be RGBA or RGBA32F, the caller owns the returned data
+		static CookedTexture Cook(Buffer aPixels, TextureFormat aFormat, uint32_t aWidth, uint32_t aHeight, const TextureCookSettings& aSettings);
+
+		// How textures are used by the materials of the asset pack being built, unknown textures are cooked as colour textures
+		static void SetUsageHints(const std::unordered_map<AssetHandle, TextureCookUsage>& aHints);
+		static void ClearUsageHints();
+		static TextureCookUsage GetUsageHint(AssetHandle aHandle);
+
+	private:
+		static inline std::unordered_map<AssetHandle, TextureCookUsage> staticUsageHints;
+	};
+}
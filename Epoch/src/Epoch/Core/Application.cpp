@@ -12,9 +12,32 @@
 #include "Epoch/Physics/PhysicsSystem.h"
 #include "Epoch/Script/ScriptEngine.h"
 #include "Epoch/Math/Noise.h"
+#include "Epoch/Debug/MemoryTracker.h"
+#include "Epoch/Core/FrameAllocator.h"
 
 namespace Epoch
 {
+	void ApplyCommandLineArgs(ApplicationSpecification& outSpecification, int aArgc, char** aArgv)
+	{
+		for (int i = 1; i < aArgc; i++)
+		{
+			const std::string_view arg = aArgv[i];
+
+			if (arg == "--profile" && i + 1 < aArgc)
+			{
+				outSpecification.profileFrameCount = (uint32_t)std::strtoul(aArgv[++i], nullptr, 10);
+			}
+			else if (arg == "--profile-output" && i + 1 < aArgc)
+			{
+				outSpecification.profileCapturePath = aArgv[++i];
+			}
+			else if (arg == "--memory-report" && i + 1 < aArgc)
+			{
+				outSpecification.memoryReportPath = aArgv[++i];
+			}
+		}
+	}
+
 	Application::Application(ApplicationSpecification aAppSpec) : 
 		myApplicationSpecification(aAppSpec)
 	{
@@ -63,6 +86,12 @@ namespace Epoch
 		CU::Random::Init();
 		CU::Timer::Init();
 		Font::Init();
+
+		if (aAppSpec.profileFrameCount > 0)
+		{
+			LOG_INFO("Profiling the first {} frames", aAppSpec.profileFrameCount);
+			FrameProfiler::RequestCapture(aAppSpec.profileFrameCount, aAppSpec.profileCapturePath);
+		}
 	}
 
 	Application::~Application()
@@ -70,7 +99,12 @@ namespace Epoch
 		EPOCH_PROFILE_FUNC();
 
 		LOG_INFO("Closing application");
-		
+
+		// Written before anything is torn down so it shows what the application was using
+		if (!myApplicationSpecification.memoryReportPath.empty() && MemoryTracker::WriteReport(myApplicationSpecification.memoryReportPath))
+		{
+			LOG_INFO("Wrote the memory report to '{}'", myApplicationSpecification.memoryReportPath.string());
+		}
 
 		for (Layer* layer : myLayerStack)
 		{
@@ -140,6 +174,15 @@ namespace Epoch
 	{
 		while (myIsRunning)
 		{
+			// Marked before the frame scope so every zone of the loop ends up inside the frame
+			if (FrameProfiler::MarkFrame() && myApplicationSpecification.profileFrameCount > 0)
+			{
+				Close();
+				break;
+			}
+
+			FrameAllocator::BeginFrame();
+
 			EPOCH_PROFILE_SCOPE("Frame");
 
 			Input::TransitionPressedKeys();
@@ -181,7 +224,8 @@ namespace Epoch
 			CU::Timer::Update();
 			
 			ProcessEvents();
-			
+
+			MemoryTracker::EndFrame();
 			EPOCH_PROFILE_MARK_FRAME;
 		}
 	}
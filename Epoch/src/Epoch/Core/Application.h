@@ -1,6 +1,7 @@
 #pragma once
 #include <memory>
 #include <string>
+#include <filesystem>
 #include "LayerStack.h"
 #include "JobSystem.h"
 #include "Events/Event.h"
@@ -29,10 +30,20 @@ namespace Epoch
 
 		std::string cacheDirectory = "cache";
 
+		// Captures this many frames with the frame profiler and closes the application once the capture is written
+		uint32_t profileFrameCount = 0;
+		std::filesystem::path profileCapturePath = "Profiling/Capture.json";
+
+		// Written when the application closes, empty disables it
+		std::filesystem::path memoryReportPath;
+
 		ScriptEngineConfig scriptEngineConfig;
 		RendererConfig rendererConfig;
 	};
 
+	// Handles the engine's own arguments: --profile <frame count>, --profile-output <path> and --memory-report <path>
+	void ApplyCommandLineArgs(ApplicationSpecification& outSpecification, int aArgc, char** aArgv);
+
 	class Application
 	{
 	public:
@@ -0,0 +1,138 @@
+#include "epch.h"
+#include "FrameAllocator.h"
+#include <atomic>
+#include "Epoch/Debug/MemoryTracker.h"
+
+namespace Epoch
+{
+	LinearArena::~LinearArena()
+	{
+		FreeBlocks();
+	}
+
+	void LinearArena::Reset()
+	{
+		if (myBlocks.size() > 1)
+		{
+			const size_t capacity = myCapacity;
+			FreeBlocks();
+			AddBlock(capacity);
+		}
+
+		myCurrentBlock = 0;
+		myOffset = 0;
+		myUsedBytes = 0;
+	}
+
+	void* LinearArena::do_allocate(size_t aBytes, size_t aAlignment)
+	{
+		while (true)
+		{
+			if (myCurrentBlock < myBlocks.size())
+			{
+				const Block& block = myBlocks[myCurrentBlock];
+
+				const uintptr_t start = (uintptr_t)block.data;
+				const uintptr_t address = (start + myOffset + aAlignment - 1) & ~(uintptr_t)(aAlignment - 1);
+				const size_t end = (size_t)(address - start) + aBytes;
+
+				if (end <= block.size)
+				{
+					myOffset = end;
+					myUsedBytes += aBytes;
+					return (void*)address;
+				}
+
+				myCurrentBlock++;
+				myOffset = 0;
+				continue;
+			}
+
+			AddBlock(aBytes + aAlignment);
+		}
+	}
+
+	void LinearArena::AddBlock(size_t aMinSize)
+	{
+		MemoryTagScope memoryTag(MemoryTag::Transient);
+
+		Block& block = myBlocks.emplace_back();
+		block.size = CU::Math::Max(aMinSize, DefaultBlockSize);
+		block.data = new std::byte[block.size];
+
+		myCapacity += block.size;
+		myCurrentBlock = myBlocks.size() - 1;
+		myOffset = 0;
+	}
+
+	void LinearArena::FreeBlocks()
+	{
+		for (const Block& block : myBlocks)
+		{
+			delete[] block.data;
+		}
+
+		myBlocks.clear();
+		myCapacity = 0;
+	}
+
+	struct FrameArenas
+	{
+		LinearArena arenas[2];
+		uint64_t frameIndex = UINT64_MAX;
+	};
+
+	static std::atomic<uint64_t> staticFrameIndex = 0;
+	static thread_local FrameArenas staticThreadArenas;
+
+	static size_t staticLastFrameUsedBytes = 0;
+
+	static LinearArena& GetThreadArena()
+	{
+		const uint64_t frameIndex = staticFrameIndex.load(std::memory_order_acquire);
+
+		FrameArenas& frameArenas = staticThreadArenas;
+		LinearArena& arena = frameArenas.arenas[frameIndex % 2];
+
+		// The other arena holds the previous frame, this one was last used two or more frames ago
+		if (frameArenas.frameIndex != frameIndex)
+		{
+			arena.Reset();
+			frameArenas.frameIndex = frameIndex;
+		}
+
+		return arena;
+	}
+
+	void FrameAllocator::BeginFrame()
+	{
+		const uint64_t frameIndex = staticFrameIndex.load(std::memory_order_relaxed);
+
+		const FrameArenas& frameArenas = staticThreadArenas;
+		staticLastFrameUsedBytes = frameArenas.frameIndex == frameIndex ? frameArenas.arenas[frameIndex % 2].GetUsedBytes() : 0;
+
+		staticFrameIndex.store(frameIndex + 1, std::memory_order_release);
+		GetThreadArena();
+	}
+
+	uint64_t FrameAllocator::GetFrameIndex()
+	{
+		return staticFrameIndex.load(std::memory_order_relaxed);
+	}
+
+	std::pmr::memory_resource* FrameAllocator::Get()
+	{
+		return &GetThreadArena();
+	}
+
+	size_t FrameAllocator::GetLastFrameUsedBytes()
+	{
+		return staticLastFrameUsedBytes;
+	}
+
+	size_t FrameAllocator::GetCapacity()
+	{
+		const FrameArenas& frameArenas = staticThreadArenas;
+		return frameArenas.arenas[0].GetCapacity() + frameArenas.arenas[1].GetCapacity();
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace Epoch
+{
+	// Linear arena for data that only lives for a frame. Allocating bumps an offset and deallocating does nothing,
+	// all memory is released at once when the arena is reset.
+	class LinearArena : public std::pmr::memory_resource
+	{
+	public:
+		static constexpr size_t DefaultBlockSize = 256 * 1024;
+
+		LinearArena() = default;
+		~LinearArena();
+
+		LinearArena(const LinearArena&) = delete;
+		LinearArena& operator=(const LinearArena&) = delete;
+
+		// Invalidates everything allocated from the arena. If the arena had to grow, the blocks are merged into one big enough for the whole frame.
+		void Reset();
+
+		size_t GetUsedBytes() const { return myUsedBytes; }
+		size_t GetCapacity() const { return myCapacity; }
+
+	protected:
+		void* do_allocate(size_t aBytes, size_t aAlignment) override;
+		void do_deallocate(void*, size_t, size_t) override {}
+		bool do_is_equal(const std::pmr::memory_resource& aOther) const noexcept override { return this == &aOther; }
+
+	private:
+		struct Block
+		{
+			std::byte* data = nullptr;
+			size_t size = 0;
+		};
+
+		void AddBlock(size_t aMinSize);
+		void FreeBlocks();
+
+		std::vector<Block> myBlocks;
+		size_t myCurrentBlock = 0;
+		size_t myOffset = 0;
+
+		size_t myUsedBytes = 0;
+		size_t myCapacity = 0;
+	};
+
+	// Double-buffered per-frame arenas, every thread gets its own pair so allocating never takes a lock.
+	// Memory handed out during a frame stays valid until the end of the next frame, so results can be handed from
+	// the job workers to the main thread or kept around to compare against next frame.
+	// Containers using the arena must not outlive that, or grow after it.
+	class FrameAllocator
+	{
+	public:
+		// Called by the main thread at the start of every frame
+		static void BeginFrame();
+		static uint64_t GetFrameIndex();
+
+		// The calling thread's arena for the current frame, meant for std::pmr containers
+		static std::pmr::memory_resource* Get();
+
+		template<typename T>
+		static T* Allocate(size_t aCount = 1)
+		{
+			return static_cast<T*>(Get()->allocate(sizeof(T) * aCount, alignof(T)));
+		}
+
+		// Main thread usage during the last finished frame
+		static size_t GetLastFrameUsedBytes();
+		static size_t GetCapacity();
+	};
+}
@@ -8,6 +8,8 @@
 #include <mutex>
 #include <condition_variable>
 #include <future>
+#include <atomic>
+#include <string>
 #include "Epoch/Debug/Assert.h"
 #include "Epoch/Debug/Profiler.h"
 
@@ -33,27 +35,33 @@ namespace Epoch
 
 			for (unsigned i = 0; i < WorkerCount; ++i)
 			{
-				myWorkers.emplace_back([this]
+				myWorkers.emplace_back([this, i]
 					{
+						FrameProfiler::SetThreadName("Job Worker " + std::to_string(i));
+
 						while (true)
 						{
 							std::function<void()> job;
 
 							{
 								std::unique_lock<std::mutex> lock(myMutex);
-								myCondition.wait(lock, [this] { return !myJobs.empty() || !myRunning; });
+								myCondition.wait(lock, [this] { return !myHighPriorityJobs.empty() || !myJobs.empty() || !myRunning; });
 
-								if (!myRunning && myJobs.empty())
+								if (!myRunning && myHighPriorityJobs.empty() && myJobs.empty())
 								{
 									return;
 								}
 
-								job = std::move(myJobs.front());
-								myJobs.pop();
+								std::queue<std::function<void()>>& queue = myHighPriorityJobs.empty() ? myJobs : myHighPriorityJobs;
+								job = std::move(queue.front());
+								queue.pop();
 								++myActiveTasks;
 							}
 
-							job();
+							{
+								EPOCH_PROFILE_SCOPE("JobSystem::Job");
+								job();
+							}
 
 							{
 								std::lock_guard<std::mutex> lock(myMutex);
@@ -97,10 +105,115 @@ namespace Epoch
 			return result;
 		}
 
+		// For short jobs something is blocked on, like the physics simulation tasks. Workers take these before any queued regular job.
+		template<typename F>
+		void AddAHighPriorityJob(F&& aFunction)
+		{
+			{
+				std::unique_lock<std::mutex> lock(myMutex);
+				myHighPriorityJobs.emplace(std::forward<F>(aFunction));
+			}
+			myCondition.notify_one();
+		}
+
+		// Runs one queued high priority job on the calling thread, returns false if there was none.
+		// Lets a thread waiting on those jobs help out instead of idling until a worker is free.
+		bool RunHighPriorityJob()
+		{
+			std::function<void()> job;
+
+			{
+				std::lock_guard<std::mutex> lock(myMutex);
+				if (myHighPriorityJobs.empty())
+				{
+					return false;
+				}
+
+				job = std::move(myHighPriorityJobs.front());
+				myHighPriorityJobs.pop();
+				++myActiveTasks;
+			}
+
+			job();
+
+			{
+				std::lock_guard<std::mutex> lock(myMutex);
+				--myActiveTasks;
+			}
+
+			return true;
+		}
+
+		// Splits [0, aCount) into batches of aBatchSize and runs aFunction(begin, end) for each of them.
+		// The batches are claimed from a shared counter by the calling thread and by helper jobs, so the caller keeps working through them
+		// instead of waiting on queued jobs. That makes it safe to call from inside a job, the helpers just pick up whatever batches
+		// the idle workers get to. Blocks until every batch is done.
+		template<typename F>
+		void ParallelFor(uint32_t aCount, uint32_t aBatchSize, F&& aFunction)
+		{
+			if (aCount == 0)
+			{
+				return;
+			}
+
+			aBatchSize = aBatchSize == 0 ? 1 : aBatchSize;
+			if (WorkerCount == 0 || aCount <= aBatchSize)
+			{
+				aFunction(0u, aCount);
+				return;
+			}
+
+			struct Batches
+			{
+				std::atomic<uint32_t> next = 0;
+				std::atomic<uint32_t> completed = 0;
+				uint32_t count = 0;
+			};
+
+			// Helpers can start after the caller returned, they only touch the shared counters then
+			auto batches = std::make_shared<Batches>();
+			batches->count = (aCount + aBatchSize - 1) / aBatchSize;
+
+			auto runBatches = [batches, aCount, aBatchSize, function = &aFunction]()
+				{
+					uint32_t batch;
+					while ((batch = batches->next.fetch_add(1)) < batches->count)
+					{
+						const uint32_t begin = batch * aBatchSize;
+						const uint32_t end = begin + aBatchSize < aCount ? begin + aBatchSize : aCount;
+						(*function)(begin, end);
+
+						if (batches->completed.fetch_add(1) + 1 == batches->count)
+						{
+							batches->completed.notify_all();
+						}
+					}
+				};
+
+			const uint32_t helperCount = batches->count - 1 < WorkerCount ? batches->count - 1 : WorkerCount;
+			{
+				std::unique_lock<std::mutex> lock(myMutex);
+				for (uint32_t i = 0; i < helperCount; ++i)
+				{
+					myJobs.emplace(runBatches);
+				}
+			}
+			myCondition.notify_all();
+
+			runBatches();
+
+			// Everything left is already being run by another thread
+			uint32_t completed;
+			while ((completed = batches->completed.load()) != batches->count)
+			{
+				batches->completed.wait(completed);
+			}
+		}
+
 		bool AllTasksDone()
 		{
 			std::lock_guard<std::mutex> lock(myMutex);
-			return myActiveTasks == (uint32_t)0 && myJobs.empty();
+			return myActiveTasks == (uint32_t)0 && myJobs.empty() && myHighPriorityJobs.empty();
 		}
 
 		void WaitUntilDone()
@@ -113,8 +226,10 @@ namespace Epoch
 		}
 
 	private:
+
 		std::vector<std::thread> myWorkers;
 		std::queue<std::function<void()>> myJobs;
+		std::queue<std::function<void()>> myHighPriorityJobs;
 		std::mutex myMutex;
 		std::condition_variable myCondition;
 		bool myRunning = false;
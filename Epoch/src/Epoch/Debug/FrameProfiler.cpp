@@ -0,0 +1,371 @@
+#include "epch.h"
+#include "FrameProfiler.h"
+#include <atomic>
+#include <deque>
+#include <iomanip>
+
+namespace Epoch
+{
+	struct ProfilerEvent
+	{
+		uint64_t start = 0;
+		uint64_t end = 0;
+		uint32_t zone = 0;
+		uint32_t depth = 0;
+	};
+
+	struct ProfilerTimeline
+	{
+		uint32_t id = 0;
+		std::string name;
+		uint32_t depth = 0;
+
+		std::unique_ptr<ProfilerEvent[]> events;
+		std::atomic<uint64_t> eventCount = 0;
+	};
+
+	struct ProfilerFrame
+	{
+		uint64_t start = 0;
+		uint64_t end = 0;
+	};
+
+	struct ProfilerData
+	{
+		std::array<const char*, FrameProfiler::MaxZones> zoneNames = {};
+		std::atomic<uint32_t> zoneCount = 1;
+
+		std::mutex internMutex;
+		std::deque<std::string> internedNames;
+		std::unordered_map<std::string_view, uint32_t> internedZones;
+
+		std::mutex timelineMutex;
+		std::vector<std::unique_ptr<ProfilerTimeline>> timelines;
+		ProfilerTimeline* mainTimeline = nullptr;
+
+		std::array<ProfilerFrame, FrameProfiler::FramesKept> frames;
+		uint64_t frameIndex = 0;
+		uint64_t frameStart = 0;
+
+		uint32_t captureFrameCount = 0;
+		uint64_t captureEndFrame = 0;
+		std::filesystem::path capturePath;
+	};
+
+	static ProfilerData& GetProfilerData()
+	{
+		// Never destroyed since zones can still end during static destruction
+		static ProfilerData* data = new ProfilerData();
+		return *data;
+	}
+
+	static thread_local ProfilerTimeline* staticThreadTimeline = nullptr;
+
+	static ProfilerTimeline& GetThreadTimeline()
+	{
+		if (staticThreadTimeline == nullptr)
+		{
+			ProfilerData& data = GetProfilerData();
+			std::scoped_lock lock(data.timelineMutex);
+
+			auto& timeline = data.timelines.emplace_back(std::make_unique<ProfilerTimeline>());
+			timeline->id = (uint32_t)data.timelines.size() - 1;
+			timeline->name = "Thread " + std::to_string(timeline->id);
+			timeline->events = std::make_unique<ProfilerEvent[]>(FrameProfiler::EventsPerThread);
+			staticThreadTimeline = timeline.get();
+		}
+
+		return *staticThreadTimeline;
+	}
+
+	static double TicksToMicroseconds(uint64_t aTicks)
+	{
+		using Period = std::chrono::steady_clock::period;
+		return (double)aTicks * 1000000.0 * Period::num / Period::den;
+	}
+
+	static void WriteEscaped(std::ofstream& aStream, const char* aString)
+	{
+		for (const char* c = aString; *c != '\0'; c++)
+		{
+			if (*c == '"' || *c == '\\') aStream << '\\';
+			aStream << *c;
+		}
+	}
+
+	uint32_t FrameProfiler::RegisterZone(const char* aName)
+	{
+		ProfilerData& data = GetProfilerData();
+
+		const uint32_t zone = data.zoneCount.fetch_add(1);
+		if (zone >= MaxZones)
+		{
+			EPOCH_ASSERT(false, "Out of profiler zones!");
+			return 0;
+		}
+
+		data.zoneNames[zone] = aName;
+		return zone;
+	}
+
+	uint32_t FrameProfiler::InternZone(std::string_view aName)
+	{
+		ProfilerData& data = GetProfilerData();
+		std::scoped_lock lock(data.internMutex);
+
+		if (auto it = data.internedZones.find(aName); it != data.internedZones.end())
+		{
+			return it->second;
+		}
+
+		const std::string& name = data.internedNames.emplace_back(aName);
+		const uint32_t zone = RegisterZone(name.c_str());
+		data.internedZones.emplace(name, zone);
+		return zone;
+	}
+
+	const char* FrameProfiler::GetZoneName(uint32_t aZone)
+	{
+		ProfilerData& data = GetProfilerData();
+		if (aZone == 0 || aZone >= MaxZones || data.zoneNames[aZone] == nullptr)
+		{
+			return "Unknown";
+		}
+
+		return data.zoneNames[aZone];
+	}
+
+	void FrameProfiler::SetThreadName(const std::string& aName)
+	{
+		ProfilerTimeline& timeline = GetThreadTimeline();
+
+		std::scoped_lock lock(GetProfilerData().timelineMutex);
+		timeline.name = aName;
+	}
+
+	void FrameProfiler::BeginZone()
+	{
+		GetThreadTimeline().depth++;
+	}
+
+	void FrameProfiler::EndZone(uint32_t aZone, uint64_t aStart)
+	{
+		const uint64_t end = GetTicks();
+
+		ProfilerTimeline& timeline = GetThreadTimeline();
+		timeline.depth--;
+
+		const uint64_t index = timeline.eventCount.load(std::memory_order_relaxed);
+		ProfilerEvent& event = timeline.events[index % EventsPerThread];
+		event.start = aStart;
+		event.end = end;
+		event.zone = aZone;
+		event.depth = timeline.depth;
+
+		timeline.eventCount.store(index + 1, std::memory_order_release);
+	}
+
+	bool FrameProfiler::MarkFrame()
+	{
+		ProfilerData& data = GetProfilerData();
+
+		if (data.mainTimeline == nullptr)
+		{
+			SetThreadName("Main Thread");
+			data.mainTimeline = &GetThreadTimeline();
+		}
+
+		const uint64_t now = GetTicks();
+		if (data.frameStart == 0)
+		{
+			data.frameStart = now;
+			return false;
+		}
+
+		data.frames[data.frameIndex % FramesKept] = { data.frameStart, now };
+		data.frameIndex++;
+		data.frameStart = now;
+
+		if (data.captureFrameCount == 0 || data.frameIndex < data.captureEndFrame)
+		{
+			return false;
+		}
+
+		if (ExportChromeTrace(data.capturePath, data.captureFrameCount))
+		{
+			LOG_INFO("Wrote a {} frame profiler capture to '{}'", data.captureFrameCount, data.capturePath.string());
+		}
+
+		data.captureFrameCount = 0;
+		return true;
+	}
+
+	uint64_t FrameProfiler::GetFrameIndex()
+	{
+		return GetProfilerData().frameIndex;
+	}
+
+	void FrameProfiler::GetLastFrameTimings(std::vector<ZoneTiming>& outTimings)
+	{
+		outTimings.clear();
+
+		ProfilerData& data = GetProfilerData();
+		if (data.mainTimeline == nullptr || data.frameIndex == 0)
+		{
+			return;
+		}
+
+		const ProfilerFrame& frame = data.frames[(data.frameIndex - 1) % FramesKept];
+		const ProfilerTimeline& timeline = *data.mainTimeline;
+
+		std::unordered_map<uint32_t, size_t> timingIndices;
+
+		// Events are stored in the order they ended, so walking backwards stops at the first one that ended before the frame
+		const uint64_t eventCount = timeline.eventCount.load(std::memory_order_acquire);
+		const uint64_t firstEvent = eventCount > EventsPerThread ? eventCount - EventsPerThread : 0;
+		for (uint64_t i = eventCount; i > firstEvent; i--)
+		{
+			const ProfilerEvent& event = timeline.events[(i - 1) % EventsPerThread];
+			if (event.end < frame.start)
+			{
+				break;
+			}
+
+			if (event.start < frame.start || event.end > frame.end)
+			{
+				continue;
+			}
+
+			auto [it, inserted] = timingIndices.try_emplace(event.zone, outTimings.size());
+			if (inserted)
+			{
+				outTimings.push_back({ GetZoneName(event.zone), 0, 0.0f });
+			}
+
+			ZoneTiming& timing = outTimings[it->second];
+			timing.calls++;
+			timing.milliseconds += (float)(TicksToMicroseconds(event.end - event.start) * 0.001);
+		}
+
+		std::sort(outTimings.begin(), outTimings.end(), [](const ZoneTiming& aLhs, const ZoneTiming& aRhs) { return aLhs.milliseconds > aRhs.milliseconds; });
+	}
+
+	float FrameProfiler::GetLastFrameTime()
+	{
+		ProfilerData& data = GetProfilerData();
+		if (data.frameIndex == 0)
+		{
+			return 0.0f;
+		}
+
+		const ProfilerFrame& frame = data.frames[(data.frameIndex - 1) % FramesKept];
+		return (float)(TicksToMicroseconds(frame.end - frame.start) * 0.001);
+	}
+
+	void FrameProfiler::RequestCapture(uint32_t aFrameCount, const std::filesystem::path& aPath)
+	{
+		ProfilerData& data = GetProfilerData();
+		data.captureFrameCount = CU::Math::Clamp(aFrameCount, 1u, FramesKept);
+		data.captureEndFrame = data.frameIndex + data.captureFrameCount;
+		data.capturePath = aPath;
+	}
+
+	bool FrameProfiler::IsCapturing()
+	{
+		return GetProfilerData().captureFrameCount > 0;
+	}
+
+	bool FrameProfiler::ExportChromeTrace(const std::filesystem::path& aPath, uint32_t aFrameCount)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		ProfilerData& data = GetProfilerData();
+
+		aFrameCount = (uint32_t)CU::Math::Min((uint64_t)CU::Math::Min(aFrameCount, FramesKept), data.frameIndex);
+		if (aFrameCount == 0)
+		{
+			LOG_WARNING("No profiler frames have been recorded yet!");
+			return false;
+		}
+
+		if (aPath.has_parent_path())
+		{
+			std::filesystem::create_directories(aPath.parent_path());
+		}
+
+		std::ofstream stream(aPath);
+		if (!stream)
+		{
+			LOG_ERROR("Failed to open '{}' for writing the profiler capture!", aPath.string());
+			return false;
+		}
+
+		const uint64_t firstFrame = data.frameIndex - aFrameCount;
+		const uint64_t rangeStart = data.frames[firstFrame % FramesKept].start;
+		const uint64_t rangeEnd = data.frames[(data.frameIndex - 1) % FramesKept].end;
+
+		stream << std::fixed << std::setprecision(3);
+		stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+		bool first = true;
+		const auto beginEvent = [&]()
+			{
+				if (!first) stream << ",\n";
+				first = false;
+			};
+
+		std::scoped_lock lock(data.timelineMutex);
+
+		bool eventsOverwritten = false;
+		for (const auto& timeline : data.timelines)
+		{
+			beginEvent();
+			stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << timeline->id << ",\"args\":{\"name\":\"";
+			WriteEscaped(stream, timeline->name.c_str());
+			stream << "\"}}";
+
+			// The oldest part of the ring is skipped since other threads can be overwriting it while this reads
+			const uint64_t eventCount = timeline->eventCount.load(std::memory_order_acquire);
+			const uint64_t firstEvent = eventCount > EventsPerThread ? eventCount - EventsPerThread + EventsPerThread / 4 : 0;
+
+			if (firstEvent > 0 && timeline->events[firstEvent % EventsPerThread].start > rangeStart)
+			{
+				eventsOverwritten = true;
+			}
+
+			for (uint64_t i = firstEvent; i < eventCount; i++)
+			{
+				const ProfilerEvent& event = timeline->events[i % EventsPerThread];
+				if (event.start < rangeStart || event.end > rangeEnd)
+				{
+					continue;
+				}
+
+				beginEvent();
+				stream << "{\"name\":\"";
+				WriteEscaped(stream, GetZoneName(event.zone));
+				stream << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << timeline->id;
+				stream << ",\"ts\":" << TicksToMicroseconds(event.start - rangeStart);
+				stream << ",\"dur\":" << TicksToMicroseconds(event.end - event.start) << "}";
+			}
+		}
+
+		for (uint64_t frameIndex = firstFrame; frameIndex < data.frameIndex; frameIndex++)
+		{
+			const ProfilerFrame& frame = data.frames[frameIndex % FramesKept];
+
+			beginEvent();
+			stream << "{\"name\":\"Frame " << frameIndex << "\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":" << data.mainTimeline->id;
+			stream << ",\"ts\":" << TicksToMicroseconds(frame.start - rangeStart) << "}";
+		}
+
+		stream << "\n]}\n";
+
+		if (eventsOverwritten)
+		{
+			LOG_WARNING("The profiler ring buffers were too small to hold all {} frames, the start of the capture is incomplete", aFrameCount);
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Epoch
+{
+	// Built-in CPU profiler that works without any external tools.
+	// Zones are registered once per call site, and every thread records its finished zones into its own fixed-size ring buffer,
+	// so recording a zone never formats strings, allocates or takes a lock.
+	class FrameProfiler
+	{
+	public:
+		static constexpr uint32_t MaxZones = 4096;
+		static constexpr uint32_t EventsPerThread = 1 << 15;
+		static constexpr uint32_t FramesKept = 256;
+
+		struct ZoneTiming
+		{
+			const char* name = nullptr;
+			uint32_t calls = 0;
+			float milliseconds = 0.0f;
+		};
+
+		// aName has to outlive the profiler, like a string literal
+		static uint32_t RegisterZone(const char* aName);
+		// Copies the name, registering the same name twice returns the same zone
+		static uint32_t InternZone(std::string_view aName);
+		static const char* GetZoneName(uint32_t aZone);
+
+		// Shown as the name of the calling thread's timeline in captures
+		static void SetThreadName(const std::string& aName);
+
+		static uint64_t GetTicks() { return (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count(); }
+		static void BeginZone();
+		static void EndZone(uint32_t aZone, uint64_t aStart);
+
+		// Called by the main thread at the start of every frame. Returns true when a requested capture was written.
+		static bool MarkFrame();
+		static uint64_t GetFrameIndex();
+
+		// The zones the main thread recorded during the last finished frame, slowest first
+		static void GetLastFrameTimings(std::vector<ZoneTiming>& outTimings);
+		static float GetLastFrameTime();
+
+		// Writes the last aFrameCount frames of every thread once they have been recorded
+		static void RequestCapture(uint32_t aFrameCount, const std::filesystem::path& aPath);
+		static bool IsCapturing();
+
+		// Chrome trace event JSON, opens in chrome://tracing and Perfetto
+		static bool ExportChromeTrace(const std::filesystem::path& aPath, uint32_t aFrameCount);
+	};
+
+	class FrameProfilerScope
+	{
+	public:
+		FrameProfilerScope(uint32_t aZone) : myZone(aZone), myStart(FrameProfiler::GetTicks()) { FrameProfiler::BeginZone(); }
+		~FrameProfilerScope() { FrameProfiler::EndZone(myZone, myStart); }
+
+		FrameProfilerScope(const FrameProfilerScope&) = delete;
+		FrameProfilerScope& operator=(const FrameProfilerScope&) = delete;
+
+	private:
+		uint32_t myZone;
+		uint64_t myStart;
+	};
+}
@@ -0,0 +1,334 @@
+#include "epch.h"
+#include "MemoryTracker.h"
+#include <atomic>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+
+namespace Epoch
+{
+	struct AtomicTagStats
+	{
+		std::atomic<uint64_t> currentBytes = 0;
+		std::atomic<uint64_t> peakBytes = 0;
+		std::atomic<uint64_t> liveAllocations = 0;
+		std::atomic<uint64_t> totalAllocations = 0;
+	};
+
+	// Everything here is constant initialized, allocations made during static initialization are counted too
+	static AtomicTagStats staticTagStats[(size_t)MemoryTag::Count];
+	static AtomicTagStats staticTotalStats;
+
+	static std::atomic<uint32_t> staticFrameAllocations = 0;
+	static std::atomic<uint64_t> staticFrameBytes = 0;
+
+	static MemoryTracker::FrameStats staticFrameHistory[MemoryTracker::FramesKept];
+	static uint64_t staticFrameCount = 0;
+
+	static thread_local MemoryTag staticCurrentTag = MemoryTag::Untagged;
+
+	static void AddAllocation(AtomicTagStats& aStats, uint64_t aSize)
+	{
+		const uint64_t current = aStats.currentBytes.fetch_add(aSize, std::memory_order_relaxed) + aSize;
+		aStats.liveAllocations.fetch_add(1, std::memory_order_relaxed);
+		aStats.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+
+		uint64_t peak = aStats.peakBytes.load(std::memory_order_relaxed);
+		while (current > peak && !aStats.peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {}
+	}
+
+	static void RemoveAllocation(AtomicTagStats& aStats, uint64_t aSize)
+	{
+		aStats.currentBytes.fetch_sub(aSize, std::memory_order_relaxed);
+		aStats.liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	static MemoryTracker::TagStats LoadStats(const AtomicTagStats& aStats)
+	{
+		MemoryTracker::TagStats stats;
+		stats.currentBytes = aStats.currentBytes.load(std::memory_order_relaxed);
+		stats.peakBytes = aStats.peakBytes.load(std::memory_order_relaxed);
+		stats.liveAllocations = aStats.liveAllocations.load(std::memory_order_relaxed);
+		stats.totalAllocations = aStats.totalAllocations.load(std::memory_order_relaxed);
+		return stats;
+	}
+
+	const char* MemoryTagToString(MemoryTag aTag)
+	{
+		switch (aTag)
+		{
+		case MemoryTag::Untagged:		return "Untagged";
+		case MemoryTag::AssetScene:		return "Asset/Scene";
+		case MemoryTag::AssetPrefab:	return "Asset/Prefab";
+		case MemoryTag::AssetTexture:	return "Asset/Texture";
+		case MemoryTag::AssetMesh:		return "Asset/Mesh";
+		case MemoryTag::AssetAnimation:	return "Asset/Animation";
+		case MemoryTag::AssetMaterial:	return "Asset/Material";
+		case MemoryTag::AssetAudio:		return "Asset/Audio";
+		case MemoryTag::AssetFont:		return "Asset/Font";
+		case MemoryTag::AssetOther:		return "Asset/Other";
+		case MemoryTag::ECS:			return "ECS";
+		case MemoryTag::Scripting:		return "Scripting";
+		case MemoryTag::Physics:		return "Physics";
+		case MemoryTag::Renderer:		return "Renderer";
+		case MemoryTag::Transient:		return "Transient";
+		}
+
+		return "Unknown";
+	}
+
+	void MemoryTracker::RecordAllocation(MemoryTag aTag, uint64_t aSize)
+	{
+		AddAllocation(staticTagStats[(size_t)aTag], aSize);
+		AddAllocation(staticTotalStats, aSize);
+
+		staticFrameAllocations.fetch_add(1, std::memory_order_relaxed);
+		staticFrameBytes.fetch_add(aSize, std::memory_order_relaxed);
+	}
+
+	void MemoryTracker::RecordFree(MemoryTag aTag, uint64_t aSize)
+	{
+		RemoveAllocation(staticTagStats[(size_t)aTag], aSize);
+		RemoveAllocation(staticTotalStats, aSize);
+	}
+
+	MemoryTag MemoryTracker::GetCurrentTag()
+	{
+		return staticCurrentTag;
+	}
+
+	MemoryTag MemoryTracker::SetCurrentTag(MemoryTag aTag)
+	{
+		const MemoryTag previousTag = staticCurrentTag;
+		staticCurrentTag = aTag;
+		return previousTag;
+	}
+
+	void MemoryTracker::EndFrame()
+	{
+		FrameStats& frame = staticFrameHistory[staticFrameCount % FramesKept];
+		frame.allocations = staticFrameAllocations.exchange(0, std::memory_order_relaxed);
+		frame.bytes = staticFrameBytes.exchange(0, std::memory_order_relaxed);
+		staticFrameCount++;
+	}
+
+	MemoryTracker::TagStats MemoryTracker::GetTagStats(MemoryTag aTag)
+	{
+		return LoadStats(staticTagStats[(size_t)aTag]);
+	}
+
+	MemoryTracker::TagStats MemoryTracker::GetTotalStats()
+	{
+		return LoadStats(staticTotalStats);
+	}
+
+	MemoryTracker::FrameStats MemoryTracker::GetLastFrameStats()
+	{
+		return staticFrameCount > 0 ? staticFrameHistory[(staticFrameCount - 1) % FramesKept] : FrameStats();
+	}
+
+	void MemoryTracker::GetFrameHistory(std::vector<FrameStats>& outFrames)
+	{
+		const uint64_t frameCount = CU::Math::Min(staticFrameCount, (uint64_t)FramesKept);
+
+		outFrames.clear();
+		outFrames.reserve(frameCount);
+		for (uint64_t i = staticFrameCount - frameCount; i < staticFrameCount; i++)
+		{
+			outFrames.push_back(staticFrameHistory[i % FramesKept]);
+		}
+	}
+
+	bool MemoryTracker::WriteReport(const std::filesystem::path& aPath)
+	{
+		if (aPath.has_parent_path())
+		{
+			std::filesystem::create_directories(aPath.parent_path());
+		}
+
+		std::ofstream stream(aPath);
+		if (!stream)
+		{
+			LOG_ERROR("Failed to open '{}' for writing the memory report!", aPath.string());
+			return false;
+		}
+
+		stream << "Epoch memory report\n";
+#if !EPOCH_TRACK_MEMORY
+		stream << "Heap tracking is compiled out, only explicitly recorded allocations are included\n";
+#endif
+		stream << "\n";
+
+		stream << fmt::format("{:<18}{:>16}{:>16}{:>14}{:>16}\n", "Tag", "Current", "Peak", "Live", "Allocations");
+		for (size_t i = 0; i < (size_t)MemoryTag::Count; i++)
+		{
+			const TagStats stats = GetTagStats((MemoryTag)i);
+			stream << fmt::format("{:<18}{:>16}{:>16}{:>14}{:>16}\n", MemoryTagToString((MemoryTag)i), stats.currentBytes, stats.peakBytes, stats.liveAllocations, stats.totalAllocations);
+		}
+
+		const TagStats total = GetTotalStats();
+		stream << fmt::format("{:<18}{:>16}{:>16}{:>14}{:>16}\n\n", "Total", total.currentBytes, total.peakBytes, total.liveAllocations, total.totalAllocations);
+
+		std::vector<FrameStats> frames;
+		GetFrameHistory(frames);
+		if (frames.empty())
+		{
+			return true;
+		}
+
+		const uint64_t countLimits[] = { 1, 16, 256, 4096 };
+		const uint64_t byteLimits[] = { 1, 1024, 64 * 1024, 1024 * 1024 };
+		uint32_t countHistogram[5] = {};
+		uint32_t byteHistogram[5] = {};
+
+		uint64_t allocationSum = 0;
+		uint64_t byteSum = 0;
+		FrameStats worst;
+		for (const FrameStats& frame : frames)
+		{
+			countHistogram[std::upper_bound(std::begin(countLimits), std::end(countLimits), (uint64_t)frame.allocations) - std::begin(countLimits)]++;
+			byteHistogram[std::upper_bound(std::begin(byteLimits), std::end(byteLimits), frame.bytes) - std::begin(byteLimits)]++;
+
+			allocationSum += frame.allocations;
+			byteSum += frame.bytes;
+			worst.allocations = CU::Math::Max(worst.allocations, frame.allocations);
+			worst.bytes = CU::Math::Max(worst.bytes, frame.bytes);
+		}
+
+		stream << fmt::format("Allocations per frame over the last {} frames: average {}, max {}\n", frames.size(), allocationSum / frames.size(), worst.allocations);
+		stream << fmt::format("  {:<14}{:>8}\n", "0", countHistogram[0]);
+		stream << fmt::format("  {:<14}{:>8}\n", "1 - 15", countHistogram[1]);
+		stream << fmt::format("  {:<14}{:>8}\n", "16 - 255", countHistogram[2]);
+		stream << fmt::format("  {:<14}{:>8}\n", "256 - 4095", countHistogram[3]);
+		stream << fmt::format("  {:<14}{:>8}\n\n", "4096+", countHistogram[4]);
+
+		stream << fmt::format("Bytes allocated per frame over the last {} frames: average {}, max {}\n", frames.size(), byteSum / frames.size(), worst.bytes);
+		stream << fmt::format("  {:<14}{:>8}\n", "0", byteHistogram[0]);
+		stream << fmt::format("  {:<14}{:>8}\n", "< 1 KB", byteHistogram[1]);
+		stream << fmt::format("  {:<14}{:>8}\n", "< 64 KB", byteHistogram[2]);
+		stream << fmt::format("  {:<14}{:>8}\n", "< 1 MB", byteHistogram[3]);
+		stream << fmt::format("  {:<14}{:>8}\n", "1 MB+", byteHistogram[4]);
+
+		return true;
+	}
+}
+
+#if EPOCH_TRACK_MEMORY
+
+// Every operator new and delete overload is replaced, so all memory reaching the deletes below was allocated by the news
+// below and has a header in front of it. Allocations made by other modules go through their own operators.
+namespace
+{
+	// Keeps the returned memory 16 byte aligned like malloc
+	struct alignas(16) AllocationHeader
+	{
+		uint64_t size;
+		Epoch::MemoryTag tag;
+		uint32_t offset; // From the start of the block to the returned memory, only read for over-aligned allocations
+	};
+
+	void* TrackedAllocate(size_t aSize) noexcept
+	{
+		AllocationHeader* header = (AllocationHeader*)std::malloc(sizeof(AllocationHeader) + aSize);
+		if (header == nullptr)
+		{
+			return nullptr;
+		}
+
+		header->size = aSize;
+		header->tag = Epoch::MemoryTracker::GetCurrentTag();
+		header->offset = sizeof(AllocationHeader);
+		Epoch::MemoryTracker::RecordAllocation(header->tag, aSize);
+
+		return header + 1;
+	}
+
+	void* TrackedAllocateAligned(size_t aSize, std::align_val_t aAlignment) noexcept
+	{
+		// The header sits right before the returned memory, which is pushed forward by a whole alignment so it stays aligned
+		const size_t alignment = CU::Math::Max((size_t)aAlignment, alignof(AllocationHeader));
+		const size_t offset = CU::Math::Max(alignment, sizeof(AllocationHeader));
+
+		uint8_t* block = (uint8_t*)_aligned_malloc(offset + aSize, alignment);
+		if (block == nullptr)
+		{
+			return nullptr;
+		}
+
+		AllocationHeader* header = (AllocationHeader*)(block + offset) - 1;
+		header->size = aSize;
+		header->tag = Epoch::MemoryTracker::GetCurrentTag();
+		header->offset = (uint32_t)offset;
+		Epoch::MemoryTracker::RecordAllocation(header->tag, aSize);
+
+		return block + offset;
+	}
+
+	void TrackedFree(void* aMemory) noexcept
+	{
+		if (aMemory == nullptr)
+		{
+			return;
+		}
+
+		AllocationHeader* header = (AllocationHeader*)aMemory - 1;
+		Epoch::MemoryTracker::RecordFree(header->tag, header->size);
+		std::free(header);
+	}
+
+	void TrackedFreeAligned(void* aMemory) noexcept
+	{
+		if (aMemory == nullptr)
+		{
+			return;
+		}
+
+		AllocationHeader* header = (AllocationHeader*)aMemory - 1;
+		Epoch::MemoryTracker::RecordFree(header->tag, header->size);
+		_aligned_free((uint8_t*)aMemory - header->offset);
+	}
+
+	void* TrackedAllocateOrThrow(size_t aSize)
+	{
+		if (void* memory = TrackedAllocate(aSize == 0 ? 1 : aSize))
+		{
+			return memory;
+		}
+
+		throw std::bad_alloc();
+	}
+
+	void* TrackedAllocateAlignedOrThrow(size_t aSize, std::align_val_t aAlignment)
+	{
+		if (void* memory = TrackedAllocateAligned(aSize == 0 ? 1 : aSize, aAlignment))
+		{
+			return memory;
+		}
+
+		throw std::bad_alloc();
+	}
+}
+
+void* operator new(size_t aSize) { return TrackedAllocateOrThrow(aSize); }
+void* operator new[](size_t aSize) { return TrackedAllocateOrThrow(aSize); }
+void* operator new(size_t aSize, const std::nothrow_t&) noexcept { return TrackedAllocate(aSize == 0 ? 1 : aSize); }
+void* operator new[](size_t aSize, const std::nothrow_t&) noexcept { return TrackedAllocate(aSize == 0 ? 1 : aSize); }
+void* operator new(size_t aSize, std::align_val_t aAlignment) { return TrackedAllocateAlignedOrThrow(aSize, aAlignment); }
+void* operator new[](size_t aSize, std::align_val_t aAlignment) { return TrackedAllocateAlignedOrThrow(aSize, aAlignment); }
+void* operator new(size_t aSize, std::align_val_t aAlignment, const std::nothrow_t&) noexcept { return TrackedAllocateAligned(aSize == 0 ? 1 : aSize, aAlignment); }
+void* operator new[](size_t aSize, std::align_val_t aAlignment, const std::nothrow_t&) noexcept { return TrackedAllocateAligned(aSize == 0 ? 1 : aSize, aAlignment); }
+
+void operator delete(void* aMemory) noexcept { TrackedFree(aMemory); }
+void operator delete[](void* aMemory) noexcept { TrackedFree(aMemory); }
+void operator delete(void* aMemory, size_t) noexcept { TrackedFree(aMemory); }
+void operator delete[](void* aMemory, size_t) noexcept { TrackedFree(aMemory); }
+void operator delete(void* aMemory, const std::nothrow_t&) noexcept { TrackedFree(aMemory); }
+void operator delete[](void* aMemory, const std::nothrow_t&) noexcept { TrackedFree(aMemory); }
+void operator delete(void* aMemory, std::align_val_t) noexcept { TrackedFreeAligned(aMemory); }
+void operator delete[](void* aMemory, std::align_val_t) noexcept { TrackedFreeAligned(aMemory); }
+void operator delete(void* aMemory, size_t, std::align_val_t) noexcept { TrackedFreeAligned(aMemory); }
+void operator delete[](void* aMemory, size_t, std::align_val_t) noexcept { TrackedFreeAligned(aMemory); }
+void operator delete(void* aMemory, std::align_val_t, const std::nothrow_t&) noexcept { TrackedFreeAligned(aMemory); }
+void operator delete[](void* aMemory, std::align_val_t, const std::nothrow_t&) noexcept { TrackedFreeAligned(aMemory); }
+
+#endif
@@ -0,0 +1,94 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+// Replaces the global operator new and delete so every heap allocation is counted under the current tag.
+// Debug builds only, every allocation pays for a few shared atomic counters.
+#ifdef _DEBUG
+	#define EPOCH_TRACK_MEMORY 1
+#else
+	#define EPOCH_TRACK_MEMORY 0
+#endif
+
+namespace Epoch
+{
+	enum class MemoryTag : uint8_t
+	{
+		Untagged,
+
+		AssetScene,
+		AssetPrefab,
+		AssetTexture,
+		AssetMesh,
+		AssetAnimation,
+		AssetMaterial,
+		AssetAudio,
+		AssetFont,
+		AssetOther,
+
+		ECS,
+		Scripting,
+		Physics,
+		Renderer,
+		Transient,
+
+		Count
+	};
+
+	const char* MemoryTagToString(MemoryTag aTag);
+
+	// Counts allocations per tag. Allocations pick up the tag of the innermost MemoryTagScope on their thread,
+	// and frees are subtracted from the tag the memory was allocated with.
+	class MemoryTracker
+	{
+	public:
+		static constexpr uint32_t FramesKept = 256;
+
+		struct TagStats
+		{
+			uint64_t currentBytes = 0;
+			uint64_t peakBytes = 0;
+			uint64_t liveAllocations = 0;
+			uint64_t totalAllocations = 0;
+		};
+
+		struct FrameStats
+		{
+			uint32_t allocations = 0;
+			uint64_t bytes = 0;
+		};
+
+		static void RecordAllocation(MemoryTag aTag, uint64_t aSize);
+		static void RecordFree(MemoryTag aTag, uint64_t aSize);
+
+		static MemoryTag GetCurrentTag();
+		// Returns the previous tag
+		static MemoryTag SetCurrentTag(MemoryTag aTag);
+
+		// Called by the main thread at the end of every frame
+		static void EndFrame();
+
+		static TagStats GetTagStats(MemoryTag aTag);
+		static TagStats GetTotalStats();
+		static FrameStats GetLastFrameStats();
+		// Oldest frame first
+		static void GetFrameHistory(std::vector<FrameStats>& outFrames);
+
+		// Plain text report with the per tag usage, high-water marks and per frame allocation histograms
+		static bool WriteReport(const std::filesystem::path& aPath);
+	};
+
+	class MemoryTagScope
+	{
+	public:
+		MemoryTagScope(MemoryTag aTag) : myPreviousTag(MemoryTracker::SetCurrentTag(aTag)) {}
+		~MemoryTagScope() { MemoryTracker::SetCurrentTag(myPreviousTag); }
+
+		MemoryTagScope(const MemoryTagScope&) = delete;
+		MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+
+	private:
+		MemoryTag myPreviousTag;
+	};
+}
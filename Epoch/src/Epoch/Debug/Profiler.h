@@ -1,14 +1,27 @@
 #pragma once
+#include "Epoch/Debug/FrameProfiler.h"
 
 #define EPOCH_ENABLE_PROFILING !_DIST
 
+#define EPOCH_PROFILE_CONCAT_INNER(A, B)	A##B
+#define EPOCH_PROFILE_CONCAT(A, B)			EPOCH_PROFILE_CONCAT_INNER(A, B)
+#define EPOCH_PROFILE_FIRST(A, ...)			A
+
+// Records into the built-in frame profiler in every configuration, NAME has to outlive the profiler
+#define EPOCH_FRAME_PROFILE_ZONE(NAME)		static const uint32_t EPOCH_PROFILE_CONCAT(epochProfileZone, __LINE__) = ::Epoch::FrameProfiler::RegisterZone(NAME); \
+											::Epoch::FrameProfilerScope EPOCH_PROFILE_CONCAT(epochProfileScope, __LINE__)(EPOCH_PROFILE_CONCAT(epochProfileZone, __LINE__))
+#define EPOCH_FRAME_PROFILE_ZONE_ID(ID)		::Epoch::FrameProfilerScope EPOCH_PROFILE_CONCAT(epochProfileScope, __LINE__)(ID)
+
 #if EPOCH_ENABLE_PROFILING
 #include <tracy/Tracy.hpp>
-#define EPOCH_PROFILE_MARK_FRAME		FrameMark
-#define EPOCH_PROFILE_FUNC(...)			ZoneScoped##__VA_OPT__(N(__VA_ARGS__))
-#define EPOCH_PROFILE_SCOPE(NAME)		ZoneScoped; ZoneName(NAME, strlen(NAME))
+#define EPOCH_PROFILE_MARK_FRAME			FrameMark
+#define EPOCH_PROFILE_FUNC(...)				ZoneScoped##__VA_OPT__(N(__VA_ARGS__)); EPOCH_FRAME_PROFILE_ZONE(EPOCH_PROFILE_FIRST(__VA_ARGS__ __VA_OPT__(,) __FUNCTION__))
+#define EPOCH_PROFILE_SCOPE(NAME)			ZoneScoped; ZoneName(NAME, strlen(NAME)); EPOCH_FRAME_PROFILE_ZONE(NAME)
+// For zones that are registered at runtime, NAME is only read by Tracy and isn't copied
+#define EPOCH_PROFILE_SCOPE_ID(ID, NAME)	ZoneScoped; ZoneName(NAME.data(), NAME.size()); EPOCH_FRAME_PROFILE_ZONE_ID(ID)
 #else
 #define EPOCH_PROFILE_MARK_FRAME
-#define EPOCH_PROFILE_FUNC(...)
-#define EPOCH_PROFILE_SCOPE(NAME)
+#define EPOCH_PROFILE_FUNC(...)				EPOCH_FRAME_PROFILE_ZONE(EPOCH_PROFILE_FIRST(__VA_ARGS__ __VA_OPT__(,) __FUNCTION__))
+#define EPOCH_PROFILE_SCOPE(NAME)			EPOCH_FRAME_PROFILE_ZONE(NAME)
+#define EPOCH_PROFILE_SCOPE_ID(ID, NAME)	EPOCH_FRAME_PROFILE_ZONE_ID(ID)
 #endif
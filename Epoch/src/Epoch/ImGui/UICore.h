@@ -651,14 +651,14 @@ namespace Epoch::UI
 	}
 
 
-	static bool DrawFieldValue(std::shared_ptr<Scene> aSceneContext, const std::string& aFieldName, std::shared_ptr<FieldStorage> aStorage, const char* aTooltip = "")
+	static bool DrawFieldValue(std::shared_ptr<Scene> aSceneContext, const std::string& aFieldName, FieldStorage aStorage, const char* aTooltip = "")
 	{
 		if (!aStorage)
 		{
 			return false;
 		}
 
-		const FieldInfo* field = aStorage->GetFieldInfo();
+		const FieldInfo* field = aStorage.GetFieldInfo();
 
 		float min = 0.0f;
 		float max = 0.0f;
@@ -676,140 +676,140 @@ namespace Epoch::UI
 		{
 		case FieldType::Bool:
 		{
-			bool value = aStorage->GetValue<bool>();
+			bool value = aStorage.GetValue<bool>();
 			if (Property_Checkbox(aFieldName.c_str(), value, aTooltip))
 			{
-				aStorage->SetValue(value);
+				aStorage.SetValue(value);
 				result = true;
 			}
 			break;
 		}
 		case FieldType::Int32:
 		{
-			int32_t value = aStorage->GetValue<int32_t>();
+			int32_t value = aStorage.GetValue<int32_t>();
 			if (Property_DragInt(aFieldName.c_str(), value, 1, 0, 0, "%d", 0, aTooltip))
 			{
-				aStorage->SetValue(value);
+				aStorage.SetValue(value);
 				result = true;
 			}
 			break;
 		}
 		case FieldType::Float:
 		{
-			float value = aStorage->GetValue<float>();
+			float value = aStorage.GetValue<float>();
 			if (Property_DragFloat(aFieldName.c_str(), value, 0.1f, 0.0f, 0.0f, "%.3f", 0, aTooltip))
 			{
-				aStorage->SetValue(value);
+				aStorage.SetValue(value);
 				result = true;
 			}
 			break;
 		}
 		case FieldType::LayerMask:
 		{
-			uint32_t value = aStorage->GetValue<uint32_t>();
+			uint32_t value = aStorage.GetValue<uint32_t>();
 			if (Property_LayerMask(aFieldName.c_str(), value, aTooltip))
 			{
-				aStorage->SetValue(value);
+				aStorage.SetValue(value);
 				result = true;
 			}
 			break;
 		}
 		case FieldType::String:
 		{
-			std::string value = aStorage->GetValue<std::string>();
+			std::string value = aStorage.GetValue<std::string>();
 			if (Property_InputText(aFieldName.c_str(), value, 0, aTooltip))
 			{
-				aStorage->SetValue<std::string>(value);
+				aStorage.SetValue<std::string>(value);
 				result = true;
 			}
 			break;
 		}
 		case FieldType::Vector2:
 		{
-			CU::Vector2f value = aStorage->GetValue<CU::Vector2f>();
+			CU::Vector2f value = aStorage.GetValue<CU::Vector2f>();
 			if (Property_DragFloat2(aFieldName.c_str(), value, 0.1f, 0.0f, 0.0f, "%.3f", 0, aTooltip))
 			{
-				aStorage->SetValue(value);
+				aStorage.SetValue(value);
 				result = true;
 			}
 			break;
 		}
 		case FieldType::Vector3:
 		{
-			CU::Vector3f value = aStorage->GetValue<CU::Vector3f>();
+			CU::Vector3f value = aStorage.GetValue<CU::Vector3f>();
 			if (Property_DragFloat3(aFieldName.c_str(), value, 0.1f, 0.0f, 0.0f, "%.3f", 0, aTooltip))
 			{
-				aStorage->SetValue(value);
+				aStorage.SetValue(value);
 				result = true;
 			}
 			break;
 		}
 		case FieldType::Color:
 		{
-			CU::Color value = aStorage->GetValue<CU::Color>();
+			CU::Color value = aStorage.GetValue<CU::Color>();
 			if (Property_ColorEdit4(aFieldName.c_str(), value, aTooltip))
 			{
-				aStorage->SetValue(value);
+				aStorage.SetValue(value);
 				result = true;
 			}
 			break;
 		}
 		case FieldType::Scene:
 		{
-			AssetHandle handle = aStorage->GetValue<AssetHandle>();
+			AssetHandle handle = aStorage.GetValue<AssetHandle>();
 			if (Property_AssetReference<AssetType::Scene>(aFieldName.c_str(), handle, aTooltip, { true }))
 			{
-				aStorage->SetValue(handle);
+				aStorage.SetValue(handle);
 				result = true;
 			}
 			break;
 		}
 		case FieldType::Prefab:
 		{
-			AssetHandle handle = aStorage->GetValue<AssetHandle>();
+			AssetHandle handle = aStorage.GetValue<AssetHandle>();
 			if (Property_AssetReference<AssetType::Prefab>(aFieldName.c_str(), handle, aTooltip, { true }))
 			{
-				aStorage->SetValue(handle);
+				aStorage.SetValue(handle);
 				result = true;
 			}
 			break;
 		}
 		case FieldType::Material:
 		{
-			AssetHandle handle = aStorage->GetValue<AssetHandle>();
+			AssetHandle handle = aStorage.GetValue<AssetHandle>();
 			if (Property_AssetReference<AssetType::Material>(aFieldName.c_str(), handle, aTooltip, { true }))
 			{
-				aStorage->SetValue(handle);
+				aStorage.SetValue(handle);
 				result = true;
 			}
 			break;
 		}
 		case FieldType::Mesh:
 		{
-			AssetHandle handle = aStorage->GetValue<AssetHandle>();
+			AssetHandle handle = aStorage.GetValue<AssetHandle>();
 			if (Property_AssetReference<AssetType::Mesh>(aFieldName.c_str(), handle, aTooltip, { true }))
 			{
-				aStorage->SetValue(handle);
+				aStorage.SetValue(handle);
 				result = true;
 			}
 			break;
 		}
 		case FieldType::Texture2D:
 		{
-			AssetHandle handle = aStorage->GetValue<AssetHandle>();
+			AssetHandle handle = aStorage.GetValue<AssetHandle>();
 			if (Property_AssetReference<AssetType::Texture>(aFieldName.c_str(), handle, aTooltip, { true }))
 			{
-				aStorage->SetValue(handle);
+				aStorage.SetValue(handle);
 				result = true;
 			}
 			break;
 		}
 		case FieldType::Entity:
 		{
-			UUID uuid = aStorage->GetValue<UUID>();
+			UUID uuid = aStorage.GetValue<UUID>();
 			if (Property_EntityReference(aFieldName.c_str(), uuid, aSceneContext, aTooltip))
 			{
-				aStorage->SetValue(uuid);
+				aStorage.SetValue(uuid);
 				result = true;
 			}
 			break;
@@ -825,20 +825,20 @@ namespace Epoch::UI
 		return result;
 	}
 
-	static bool DrawFieldArray(std::shared_ptr<Scene> aSceneContext, const std::string& aFieldName, std::shared_ptr<ArrayFieldStorage> aStorage, const char* aTooltip = "")
+	static bool DrawFieldArray(std::shared_ptr<Scene> aSceneContext, const std::string& aFieldName, ArrayFieldStorage aStorage, const char* aTooltip = "")
 	{
 		if (!aStorage)
 		{
 			return false;
 		}
 
-		const FieldInfo* field = aStorage->GetFieldInfo();
+		const FieldInfo* field = aStorage.GetFieldInfo();
 
 		bool modified = false;
 
 		ImGui::PushID(aFieldName.c_str());
 
-		uint32_t length = aStorage->GetLength();
+		uint32_t length = aStorage.GetLength();
 		int tempLength = length;
 
 		if (UI::SubHeader(aFieldName.c_str(), false))
@@ -852,7 +852,7 @@ namespace Epoch::UI
 
 			if (UI::Property_InputInt("Length", tempLength, 1, 1, 0, INT32_MAX))
 			{
-				aStorage->Resize((uint32_t)tempLength);
+				aStorage.Resize((uint32_t)tempLength);
 				length = tempLength;
 				modified = true;
 			}
@@ -868,130 +868,130 @@ namespace Epoch::UI
 				{
 				case FieldType::Bool:
 				{
-					bool value = aStorage->GetValue<bool>(i);
+					bool value = aStorage.GetValue<bool>(i);
 					if (Property_Checkbox(indexString.c_str(), value, aTooltip))
 					{
-						aStorage->SetValue(i, value);
+						aStorage.SetValue(i, value);
 						modified = true;
 					}
 					break;
 				}
 				case FieldType::Int32:
 				{
-					int32_t value = aStorage->GetValue<int32_t>(i);
+					int32_t value = aStorage.GetValue<int32_t>(i);
 					if (Property_DragInt(indexString.c_str(), value, 1, 0, 0, "%d", 0, aTooltip))
 					{
-						aStorage->SetValue(i, value);
+						aStorage.SetValue(i, value);
 						modified = true;
 					}
 					break;
 				}
 				case FieldType::Float:
 				{
-					float value = aStorage->GetValue<float>(i);
+					float value = aStorage.GetValue<float>(i);
 					if (Property_DragFloat(indexString.c_str(), value, 0.1f, 0.0f, 0.0f, "%.3d", 0, aTooltip))
 					{
-						aStorage->SetValue(i, value);
+						aStorage.SetValue(i, value);
 						modified = true;
 					}
 					break;
 				}
 				case FieldType::String:
 				{
-					std::string value = aStorage->GetValue<std::string>(i);
+					std::string value = aStorage.GetValue<std::string>(i);
 					if (Property_InputText(indexString.c_str(), value, 0, aTooltip))
 					{
-						aStorage->SetValue<std::string>(i, value);
+						aStorage.SetValue<std::string>(i, value);
 						modified = true;
 					}
 					break;
 				}
 				case FieldType::Vector2:
 				{
-					CU::Vector2f value = aStorage->GetValue<CU::Vector2f>(i);
+					CU::Vector2f value = aStorage.GetValue<CU::Vector2f>(i);
 					if (Property_DragFloat2(indexString.c_str(), value, 0.1f, 0.0f, 0.0f, "%.3f", 0, aTooltip))
 					{
-						aStorage->SetValue(i, value);
+						aStorage.SetValue(i, value);
 						modified = true;
 					}
 					break;
 				}
 				case FieldType::Vector3:
 				{
-					CU::Vector3f value = aStorage->GetValue<CU::Vector3f>(i);
+					CU::Vector3f value = aStorage.GetValue<CU::Vector3f>(i);
 					if (Property_DragFloat3(indexString.c_str(), value, 0.1f, 0.0f, 0.0f, "%.3f", 0, aTooltip))
 					{
-						aStorage->SetValue(i, value);
+						aStorage.SetValue(i, value);
 						modified = true;
 					}
 					break;
 				}
 				case FieldType::Color:
 				{
-					CU::Color value = aStorage->GetValue<CU::Color>(i);
+					CU::Color value = aStorage.GetValue<CU::Color>(i);
 					if (Property_ColorEdit4(indexString.c_str(), value, aTooltip))
 					{
-						aStorage->SetValue(i, value);
+						aStorage.SetValue(i, value);
 						modified = true;
 					}
 					break;
 				}
 				case FieldType::Scene:
 				{
-					AssetHandle handle = aStorage->GetValue<AssetHandle>(i);
+					AssetHandle handle = aStorage.GetValue<AssetHandle>(i);
 					if (Property_AssetReference<AssetType::Scene>(indexString.c_str(), handle, aTooltip, { true }))
 					{
-						aStorage->SetValue(i, handle);
+						aStorage.SetValue(i, handle);
 						modified = true;
 					}
 					break;
 				}
 				case FieldType::Prefab:
 				{
-					AssetHandle handle = aStorage->GetValue<AssetHandle>(i);
+					AssetHandle handle = aStorage.GetValue<AssetHandle>(i);
 					if (Property_AssetReference<AssetType::Prefab>(indexString.c_str(), handle, aTooltip, { true }))
 					{
-						aStorage->SetValue(i, handle);
+						aStorage.SetValue(i, handle);
 						modified = true;
 					}
 					break;
 				}
 				case FieldType::Material:
 				{
-					AssetHandle handle = aStorage->GetValue<AssetHandle>(i);
+					AssetHandle handle = aStorage.GetValue<AssetHandle>(i);
 					if (Property_AssetReference<AssetType::Material>(indexString.c_str(), handle, aTooltip, { true }))
 					{
-						aStorage->SetValue(i, handle);
+						aStorage.SetValue(i, handle);
 						modified = true;
 					}
 					break;
 				}
 				case FieldType::Mesh:
 				{
-					AssetHandle handle = aStorage->GetValue<AssetHandle>(i);
+					AssetHandle handle = aStorage.GetValue<AssetHandle>(i);
 					if (Property_AssetReference<AssetType::Mesh>(indexString.c_str(), handle, aTooltip, { true }))
 					{
-						aStorage->SetValue(i, handle);
+						aStorage.SetValue(i, handle);
 						modified = true;
 					}
 					break;
 				}
 				case FieldType::Texture2D:
 				{
-					AssetHandle handle = aStorage->GetValue<AssetHandle>(i);
+					AssetHandle handle = aStorage.GetValue<AssetHandle>(i);
 					if (Property_AssetReference<AssetType::Texture>(indexString.c_str(), handle, aTooltip, { true }))
 					{
-						aStorage->SetValue(i, handle);
+						aStorage.SetValue(i, handle);
 						modified = true;
 					}
 					break;
 				}
 				case FieldType::Entity:
 				{
-					UUID uuid = aStorage->GetValue<UUID>(i);
+					UUID uuid = aStorage.GetValue<UUID>(i);
 					if (Property_EntityReference(indexString.c_str(), uuid, aSceneContext, aTooltip))
 					{
-						aStorage->SetValue(i, uuid);
+						aStorage.SetValue(i, uuid);
 						modified = true;
 					}
 					break;
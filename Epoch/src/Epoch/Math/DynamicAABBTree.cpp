@@ -0,0 +1,402 @@
+#include "epch.h"
+#include "DynamicAABBTree.h"
+#include <limits>
+
+namespace Epoch
+{
+	DynamicAABBTree::DynamicAABBTree(float aMargin) : myMargin(aMargin)
+	{
+	}
+
+	int32_t DynamicAABBTree::CreateProxy(const AABB& aAABB, uint32_t aUserData, uint32_t aCategory)
+	{
+		const int32_t proxyID = AllocateNode();
+
+		Node& node = myNodes[proxyID];
+		const CU::Vector3f margin = CU::Vector3f(myMargin, myMargin, myMargin);
+		node.aabb = AABB(aAABB.min - margin, aAABB.max + margin);
+		node.userData = aUserData;
+		node.category = aCategory;
+		node.height = 0;
+
+		InsertLeaf(proxyID);
+		myProxyCount++;
+
+		return proxyID;
+	}
+
+	void DynamicAABBTree::DestroyProxy(int32_t aProxyID)
+	{
+		EPOCH_ASSERT(aProxyID >= 0 && aProxyID < (int32_t)myNodes.size() && myNodes[aProxyID].IsLeaf(), "Invalid proxy!");
+
+		RemoveLeaf(aProxyID);
+		FreeNode(aProxyID);
+		myProxyCount--;
+	}
+
+	bool DynamicAABBTree::MoveProxy(int32_t aProxyID, const AABB& aAABB)
+	{
+		EPOCH_ASSERT(aProxyID >= 0 && aProxyID < (int32_t)myNodes.size() && myNodes[aProxyID].IsLeaf(), "Invalid proxy!");
+
+		const AABB& fatAABB = myNodes[aProxyID].aabb;
+		if (fatAABB.min.x <= aAABB.min.x && fatAABB.min.y <= aAABB.min.y && fatAABB.min.z <= aAABB.min.z &&
+			aAABB.max.x <= fatAABB.max.x && aAABB.max.y <= fatAABB.max.y && aAABB.max.z <= fatAABB.max.z)
+		{
+			return false;
+		}
+
+		RemoveLeaf(aProxyID);
+
+		const CU::Vector3f margin = CU::Vector3f(myMargin, myMargin, myMargin);
+		myNodes[aProxyID].aabb = AABB(aAABB.min - margin, aAABB.max + margin);
+
+		InsertLeaf(aProxyID);
+		return true;
+	}
+
+	void DynamicAABBTree::Clear()
+	{
+		myNodes.clear();
+		myRoot = NullNode;
+		myFreeList = NullNode;
+		myProxyCount = 0;
+	}
+
+	bool DynamicAABBTree::Overlaps(const AABB& aA, const AABB& aB)
+	{
+		return aA.min.x <= aB.max.x && aA.max.x >= aB.min.x &&
+			aA.min.y <= aB.max.y && aA.max.y >= aB.min.y &&
+			aA.min.z <= aB.max.z && aA.max.z >= aB.min.z;
+	}
+
+	bool DynamicAABBTree::Contains(const AABB& aAABB, const CU::Vector3f& aPoint)
+	{
+		return aPoint.x >= aAABB.min.x && aPoint.x <= aAABB.max.x &&
+			aPoint.y >= aAABB.min.y && aPoint.y <= aAABB.max.y &&
+			aPoint.z >= aAABB.min.z && aPoint.z <= aAABB.max.z;
+	}
+
+	bool DynamicAABBTree::SphereOverlaps(const AABB& aAABB, const CU::Vector3f& aCenter, float aRadius)
+	{
+		const CU::Vector3f closest
+		(
+			CU::Math::Clamp(aCenter.x, aAABB.min.x, aAABB.max.x),
+			CU::Math::Clamp(aCenter.y, aAABB.min.y, aAABB.max.y),
+			CU::Math::Clamp(aCenter.z, aAABB.min.z, aAABB.max.z)
+		);
+
+		return (closest - aCenter).LengthSqr() <= aRadius * aRadius;
+	}
+
+	bool DynamicAABBTree::FrustumOverlaps(const AABB& aAABB, const Frustum& aFrustum)
+	{
+		const CU::Vector3f center = aAABB.GetCenter();
+		const CU::Vector3f extents = aAABB.GetExtents();
+
+		for (const Frustum::Plane& plane : aFrustum.planes)
+		{
+			const float radius = extents.x * std::abs(plane.normal.x) + extents.y * std::abs(plane.normal.y) + extents.z * std::abs(plane.normal.z);
+			if (center.Dot(plane.normal) + plane.distance + radius < 0.0f)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool DynamicAABBTree::RayOverlaps(const AABB& aAABB, const CU::Vector3f& aOrigin, const CU::Vector3f& aInvDirection, float aMaxDistance, float& outDistance)
+	{
+		float tMin = -std::numeric_limits<float>::max();
+		float tMax = std::numeric_limits<float>::max();
+
+		auto clipSlab = [&tMin, &tMax](float aMin, float aMax, float aOrigin, float aInvDirection)
+			{
+				// A ray parallel to the slab is inside it everywhere or nowhere. Checked up front since an origin on one of
+				// the planes would otherwise give 0 * inf = NaN, which fails every comparison below.
+				if (std::isinf(aInvDirection))
+				{
+					return aOrigin >= aMin && aOrigin <= aMax;
+				}
+
+				const float t1 = (aMin - aOrigin) * aInvDirection;
+				const float t2 = (aMax - aOrigin) * aInvDirection;
+				tMin = CU::Math::Max(tMin, CU::Math::Min(t1, t2));
+				tMax = CU::Math::Min(tMax, CU::Math::Max(t1, t2));
+				return true;
+			};
+
+		if (!clipSlab(aAABB.min.x, aAABB.max.x, aOrigin.x, aInvDirection.x) ||
+			!clipSlab(aAABB.min.y, aAABB.max.y, aOrigin.y, aInvDirection.y) ||
+			!clipSlab(aAABB.min.z, aAABB.max.z, aOrigin.z, aInvDirection.z))
+		{
+			return false;
+		}
+
+		if (tMax < CU::Math::Max(tMin, 0.0f) || tMin > aMaxDistance)
+		{
+			return false;
+		}
+
+		outDistance = CU::Math::Max(tMin, 0.0f);
+		return true;
+	}
+
+	int32_t DynamicAABBTree::AllocateNode()
+	{
+		if (myFreeList == NullNode)
+		{
+			myNodes.emplace_back();
+			return (int32_t)myNodes.size() - 1;
+		}
+
+		const int32_t nodeID = myFreeList;
+		myFreeList = myNodes[nodeID].parent;
+		myNodes[nodeID] = Node();
+		return nodeID;
+	}
+
+	void DynamicAABBTree::FreeNode(int32_t aNodeID)
+	{
+		myNodes[aNodeID].parent = myFreeList;
+		myNodes[aNodeID].height = -1;
+		myNodes[aNodeID].child1 = NullNode;
+		myNodes[aNodeID].child2 = NullNode;
+		myFreeList = aNodeID;
+	}
+
+	void DynamicAABBTree::InsertLeaf(int32_t aLeaf)
+	{
+		if (myRoot == NullNode)
+		{
+			myRoot = aLeaf;
+			myNodes[myRoot].parent = NullNode;
+			return;
+		}
+
+		// Find the best sibling by walking down the cheapest branch, using the surface area as cost
+		const AABB leafAABB = myNodes[aLeaf].aabb;
+		int32_t index = myRoot;
+		while (!myNodes[index].IsLeaf())
+		{
+			const Node& node = myNodes[index];
+
+			const float area = SurfaceArea(node.aabb);
+			const float combinedArea = SurfaceArea(Union(node.aabb, leafAABB));
+
+			// Cost of creating a new parent for this node and the new leaf
+			const float cost = 2.0f * combinedArea;
+			// Minimum cost of pushing the leaf further down the tree
+			const float inheritanceCost = 2.0f * (combinedArea - area);
+
+			auto childCost = [&](int32_t aChild)
+				{
+					const Node& child = myNodes[aChild];
+					const float newArea = SurfaceArea(Union(child.aabb, leafAABB));
+					return child.IsLeaf() ? newArea + inheritanceCost : newArea - SurfaceArea(child.aabb) + inheritanceCost;
+				};
+
+			const float cost1 = childCost(node.child1);
+			const float cost2 = childCost(node.child2);
+
+			if (cost < cost1 && cost < cost2)
+			{
+				break;
+			}
+
+			index = cost1 < cost2 ? node.child1 : node.child2;
+		}
+
+		const int32_t sibling = index;
+		const int32_t oldParent = myNodes[sibling].parent;
+		const int32_t newParent = AllocateNode();
+
+		// AllocateNode can reallocate the node array, so nodes are only referenced after this point
+		myNodes[newParent].parent = oldParent;
+		myNodes[newParent].aabb = Union(leafAABB, myNodes[sibling].aabb);
+		myNodes[newParent].height = myNodes[sibling].height + 1;
+		myNodes[newParent].category = myNodes[sibling].category | myNodes[aLeaf].category;
+		myNodes[newParent].child1 = sibling;
+		myNodes[newParent].child2 = aLeaf;
+		myNodes[sibling].parent = newParent;
+		myNodes[aLeaf].parent = newParent;
+
+		if (oldParent != NullNode)
+		{
+			if (myNodes[oldParent].child1 == sibling)
+			{
+				myNodes[oldParent].child1 = newParent;
+			}
+			else
+			{
+				myNodes[oldParent].child2 = newParent;
+			}
+		}
+		else
+		{
+			myRoot = newParent;
+		}
+
+		RefitAncestors(myNodes[aLeaf].parent);
+	}
+
+	void DynamicAABBTree::RemoveLeaf(int32_t aLeaf)
+	{
+		if (aLeaf == myRoot)
+		{
+			myRoot = NullNode;
+			return;
+		}
+
+		const int32_t parent = myNodes[aLeaf].parent;
+		const int32_t grandParent = myNodes[parent].parent;
+		const int32_t sibling = myNodes[parent].child1 == aLeaf ? myNodes[parent].child2 : myNodes[parent].child1;
+
+		if (grandParent != NullNode)
+		{
+			if (myNodes[grandParent].child1 == parent)
+			{
+				myNodes[grandParent].child1 = sibling;
+			}
+			else
+			{
+				myNodes[grandParent].child2 = sibling;
+			}
+
+			myNodes[sibling].parent = grandParent;
+			FreeNode(parent);
+
+			RefitAncestors(grandParent);
+		}
+		else
+		{
+			myRoot = sibling;
+			myNodes[sibling].parent = NullNode;
+			FreeNode(parent);
+		}
+	}
+
+	void DynamicAABBTree::RefitAncestors(int32_t aNodeID)
+	{
+		int32_t index = aNodeID;
+		while (index != NullNode)
+		{
+			index = Balance(index);
+
+			Node& node = myNodes[index];
+			const Node& child1 = myNodes[node.child1];
+			const Node& child2 = myNodes[node.child2];
+
+			node.aabb = Union(child1.aabb, child2.aabb);
+			node.height = 1 + CU::Math::Max(child1.height, child2.height);
+			node.category = child1.category | child2.category;
+
+			index = node.parent;
+		}
+	}
+
+	// Rotates the subtree if its children differ in height by more than one, returns the new root of the subtree
+	int32_t DynamicAABBTree::Balance(int32_t aNodeID)
+	{
+		const int32_t iA = aNodeID;
+		Node& a = myNodes[iA];
+		if (a.IsLeaf() || a.height < 2)
+		{
+			return iA;
+		}
+
+		const int32_t iB = a.child1;
+		const int32_t iC = a.child2;
+		Node& b = myNodes[iB];
+		Node& c = myNodes[iC];
+
+		const int32_t balance = c.height - b.height;
+
+		auto rotate = [&](int32_t iUp, int32_t iOther, bool aUpIsChild2)
+			{
+				Node& up = myNodes[iUp];
+				Node& other = myNodes[iOther];
+
+				const int32_t iF = up.child1;
+				const int32_t iG = up.child2;
+				Node& f = myNodes[iF];
+				Node& g = myNodes[iG];
+
+				// Swap A and the promoted child
+				up.child1 = iA;
+				up.parent = a.parent;
+				a.parent = iUp;
+
+				if (up.parent != NullNode)
+				{
+					if (myNodes[up.parent].child1 == iA)
+					{
+						myNodes[up.parent].child1 = iUp;
+					}
+					else
+					{
+						myNodes[up.parent].child2 = iUp;
+					}
+				}
+				else
+				{
+					myRoot = iUp;
+				}
+
+				// Keep the taller grandchild under the promoted node
+				const bool keepF = f.height > g.height;
+				const int32_t iKeep = keepF ? iF : iG;
+				const int32_t iMove = keepF ? iG : iF;
+				Node& keep = myNodes[iKeep];
+				Node& move = myNodes[iMove];
+
+				up.child2 = iKeep;
+				if (aUpIsChild2)
+				{
+					a.child2 = iMove;
+				}
+				else
+				{
+					a.child1 = iMove;
+				}
+				move.parent = iA;
+
+				a.aabb = Union(other.aabb, move.aabb);
+				a.height = 1 + CU::Math::Max(other.height, move.height);
+				a.category = other.category | move.category;
+
+				up.aabb = Union(a.aabb, keep.aabb);
+				up.height = 1 + CU::Math::Max(a.height, keep.height);
+				up.category = a.category | keep.category;
+			};
+
+		if (balance > 1)
+		{
+			rotate(iC, iB, true);
+			return iC;
+		}
+
+		if (balance < -1)
+		{
+			rotate(iB, iC, false);
+			return iB;
+		}
+
+		return iA;
+	}
+
+	AABB DynamicAABBTree::Union(const AABB& aA, const AABB& aB)
+	{
+		return AABB
+		(
+			CU::Vector3f(CU::Math::Min(aA.min.x, aB.min.x), CU::Math::Min(aA.min.y, aB.min.y), CU::Math::Min(aA.min.z, aB.min.z)),
+			CU::Vector3f(CU::Math::Max(aA.max.x, aB.max.x), CU::Math::Max(aA.max.y, aB.max.y), CU::Math::Max(aA.max.z, aB.max.z))
+		);
+	}
+
+	float DynamicAABBTree::SurfaceArea(const AABB& aAABB)
+	{
+		const CU::Vector3f size = aAABB.max - aAABB.min;
+		return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+	}
+}
@@ -0,0 +1,198 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "AABB.h"
+#include "Frustum.h"
+
+namespace Epoch
+{
+	// Incrementally updated bounding volume hierarchy.
+	// Leaves store a fattened box so small movements don't require the proxy to be reinserted.
+	// Every proxy carries a category bit mask, queries only visit proxies matching the given mask.
+	// Query callbacks take the user data of the hit proxy and return false to stop the query.
+	// Queries only read the tree, so they can run from several threads at once as long as nothing modifies it meanwhile.
+	class DynamicAABBTree
+	{
+	public:
+		static constexpr int32_t NullNode = -1;
+		// A query stack never holds more than the height of the tree plus one, which stays far below this as the tree is kept balanced
+		static constexpr int32_t QueryStackSize = 256;
+
+		DynamicAABBTree(float aMargin = 10.0f);
+		~DynamicAABBTree() = default;
+
+		int32_t CreateProxy(const AABB& aAABB, uint32_t aUserData, uint32_t aCategory = 1);
+		void DestroyProxy(int32_t aProxyID);
+
+		// Returns true if the proxy left its fat box and was reinserted
+		bool MoveProxy(int32_t aProxyID, const AABB& aAABB);
+
+		uint32_t GetUserData(int32_t aProxyID) const { return myNodes[aProxyID].userData; }
+		uint32_t GetCategory(int32_t aProxyID) const { return myNodes[aProxyID].category; }
+		const AABB& GetFatAABB(int32_t aProxyID) const { return myNodes[aProxyID].aabb; }
+
+		uint32_t GetProxyCount() const { return myProxyCount; }
+		int32_t GetHeight() const { return myRoot == NullNode ? 0 : myNodes[myRoot].height; }
+
+		void Clear();
+
+		template<typename F>
+		void Query(const AABB& aAABB, uint32_t aCategoryMask, F&& aCallback) const
+		{
+			Traverse(aCategoryMask, [&aAABB](const AABB& aNodeAABB)
+				{
+					return Overlaps(aNodeAABB, aAABB);
+				}, aCallback);
+		}
+
+		template<typename F>
+		void QueryPoint(const CU::Vector3f& aPoint, uint32_t aCategoryMask, F&& aCallback) const
+		{
+			Traverse(aCategoryMask, [&aPoint](const AABB& aNodeAABB)
+				{
+					return Contains(aNodeAABB, aPoint);
+				}, aCallback);
+		}
+
+		template<typename F>
+		void QuerySphere(const CU::Vector3f& aCenter, float aRadius, uint32_t aCategoryMask, F&& aCallback) const
+		{
+			Traverse(aCategoryMask, [&aCenter, aRadius](const AABB& aNodeAABB)
+				{
+					return SphereOverlaps(aNodeAABB, aCenter, aRadius);
+				}, aCallback);
+		}
+
+		template<typename F>
+		void QueryFrustum(const Frustum& aFrustum, uint32_t aCategoryMask, F&& aCallback) const
+		{
+			Traverse(aCategoryMask, [&aFrustum](const AABB& aNodeAABB)
+				{
+					return FrustumOverlaps(aNodeAABB, aFrustum);
+				}, aCallback);
+		}
+
+		// The callback also gets the distance along the ray at which the fat box of the proxy is entered
+		template<typename F>
+		void QueryRay(const CU::Vector3f& aOrigin, const CU::Vector3f& aDirection, float aMaxDistance, uint32_t aCategoryMask, F&& aCallback) const
+		{
+			if (myRoot == NullNode)
+			{
+				return;
+			}
+
+			const CU::Vector3f invDirection = CU::Vector3f(1.0f / aDirection.x, 1.0f / aDirection.y, 1.0f / aDirection.z);
+
+			int32_t stack[QueryStackSize];
+			int32_t stackSize = 0;
+			stack[stackSize++] = myRoot;
+
+			while (stackSize > 0)
+			{
+				const int32_t nodeID = stack[--stackSize];
+
+				const Node& node = myNodes[nodeID];
+				if ((node.category & aCategoryMask) == 0)
+				{
+					continue;
+				}
+
+				float distance = 0.0f;
+				if (!RayOverlaps(node.aabb, aOrigin, invDirection, aMaxDistance, distance))
+				{
+					continue;
+				}
+
+				if (node.IsLeaf())
+				{
+					if (!aCallback(node.userData, distance))
+					{
+						return;
+					}
+				}
+				else
+				{
+					EPOCH_ASSERT(stackSize + 2 <= QueryStackSize, "Tree query stack overflow!");
+					stack[stackSize++] = node.child1;
+					stack[stackSize++] = node.child2;
+				}
+			}
+		}
+
+		static bool Overlaps(const AABB& aA, const AABB& aB);
+		static bool Contains(const AABB& aAABB, const CU::Vector3f& aPoint);
+		static bool SphereOverlaps(const AABB& aAABB, const CU::Vector3f& aCenter, float aRadius);
+		static bool FrustumOverlaps(const AABB& aAABB, const Frustum& aFrustum);
+		static bool RayOverlaps(const AABB& aAABB, const CU::Vector3f& aOrigin, const CU::Vector3f& aInvDirection, float aMaxDistance, float& outDistance);
+
+	private:
+		struct Node
+		{
+			AABB aabb;
+			int32_t parent = NullNode; // Next free node while the node is unused
+			int32_t child1 = NullNode;
+			int32_t child2 = NullNode;
+			int32_t height = -1; // -1 while the node is unused, 0 for leaves
+			uint32_t userData = 0;
+			uint32_t category = 0; // Union of the children for internal nodes
+
+			bool IsLeaf() const { return child1 == NullNode; }
+		};
+
+		template<typename Overlap, typename F>
+		void Traverse(uint32_t aCategoryMask, Overlap&& aOverlap, F&& aCallback) const
+		{
+			if (myRoot == NullNode)
+			{
+				return;
+			}
+
+			int32_t stack[QueryStackSize];
+			int32_t stackSize = 0;
+			stack[stackSize++] = myRoot;
+
+			while (stackSize > 0)
+			{
+				const int32_t nodeID = stack[--stackSize];
+
+				const Node& node = myNodes[nodeID];
+				if ((node.category & aCategoryMask) == 0 || !aOverlap(node.aabb))
+				{
+					continue;
+				}
+
+				if (node.IsLeaf())
+				{
+					if (!aCallback(node.userData))
+					{
+						return;
+					}
+				}
+				else
+				{
+					EPOCH_ASSERT(stackSize + 2 <= QueryStackSize, "Tree query stack overflow!");
+					stack[stackSize++] = node.child1;
+					stack[stackSize++] = node.child2;
+				}
+			}
+		}
+
+		int32_t AllocateNode();
+		void FreeNode(int32_t aNodeID);
+
+		void InsertLeaf(int32_t aLeaf);
+		void RemoveLeaf(int32_t aLeaf);
+		int32_t Balance(int32_t aNodeID);
+		void RefitAncestors(int32_t aNodeID);
+
+		static AABB Union(const AABB& aA, const AABB& aB);
+		static float SurfaceArea(const AABB& aAABB);
+
+	private:
+		std::vector<Node> myNodes;
+		int32_t myRoot = NullNode;
+		int32_t myFreeList = NullNode;
+		uint32_t myProxyCount = 0;
+		float myMargin;
+	};
+}
@@ -32,4 +32,36 @@ namespace Epoch
 
         return outputCorners;
     }
+
+	Frustum Frustum::CreateFromViewProjection(const CU::Matrix4x4f& aViewProjection, const CU::Vector2f& aMin, const CU::Vector2f& aMax)
+	{
+		// Clip space x is the dot product of the point with the first column, y with the second and so on.
+		// Keeping x above aMin.x * w gives the plane column1 - aMin.x * column4, the other planes follow the same way.
+		auto column = [&aViewProjection](int aColumn)
+			{
+				return CU::Vector4f(aViewProjection(1, aColumn), aViewProjection(2, aColumn), aViewProjection(3, aColumn), aViewProjection(4, aColumn));
+			};
+
+		const CU::Vector4f x = column(1);
+		const CU::Vector4f y = column(2);
+		const CU::Vector4f z = column(3);
+		const CU::Vector4f w = column(4);
+
+		Frustum frustum;
+		frustum.leftPlane = Plane(x - w * aMin.x);
+		frustum.rightPlane = Plane(w * aMax.x - x);
+		frustum.bottomPlane = Plane(y - w * aMin.y);
+		frustum.topPlane = Plane(w * aMax.y - y);
+		frustum.nearPlane = Plane(z);
+		frustum.farPlane = Plane(w - z);
+
+		for (Plane& plane : frustum.planes)
+		{
+			const float length = plane.normal.Length();
+			plane.normal /= length;
+			plane.distance /= length;
+		}
+
+		return frustum;
+	}
 }
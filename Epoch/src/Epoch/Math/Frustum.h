@@ -40,6 +40,10 @@ namespace Epoch
 			planes = { Plane() };
 		}
 
+		// The part of the view between two corners in normalized device coordinates, the whole view by default.
+		// Used for box selection, where the corners are those of the box on the screen.
+		static Frustum CreateFromViewProjection(const CU::Matrix4x4f& aViewProjection, const CU::Vector2f& aMin = { -1.0f, -1.0f }, const CU::Vector2f& aMax = { 1.0f, 1.0f });
+
 		//NOTE: Not working
 		static std::array<CU::Vector4f, 8> GetCorners(const CU::Matrix4x4f& aView, const CU::Matrix4x4f& aProj);
 	};
@@ -0,0 +1,328 @@
+#include "epch.h"
+#include "MeshBVH.h"
+#include "Epoch/Math/DynamicAABBTree.h"
+#include "Epoch/Rendering/Mesh.h"
+
+namespace Epoch
+{
+	// Median splits keep the depth at log2 of the leaf count, which is far below this for any mesh that fits in memory
+	static constexpr uint32_t MaxTraversalDepth = 64;
+
+	static float GetAxis(const CU::Vector3f& aVector, uint32_t aAxis)
+	{
+		return aAxis == 0 ? aVector.x : (aAxis == 1 ? aVector.y : aVector.z);
+	}
+
+	static void Grow(AABB& aBounds, const CU::Vector3f& aPoint)
+	{
+		aBounds.min.x = CU::Math::Min(aBounds.min.x, aPoint.x);
+		aBounds.min.y = CU::Math::Min(aBounds.min.y, aPoint.y);
+		aBounds.min.z = CU::Math::Min(aBounds.min.z, aPoint.z);
+		aBounds.max.x = CU::Math::Max(aBounds.max.x, aPoint.x);
+		aBounds.max.y = CU::Math::Max(aBounds.max.y, aPoint.y);
+		aBounds.max.z = CU::Math::Max(aBounds.max.z, aPoint.z);
+	}
+
+	static bool RayIntersectsTriangle(const CU::Vector3f& aOrigin, const CU::Vector3f& aDirection, const CU::Vector3f& aV0, const CU::Vector3f& aV1, const CU::Vector3f& aV2, float& outDistance)
+	{
+		// Moller-Trumbore
+		const CU::Vector3f edge1 = aV1 - aV0;
+		const CU::Vector3f edge2 = aV2 - aV0;
+
+		const CU::Vector3f p = aDirection.Cross(edge2);
+		const float determinant = edge1.Dot(p);
+		if (std::abs(determinant) < 1e-12f)
+		{
+			return false;
+		}
+
+		const float inverseDeterminant = 1.0f / determinant;
+
+		const CU::Vector3f s = aOrigin - aV0;
+		const float u = s.Dot(p) * inverseDeterminant;
+		if (u < 0.0f || u > 1.0f)
+		{
+			return false;
+		}
+
+		const CU::Vector3f q = s.Cross(edge1);
+		const float v = aDirection.Dot(q) * inverseDeterminant;
+		if (v < 0.0f || u + v > 1.0f)
+		{
+			return false;
+		}
+
+		outDistance = edge2.Dot(q) * inverseDeterminant;
+		return outDistance >= 0.0f;
+	}
+
+	static bool TriangleOverlaps(const Frustum& aFrustum, const CU::Vector3f& aV0, const CU::Vector3f& aV1, const CU::Vector3f& aV2)
+	{
+		for (const Frustum::Plane& plane : aFrustum.planes)
+		{
+			if (aV0.Dot(plane.normal) + plane.distance < 0.0f &&
+				aV1.Dot(plane.normal) + plane.distance < 0.0f &&
+				aV2.Dot(plane.normal) + plane.distance < 0.0f)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	static bool ContainedInFrustum(const AABB& aAABB, const Frustum& aFrustum)
+	{
+		const CU::Vector3f center = aAABB.GetCenter();
+		const CU::Vector3f extents = aAABB.GetExtents();
+
+		for (const Frustum::Plane& plane : aFrustum.planes)
+		{
+			const float radius = extents.x * std::abs(plane.normal.x) + extents.y * std::abs(plane.normal.y) + extents.z * std::abs(plane.normal.z);
+			if (center.Dot(plane.normal) + plane.distance - radius < 0.0f)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void MeshBVH::Build(const Vertex* aVertices, uint32_t aVertexCount, const uint32_t* aIndices, uint32_t aIndexCount)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		myNodes.clear();
+		myPositions.clear();
+
+		const AABB emptyBounds = AABB(CU::Vector3f(FLT_MAX, FLT_MAX, FLT_MAX), CU::Vector3f(-FLT_MAX, -FLT_MAX, -FLT_MAX));
+
+		std::vector<uint32_t> triangles;
+		std::vector<CU::Vector3f> centroids;
+		std::vector<AABB> triangleBounds;
+
+		const uint32_t triangleCount = aIndexCount / 3u;
+		triangles.reserve(triangleCount);
+		centroids.reserve(triangleCount);
+		triangleBounds.reserve(triangleCount);
+
+		for (uint32_t i = 0; i < triangleCount; i++)
+		{
+			const uint32_t* indices = &aIndices[i * 3];
+			if (indices[0] >= aVertexCount || indices[1] >= aVertexCount || indices[2] >= aVertexCount)
+			{
+				continue;
+			}
+
+			AABB& bounds = triangleBounds.emplace_back(emptyBounds);
+			Grow(bounds, aVertices[indices[0]].position);
+			Grow(bounds, aVertices[indices[1]].position);
+			Grow(bounds, aVertices[indices[2]].position);
+
+			centroids.push_back(bounds.GetCenter());
+			triangles.push_back(i);
+		}
+
+		if (triangles.empty())
+		{
+			return;
+		}
+
+		struct BuildRange
+		{
+			uint32_t node;
+			uint32_t begin;
+			uint32_t end;
+		};
+
+		// The ranges index into the order vector, which gets partitioned in place as the tree is built top down
+		std::vector<uint32_t> order(triangles.size());
+		for (uint32_t i = 0; i < (uint32_t)order.size(); i++)
+		{
+			order[i] = i;
+		}
+
+		myNodes.reserve(2 * (order.size() / MaxLeafTriangles + 1));
+		myNodes.emplace_back();
+
+		std::vector<BuildRange> stack;
+		stack.push_back({ 0, 0, (uint32_t)order.size() });
+
+		while (!stack.empty())
+		{
+			const BuildRange range = stack.back();
+			stack.pop_back();
+
+			AABB bounds = emptyBounds;
+			AABB centroidBounds = emptyBounds;
+			for (uint32_t i = range.begin; i < range.end; i++)
+			{
+				const AABB& triangle = triangleBounds[order[i]];
+				Grow(bounds, triangle.min);
+				Grow(bounds, triangle.max);
+				Grow(centroidBounds, centroids[order[i]]);
+			}
+
+			myNodes[range.node].bounds = bounds;
+
+			const uint32_t count = range.end - range.begin;
+			if (count <= MaxLeafTriangles)
+			{
+				myNodes[range.node].first = range.begin;
+				myNodes[range.node].triangleCount = count;
+				continue;
+			}
+
+			// Median split along the longest axis of the centroids, always balanced even for degenerate input
+			const CU::Vector3f extents = centroidBounds.GetExtents();
+			const uint32_t axis = extents.x >= extents.y && extents.x >= extents.z ? 0 : (extents.y >= extents.z ? 1 : 2);
+
+			const uint32_t middle = range.begin + count / 2;
+			std::nth_element(order.begin() + range.begin, order.begin() + middle, order.begin() + range.end, [&](uint32_t aLhs, uint32_t aRhs)
+				{
+					return GetAxis(centroids[aLhs], axis) < GetAxis(centroids[aRhs], axis);
+				});
+
+			const uint32_t left = (uint32_t)myNodes.size();
+			myNodes.emplace_back();
+			myNodes.emplace_back();
+			myNodes[range.node].first = left;
+
+			stack.push_back({ left, range.begin, middle });
+			stack.push_back({ left + 1, middle, range.end });
+		}
+
+		myPositions.resize(order.size() * 3);
+		for (size_t i = 0; i < order.size(); i++)
+		{
+			const uint32_t* indices = &aIndices[triangles[order[i]] * 3];
+			myPositions[i * 3 + 0] = aVertices[indices[0]].position;
+			myPositions[i * 3 + 1] = aVertices[indices[1]].position;
+			myPositions[i * 3 + 2] = aVertices[indices[2]].position;
+		}
+	}
+
+	bool MeshBVH::Raycast(const CU::Vector3f& aOrigin, const CU::Vector3f& aDirection, float aMaxDistance, float& outDistance) const
+	{
+		if (myNodes.empty())
+		{
+			return false;
+		}
+
+		const CU::Vector3f invDirection = CU::Vector3f(1.0f / aDirection.x, 1.0f / aDirection.y, 1.0f / aDirection.z);
+
+		float closestDistance = aMaxDistance;
+		bool hit = false;
+
+		float entryDistance = 0.0f;
+		if (!DynamicAABBTree::RayOverlaps(myNodes[0].bounds, aOrigin, invDirection, closestDistance, entryDistance))
+		{
+			return false;
+		}
+
+		// Nodes are pushed with the distance the ray enters them at, so they can be skipped once something closer was hit
+		std::pair<uint32_t, float> stack[MaxTraversalDepth];
+		uint32_t stackSize = 0;
+		stack[stackSize++] = { 0, entryDistance };
+
+		while (stackSize > 0)
+		{
+			const auto [nodeIndex, nodeDistance] = stack[--stackSize];
+			if (nodeDistance > closestDistance)
+			{
+				continue;
+			}
+
+			const Node& node = myNodes[nodeIndex];
+			if (node.IsLeaf())
+			{
+				for (uint32_t i = node.first; i < node.first + node.triangleCount; i++)
+				{
+					float distance = 0.0f;
+					if (RayIntersectsTriangle(aOrigin, aDirection, myPositions[i * 3 + 0], myPositions[i * 3 + 1], myPositions[i * 3 + 2], distance) && distance <= closestDistance)
+					{
+						closestDistance = distance;
+						hit = true;
+					}
+				}
+				continue;
+			}
+
+			float leftDistance = 0.0f;
+			float rightDistance = 0.0f;
+			const bool leftHit = DynamicAABBTree::RayOverlaps(myNodes[node.first].bounds, aOrigin, invDirection, closestDistance, leftDistance);
+			const bool rightHit = DynamicAABBTree::RayOverlaps(myNodes[node.first + 1].bounds, aOrigin, invDirection, closestDistance, rightDistance);
+
+			EPOCH_ASSERT(stackSize + 2 <= MaxTraversalDepth, "Mesh BVH is deeper than the traversal stack");
+
+			// The nearer child is pushed last so it's visited first
+			if (leftHit && rightHit)
+			{
+				const bool leftFirst = leftDistance <= rightDistance;
+				stack[stackSize++] = leftFirst ? std::make_pair(node.first + 1, rightDistance) : std::make_pair(node.first, leftDistance);
+				stack[stackSize++] = leftFirst ? std::make_pair(node.first, leftDistance) : std::make_pair(node.first + 1, rightDistance);
+			}
+			else if (leftHit)
+			{
+				stack[stackSize++] = { node.first, leftDistance };
+			}
+			else if (rightHit)
+			{
+				stack[stackSize++] = { node.first + 1, rightDistance };
+			}
+		}
+
+		if (hit)
+		{
+			outDistance = closestDistance;
+		}
+
+		return hit;
+	}
+
+	bool MeshBVH::Overlaps(const Frustum& aFrustum) const
+	{
+		if (myNodes.empty())
+		{
+			return false;
+		}
+
+		uint32_t stack[MaxTraversalDepth];
+		uint32_t stackSize = 0;
+		stack[stackSize++] = 0;
+
+		while (stackSize > 0)
+		{
+			const Node& node = myNodes[stack[--stackSize]];
+			if (!DynamicAABBTree::FrustumOverlaps(node.bounds, aFrustum))
+			{
+				continue;
+			}
+
+			// Every node holds at least one triangle, so a node entirely inside is a hit without looking further
+			if (ContainedInFrustum(node.bounds, aFrustum))
+			{
+				return true;
+			}
+
+			if (node.IsLeaf())
+			{
+				for (uint32_t i = node.first; i < node.first + node.triangleCount; i++)
+				{
+					if (TriangleOverlaps(aFrustum, myPositions[i * 3 + 0], myPositions[i * 3 + 1], myPositions[i * 3 + 2]))
+					{
+						return true;
+					}
+				}
+				continue;
+			}
+
+			EPOCH_ASSERT(stackSize + 2 <= MaxTraversalDepth, "Mesh BVH is deeper than the traversal stack");
+
+			stack[stackSize++] = node.first;
+			stack[stackSize++] = node.first + 1;
+		}
+
+		return false;
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "AABB.h"
+#include "Frustum.h"
+
+namespace Epoch
+{
+	struct Vertex;
+
+	// Static bounding volume hierarchy over the triangles of a submesh, built once from its vertex and index data.
+	// The triangles are copied in leaf order so every leaf is a contiguous range of positions.
+	// Queries are done in the space of the vertices, rays and frustums have to be transformed into it first.
+	class MeshBVH
+	{
+	public:
+		static constexpr uint32_t MaxLeafTriangles = 4;
+
+		MeshBVH() = default;
+		~MeshBVH() = default;
+
+		// The indices are relative to aVertices, like the indices of a submesh are relative to its base vertex
+		void Build(const Vertex* aVertices, uint32_t aVertexCount, const uint32_t* aIndices, uint32_t aIndexCount);
+
+		bool IsEmpty() const { return myNodes.empty(); }
+		uint32_t GetTriangleCount() const { return (uint32_t)myPositions.size() / 3u; }
+
+		// Closest triangle hit within aMaxDistance, both sides of the triangles are hit.
+		// The distance is in units of aDirection, so it stays the same through affine transforms of the ray.
+		bool Raycast(const CU::Vector3f& aOrigin, const CU::Vector3f& aDirection, float aMaxDistance, float& outDistance) const;
+		// Conservative, a triangle only counts as outside if all its corners are behind the same plane
+		bool Overlaps(const Frustum& aFrustum) const;
+
+	private:
+		struct Node
+		{
+			AABB bounds;
+			uint32_t first = 0; // First triangle for leaves, left child for internal nodes. The right child follows it.
+			uint32_t triangleCount = 0; // 0 for internal nodes
+
+			bool IsLeaf() const { return triangleCount > 0; }
+		};
+
+		std::vector<Node> myNodes;
+		std::vector<CU::Vector3f> myPositions;
+	};
+}
@@ -1,6 +1,6 @@
 #include "epch.h"
 #include "PhysXAPI.h"
-#include "Epoch/Core/JobSystem.h" 
+#include "Epoch/Core/Application.h"
 #include "PhysXScene.h"
 #include "Epoch/Assets/AssetManager.h"
 #include "Epoch/Physics/PhysicsMaterial.h"
@@ -11,7 +11,7 @@ namespace Epoch
 	{
 		EPOCH_PROFILE_FUNC();
 
-		myFoundation = PxCreateFoundation(PX_PHYSICS_VERSION, myDefaultAllocator, myDefaultErrorCallback);
+		myFoundation = PxCreateFoundation(PX_PHYSICS_VERSION, myAllocator, myDefaultErrorCallback);
 	
 		myTolerancesScale.length = 100;
 		myTolerancesScale.speed = 982;
@@ -22,7 +22,7 @@ namespace Epoch
 
 		myPhysicsSystem = PxCreatePhysics(PX_PHYSICS_VERSION, *myFoundation, myTolerancesScale, true, myPVD);
 
-		myDispatcher = physx::PxDefaultCpuDispatcherCreate(JobSystem::WorkerCount);
+		myDispatcher = std::make_unique<PhysXCpuDispatcher>(Application::Get().GetJobSystem());
 		myDefaultPhysicsMat = myPhysicsSystem->createMaterial(0.8f, 0.7f, 0.1f);
 	}
 
@@ -30,11 +30,13 @@ namespace Epoch
 	{
 		myPhysicsSystem->release();
 		myPhysicsSystem = nullptr;
+
+		myDispatcher.reset();
 	}
 
-	std::shared_ptr<PhysicsScene> PhysXAPI::CreateScene(Scene* aScene) const
+	std::shared_ptr<PhysicsScene> PhysXAPI::CreateScene(Scene* aScene, bool aDeferBodies) const
 	{
-		return std::make_shared<PhysXScene>(aScene);
+		return std::make_shared<PhysXScene>(aScene, aDeferBodies);
 	}
 
 	physx::PxMaterial* PhysXAPI::GetMaterial(AssetHandle aAssetHandle)
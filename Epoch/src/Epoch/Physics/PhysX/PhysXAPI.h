@@ -4,6 +4,8 @@
 #include <PxPhysics.h>
 #include <PxPhysicsAPI.h>
 #include <characterkinematic/PxControllerManager.h>
+#include "PhysXCpuDispatcher.h"
+#include "PhysXAllocator.h"
 
 namespace Epoch
 {
@@ -15,12 +17,12 @@ namespace Epoch
 		void Init() override;
 		void Shutdown() override;
 
-		std::shared_ptr<PhysicsScene> CreateScene(Scene* aScene) const override;
+		std::shared_ptr<PhysicsScene> CreateScene(Scene* aScene, bool aDeferBodies) const override;
 
 		physx::PxFoundation* GetFoundation() { return myFoundation; }
 		physx::PxPhysics* GetPhysicsSystem() { return myPhysicsSystem; }
 		physx::PxControllerManager* GetControllerManager() { return myControllerManager; }
-		physx::PxDefaultCpuDispatcher* GetDispatcher() { return myDispatcher; }
+		physx::PxCpuDispatcher* GetDispatcher() { return myDispatcher.get(); }
 
 		physx::PxMaterial* GetDefaultMaterial() { return myDefaultPhysicsMat; }
 		physx::PxMaterial* GetMaterial(AssetHandle aAssetHandle);
@@ -39,10 +41,10 @@ namespace Epoch
 		physx::PxControllerManager* myControllerManager;
 
 		physx::PxTolerancesScale myTolerancesScale;
-		physx::PxDefaultAllocator myDefaultAllocator;
+		PhysXAllocator myAllocator;
 		physx::PxDefaultErrorCallback myDefaultErrorCallback;
 
-		physx::PxDefaultCpuDispatcher* myDispatcher = nullptr;
+		std::unique_ptr<PhysXCpuDispatcher> myDispatcher;
 
 		physx::PxMaterial* myDefaultPhysicsMat = nullptr;
 		std::unordered_map<AssetHandle, physx::PxMaterial*> myMaterialMap;
@@ -0,0 +1,43 @@
+#pragma once
+#include <malloc.h>
+#include <foundation/PxAllocatorCallback.h>
+#include "Epoch/Debug/MemoryTracker.h"
+
+namespace Epoch
+{
+	// Hands PhysX 16 byte aligned memory and counts it under the physics memory tag
+	class PhysXAllocator : public physx::PxAllocatorCallback
+	{
+	public:
+		void* allocate(size_t size, const char* typeName, const char* filename, int line) override
+		{
+			Header* header = (Header*)_aligned_malloc(sizeof(Header) + size, 16);
+			if (header == nullptr)
+			{
+				return nullptr;
+			}
+
+			header->size = size;
+			MemoryTracker::RecordAllocation(MemoryTag::Physics, size);
+			return header + 1;
+		}
+
+		void deallocate(void* ptr) override
+		{
+			if (ptr == nullptr)
+			{
+				return;
+			}
+
+			Header* header = (Header*)ptr - 1;
+			MemoryTracker::RecordFree(MemoryTag::Physics, header->size);
+			_aligned_free(header);
+		}
+
+	private:
+		struct alignas(16) Header
+		{
+			uint64_t size;
+		};
+	};
+}
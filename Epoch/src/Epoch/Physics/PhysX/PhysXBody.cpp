@@ -11,6 +11,20 @@
 
 namespace Epoch
 {
+	static void ApplyInitialVelocity(physx::PxRigidDynamic* aBody, const RigidbodyComponent& aRigidbody, const CU::Transform& aWorldTransform)
+	{
+		const CU::Vector3f initialLinearVelocity = 
+			aWorldTransform.GetForward() * aRigidbody.initialLinearVelocity.z + 
+			aWorldTransform.GetRight() * aRigidbody.initialLinearVelocity.x + 
+			aWorldTransform.GetUp() * aRigidbody.initialLinearVelocity.y;
+
+		const CU::Matrix3x3f rotationMatrix = CU::Quatf(aWorldTransform.GetRotation()).GetRotationMatrix3x3();
+		const CU::Vector3f initialAngularVelocity = rotationMatrix * aRigidbody.initialAngularVelocity;
+
+		aBody->setAngularVelocity(PhysXUtils::ToPhysXVector(initialAngularVelocity));
+		aBody->setLinearVelocity(PhysXUtils::ToPhysXVector(initialLinearVelocity));
+	}
+
 	PhysXBody::PhysXBody(Entity aEntity) : PhysicsBody(aEntity)
 	{
 		CreateCollisionShapesForEntity(aEntity);
@@ -51,16 +65,7 @@ namespace Epoch
 			pxBody->setAngularDamping(rigidbodyComponent.angularDrag);
 			physx::PxRigidBodyExt::setMassAndUpdateInertia(*pxBody, rigidbodyComponent.mass);
 
-			const CU::Vector3f initialLinearVelocity = 
-				worldTransform.GetForward() * rigidbodyComponent.initialLinearVelocity.z + 
-				worldTransform.GetRight() * rigidbodyComponent.initialLinearVelocity.x + 
-				worldTransform.GetUp() * rigidbodyComponent.initialLinearVelocity.y;
-
-			const CU::Matrix3x3f rotationMatrix = CU::Quatf(worldTransform.GetRotation()).GetRotationMatrix3x3();
-			const CU::Vector3f initialAngularVelocity = rotationMatrix * rigidbodyComponent.initialAngularVelocity;
-
-			pxBody->setAngularVelocity(PhysXUtils::ToPhysXVector(initialAngularVelocity));
-			pxBody->setLinearVelocity(PhysXUtils::ToPhysXVector(initialLinearVelocity));
+			ApplyInitialVelocity(pxBody, rigidbodyComponent, worldTransform);
 
 			pxBody->setActorFlag(physx::PxActorFlag::eDISABLE_GRAVITY, !rigidbodyComponent.useGravity);
 
@@ -76,7 +81,8 @@ namespace Epoch
 		}
 
 		myActor->setName(myEntity.GetName().c_str());
-		myActor->userData = new UUID(myEntity.GetUUID());
+		myActorID = myEntity.GetUUID();
+		myActor->userData = &myActorID;
 	}
 
 	PhysXBody::~PhysXBody()
@@ -88,6 +94,23 @@ namespace Epoch
 		}
 	}
 
+	void PhysXBody::SetSimulationEnabled(bool aState)
+	{
+		myActor->setActorFlag(physx::PxActorFlag::eDISABLE_SIMULATION, !aState);
+
+		if (!aState || myIsStatic)
+		{
+			return;
+		}
+
+		// Re-enabled bodies start moving like freshly created ones
+		physx::PxRigidDynamic* pxBody = (physx::PxRigidDynamic*)myActor;
+		if (!(pxBody->getRigidBodyFlags() & physx::PxRigidBodyFlag::eKINEMATIC))
+		{
+			ApplyInitialVelocity(pxBody, myEntity.GetComponent<RigidbodyComponent>(), myEntity.GetWorldSpaceTransform());
+		}
+	}
+
 	float PhysXBody::GetMass()
 	{
 		return ((physx::PxRigidDynamic*)myActor)->getMass();
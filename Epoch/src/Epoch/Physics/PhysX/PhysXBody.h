@@ -9,6 +9,8 @@ namespace Epoch
 	public:
 		PhysXBody(Entity aEntity);
 		~PhysXBody() override;
+
+		void SetSimulationEnabled(bool aState) override;
 		
 		float GetMass() override;
 		void SetMass(float aMass) override;
@@ -46,6 +48,7 @@ namespace Epoch
 
 	private:
 		physx::PxActor* myActor = nullptr;
+		UUID myActorID = 0; // Pointed to by the actors user data
 
 		friend class PhysXScene;
 	};
@@ -0,0 +1,39 @@
+#pragma once
+#include "Epoch/Core/JobSystem.h"
+#include <task/PxCpuDispatcher.h>
+#include <task/PxTask.h>
+
+namespace Epoch
+{
+	// Runs the PhysX simulation tasks on the engine job system so physics doesn't spin up its own worker threads.
+	// The tasks go in the high priority lane, so a step isn't stuck behind asset loads and other long jobs.
+	class PhysXCpuDispatcher : public physx::PxCpuDispatcher
+	{
+	public:
+		PhysXCpuDispatcher(JobSystem& aJobSystem) : physx::PxCpuDispatcher(), myJobSystem(aJobSystem) { }
+
+		void submitTask(physx::PxBaseTask& task) override
+		{
+			// Without workers nothing would ever run the queued task and fetchResults would wait forever.
+			// Running it inline is what a PhysX dispatcher with no threads does.
+			if (JobSystem::WorkerCount == 0)
+			{
+				task.run();
+				task.release();
+				return;
+			}
+
+			physx::PxBaseTask* taskPtr = &task;
+			myJobSystem.AddAHighPriorityJob([taskPtr]()
+				{
+					taskPtr->run();
+					taskPtr->release();
+				});
+		}
+
+		uint32_t getWorkerCount() const override { return JobSystem::WorkerCount; }
+
+	private:
+		JobSystem& myJobSystem;
+	};
+}
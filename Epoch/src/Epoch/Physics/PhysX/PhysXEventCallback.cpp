@@ -1,86 +1,57 @@
 #include "epch.h"
 #include "PhysXEventCallback.h"
-#include "Epoch/Script/ScriptEngine.h"
 
 namespace Epoch
 {
-	void PhysXEventCallback::onContact(const physx::PxContactPairHeader& pairHeader, const physx::PxContactPair* pairs, physx::PxU32 nbPairs)
-	{
-		//TODO:: Loop through pairs?
-
-		if (pairs->events & physx::PxPairFlag::eNOTIFY_TOUCH_FOUND)
-		{
-			OnCollisionEnter(*(UUID*)pairHeader.actors[0]->userData, *(UUID*)pairHeader.actors[1]->userData);
-		}
-		else if (pairs->events & physx::PxPairFlag::eNOTIFY_TOUCH_LOST)
-		{
-			OnCollisionExit(*(UUID*)pairHeader.actors[0]->userData, *(UUID*)pairHeader.actors[1]->userData);
-		}
-	}
-
-	void PhysXEventCallback::onTrigger(physx::PxTriggerPair* pairs, physx::PxU32 count)
-	{
-		//TODO:: Loop through pairs?
-
-		if (pairs->status == physx::PxPairFlag::Enum::eNOTIFY_TOUCH_FOUND)
-		{
-			OnTriggerEnter(*(UUID*)pairs->otherActor->userData, *(UUID*)pairs->triggerActor->userData);
-		}
-		else
-		{
-			OnTriggerExit(*(UUID*)pairs->otherActor->userData, *(UUID*)pairs->triggerActor->userData);
-		}
-	}
+	// Events only carry the entity IDs, they are resolved once per entity when the events get dispatched after the simulation.
 
-	void PhysXEventCallback::OnCollisionEnter(UUID aBody1, UUID aBody2)
+	void PhysXEventCallback::onContact(const physx::PxContactPairHeader& pairHeader, const physx::PxContactPair* pairs, physx::PxU32 nbPairs)
 	{
-		Entity entity1 = ScriptEngine::GetSceneContext()->TryGetEntityWithUUID(aBody1);
-		Entity entity2 = ScriptEngine::GetSceneContext()->TryGetEntityWithUUID(aBody2);
-
-		if (!entity1 || !entity2)
+		if (pairHeader.flags & (physx::PxContactPairHeaderFlag::eREMOVED_ACTOR_0 | physx::PxContactPairHeaderFlag::eREMOVED_ACTOR_1))
 		{
 			return;
 		}
 
-		myEventCallback(PhysicsEventType::CollisionEnter, entity1, entity2);
-	}
-
-	void PhysXEventCallback::OnCollisionExit(UUID aBody1, UUID aBody2)
-	{
-		Entity entity1 = ScriptEngine::GetSceneContext()->TryGetEntityWithUUID(aBody1);
-		Entity entity2 = ScriptEngine::GetSceneContext()->TryGetEntityWithUUID(aBody2);
+		const UUID entityA = *(UUID*)pairHeader.actors[0]->userData;
+		const UUID entityB = *(UUID*)pairHeader.actors[1]->userData;
 
-		if (!entity1 || !entity2)
+		for (physx::PxU32 i = 0; i < nbPairs; ++i)
 		{
-			return;
-		}
+			const physx::PxContactPair& pair = pairs[i];
 
-		myEventCallback(PhysicsEventType::CollisionExit, entity1, entity2);
+			if (pair.events & physx::PxPairFlag::eNOTIFY_TOUCH_FOUND)
+			{
+				myEventCallback(PhysicsEventType::CollisionEnter, entityA, entityB);
+			}
+			else if (pair.events & physx::PxPairFlag::eNOTIFY_TOUCH_LOST)
+			{
+				myEventCallback(PhysicsEventType::CollisionExit, entityA, entityB);
+			}
+		}
 	}
 
-	void PhysXEventCallback::OnTriggerEnter(UUID aBody1, UUID aBody2)
+	void PhysXEventCallback::onTrigger(physx::PxTriggerPair* pairs, physx::PxU32 count)
 	{
-		Entity entity1 = ScriptEngine::GetSceneContext()->TryGetEntityWithUUID(aBody1);
-		Entity entity2 = ScriptEngine::GetSceneContext()->TryGetEntityWithUUID(aBody2);
-
-		if (!entity1 || !entity2)
+		for (physx::PxU32 i = 0; i < count; ++i)
 		{
-			return;
-		}
+			const physx::PxTriggerPair& pair = pairs[i];
 
-		myEventCallback(PhysicsEventType::TriggerEnter, entity1, entity2);
-	}
+			if (pair.flags & (physx::PxTriggerPairFlag::eREMOVED_SHAPE_TRIGGER | physx::PxTriggerPairFlag::eREMOVED_SHAPE_OTHER))
+			{
+				continue;
+			}
 
-	void PhysXEventCallback::OnTriggerExit(UUID aBody1, UUID aBody2)
-	{
-		Entity entity1 = ScriptEngine::GetSceneContext()->TryGetEntityWithUUID(aBody1);
-		Entity entity2 = ScriptEngine::GetSceneContext()->TryGetEntityWithUUID(aBody2);
+			const UUID otherEntity = *(UUID*)pair.otherActor->userData;
+			const UUID triggerEntity = *(UUID*)pair.triggerActor->userData;
 
-		if (!entity1 || !entity2)
-		{
-			return;
+			if (pair.status == physx::PxPairFlag::Enum::eNOTIFY_TOUCH_FOUND)
+			{
+				myEventCallback(PhysicsEventType::TriggerEnter, otherEntity, triggerEntity);
+			}
+			else
+			{
+				myEventCallback(PhysicsEventType::TriggerExit, otherEntity, triggerEntity);
+			}
 		}
-
-		myEventCallback(PhysicsEventType::TriggerExit, entity1, entity2);
 	}
 }
@@ -23,12 +23,6 @@ namespace Epoch
 
 		void onAdvance(const physx::PxRigidBody* const* bodyBuffer, const physx::PxTransform* poseBuffer, const physx::PxU32 count) override { }
 		
-	private:
-		void OnCollisionEnter(UUID aBody1, UUID aBody2);
-		void OnCollisionExit(UUID aBody1, UUID aBody2);
-		void OnTriggerEnter(UUID aBody1, UUID aBody2);
-		void OnTriggerExit(UUID aBody1, UUID aBody2);
-
 	private:
 		PhysicsEventCallbackFn myEventCallback;
 	};
@@ -1,5 +1,6 @@
 #include "epch.h"
 #include "PhysXScene.h"
+#include <atomic>
 #include "Epoch/Scene/Scene.h"
 #include "Epoch/Core/Application.h"
 #include "Epoch/Physics/PhysicsSystem.h"
@@ -12,13 +13,50 @@
 
 namespace Epoch
 {
-	PhysXScene::PhysXScene(Scene* aScene) : PhysicsScene(aScene)
+	namespace Utils
+	{
+		static physx::PxQueryFilterData GetQueryFilterData(LayerMask aLayerMask)
+		{
+			physx::PxQueryFilterData filterData;
+			if (aLayerMask.bitValue != 0)
+			{
+				filterData.flags |= physx::PxQueryFlag::Enum::ePREFILTER;
+				filterData.flags |= physx::PxQueryFlag::Enum::eDYNAMIC;
+				filterData.flags |= physx::PxQueryFlag::Enum::eSTATIC;
+				filterData.data.word0 = aLayerMask.bitValue;
+			}
+			return filterData;
+		}
+
+		static physx::PxGeometryHolder GetQueryGeometry(Physics::ShapeType aShape, const CU::Vector3f& aHalfExtent, float aRadius)
+		{
+			switch (aShape)
+			{
+			case Physics::ShapeType::Box: return physx::PxBoxGeometry(PhysXUtils::ToPhysXVector(aHalfExtent));
+			case Physics::ShapeType::Sphere: return physx::PxSphereGeometry(aRadius);
+			default:
+				// The script glue filters these out before the batch queries are dispatched to the job system
+				EPOCH_ASSERT(false, "Only boxes and spheres can be used for shape queries!");
+				return physx::PxSphereGeometry(aRadius);
+			}
+		}
+
+		static void FillHitInfo(HitInfo& outHit, const physx::PxLocationHit& aHit)
+		{
+			outHit.entity = *(uint64_t*)aHit.actor->userData;
+			outHit.position = PhysXUtils::FromPhysXVector(aHit.position);
+			outHit.normal = PhysXUtils::FromPhysXVector(aHit.normal);
+			outHit.distance = aHit.distance;
+		}
+	}
+
+	PhysXScene::PhysXScene(Scene* aScene, bool aDeferBodies) : PhysicsScene(aScene)
 	{
 		EPOCH_PROFILE_FUNC();
 
 		PhysXAPI* api = (PhysXAPI*)PhysicsSystem::GetAPI();
 
-		myEventCallback = std::make_unique<PhysXEventCallback>([this](PhysicsEventType aEventType, Entity aEntityA, Entity aEntityB)
+		myEventCallback = std::make_unique<PhysXEventCallback>([this](PhysicsEventType aEventType, UUID aEntityA, UUID aEntityB)
 			{
 				OnPhysicsEvent(aEventType, aEntityA, aEntityB);
 			});
@@ -28,6 +66,7 @@ namespace Epoch
 		sceneDesc.cpuDispatcher = api->GetDispatcher();
 		sceneDesc.filterShader = contactReportFilterShader;
 		sceneDesc.simulationEventCallback = myEventCallback.get();
+		sceneDesc.flags |= physx::PxSceneFlag::eENABLE_ACTIVE_ACTORS;
 
 		myScene = api->GetPhysicsSystem()->createScene(sceneDesc);
 
@@ -37,16 +76,32 @@ namespace Epoch
 
 		api->InitControllerManager(this);
 
-		CreatePhysicsBodies();
-		CreateCharacterControllers();
+		myOverlapHitBuffer.resize(MaxOverlapHits);
+
+		QueuePhysicsBodies();
+		if (!aDeferBodies)
+		{
+			CreateQueuedPhysicsBodies();
+		}
 	}
 
 	PhysXScene::~PhysXScene()
 	{
+		if (myIsSimulating)
+		{
+			myScene->fetchResults(true);
+			myIsSimulating = false;
+		}
 	}
 
 	void PhysXScene::Destroy()
 	{
+		if (myIsSimulating)
+		{
+			myScene->fetchResults(true);
+			myIsSimulating = false;
+		}
+
 		PhysXAPI* api = (PhysXAPI*)PhysicsSystem::GetAPI();
 		api->ClearMaterials();
 		api->DisconnectPVD();
@@ -57,65 +112,184 @@ namespace Epoch
 	{
 		EPOCH_PROFILE_FUNC();
 
+		// A step started last frame has been running alongside the rest of that frame, finish it first
+		if (myIsSimulating)
+		{
+			FetchResults();
+			PostSimulate();
+			SynchronizeTransforms();
+		}
+
 		SubStepStrategy();
 
 		PreSimulate();
 
-		bool sync = false;
-		for (size_t i = 0; i < mySubSteps; i++)
+		const bool async = PhysicsSystem::GetSettings().asyncSimulation && mySubSteps > 0;
+		const uint32_t blockingSubSteps = async ? mySubSteps - 1 : mySubSteps;
+
+		for (uint32_t i = 0; i < blockingSubSteps; i++)
 		{
-			for (auto& [id, pxController] : myCharacterControllers)
+			StartSimulation();
+			FetchResults();
+		}
+
+		if (blockingSubSteps > 0)
+		{
+			PostSimulate();
+			SynchronizeTransforms();
+		}
+
+		// Writes made before the step is fetched are buffered by PhysX and applied when the results are fetched
+		if (async)
+		{
+			StartSimulation();
+		}
+	}
+
+	void PhysXScene::StartSimulation()
+	{
+		for (auto& [id, pxController] : myCharacterControllers)
+		{
+			pxController->Simulate(PhysicsSystem::GetSettings().fixedTimestep);
+		}
+
+		EPOCH_PROFILE_SCOPE("PhysXSystem::Update");
+		myScene->simulate(PhysicsSystem::GetSettings().fixedTimestep);
+		myIsSimulating = true;
+	}
+
+	void PhysXScene::FetchResults()
+	{
+		{
+			EPOCH_PROFILE_SCOPE("PhysXScene::FetchResults");
+
+			// Runs the step's queued tasks here rather than waiting for a worker to finish whatever it is busy with
+			JobSystem& jobSystem = Application::Get().GetJobSystem();
+			while (!myScene->checkResults(false))
 			{
-				pxController->Simulate(PhysicsSystem::GetSettings().fixedTimestep);
+				if (!jobSystem.RunHighPriorityJob())
+				{
+					std::this_thread::yield();
+				}
 			}
 
+			mySyncPending |= myScene->fetchResults(true);
+			myIsSimulating = false;
+		}
+
+		BeginPoseSnapshots();
+
+		// Only actors that moved this step are synced back, sleeping bodies are left untouched
+		uint32_t activeActorCount = 0;
+		physx::PxActor** activeActors = myScene->getActiveActors(activeActorCount);
+		for (uint32_t actorIndex = 0; actorIndex < activeActorCount; actorIndex++)
+		{
+			if (!activeActors[actorIndex]->userData)
 			{
-				EPOCH_PROFILE_SCOPE("PhysXSystem::Update");
-				myScene->simulate(PhysicsSystem::GetSettings().fixedTimestep);
-				sync |= myScene->fetchResults(true);
+				continue;
 			}
 
-			PostSimulate();
+			const UUID id = *(UUID*)activeActors[actorIndex]->userData;
+			myActiveBodies.push_back(id);
+
+			const physx::PxTransform pose = ((physx::PxRigidActor*)activeActors[actorIndex])->getGlobalPose();
+			RecordPoseSnapshot(id, PhysXUtils::FromPhysXVector(pose.p), PhysXUtils::FromPhysXQuat(pose.q));
 		}
+	}
 
-		if (sync)
+	void PhysXScene::SynchronizeTransforms()
+	{
+		if (!mySyncPending)
 		{
-			EPOCH_PROFILE_SCOPE("PhysXScene::SynchronizeTransform");
+			myActiveBodies.clear();
+			return;
+		}
 
-			for (auto& [id, pxBody] : myDynamicPhysicsBodies)
+		EPOCH_PROFILE_SCOPE("PhysXScene::SynchronizeTransform");
+
+		// With interpolation the body transforms are written by ApplyInterpolatedTransforms instead
+		if (!PhysicsSystem::GetSettings().interpolateTransforms)
+		{
+			std::sort(myActiveBodies.begin(), myActiveBodies.end(), [](UUID aLhs, UUID aRhs) { return (uint64_t)aLhs < (uint64_t)aRhs; });
+			myActiveBodies.erase(std::unique(myActiveBodies.begin(), myActiveBodies.end(), [](UUID aLhs, UUID aRhs) { return (uint64_t)aLhs == (uint64_t)aRhs; }), myActiveBodies.end());
+
+			// Bodies are looked up after the script callbacks since those can destroy them.
+			// Character controllers are active actors too but are synced separately below.
+			myRootSyncEntities.clear();
+			myRootSyncPoses.clear();
+			myChildSyncEntities.clear();
+			myChildSyncPoses.clear();
+			for (UUID id : myActiveBodies)
 			{
+				auto bodyIt = myDynamicPhysicsBodies.find(id);
+				if (bodyIt == myDynamicPhysicsBodies.end())
+				{
+					continue;
+				}
+
 				Entity entity = mySceneContext->TryGetEntityWithUUID(id);
 				if (!entity)
 				{
 					continue;
 				}
 
-				physx::PxTransform pxTrans = ((physx::PxRigidDynamic*)(((PhysXBody*)pxBody.get())->myActor))->getGlobalPose();
-				
+				const physx::PxTransform pose = ((physx::PxRigidDynamic*)(((PhysXBody*)bodyIt->second.get())->myActor))->getGlobalPose();
+				if (entity.HasParent())
+				{
+					myChildSyncEntities.push_back(entity);
+					myChildSyncPoses.push_back(pose);
+				}
+				else
+				{
+					myRootSyncEntities.push_back(entity);
+					myRootSyncPoses.push_back(pose);
+				}
+			}
+
+			// Root bodies only write to their own transform component so they can be synced in parallel
+			Application::Get().GetJobSystem().ParallelFor((uint32_t)myRootSyncEntities.size(), SyncBatchSize, [this](uint32_t aBegin, uint32_t aEnd)
+				{
+					for (uint32_t i = aBegin; i < aEnd; i++)
+					{
+						const physx::PxTransform& pose = myRootSyncPoses[i];
+						auto& transComp = myRootSyncEntities[i].GetComponent<TransformComponent>();
+						transComp.transform.SetTranslation(PhysXUtils::FromPhysXVector(pose.p));
+						transComp.transform.SetRotation(PhysXUtils::FromPhysXQuat(pose.q).GetEulerAngles());
+					}
+				});
+
+			// Converting to local space reads the parent chain, keep it on this thread
+			for (size_t i = 0; i < myChildSyncEntities.size(); i++)
+			{
+				Entity entity = myChildSyncEntities[i];
+				const physx::PxTransform& pose = myChildSyncPoses[i];
 				auto& transComp = entity.GetComponent<TransformComponent>();
-				const CU::Vector3f orgScale = entity.Transform().GetScale();
-				transComp.transform.SetTranslation(PhysXUtils::FromPhysXVector(pxTrans.p));
-				transComp.transform.SetRotation(PhysXUtils::FromPhysXQuat(pxTrans.q).GetEulerAngles());
+				const CU::Vector3f orgScale = transComp.transform.GetScale();
+				transComp.transform.SetTranslation(PhysXUtils::FromPhysXVector(pose.p));
+				transComp.transform.SetRotation(PhysXUtils::FromPhysXQuat(pose.q).GetEulerAngles());
 
 				mySceneContext->ConvertToLocalSpace(entity);
 				transComp.transform.SetScale(orgScale);
 			}
+		}
 
-			for (auto& [id, pxController] : myCharacterControllers)
+		for (auto& [id, pxController] : myCharacterControllers)
+		{
+			Entity entity = mySceneContext->TryGetEntityWithUUID(id);
+			if (!entity)
 			{
-				Entity entity = mySceneContext->TryGetEntityWithUUID(id);
-				if (!entity)
-				{
-					continue;
-				}
-
-				const auto& ccComponent = entity.GetComponent<CharacterControllerComponent>();
-				const physx::PxExtendedVec3 position = ((PhysXCharacterController*)pxController.get())->GetCharacterController()->getPosition();
-				auto& transComp = entity.GetComponent<TransformComponent>();
-				const CU::Vector3f newPos = CU::Vector3f((float)position.x, (float)position.y, (float)position.z) - ccComponent.offset;
-				transComp.transform.SetTranslation(newPos);
+				continue;
 			}
+
+			const auto& ccComponent = entity.GetComponent<CharacterControllerComponent>();
+			const physx::PxExtendedVec3 position = ((PhysXCharacterController*)pxController.get())->GetCharacterController()->getPosition();
+			auto& transComp = entity.GetComponent<TransformComponent>();
+			const CU::Vector3f newPos = CU::Vector3f((float)position.x, (float)position.y, (float)position.z) - ccComponent.offset;
+			transComp.transform.SetTranslation(newPos);
 		}
+
+		myActiveBodies.clear();
+		mySyncPending = false;
 	}
 
 	std::shared_ptr<PhysicsBody> Epoch::PhysXScene::CreateBody(Entity aEntity)
@@ -138,6 +312,9 @@ namespace Epoch
 		else
 		{
 			myDynamicPhysicsBodies[aEntity.GetUUID()] = physicsBody;
+
+			const physx::PxTransform pose = ((physx::PxRigidActor*)physicsBody->myActor)->getGlobalPose();
+			AddPoseSnapshot(aEntity.GetUUID(), PhysXUtils::FromPhysXVector(pose.p), PhysXUtils::FromPhysXQuat(pose.q));
 		}
 
 		if (!myScene->addActor(*physicsBody->myActor))
@@ -156,6 +333,7 @@ namespace Epoch
 		else if (auto it = myDynamicPhysicsBodies.find(aEntity.GetUUID()); it != myDynamicPhysicsBodies.end())
 		{
 			myDynamicPhysicsBodies.erase(it);
+			RemovePoseSnapshot(aEntity.GetUUID());
 		}
 	}
 
@@ -303,21 +481,21 @@ namespace Epoch
 		physx::PxTransform shapePose = physx::PxTransform(PhysXUtils::ToPhysXVector(aShapeOverlapInfo->origin));
 
 		int numberOfHits = 0;
-		std::unique_ptr<physx::PxOverlapHit[]> hitOv = std::make_unique<physx::PxOverlapHit[]>(4096);
+		physx::PxOverlapHit* hitOv = myOverlapHitBuffer.data();
 		switch (aShapeOverlapInfo->GetShapeType())
 		{
 		case Physics::ShapeType::Box:
 		{
 			const auto* boxOverlapInfo = reinterpret_cast<const BoxOverlapInfo*>(aShapeOverlapInfo);
 			physx::PxBoxGeometry shape = physx::PxBoxGeometry(boxOverlapInfo->halfExtent);
-			numberOfHits = physx::PxSceneQueryExt::overlapMultiple(*myScene, shape, shapePose, hitOv.get(), 4096);
+			numberOfHits = physx::PxSceneQueryExt::overlapMultiple(*myScene, shape, shapePose, hitOv, MaxOverlapHits);
 			break;
 		}
 		case Physics::ShapeType::Sphere:
 		{
 			const auto* sphereOverlapInfo = reinterpret_cast<const SphereOverlapInfo*>(aShapeOverlapInfo);
 			physx::PxSphereGeometry shape = physx::PxSphereGeometry(sphereOverlapInfo->radius);
-			numberOfHits = physx::PxSceneQueryExt::overlapMultiple(*myScene, shape, shapePose, hitOv.get(), 4096);
+			numberOfHits = physx::PxSceneQueryExt::overlapMultiple(*myScene, shape, shapePose, hitOv, MaxOverlapHits);
 			break;
 		}
 		default:
@@ -326,6 +504,7 @@ namespace Epoch
 		}
 
 		std::vector<UUID> overlapHitBuffer;
+		overlapHitBuffer.reserve(numberOfHits);
 		for (size_t i = 0; i < numberOfHits; i++)
 		{
 			const physx::PxOverlapHit& hit = hitOv[i];
@@ -336,9 +515,121 @@ namespace Epoch
 		return overlapHitBuffer;
 	}
 
+	uint32_t PhysXScene::RaycastBatch(const RaycastQuery* aQueries, uint32_t aQueryCount, HitInfo* outHits)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		std::atomic<uint32_t> hitCount = 0;
+
+		Application::Get().GetJobSystem().ParallelFor(aQueryCount, QueryBatchSize, [&](uint32_t aBegin, uint32_t aEnd)
+			{
+				uint32_t batchHits = 0;
+				for (uint32_t i = aBegin; i < aEnd; ++i)
+				{
+					const RaycastQuery& query = aQueries[i];
+					HitInfo& outHit = outHits[i];
+
+					physx::PxRaycastBuffer hitInfo;
+					const physx::PxQueryFilterData filterData = Utils::GetQueryFilterData(query.layerMask);
+					if (myScene->raycast(PhysXUtils::ToPhysXVector(query.origin), PhysXUtils::ToPhysXVector(query.direction), query.maxDistance, hitInfo, physx::PxHitFlag::ePOSITION | physx::PxHitFlag::eNORMAL, filterData))
+					{
+						Utils::FillHitInfo(outHit, hitInfo.block);
+						++batchHits;
+					}
+					else
+					{
+						outHit = HitInfo();
+					}
+				}
+				hitCount += batchHits;
+			});
+
+		return hitCount;
+	}
+
+	uint32_t PhysXScene::ShapeCastBatch(const ShapeCastQuery* aQueries, uint32_t aQueryCount, HitInfo* outHits)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		std::atomic<uint32_t> hitCount = 0;
+
+		Application::Get().GetJobSystem().ParallelFor(aQueryCount, QueryBatchSize, [&](uint32_t aBegin, uint32_t aEnd)
+			{
+				uint32_t batchHits = 0;
+				for (uint32_t i = aBegin; i < aEnd; ++i)
+				{
+					const ShapeCastQuery& query = aQueries[i];
+					HitInfo& outHit = outHits[i];
+
+					const physx::PxGeometryHolder shape = Utils::GetQueryGeometry(query.shape, query.halfExtent, query.radius);
+					const physx::PxTransform initialPose = physx::PxTransform(PhysXUtils::ToPhysXVector(query.origin));
+					const physx::PxQueryFilterData filterData = Utils::GetQueryFilterData(query.layerMask);
+
+					physx::PxSweepHit hitInfo;
+					if (physx::PxSceneQueryExt::sweepSingle(*myScene, shape.any(), initialPose, PhysXUtils::ToPhysXVector(query.direction), query.maxDistance, physx::PxHitFlag::ePOSITION | physx::PxHitFlag::eNORMAL | physx::PxHitFlag::eMTD, hitInfo, filterData))
+					{
+						Utils::FillHitInfo(outHit, hitInfo);
+						++batchHits;
+					}
+					else
+					{
+						outHit = HitInfo();
+					}
+				}
+				hitCount += batchHits;
+			});
+
+		return hitCount;
+	}
+
+	uint32_t PhysXScene::OverlapShapeBatch(const ShapeOverlapQuery* aQueries, uint32_t aQueryCount, UUID* outHits, uint32_t* outHitCounts, uint32_t aMaxHitsPerQuery)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		if (aMaxHitsPerQuery == 0)
+		{
+			memset(outHitCounts, 0, sizeof(uint32_t) * aQueryCount);
+			return 0;
+		}
+
+		std::atomic<uint32_t> hitCount = 0;
+
+		Application::Get().GetJobSystem().ParallelFor(aQueryCount, QueryBatchSize, [&](uint32_t aBegin, uint32_t aEnd)
+			{
+				std::vector<physx::PxOverlapHit> hitBuffer(aMaxHitsPerQuery);
+
+				uint32_t batchHits = 0;
+				for (uint32_t i = aBegin; i < aEnd; ++i)
+				{
+					const ShapeOverlapQuery& query = aQueries[i];
+
+					const physx::PxGeometryHolder shape = Utils::GetQueryGeometry(query.shape, query.halfExtent, query.radius);
+					const physx::PxTransform shapePose = physx::PxTransform(PhysXUtils::ToPhysXVector(query.origin));
+					const physx::PxQueryFilterData filterData = Utils::GetQueryFilterData(query.layerMask);
+
+					const physx::PxI32 numberOfHits = physx::PxSceneQueryExt::overlapMultiple(*myScene, shape.any(), shapePose, hitBuffer.data(), aMaxHitsPerQuery, filterData);
+					// A negative hit count means the buffer overflowed and is completely filled
+					const uint32_t queryHits = numberOfHits < 0 ? aMaxHitsPerQuery : (uint32_t)numberOfHits;
+
+					UUID* queryOutHits = outHits + (size_t)i * aMaxHitsPerQuery;
+					for (uint32_t j = 0; j < queryHits; ++j)
+					{
+						queryOutHits[j] = *(UUID*)hitBuffer[j].actor->userData;
+					}
+
+					outHitCounts[i] = queryHits;
+					batchHits += queryHits;
+				}
+				hitCount += batchHits;
+			});
+
+		return hitCount;
+	}
+
 	void PhysXScene::Teleport(Entity aEntity, const CU::Vector3f& aTargetPosition, const CU::Quatf& aTargetRotation)
 	{
 		auto body = std::static_pointer_cast<PhysXBody>(GetPhysicsBody(aEntity));
 		((physx::PxRigidActor*)body->myActor)->setGlobalPose({ PhysXUtils::ToPhysXVector(aTargetPosition), PhysXUtils::ToPhysXQuat(aTargetRotation) });
+		RecordPoseSnapshot(aEntity.GetUUID(), aTargetPosition, aTargetRotation, true);
 	}
 }
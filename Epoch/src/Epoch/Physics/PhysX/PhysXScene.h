@@ -10,7 +10,7 @@ namespace Epoch
 	class PhysXScene : public PhysicsScene
 	{
 	public:
-		PhysXScene(Scene* aScene);
+		PhysXScene(Scene* aScene, bool aDeferBodies = false);
 		~PhysXScene() override;
 
 		void Destroy() override;
@@ -30,11 +30,36 @@ namespace Epoch
 		bool CheckShape(const ShapeOverlapInfo* aShapeOverlapInfo, LayerMask* aLayerMask = nullptr) override;
 		std::vector<UUID> OverlapShape(const ShapeOverlapInfo* aShapeOverlapInfo) override;
 
+		uint32_t RaycastBatch(const RaycastQuery* aQueries, uint32_t aQueryCount, HitInfo* outHits) override;
+		uint32_t ShapeCastBatch(const ShapeCastQuery* aQueries, uint32_t aQueryCount, HitInfo* outHits) override;
+		uint32_t OverlapShapeBatch(const ShapeOverlapQuery* aQueries, uint32_t aQueryCount, UUID* outHits, uint32_t* outHitCounts, uint32_t aMaxHitsPerQuery) override;
+
 		void Teleport(Entity aEntity, const CU::Vector3f& aTargetPosition, const CU::Quatf& aTargetRotation) override;
 
 	private:
+		void StartSimulation();
+		void FetchResults();
+		void SynchronizeTransforms();
+
+	private:
+		static constexpr uint32_t MaxOverlapHits = 4096;
+		static constexpr uint32_t QueryBatchSize = 256;
+		static constexpr uint32_t SyncBatchSize = 256;
+
 		physx::PxScene* myScene = nullptr;
 
+		bool myIsSimulating = false;
+		bool mySyncPending = false;
+
+		std::vector<physx::PxOverlapHit> myOverlapHitBuffer;
+
+		std::vector<UUID> myActiveBodies;
+		// The bodies to sync and their poses in parallel arrays, the pose gather and the transform writes each walk one array at a time
+		std::vector<Entity> myRootSyncEntities;
+		std::vector<physx::PxTransform> myRootSyncPoses;
+		std::vector<Entity> myChildSyncEntities;
+		std::vector<physx::PxTransform> myChildSyncPoses;
+
 		std::unique_ptr<PhysXEventCallback> myEventCallback;
 	};
 }
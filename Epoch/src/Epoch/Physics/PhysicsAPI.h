@@ -13,7 +13,7 @@ namespace Epoch
 		virtual void Init() = 0;
 		virtual void Shutdown() = 0;
 
-		virtual std::shared_ptr<PhysicsScene> CreateScene(Scene* aScene) const = 0;
+		virtual std::shared_ptr<PhysicsScene> CreateScene(Scene* aScene, bool aDeferBodies) const = 0;
 		
 		static PhysicsAPIType Current() { return staticCurrentPhysicsAPI; }
 		static void SetCurrentAPI(PhysicsAPIType aApi) { staticCurrentPhysicsAPI = aApi; }
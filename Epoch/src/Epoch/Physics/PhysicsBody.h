@@ -13,6 +13,9 @@ namespace Epoch
 		bool IsValid() const { return myShapes.size() > 0; }
 		bool IsStatic() const { return myIsStatic; }
 
+		// Disabled bodies stay in the scene but are neither simulated nor hit by queries
+		virtual void SetSimulationEnabled(bool aState) = 0;
+
 		virtual float GetMass() = 0;
 		virtual void SetMass(float aMass) = 0;
 		
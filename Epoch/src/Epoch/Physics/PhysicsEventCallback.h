@@ -1,9 +1,9 @@
 #pragma once
 #include <functional>
-#include "Epoch/Scene/Entity.h"
+#include "Epoch/Core/UUID.h"
 
 namespace Epoch
 {
 	enum class PhysicsEventType : int8_t { None = -1, CollisionEnter, CollisionExit, TriggerEnter, TriggerExit };
-	using PhysicsEventCallbackFn = std::function<void(PhysicsEventType, Entity, Entity)>;
+	using PhysicsEventCallbackFn = std::function<void(PhysicsEventType, UUID, UUID)>;
 }
@@ -3,6 +3,7 @@
 #include <CommonUtilities/Timer.h>
 #include "Epoch/Scene/Scene.h"
 #include "Epoch/Script/ScriptEngine.h"
+#include "Epoch/Core/Application.h"
 
 namespace Epoch
 {
@@ -65,7 +66,42 @@ namespace Epoch
 		}
 	}
 
-	void PhysicsScene::CreatePhysicsBodies()
+	bool PhysicsScene::CreateQueuedPhysicsBodies(float aBudgetMilliseconds)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		Timer timer;
+
+		while (myCreatedBodyCount < (uint32_t)myQueuedBodies.size())
+		{
+			if (Entity entity = mySceneContext->TryGetEntityWithUUID(myQueuedBodies[myCreatedBodyCount++]))
+			{
+				CreateBody(entity);
+			}
+
+			if (timer.ElapsedMillis() >= aBudgetMilliseconds)
+			{
+				return false;
+			}
+		}
+
+		while (myCreatedCharacterControllerCount < (uint32_t)myQueuedCharacterControllers.size())
+		{
+			if (Entity entity = mySceneContext->TryGetEntityWithUUID(myQueuedCharacterControllers[myCreatedCharacterControllerCount++]))
+			{
+				CreateCharacterController(entity);
+			}
+
+			if (timer.ElapsedMillis() >= aBudgetMilliseconds)
+			{
+				break;
+			}
+		}
+
+		return myCreatedCharacterControllerCount == (uint32_t)myQueuedCharacterControllers.size();
+	}
+
+	void PhysicsScene::QueuePhysicsBodies()
 	{
 		EPOCH_PROFILE_FUNC();
 		
@@ -104,12 +140,8 @@ namespace Epoch
 			}
 		}
 
-		
-		for (UUID entityID : compoundedEntities)
-		{
-			Entity entity = mySceneContext->GetEntityWithUUID(entityID);
-			CreateBody(entity);
-		}
+		// Compound bodies pick up the colliders of their children, so they are created first and the children skipped
+		myQueuedBodies = std::move(compoundedEntities);
 
 		for (UUID entityID : other)
 		{
@@ -118,17 +150,13 @@ namespace Epoch
 				continue;
 			}
 
-			Entity entity = mySceneContext->GetEntityWithUUID(entityID);
-			CreateBody(entity);
+			myQueuedBodies.push_back(entityID);
 		}
-	}
 
-	void PhysicsScene::CreateCharacterControllers()
-	{
-		EPOCH_PROFILE_FUNC();
+		myQueuedCharacterControllers.clear();
 
-		auto view = mySceneContext->GetAllEntitiesWith<CharacterControllerComponent>();
-		for (auto enttID : view)
+		auto characterControllerView = mySceneContext->GetAllEntitiesWith<CharacterControllerComponent>();
+		for (auto enttID : characterControllerView)
 		{
 			Entity entity = { enttID, mySceneContext };
 
@@ -137,8 +165,11 @@ namespace Epoch
 				continue;
 			}
 
-			CreateCharacterController(entity);
+			myQueuedCharacterControllers.push_back(entity.GetUUID());
 		}
+
+		myCreatedBodyCount = 0;
+		myCreatedCharacterControllerCount = 0;
 	}
 
 	void PhysicsScene::PreSimulate()
@@ -151,12 +182,12 @@ namespace Epoch
 			EPOCH_PROFILE_SCOPE("Scene::OnFixedUpdate - C# OnUpdate");
 			Timer timer;
 
-			auto entities = mySceneContext->GetAllEntitiesWith<ScriptComponent>();
+			auto entities = mySceneContext->GetAllActiveEntitiesWith<ScriptComponent>();
 			for (auto id : entities)
 			{
 				Entity entity = Entity(id, mySceneContext);
 				const auto& sc = entities.get<ScriptComponent>(id);
-				if (entity.IsActive() && sc.isActive && sc.IsFlagSet(ManagedClassMethodFlags::ShouldFixedUpdate) && ScriptEngine::IsEntityInstantiated(entity))
+				if (sc.isActive && sc.IsFlagSet(ManagedClassMethodFlags::ShouldFixedUpdate) && ScriptEngine::IsEntityInstantiated(entity))
 				{
 					ScriptEngine::CallMethod(ScriptEngine::GetEntityInstance(entity.GetUUID()), "OnFixedUpdate");
 				}
@@ -166,75 +197,263 @@ namespace Epoch
 		}
 	}
 
-	static void CallScriptPhysicsCallback(const char* aMethodName, Entity aEntityA, Entity aEntityB)
+	void PhysicsScene::PostSimulate()
 	{
-		if (!aEntityA.HasComponent<ScriptComponent>())
+		EPOCH_PROFILE_FUNC();
+
+		if (myPhysicsEvents.empty())
 		{
 			return;
 		}
 
-		const auto& sc = aEntityA.GetComponent<ScriptComponent>();
-
-		if (!ScriptEngine::IsModuleValid(sc.scriptClassHandle) || !ScriptEngine::IsEntityInstantiated(aEntityA))
+		// Every event is delivered to both entities, split it into one record per receiver
+		myPhysicsEventRecords.clear();
+		myPhysicsEventRecords.reserve(myPhysicsEvents.size() * 2);
+		for (uint32_t i = 0; i < (uint32_t)myPhysicsEvents.size(); i++)
 		{
-			return;
+			const auto& event = myPhysicsEvents[i];
+			myPhysicsEventRecords.push_back({ event.entityA, event.entityB, event.type, i });
+			myPhysicsEventRecords.push_back({ event.entityB, event.entityA, event.type, i });
 		}
+		myPhysicsEvents.clear();
 
-		ScriptEngine::CallMethod(sc.managedInstance, aMethodName, aEntityB.GetUUID());
-	}
+		std::sort(myPhysicsEventRecords.begin(), myPhysicsEventRecords.end(), [](const PhysicsEventRecord& aLhs, const PhysicsEventRecord& aRhs)
+			{
+				if ((uint64_t)aLhs.receiver != (uint64_t)aRhs.receiver) return (uint64_t)aLhs.receiver < (uint64_t)aRhs.receiver;
+				if ((uint64_t)aLhs.other != (uint64_t)aRhs.other) return (uint64_t)aLhs.other < (uint64_t)aRhs.other;
+				return aLhs.order < aRhs.order;
+			});
 
-	void PhysicsScene::PostSimulate()
-	{
-		EPOCH_PROFILE_FUNC();
+		// Method pointers are only valid for the currently loaded assembly, so they are resolved again each step
+		myPhysicsCallbackMethods.clear();
+
+		static const char* callbackNames[] = { "OnCollisionEnter", "OnCollisionExit", "OnTriggerEnter", "OnTriggerExit" };
 
-		for (const auto& event : myPhysicsEvents)
+		size_t runStart = 0;
+		while (runStart < myPhysicsEventRecords.size())
 		{
-			Entity entityA = mySceneContext->TryGetEntityWithUUID(event.entityA);
-			Entity entityB = mySceneContext->TryGetEntityWithUUID(event.entityB);
+			const UUID receiverID = myPhysicsEventRecords[runStart].receiver;
+
+			size_t runEnd = runStart + 1;
+			while (runEnd < myPhysicsEventRecords.size() && (uint64_t)myPhysicsEventRecords[runEnd].receiver == (uint64_t)receiverID)
+			{
+				runEnd++;
+			}
+
+			const size_t begin = runStart;
+			runStart = runEnd;
+
+			Entity receiver = mySceneContext->TryGetEntityWithUUID(receiverID);
+			if (!receiver || !receiver.HasComponent<ScriptComponent>())
+			{
+				continue;
+			}
 
-			if (!entityA || !entityB)
+			const auto& sc = receiver.GetComponent<ScriptComponent>();
+			if (!ScriptEngine::IsModuleValid(sc.scriptClassHandle) || !ScriptEngine::IsEntityInstantiated(receiver))
 			{
 				continue;
 			}
 
-			switch (event.type)
+			// Callbacks can create entities, so don't hold on to the component itself
+			const GCHandle instance = sc.managedInstance;
+			const uint32_t classID = ScriptEngine::GetScriptClassIDFromComponent(sc);
+			auto methodsIt = myPhysicsCallbackMethods.find(classID);
+			if (methodsIt == myPhysicsCallbackMethods.end())
 			{
-				case PhysicsEventType::CollisionEnter:
+				ManagedClass* managedClass = ScriptCache::GetManagedClassByID(classID);
+
+				std::array<ManagedMethod*, 4> methods = {};
+				for (size_t i = 0; i < methods.size(); i++)
 				{
-					CallScriptPhysicsCallback("OnCollisionEnter", entityA, entityB);
-					CallScriptPhysicsCallback("OnCollisionEnter", entityB, entityA);
-					break;
+					methods[i] = managedClass ? ScriptCache::GetSpecificManagedMethod(managedClass, callbackNames[i], 1) : nullptr;
 				}
-				case PhysicsEventType::CollisionExit:
+
+				methodsIt = myPhysicsCallbackMethods.emplace(classID, methods).first;
+			}
+
+			for (size_t i = begin; i < runEnd; i++)
+			{
+				const auto& record = myPhysicsEventRecords[i];
+
+				// Substeps can report the same contact more than once, only pass on changes
+				if (i > begin)
 				{
-					CallScriptPhysicsCallback("OnCollisionExit", entityA, entityB);
-					CallScriptPhysicsCallback("OnCollisionExit", entityB, entityA);
-					break;
+					const auto& previous = myPhysicsEventRecords[i - 1];
+					if ((uint64_t)previous.other == (uint64_t)record.other && previous.type == record.type)
+					{
+						continue;
+					}
 				}
-				case PhysicsEventType::TriggerEnter:
+
+				if (!mySceneContext->TryGetEntityWithUUID(record.other))
 				{
-					CallScriptPhysicsCallback("OnTriggerEnter", entityA, entityB);
-					CallScriptPhysicsCallback("OnTriggerEnter", entityB, entityA);
-					break;
+					continue;
 				}
-				case PhysicsEventType::TriggerExit:
+
+				ScriptEngine::CallResolvedMethod(instance, methodsIt->second[(size_t)record.type], record.other);
+			}
+		}
+	}
+
+	void PhysicsScene::OnPhysicsEvent(PhysicsEventType aType, UUID aEntityA, UUID aEntityB)
+	{
+		auto& contactEvent = myPhysicsEvents.emplace_back();
+		contactEvent.type = aType;
+		contactEvent.entityA = aEntityA;
+		contactEvent.entityB = aEntityB;
+	}
+
+	void PhysicsScene::ApplyInterpolatedTransforms()
+	{
+		EPOCH_PROFILE_FUNC();
+
+		if (!PhysicsSystem::GetSettings().interpolateTransforms)
+		{
+			return;
+		}
+
+		// With async simulation the newest step is still running on frames that started one, so the fetched poses are a step older than
+		// the accumulator assumes and bodies are shown one extra step behind. Frames without a step in flight already have the newest
+		// pose, they are held at the previous one instead so the shown time doesn't jump back a step once the next step starts.
+		float alpha = myAccumulator / PhysicsSystem::GetSettings().fixedTimestep;
+		if (PhysicsSystem::GetSettings().asyncSimulation && mySubSteps == 0)
+		{
+			alpha -= 1.0f;
+		}
+		alpha = CU::Math::Clamp01(alpha);
+
+		// A body only needs to be written while it is moving and once more after it stopped, to land on its final pose.
+		// Only moved bodies are recorded, so the previous pose of one that wasn't recorded in the last step is stale and it's written at its current pose.
+		myInterpolatedRootBodies.clear();
+		myInterpolatedChildBodies.clear();
+		for (uint32_t i = 0; i < (uint32_t)myPoseSnapshots.entityIDs.size(); i++)
+		{
+			if (myPoseSnapshotStep - myPoseSnapshots.recordedSteps[i] > 1)
+			{
+				continue;
+			}
+
+			Entity entity = mySceneContext->TryGetEntityWithUUID(myPoseSnapshots.entityIDs[i]);
+			if (!entity)
+			{
+				continue;
+			}
+
+			if (entity.HasParent())
+			{
+				myInterpolatedChildBodies.emplace_back(entity, i);
+			}
+			else
+			{
+				myInterpolatedRootBodies.emplace_back(entity, i);
+			}
+		}
+
+		Application::Get().GetJobSystem().ParallelFor((uint32_t)myInterpolatedRootBodies.size(), 256, [this, alpha](uint32_t aBegin, uint32_t aEnd)
+			{
+				for (uint32_t i = aBegin; i < aEnd; i++)
 				{
-					CallScriptPhysicsCallback("OnTriggerExit", entityA, entityB);
-					CallScriptPhysicsCallback("OnTriggerExit", entityB, entityA);
-					break;
+					auto& [entity, index] = myInterpolatedRootBodies[i];
+					const float bodyAlpha = myPoseSnapshots.recordedSteps[index] == myPoseSnapshotStep ? alpha : 1.0f;
+					auto& transComp = entity.GetComponent<TransformComponent>();
+					transComp.transform.SetTranslation(CU::Vector3f::Lerp(myPoseSnapshots.previousPositions[index], myPoseSnapshots.currentPositions[index], bodyAlpha));
+					transComp.transform.SetRotation(CU::Quatf::Slerp(myPoseSnapshots.previousRotations[index], myPoseSnapshots.currentRotations[index], bodyAlpha).GetEulerAngles());
 				}
-			}
+			});
+
+		// Converting to local space reads the parent chain, keep it on this thread
+		for (auto& [entity, index] : myInterpolatedChildBodies)
+		{
+			const float bodyAlpha = myPoseSnapshots.recordedSteps[index] == myPoseSnapshotStep ? alpha : 1.0f;
+			auto& transComp = entity.GetComponent<TransformComponent>();
+			const CU::Vector3f orgScale = transComp.transform.GetScale();
+			transComp.transform.SetTranslation(CU::Vector3f::Lerp(myPoseSnapshots.previousPositions[index], myPoseSnapshots.currentPositions[index], bodyAlpha));
+			transComp.transform.SetRotation(CU::Quatf::Slerp(myPoseSnapshots.previousRotations[index], myPoseSnapshots.currentRotations[index], bodyAlpha).GetEulerAngles());
+
+			mySceneContext->ConvertToLocalSpace(entity);
+			transComp.transform.SetScale(orgScale);
 		}
+	}
 
-		myPhysicsEvents.clear();
+	void PhysicsScene::AddPoseSnapshot(UUID aEntityID, const CU::Vector3f& aPosition, const CU::Quatf& aRotation)
+	{
+		if (auto it = myPoseSnapshotIndices.find(aEntityID); it != myPoseSnapshotIndices.end())
+		{
+			RecordPoseSnapshot(aEntityID, aPosition, aRotation, true);
+			return;
+		}
+
+		myPoseSnapshotIndices[aEntityID] = (uint32_t)myPoseSnapshots.entityIDs.size();
+		myPoseSnapshots.entityIDs.push_back(aEntityID);
+		myPoseSnapshots.previousPositions.push_back(aPosition);
+		myPoseSnapshots.currentPositions.push_back(aPosition);
+		myPoseSnapshots.previousRotations.push_back(aRotation);
+		myPoseSnapshots.currentRotations.push_back(aRotation);
+		myPoseSnapshots.recordedSteps.push_back(myPoseSnapshotStep);
 	}
 
-	void PhysicsScene::OnPhysicsEvent(PhysicsEventType aType, Entity aEntityA, Entity aEntityB)
+	void PhysicsScene::RemovePoseSnapshot(UUID aEntityID)
 	{
-		auto& contactEvent = myPhysicsEvents.emplace_back();;
-		contactEvent.type = aType;
-		contactEvent.entityA = aEntityA.GetUUID();
-		contactEvent.entityB = aEntityB.GetUUID();
+		auto it = myPoseSnapshotIndices.find(aEntityID);
+		if (it == myPoseSnapshotIndices.end())
+		{
+			return;
+		}
+
+		// Swap with the last snapshot to keep the arrays dense
+		const uint32_t index = it->second;
+		const uint32_t last = (uint32_t)myPoseSnapshots.entityIDs.size() - 1;
+		if (index != last)
+		{
+			myPoseSnapshots.entityIDs[index] = myPoseSnapshots.entityIDs[last];
+			myPoseSnapshots.previousPositions[index] = myPoseSnapshots.previousPositions[last];
+			myPoseSnapshots.currentPositions[index] = myPoseSnapshots.currentPositions[last];
+			myPoseSnapshots.previousRotations[index] = myPoseSnapshots.previousRotations[last];
+			myPoseSnapshots.currentRotations[index] = myPoseSnapshots.currentRotations[last];
+			myPoseSnapshots.recordedSteps[index] = myPoseSnapshots.recordedSteps[last];
+			myPoseSnapshotIndices[myPoseSnapshots.entityIDs[index]] = index;
+		}
+
+		myPoseSnapshots.entityIDs.pop_back();
+		myPoseSnapshots.previousPositions.pop_back();
+		myPoseSnapshots.currentPositions.pop_back();
+		myPoseSnapshots.previousRotations.pop_back();
+		myPoseSnapshots.currentRotations.pop_back();
+		myPoseSnapshots.recordedSteps.pop_back();
+		myPoseSnapshotIndices.erase(it);
+	}
+
+	void PhysicsScene::BeginPoseSnapshots()
+	{
+		// Nothing is copied here, only the active actors are recorded and they shift their own poses in RecordPoseSnapshot
+		myPoseSnapshotStep++;
+	}
+
+	void PhysicsScene::RecordPoseSnapshot(UUID aEntityID, const CU::Vector3f& aPosition, const CU::Quatf& aRotation, bool aTeleport)
+	{
+		auto it = myPoseSnapshotIndices.find(aEntityID);
+		if (it == myPoseSnapshotIndices.end())
+		{
+			return;
+		}
+
+		const uint32_t index = it->second;
+		if (aTeleport)
+		{
+			myPoseSnapshots.previousPositions[index] = aPosition;
+			myPoseSnapshots.previousRotations[index] = aRotation;
+		}
+		else if (myPoseSnapshots.recordedSteps[index] != myPoseSnapshotStep)
+		{
+			// The current pose is where the body was at the end of the last step, whether or not it moved then
+			myPoseSnapshots.previousPositions[index] = myPoseSnapshots.currentPositions[index];
+			myPoseSnapshots.previousRotations[index] = myPoseSnapshots.currentRotations[index];
+		}
+
+		myPoseSnapshots.currentPositions[index] = aPosition;
+		myPoseSnapshots.currentRotations[index] = aRotation;
+		myPoseSnapshots.recordedSteps[index] = myPoseSnapshotStep;
 	}
 
 	void PhysicsScene::SubStepStrategy()
@@ -1,5 +1,6 @@
 #pragma once
 #include <unordered_map>
+#include <array>
 #include "PhysicsEventCallback.h"
 #include "PhysicsBody.h"
 #include "CharacterController.h"
@@ -9,6 +10,7 @@
 namespace Epoch
 {
 	class Scene;
+	struct ManagedMethod;
 
 	class PhysicsScene
 	{
@@ -32,6 +34,10 @@ namespace Epoch
 		uint32_t GetDynamicPhysicsBodyCount() const { return (uint32_t)myDynamicPhysicsBodies.size(); }
 		uint32_t GetCharacterControllerCount() const { return (uint32_t)myCharacterControllers.size(); }
 
+		// Scenes created with deferred bodies only gather what to create, this creates it until the budget is used up.
+		// Returns true once every body and character controller exists.
+		bool CreateQueuedPhysicsBodies(float aBudgetMilliseconds = FLT_MAX);
+
 		virtual CU::Vector3f GetGravity() const = 0;
 		virtual void SetGravity(const CU::Vector3f& aGravity) = 0;
 
@@ -40,19 +46,37 @@ namespace Epoch
 		virtual bool CheckShape(const ShapeOverlapInfo* aShapeOverlapInfo, LayerMask* aLayerMask = nullptr) = 0;
 		virtual std::vector<UUID> OverlapShape(const ShapeOverlapInfo* aShapeOverlapInfo) = 0;
 
+		// Batched queries, executed in parallel over the job system.
+		// outHits holds one slot per query, a miss is reported as a hit with entity 0. Returns the number of hits.
+		// The shape queries only support boxes and spheres, callers have to filter out other shapes before dispatching.
+		virtual uint32_t RaycastBatch(const RaycastQuery* aQueries, uint32_t aQueryCount, HitInfo* outHits) = 0;
+		virtual uint32_t ShapeCastBatch(const ShapeCastQuery* aQueries, uint32_t aQueryCount, HitInfo* outHits) = 0;
+		// outHits holds aMaxHitsPerQuery slots per query and outHitCounts one count per query. Returns the total number of hits.
+		virtual uint32_t OverlapShapeBatch(const ShapeOverlapQuery* aQueries, uint32_t aQueryCount, UUID* outHits, uint32_t* outHitCounts, uint32_t aMaxHitsPerQuery) = 0;
+
 		void AddRadialImpulse(CU::Vector3f aOrigin, float aRadius, float aStrength);
 		
 		virtual void Teleport(Entity aEntity, const CU::Vector3f& aTargetPosition, const CU::Quatf& aTargetRotation) = 0;
 
+		// Writes the dynamic body poses interpolated between the last two fixed steps to their transforms
+		void ApplyInterpolatedTransforms();
+
 	protected:
-		void CreatePhysicsBodies();
-		void CreateCharacterControllers();
+		// Gathers the entities that need a body or character controller, they are created by CreateQueuedPhysicsBodies
+		void QueuePhysicsBodies();
 		
 		void SubStepStrategy();
 		void PreSimulate();
 		void PostSimulate();
 
-		void OnPhysicsEvent(PhysicsEventType aType, Entity aEntityA, Entity aEntityB);
+		void OnPhysicsEvent(PhysicsEventType aType, UUID aEntityA, UUID aEntityB);
+
+		void AddPoseSnapshot(UUID aEntityID, const CU::Vector3f& aPosition, const CU::Quatf& aRotation);
+		void RemovePoseSnapshot(UUID aEntityID);
+		// Called once per fixed step before the moved bodies are recorded
+		void BeginPoseSnapshots();
+		// A teleport overwrites both poses so the body doesn't get interpolated across the jump
+		void RecordPoseSnapshot(UUID aEntityID, const CU::Vector3f& aPosition, const CU::Quatf& aRotation, bool aTeleport = false);
 		
 	protected:
 		Scene* mySceneContext;
@@ -64,8 +88,37 @@ namespace Epoch
 		float myAccumulator = 0.0f;
 		uint32_t mySubSteps = 1;
 
+		std::vector<UUID> myQueuedBodies;
+		std::vector<UUID> myQueuedCharacterControllers;
+		uint32_t myCreatedBodyCount = 0;
+		uint32_t myCreatedCharacterControllerCount = 0;
+
 	private:
 		struct PhysicsEvent { PhysicsEventType type = PhysicsEventType::None; UUID entityA; UUID entityB; };
 		std::vector<PhysicsEvent> myPhysicsEvents;
+
+		// One record per receiving entity, sorted so all callbacks for an entity are dispatched together
+		struct PhysicsEventRecord { UUID receiver; UUID other; PhysicsEventType type = PhysicsEventType::None; uint32_t order = 0; };
+		std::vector<PhysicsEventRecord> myPhysicsEventRecords;
+
+		// Resolved callback methods per script class, indexed by PhysicsEventType
+		std::unordered_map<uint32_t, std::array<ManagedMethod*, 4>> myPhysicsCallbackMethods;
+
+		// World space poses of the dynamic bodies from the previous and current fixed step, stored densely
+		struct PoseSnapshots
+		{
+			std::vector<UUID> entityIDs;
+			std::vector<CU::Vector3f> previousPositions;
+			std::vector<CU::Vector3f> currentPositions;
+			std::vector<CU::Quatf> previousRotations;
+			std::vector<CU::Quatf> currentRotations;
+			std::vector<uint32_t> recordedSteps;
+		};
+		PoseSnapshots myPoseSnapshots;
+		std::unordered_map<UUID, uint32_t> myPoseSnapshotIndices;
+		uint32_t myPoseSnapshotStep = 0;
+
+		std::vector<std::pair<Entity, uint32_t>> myInterpolatedRootBodies;
+		std::vector<std::pair<Entity, uint32_t>> myInterpolatedChildBodies;
 	};
 }
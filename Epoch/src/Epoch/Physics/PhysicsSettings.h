@@ -7,5 +7,13 @@ namespace Epoch
 	{
 		float fixedTimestep = 1.0f / 60.0f;
 		CU::Vector3f gravity = { 0.0f, -982.0f, 0.0f };
+
+		// Runs the simulation step alongside the rest of the frame and fetches it at the start of the next physics update.
+		// Scripts then see the results of the previous step.
+		bool asyncSimulation = false;
+
+		// Renders dynamic bodies between the last two fixed steps instead of at the latest one, which hides stutter at low fixed rates.
+		// Combined with asyncSimulation the bodies lag one more fixed step behind, since the newest step is still running when they are drawn.
+		bool interpolateTransforms = false;
 	};
 }
@@ -32,5 +32,5 @@ namespace Epoch
 		delete staticPhysicsAPI;
 	}
 
-	std::shared_ptr<PhysicsScene> PhysicsSystem::CreatePhysicsScene(Scene* aScene) { return staticPhysicsAPI->CreateScene(aScene); }
+	std::shared_ptr<PhysicsScene> PhysicsSystem::CreatePhysicsScene(Scene* aScene, bool aDeferBodies) { return staticPhysicsAPI->CreateScene(aScene, aDeferBodies); }
 }
\ No newline at end of file
@@ -14,7 +14,8 @@ namespace Epoch
 		
 		static PhysicsSettings& GetSettings() { return staticPhysicsSettings; }
 
-		static std::shared_ptr<PhysicsScene> CreatePhysicsScene(Scene* aScene);
+		// With aDeferBodies the bodies are only gathered, see PhysicsScene::CreateQueuedPhysicsBodies
+		static std::shared_ptr<PhysicsScene> CreatePhysicsScene(Scene* aScene, bool aDeferBodies = false);
 
 		static PhysicsAPI* GetAPI() { return staticPhysicsAPI; }
 		
@@ -1,7 +1,9 @@
 #pragma once
 #include <cstdint>
+#include <cfloat>
 #include <CommonUtilities/Math/Vector/Vector3.hpp>
 #include "Epoch/Physics/PhysicsTypes.h"
+#include "Epoch/Physics/PhysicsLayer.h"
 
 namespace Epoch
 {
@@ -70,4 +72,37 @@ namespace Epoch
 
 		float radius = 0.0f;
 	};
+
+
+	// Plain query descriptions used by the batched scene query API.
+	// The layouts are mirrored on the managed side so script arrays can be passed straight through.
+	// A layer mask with a bit value of 0 disables layer filtering.
+
+	struct RaycastQuery
+	{
+		CU::Vector3f origin;
+		CU::Vector3f direction;
+		float maxDistance = FLT_MAX;
+		LayerMask layerMask;
+	};
+
+	struct ShapeCastQuery
+	{
+		Physics::ShapeType shape = Physics::ShapeType::Sphere;
+		CU::Vector3f origin;
+		CU::Vector3f direction;
+		CU::Vector3f halfExtent;
+		float radius = 0.0f;
+		float maxDistance = 0.0f;
+		LayerMask layerMask;
+	};
+
+	struct ShapeOverlapQuery
+	{
+		Physics::ShapeType shape = Physics::ShapeType::Sphere;
+		CU::Vector3f origin;
+		CU::Vector3f halfExtent;
+		float radius = 0.0f;
+		LayerMask layerMask;
+	};
 }
@@ -6,6 +6,28 @@
 
 namespace Epoch
 {
+	// One subresource per mip, aData holds the mips from aFirstMip to the last one tightly packed
+	static std::vector<D3D11_SUBRESOURCE_DATA> GetMipSubresources(const TextureSpecification& aSpec, uint32_t aFirstMip, Buffer aData)
+	{
+		std::vector<D3D11_SUBRESOURCE_DATA> subresources(aSpec.mipCount - aFirstMip);
+
+		size_t offset = 0;
+		for (uint32_t mip = aFirstMip; mip < aSpec.mipCount; mip++)
+		{
+			const uint32_t mipWidth = CU::Math::Max(aSpec.width >> mip, 1u);
+			const uint32_t mipHeight = CU::Math::Max(aSpec.height >> mip, 1u);
+
+			D3D11_SUBRESOURCE_DATA& subresource = subresources[mip - aFirstMip];
+			subresource.pSysMem = (byte*)aData.data + offset;
+			subresource.SysMemPitch = (UINT)GetRowPitch(aSpec.format, mipWidth);
+			subresource.SysMemSlicePitch = 0;
+			offset += GetMemorySize(aSpec.format, mipWidth, mipHeight);
+		}
+
+		EPOCH_ASSERT(offset <= aData.size, "Not enough data for the mips!");
+		return subresources;
+	}
+
 	DX11Texture2D::DX11Texture2D(const std::filesystem::path& aFilepath)
 	{
 		myTextureData = TextureImporter::ToBufferFromFile(aFilepath, mySpecification.format, mySpecification.width, mySpecification.height);
@@ -25,13 +47,19 @@ namespace Epoch
 	{
 		mySpecification = aSpec;
 
-		auto size = GetMemorySize(mySpecification.format, mySpecification.width, mySpecification.height);
+		auto size = GetMipTailMemorySize(mySpecification.format, mySpecification.width, mySpecification.height, mySpecification.residentMip, CU::Math::Max(mySpecification.mipCount, 1u));
 		if (aTextureData)
 		{
 			myTextureData = Buffer::Copy(aTextureData.data, size);
 		}
 
 		Create();
+
+		// Streamed textures are read from the asset pack again when they need more mips, there's no point keeping a CPU copy
+		if (mySpecification.residentMip > 0)
+		{
+			myTextureData.Release();
+		}
 	}
 
 	DX11Texture2D::~DX11Texture2D()
@@ -125,6 +153,80 @@ namespace Epoch
 		Create();
 	}
 
+	void DX11Texture2D::SetResidentMips(uint32_t aFirstMip, Buffer aMipData)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		EPOCH_ASSERT(aFirstMip < mySpecification.mipCount, "Texture doesn't have that many mips!");
+		EPOCH_ASSERT(aMipData || aFirstMip >= mySpecification.residentMip, "Mip data is needed to make more mips resident!");
+
+		if (aFirstMip == mySpecification.residentMip && !aMipData)
+		{
+			return;
+		}
+
+		const uint32_t mipLevels = mySpecification.mipCount - aFirstMip;
+
+		D3D11_TEXTURE2D_DESC description;
+		ZeroMemory(&description, sizeof(description));
+		description.Width = CU::Math::Max(mySpecification.width >> aFirstMip, 1u);
+		description.Height = CU::Math::Max(mySpecification.height >> aFirstMip, 1u);
+		description.MipLevels = mipLevels;
+		description.ArraySize = 1;
+		description.Format = DX11TextureFormat(mySpecification.format);
+		description.SampleDesc.Count = 1;
+		description.SampleDesc.Quality = 0;
+		description.Usage = D3D11_USAGE_DEFAULT;
+		description.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+		ComPtr<ID3D11Resource> texture;
+		if (aMipData)
+		{
+			std::vector<D3D11_SUBRESOURCE_DATA> mipSubresources = GetMipSubresources(mySpecification, aFirstMip, aMipData);
+			HRESULT result = RHI::GetDevice()->CreateTexture2D(&description, mipSubresources.data(), reinterpret_cast<ID3D11Texture2D**>(texture.GetAddressOf()));
+			if (FAILED(result))
+			{
+				EPOCH_ASSERT(false, "Failed to create a texture 2D!");
+				return;
+			}
+		}
+		else
+		{
+			HRESULT result = RHI::GetDevice()->CreateTexture2D(&description, nullptr, reinterpret_cast<ID3D11Texture2D**>(texture.GetAddressOf()));
+			if (FAILED(result))
+			{
+				EPOCH_ASSERT(false, "Failed to create a texture 2D!");
+				return;
+			}
+
+			// Only dropping mips, the ones that stay are already on the GPU
+			std::lock_guard lock(staticMutex);
+			for (uint32_t mip = 0; mip < mipLevels; mip++)
+			{
+				const uint32_t sourceMip = aFirstMip - mySpecification.residentMip + mip;
+				RHI::GetContext()->CopySubresourceRegion(texture.Get(), mip, 0, 0, 0, myTexture.Get(), sourceMip, nullptr);
+			}
+		}
+
+		D3D11_SHADER_RESOURCE_VIEW_DESC srvDescription = {};
+		srvDescription.Format = description.Format;
+		srvDescription.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+		srvDescription.Texture2D.MipLevels = mipLevels;
+		srvDescription.Texture2D.MostDetailedMip = 0;
+
+		ComPtr<ID3D11ShaderResourceView> srv;
+		HRESULT result = RHI::GetDevice()->CreateShaderResourceView(texture.Get(), &srvDescription, srv.GetAddressOf());
+		if (FAILED(result))
+		{
+			EPOCH_ASSERT(false, "Failed to create a shader resource view!");
+			return;
+		}
+
+		myTexture = texture;
+		mySRV = srv;
+		mySpecification.residentMip = aFirstMip;
+	}
+
 	Buffer DX11Texture2D::ReadData() const
 	{
 		return ReadData(GetWidth(), GetHeight(), 0, 0);
@@ -204,17 +306,28 @@ namespace Epoch
 		if (myTextureData)
 		{
 			subResourceData.pSysMem = myTextureData.data;
-			subResourceData.SysMemPitch = (uint32_t)size / mySpecification.height;
+			subResourceData.SysMemPitch = (uint32_t)GetRowPitch(mySpecification.format, mySpecification.width);
 			subResourceData.SysMemSlicePitch = 0;
 		}
 
 		DXGI_FORMAT format = DX11TextureFormat(mySpecification.format);
-		UINT mipLevels = mySpecification.generateMips ? GetMipLevelCount() : 1;
+		const bool hasCookedMips = mySpecification.mipCount > 1 && myTextureData;
+		UINT mipLevels = hasCookedMips ? mySpecification.mipCount - mySpecification.residentMip : (mySpecification.generateMips ? GetMipLevelCount() : 1);
+
+		// Cooked textures come with every resident mip, each one becomes its own subresource
+		std::vector<D3D11_SUBRESOURCE_DATA> mipSubresources;
+		if (hasCookedMips)
+		{
+			mySpecification.generateMips = false;
+			mipSubresources = GetMipSubresources(mySpecification, mySpecification.residentMip, myTextureData);
+		}
+
+		const uint32_t residentMip = hasCookedMips ? mySpecification.residentMip : 0;
 
 		D3D11_TEXTURE2D_DESC description;
 		ZeroMemory(&description, sizeof(description));
-		description.Width = mySpecification.width;
-		description.Height = mySpecification.height;
+		description.Width = CU::Math::Max(mySpecification.width >> residentMip, 1u);
+		description.Height = CU::Math::Max(mySpecification.height >> residentMip, 1u);
 		description.MipLevels = mipLevels;
 		description.ArraySize = 1;
 		description.Format = format;
@@ -238,7 +351,8 @@ namespace Epoch
 		}
 		else
 		{
-			HRESULT result = RHI::GetDevice()->CreateTexture2D(&description, myTextureData ? &subResourceData : nullptr, reinterpret_cast<ID3D11Texture2D**>(myTexture.GetAddressOf()));
+			const D3D11_SUBRESOURCE_DATA* initialData = hasCookedMips ? mipSubresources.data() : (myTextureData ? &subResourceData : nullptr);
+			HRESULT result = RHI::GetDevice()->CreateTexture2D(&description, initialData, reinterpret_cast<ID3D11Texture2D**>(myTexture.GetAddressOf()));
 			if (FAILED(result))
 			{
 				EPOCH_ASSERT(false, "Failed to create a texture 2D!");
@@ -21,6 +21,11 @@ namespace Epoch
 		case TextureFormat::RG16F:			return DXGI_FORMAT_R16G16_FLOAT;
 		case TextureFormat::R32F:			return DXGI_FORMAT_R32_FLOAT;
 		case TextureFormat::R32UI:			return DXGI_FORMAT_R32_UINT;
+		case TextureFormat::BC1:			return DXGI_FORMAT_BC1_UNORM;
+		case TextureFormat::BC3:			return DXGI_FORMAT_BC3_UNORM;
+		case TextureFormat::BC4:			return DXGI_FORMAT_BC4_UNORM;
+		case TextureFormat::BC5:			return DXGI_FORMAT_BC5_UNORM;
+		case TextureFormat::BC7:			return DXGI_FORMAT_BC7_UNORM;
 		case TextureFormat::DEPTH32:		return DXGI_FORMAT_R32_TYPELESS;
 		}
 		EPOCH_ASSERT(false, "Unknown texture format!");
@@ -44,6 +49,7 @@ namespace Epoch
 		
 		void Resize(uint32_t aWidth, uint32_t aHeight) override;
 		void SetData(Buffer aTextureData) override;
+		void SetResidentMips(uint32_t aFirstMip, Buffer aMipData) override;
 
 		Buffer ReadData() const override;
 		Buffer ReadData(uint32_t aWidth, uint32_t aHeight, uint32_t aX, uint32_t aY) const override;
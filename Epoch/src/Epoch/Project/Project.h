@@ -27,6 +27,10 @@ namespace Epoch
 		std::string scriptModulePath = "Scripts/Binaries";
 		std::string defaultScriptNamespace;
 
+		// Imported assets missing from the local cache are looked for here before importing, relative to the project or absolute
+		std::filesystem::path sharedDerivedDataDirectory;
+		uint32_t derivedDataCacheSizeMB = 4096;
+
 		// Not serialized
 		std::filesystem::path projectFileName;
 		std::filesystem::path projectDirectory;
@@ -108,6 +112,13 @@ namespace Epoch
 			return staticActiveProject->GetConfig().projectDirectory / staticActiveProject->GetConfig().assetRegistryPath;
 		}
 
+		// Generated data that can be rebuilt from the project at any time
+		static std::filesystem::path GetCacheDirectory()
+		{
+			EPOCH_ASSERT(staticActiveProject, "No active project!");
+			return staticActiveProject->GetConfig().projectDirectory / "Cache";
+		}
+
 		static std::filesystem::path GetScriptModulePath()
 		{
 			EPOCH_ASSERT(staticActiveProject, "No active project!");
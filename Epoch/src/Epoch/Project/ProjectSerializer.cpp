@@ -97,8 +97,13 @@ namespace Epoch
 
 				out << YAML::Key << "DefaultScriptNamespace" << YAML::Value << config.defaultScriptNamespace;
 
+				out << YAML::Key << "SharedDerivedDataDirectory" << YAML::Value << config.sharedDerivedDataDirectory.string();
+				out << YAML::Key << "DerivedDataCacheSizeMB" << YAML::Value << config.derivedDataCacheSizeMB;
+
 				out << YAML::Key << "FixedTimestep" << YAML::Value << physicsSettings.fixedTimestep;
 				out << YAML::Key << "Gravity" << YAML::Value << physicsSettings.gravity;
+				out << YAML::Key << "AsyncSimulation" << YAML::Value << physicsSettings.asyncSimulation;
+				out << YAML::Key << "InterpolateTransforms" << YAML::Value << physicsSettings.interpolateTransforms;
 
 				SerializePhysicsLayers(out);
 
@@ -216,8 +221,13 @@ namespace Epoch
 			config.defaultScriptNamespace = rootNode["DefaultScriptNamespace"].as<std::string>(config.projectFileName.stem().string());
 			config.defaultScriptNamespace = CU::RemoveWhitespaces(config.defaultScriptNamespace);
 
+			config.sharedDerivedDataDirectory = rootNode["SharedDerivedDataDirectory"].as<std::string>("");
+			config.derivedDataCacheSizeMB = rootNode["DerivedDataCacheSizeMB"].as<uint32_t>(config.derivedDataCacheSizeMB);
+
 			physicsSettings.fixedTimestep = rootNode["FixedTimestep"].as<float>(1.0f / 60.0f);
 			physicsSettings.gravity = rootNode["Gravity"].as<CU::Vector3f>(CU::Vector3f(0.0f, -982.0f, 0.0f));
+			physicsSettings.asyncSimulation = rootNode["AsyncSimulation"].as<bool>(false);
+			physicsSettings.interpolateTransforms = rootNode["InterpolateTransforms"].as<bool>(false);
 
 			DeserializePhysicsLayers(rootNode);
 		}
@@ -291,6 +301,8 @@ namespace Epoch
 			
 			out << YAML::Key << "FixedTimestep" << YAML::Value << physicsSettings.fixedTimestep;
 			out << YAML::Key << "Gravity" << YAML::Value << physicsSettings.gravity;
+			out << YAML::Key << "AsyncSimulation" << YAML::Value << physicsSettings.asyncSimulation;
+			out << YAML::Key << "InterpolateTransforms" << YAML::Value << physicsSettings.interpolateTransforms;
 
 			SerializePhysicsLayers(out);
 
@@ -339,6 +351,8 @@ namespace Epoch
 		
 		physicsSettings.fixedTimestep = rootNode["FixedTimestep"].as<float>(1.0f/60.0f);
 		physicsSettings.gravity = rootNode["Gravity"].as<CU::Vector3f>(CU::Vector3f(0.0f, -982.0f, 0.0f));
+		physicsSettings.asyncSimulation = rootNode["AsyncSimulation"].as<bool>(false);
+		physicsSettings.interpolateTransforms = rootNode["InterpolateTransforms"].as<bool>(false);
 
 		DeserializePhysicsLayers(rootNode);
 
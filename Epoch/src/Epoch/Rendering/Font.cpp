@@ -3,7 +3,7 @@
 #include "MSDFData.h"
 #include "Epoch/Core/Application.h"
 #include "Epoch/Utils/FileSystem.h"
-#include "Epoch/Core/Hash.h"
+#include "Epoch/Assets/DerivedDataCache.h"
 
 #include "Epoch/Embed/OpenSans_Regular.embed"
 
@@ -42,65 +42,56 @@ namespace Epoch
 	#define LCG_INCREMENT 1442695040888963407ull
 	#define THREADS 8
 
-	namespace Utils {
-
-		static std::filesystem::path GetCacheDirectory()
-		{
-			return Application::Get().GetSpecification().cacheDirectory + "/Font";
-		}
-
-		static void CreateCacheDirectoryIfNeeded()
-		{
-			std::filesystem::path cacheDirectory = GetCacheDirectory();
-			if (!std::filesystem::exists(cacheDirectory))
-			{
-				std::filesystem::create_directories(cacheDirectory);
-			}
-		}
-	}
-
 	struct AtlasHeader
 	{
 		uint32_t type = 0;
 		uint32_t width = 0, height = 0;
 	};
 
-	static bool TryReadFontAtlasFromCache(const std::string& aFontName, float aFontSize, AtlasHeader& aHeader, void*& aPixels, Buffer& aStorageBuffer)
+	// Bump when the atlas generation changes so stale atlases aren't used
+	static constexpr uint32_t FontAtlasVersion = 1;
+
+	static DerivedDataKey GetFontAtlasKey(Buffer aFontData, const Configuration& aConfig)
 	{
-		std::string filename = fmt::format("{}{}.efa", Hash::GenerateFNVHash(aFontName), aFontSize);
-		std::filesystem::path filepath = Utils::GetCacheDirectory() / filename;
+		uint64_t settingsHash = DerivedDataCache::HashData(&aConfig.emSize, sizeof(aConfig.emSize));
+		settingsHash = DerivedDataCache::HashData(&aConfig.imageType, sizeof(aConfig.imageType), settingsHash);
 
-		if (std::filesystem::exists(filepath))
-		{
-			aStorageBuffer = FileSystem::ReadBytes(filepath);
-			aHeader = *aStorageBuffer.As<AtlasHeader>();
-			aPixels = (uint8_t*)aStorageBuffer.data + sizeof(AtlasHeader);
-			return true;
-		}
-		return false;
+		return DerivedDataCache::MakeKey("efa", DerivedDataCache::HashData(aFontData.data, aFontData.size), FontAtlasVersion, settingsHash);
 	}
 
-	static void CacheFontAtlas(const std::string& aFontName, float aFontSize, AtlasHeader aHeader, const void* aPixels)
+	static bool TryReadFontAtlasFromCache(const DerivedDataKey& aKey, AtlasHeader& aHeader, Buffer& aStorageBuffer)
 	{
-		Utils::CreateCacheDirectoryIfNeeded();
+		return DerivedDataCache::Load(aKey, [&](FileStreamReader& aStream)
+			{
+				aStream.ReadRaw<AtlasHeader>(aHeader);
+				aStream.ReadBuffer(aStorageBuffer, aHeader.width * aHeader.height * sizeof(float) * 4);
+				if (!aStream.IsStreamGood())
+				{
+					aStorageBuffer.Release();
+					return false;
+				}
 
-		std::string filename = fmt::format("{}{}.efa", Hash::GenerateFNVHash(aFontName), aFontSize);
-		std::filesystem::path filepath = Utils::GetCacheDirectory() / filename;
+				return true;
+			});
+	}
 
-		std::ofstream stream(filepath, std::ios::binary | std::ios::trunc);
-		if (!stream)
+	static void CacheFontAtlas(const DerivedDataKey& aKey, AtlasHeader aHeader, const void* aPixels)
+	{
+		const bool cached = DerivedDataCache::Store(aKey, [&](FileStreamWriter& aStream)
+			{
+				aStream.WriteRaw<AtlasHeader>(aHeader);
+				aStream.WriteData((const char*)aPixels, aHeader.width * aHeader.height * sizeof(float) * 4);
+				return true;
+			});
+
+		if (!cached)
 		{
-			stream.close();
-			LOG_ERROR_TAG("Renderer", "Failed to cache font atlas to {}", filepath.string());
-			return;
+			LOG_ERROR_TAG("Renderer", "Failed to cache font atlas");
 		}
-
-		stream.write((char*)&aHeader, sizeof(AtlasHeader));
-		stream.write((char*)aPixels, aHeader.width * aHeader.height * sizeof(float) * 4);
 	}
 
 	template <typename T, typename S, int N, GeneratorFunction<S, N> GEN_FN>
-	static std::shared_ptr<Texture2D> CreateAndCacheAtlas(const std::string& aFontName, float aFontSize, const std::vector<GlyphGeometry>& aGlyphs, const FontGeometry& aFontGeometry, const Configuration& aConfig)
+	static std::shared_ptr<Texture2D> CreateAndCacheAtlas(const DerivedDataKey& aKey, const std::vector<GlyphGeometry>& aGlyphs, const FontGeometry& aFontGeometry, const Configuration& aConfig)
 	{
 		ImmediateAtlasGenerator<S, N, GEN_FN, BitmapAtlasStorage<T, N>> generator(aConfig.width, aConfig.height);
 		generator.setAttributes(aConfig.generatorAttributes);
@@ -112,7 +103,7 @@ namespace Epoch
 		AtlasHeader header;
 		header.width = bitmap.width;
 		header.height = bitmap.height;
-		CacheFontAtlas(aFontName, aFontSize, header, bitmap.pixels);
+		CacheFontAtlas(aKey, header, bitmap.pixels);
 
 		TextureSpecification spec;
 		spec.format = TextureFormat::RGBA32F;
@@ -358,13 +349,14 @@ namespace Epoch
 		}
 
 		// Check cache here
+		const DerivedDataKey atlasKey = GetFontAtlasKey(aBuffer, config);
+
 		Buffer storageBuffer;
 		AtlasHeader header;
-		void* pixels;
-		if (TryReadFontAtlasFromCache(myName, (float)config.emSize, header, pixels, storageBuffer))
+		if (TryReadFontAtlasFromCache(atlasKey, header, storageBuffer))
 		{
 			LOG_INFO_TAG("Renderer", "Created cached font atlas");
-			myTextureAtlas = CreateCachedAtlas(header, pixels);
+			myTextureAtlas = CreateCachedAtlas(header, storageBuffer.data);
 			storageBuffer.Release();
 		}
 		else
@@ -378,21 +370,21 @@ namespace Epoch
 			case ImageType::MSDF:
 				if (floatingPointFormat)
 				{
-					texture = CreateAndCacheAtlas<float, float, 3, msdfGenerator>(myName, (float)config.emSize, myMSDFData->glyphs, myMSDFData->fontGeometry, config);
+					texture = CreateAndCacheAtlas<float, float, 3, msdfGenerator>(atlasKey, myMSDFData->glyphs, myMSDFData->fontGeometry, config);
 				}
 				else
 				{
-					texture = CreateAndCacheAtlas<byte, float, 3, msdfGenerator>(myName, (float)config.emSize, myMSDFData->glyphs, myMSDFData->fontGeometry, config);
+					texture = CreateAndCacheAtlas<byte, float, 3, msdfGenerator>(atlasKey, myMSDFData->glyphs, myMSDFData->fontGeometry, config);
 				}
 				break;
 			case ImageType::MTSDF:
 				if (floatingPointFormat)
 				{
-					texture = CreateAndCacheAtlas<float, float, 4, mtsdfGenerator>(myName, (float)config.emSize, myMSDFData->glyphs, myMSDFData->fontGeometry, config);
+					texture = CreateAndCacheAtlas<float, float, 4, mtsdfGenerator>(atlasKey, myMSDFData->glyphs, myMSDFData->fontGeometry, config);
 				}
 				else
 				{
-					texture = CreateAndCacheAtlas<byte, float, 4, mtsdfGenerator>(myName, (float)config.emSize, myMSDFData->glyphs, myMSDFData->fontGeometry, config);
+					texture = CreateAndCacheAtlas<byte, float, 4, mtsdfGenerator>(atlasKey, myMSDFData->glyphs, myMSDFData->fontGeometry, config);
 				}
 				break;
 			}
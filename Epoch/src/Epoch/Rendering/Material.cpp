@@ -1,6 +1,7 @@
 #include "epch.h"
 #include "Material.h"
 #include "Epoch/Assets/AssetManager.h"
+#include "Epoch/Rendering/ConstantBuffer.h"
 
 namespace Epoch
 {
@@ -129,6 +130,22 @@ namespace Epoch
 		myMaterialTexture = 0;
 	}
 
+	std::shared_ptr<ConstantBuffer> Material::GetConstantBuffer()
+	{
+		if (!myConstantBuffer)
+		{
+			myConstantBuffer = ConstantBuffer::Create(&myData, sizeof(Data));
+			myUploadedData = myData;
+		}
+		else if (memcmp(&myUploadedData, &myData, sizeof(Data)) != 0)
+		{
+			myConstantBuffer->SetData(&myData);
+			myUploadedData = myData;
+		}
+
+		return myConstantBuffer;
+	}
+
 	void Material::SetDefaults()
 	{
 		myData = Data();
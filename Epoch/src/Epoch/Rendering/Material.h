@@ -6,6 +6,7 @@
 namespace Epoch
 {
 	class Texture2D;
+	class ConstantBuffer;
 
 	class Material : public Asset
 	{
@@ -71,6 +72,9 @@ namespace Epoch
 		void SetMaterialTexture(UUID aTextureID);
 		void ClearMaterialTexture();
 
+		// GPU copy of the material data. Created on first use and only uploaded again when the data differs from the last upload.
+		std::shared_ptr<ConstantBuffer> GetConstantBuffer();
+
 		static AssetType GetStaticType() { return AssetType::Material; }
 		AssetType GetAssetType() const override { return  GetStaticType(); }
 		
@@ -84,6 +88,9 @@ namespace Epoch
 		UUID myNormalTexture = 0;
 		UUID myMaterialTexture = 0;
 
+		std::shared_ptr<ConstantBuffer> myConstantBuffer;
+		Data myUploadedData;
+
 		friend class MaterialSerializer;
 	};
 
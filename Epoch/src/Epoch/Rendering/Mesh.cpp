@@ -40,4 +40,27 @@ namespace Epoch
 			myBoundingBox.max.z = CU::Math::Max(vertex.position.z, myBoundingBox.max.z);
 		}
 	}
+
+	const MeshBVH& Mesh::GetSubmeshBVH(uint32_t aSubmeshIndex)
+	{
+		std::call_once(mySubmeshBVHsBuilt, [this]()
+			{
+				EPOCH_PROFILE_SCOPE("Mesh::BuildSubmeshBVHs");
+
+				mySubmeshBVHs.resize(mySubmeshes.size());
+				for (size_t i = 0; i < mySubmeshes.size(); i++)
+				{
+					const Submesh& submesh = mySubmeshes[i];
+					if (submesh.baseVertex >= myVertices.size() || (size_t)submesh.baseIndex + submesh.indexCount > myIndices.size())
+					{
+						continue;
+					}
+
+					const uint32_t vertexCount = CU::Math::Min(submesh.vertexCount, (uint32_t)myVertices.size() - submesh.baseVertex);
+					mySubmeshBVHs[i].Build(&myVertices[submesh.baseVertex], vertexCount, myIndices.data() + submesh.baseIndex, submesh.indexCount);
+				}
+			});
+
+		return mySubmeshBVHs[aSubmeshIndex];
+	}
 }
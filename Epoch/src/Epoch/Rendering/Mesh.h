@@ -3,11 +3,13 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <mutex>
 #include <CommonUtilities/Color.h>
 #include <CommonUtilities/Math/Transform.h>
 #include "Epoch/Debug/Log.h"
 #include "Epoch/Assets/Asset.h"
 #include "Epoch/Math/AABB.h"
+#include "Epoch/Math/MeshBVH.h"
 #include "Epoch/Serialization/StreamReader.h"
 #include "Epoch/Serialization/StreamWriter.h"
 
@@ -75,6 +77,7 @@ namespace Epoch
 		Vertex vertex1;
 		Vertex vertex2;
 
+		Triangle() = default;
 		Triangle(const Vertex& v0, const Vertex& v1, const Vertex& v2) : vertex0(v0), vertex1(v1), vertex2(v2) {}
 	};
 
@@ -221,6 +224,9 @@ namespace Epoch
 
 		const AABB& GetBoundingBox() const { return myBoundingBox; }
 
+		// Built from the vertex and index data the first time any submesh is queried, in the space of the submesh vertices
+		const MeshBVH& GetSubmeshBVH(uint32_t aSubmeshIndex);
+
 		bool HasSkeleton() const { return (bool)mySkeleton; }
 		std::shared_ptr<Skeleton> GetSkeleton() const { return mySkeleton; }
 
@@ -244,6 +250,9 @@ namespace Epoch
 
 		std::unordered_map<uint32_t, std::vector<Triangle>> myTriangleCache;
 
+		std::vector<MeshBVH> mySubmeshBVHs;
+		std::once_flag mySubmeshBVHsBuilt;
+
 		AABB myBoundingBox;
 
 		std::shared_ptr<Skeleton> mySkeleton;
@@ -0,0 +1,82 @@
+#include "epch.h"
+#include "RenderQueue.h"
+
+namespace Epoch
+{
+	uint64_t RenderQueue::MakeKey(RenderQueuePass aPass, uint32_t aMaterial, uint32_t aMesh, uint32_t aSubmesh, uint32_t aDepth)
+	{
+		EPOCH_ASSERT(aMaterial < MaxMaterials, "Too many materials in the render queue!");
+		EPOCH_ASSERT(aMesh < MaxMeshes, "Too many meshes in the render queue!");
+		EPOCH_ASSERT(aSubmesh < MaxSubmeshes, "Submesh index doesn't fit in the render queue key!");
+
+		return ((uint64_t)aPass << PassShift) |
+			((uint64_t)aMaterial << MaterialShift) |
+			((uint64_t)aMesh << MeshShift) |
+			((uint64_t)aSubmesh << SubmeshShift) |
+			((uint64_t)aDepth << DepthShift);
+	}
+
+	uint32_t RenderQueue::QuantizeDepth(float aDepth, float aMaxDepth)
+	{
+		constexpr uint32_t maxValue = (1u << DepthBits) - 1;
+
+		if (aMaxDepth <= 0.0f)
+		{
+			return 0;
+		}
+
+		const float normalizedDepth = CU::Math::Clamp(aDepth / aMaxDepth, 0.0f, 1.0f);
+		return (uint32_t)(normalizedDepth * (float)maxValue);
+	}
+
+	void RenderQueue::Sort()
+	{
+		EPOCH_PROFILE_FUNC();
+
+		const size_t count = myItems.size();
+		if (count < 2)
+		{
+			return;
+		}
+
+		mySortBuffer.resize(count);
+
+		Item* source = myItems.data();
+		Item* destination = mySortBuffer.data();
+
+		for (uint32_t shift = 0; shift < 64; shift += 8)
+		{
+			std::array<size_t, 256> offsets = {};
+			for (size_t i = 0; i < count; i++)
+			{
+				offsets[(source[i].key >> shift) & 0xFF]++;
+			}
+
+			// All keys share this byte, the pass wouldn't change the order
+			if (offsets[(source[0].key >> shift) & 0xFF] == count)
+			{
+				continue;
+			}
+
+			size_t total = 0;
+			for (size_t& offset : offsets)
+			{
+				const size_t bucketCount = offset;
+				offset = total;
+				total += bucketCount;
+			}
+
+			for (size_t i = 0; i < count; i++)
+			{
+				destination[offsets[(source[i].key >> shift) & 0xFF]++] = source[i];
+			}
+
+			std::swap(source, destination);
+		}
+
+		if (source != myItems.data())
+		{
+			std::copy(source, source + count, myItems.data());
+		}
+	}
+}
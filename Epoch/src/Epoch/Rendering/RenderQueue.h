@@ -0,0 +1,96 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+namespace Epoch
+{
+	enum class RenderQueuePass : uint32_t
+	{
+		Opaque = 0
+	};
+
+	// Flat list of draw items sorted by a 64 bit key.
+	// The key packs, from most to least significant bits: pass, material, mesh, submesh and depth.
+	// Material and mesh are per frame indices, not asset handles, so the renderer decides what they map to.
+	// Items only carry an index into the renderer's own per item data so the queue knows nothing about the backend.
+	class RenderQueue
+	{
+	public:
+		static constexpr uint32_t PassBits = 4;
+		static constexpr uint32_t MaterialBits = 20;
+		static constexpr uint32_t MeshBits = 20;
+		static constexpr uint32_t SubmeshBits = 12;
+		static constexpr uint32_t DepthBits = 8;
+
+		static constexpr uint32_t DepthShift = 0;
+		static constexpr uint32_t SubmeshShift = DepthShift + DepthBits;
+		static constexpr uint32_t MeshShift = SubmeshShift + SubmeshBits;
+		static constexpr uint32_t MaterialShift = MeshShift + MeshBits;
+		static constexpr uint32_t PassShift = MaterialShift + MaterialBits;
+
+		static constexpr uint32_t MaxMaterials = 1u << MaterialBits;
+		static constexpr uint32_t MaxMeshes = 1u << MeshBits;
+		static constexpr uint32_t MaxSubmeshes = 1u << SubmeshBits;
+
+		struct Item
+		{
+			uint64_t key = 0;
+			uint32_t index = 0;
+		};
+
+		// Indices that don't fit would alias other keys, callers have to draw those some other way
+		static bool FitsKey(uint32_t aMaterial, uint32_t aMesh, uint32_t aSubmesh) { return aMaterial < MaxMaterials && aMesh < MaxMeshes && aSubmesh < MaxSubmeshes; }
+		static uint64_t MakeKey(RenderQueuePass aPass, uint32_t aMaterial, uint32_t aMesh, uint32_t aSubmesh, uint32_t aDepth);
+
+		// Maps a distance in the range [0, aMaxDepth] to the depth bits of the key
+		static uint32_t QuantizeDepth(float aDepth, float aMaxDepth);
+
+		static RenderQueuePass GetPass(uint64_t aKey) { return (RenderQueuePass)GetBits(aKey, PassShift, PassBits); }
+		static uint32_t GetMaterial(uint64_t aKey) { return GetBits(aKey, MaterialShift, MaterialBits); }
+		static uint32_t GetMesh(uint64_t aKey) { return GetBits(aKey, MeshShift, MeshBits); }
+		static uint32_t GetSubmesh(uint64_t aKey) { return GetBits(aKey, SubmeshShift, SubmeshBits); }
+		static uint32_t GetDepth(uint64_t aKey) { return GetBits(aKey, DepthShift, DepthBits); }
+
+		void Submit(uint64_t aKey, uint32_t aIndex) { myItems.push_back({ aKey, aIndex }); }
+
+		// Stable LSD radix sort, byte passes where every key has the same value are skipped
+		void Sort();
+
+		// Keeps the allocated memory so the next frame doesn't have to grow the buffers again
+		void Clear() { myItems.clear(); }
+
+		const std::vector<Item>& GetItems() const { return myItems; }
+		size_t Size() const { return myItems.size(); }
+		bool Empty() const { return myItems.empty(); }
+
+		// Calls aCallback(aFirst, aLast) for every run of sorted items that only differ in depth, aLast is exclusive.
+		// A run can be drawn with a single instanced draw.
+		template<typename F>
+		void ForEachRun(F&& aCallback) const
+		{
+			constexpr uint64_t depthMask = ((1ull << DepthBits) - 1) << DepthShift;
+
+			size_t first = 0;
+			while (first < myItems.size())
+			{
+				const uint64_t runKey = myItems[first].key & ~depthMask;
+
+				size_t last = first + 1;
+				while (last < myItems.size() && (myItems[last].key & ~depthMask) == runKey)
+				{
+					last++;
+				}
+
+				aCallback(first, last);
+				first = last;
+			}
+		}
+
+	private:
+		static uint32_t GetBits(uint64_t aKey, uint32_t aShift, uint32_t aBits) { return (uint32_t)((aKey >> aShift) & ((1ull << aBits) - 1)); }
+
+	private:
+		std::vector<Item> myItems;
+		std::vector<Item> mySortBuffer;
+	};
+}
@@ -0,0 +1,96 @@
+#include "epch.h"
+#include "RenderStateCache.h"
+
+namespace Epoch
+{
+	static const uint8_t staticUnknownBindingTag = 0;
+	const void* const RenderStateCache::UnknownBinding = &staticUnknownBindingTag;
+
+	RenderStateCache::RenderStateCache()
+	{
+		Invalidate();
+	}
+
+	void RenderStateCache::Invalidate()
+	{
+		myPipeline = UnknownBinding;
+
+		for (auto& stage : myConstantBuffers)
+		{
+			stage.fill(UnknownBinding);
+		}
+
+		InvalidateTextures();
+	}
+
+	void RenderStateCache::InvalidateTextures()
+	{
+		myTextures.fill(UnknownBinding);
+	}
+
+	bool RenderStateCache::SetPipeline(const void* aPipeline)
+	{
+		if (myPipeline == aPipeline)
+		{
+			myStats.skippedBinds++;
+			return false;
+		}
+
+		myPipeline = aPipeline;
+		myStats.pipelineBinds++;
+		return true;
+	}
+
+	bool RenderStateCache::SetConstantBuffer(uint32_t aStages, uint32_t aSlot, const void* aBuffer)
+	{
+		EPOCH_ASSERT(aSlot < MaxConstantBufferSlots, "Constant buffer slot out of range!");
+
+		bool changed = false;
+		for (uint32_t stage = 0; stage < StageCount; stage++)
+		{
+			if ((aStages & BIT(stage)) && myConstantBuffers[stage][aSlot] != aBuffer)
+			{
+				myConstantBuffers[stage][aSlot] = aBuffer;
+				changed = true;
+			}
+		}
+
+		if (!changed)
+		{
+			myStats.skippedBinds++;
+			return false;
+		}
+
+		myStats.constantBufferBinds++;
+		return true;
+	}
+
+	bool RenderStateCache::SetTextures(uint32_t aFirstSlot, uint32_t aCount, const void* const* aViews, uint32_t& outFirstChangedSlot, uint32_t& outChangedCount)
+	{
+		EPOCH_ASSERT(aFirstSlot + aCount <= MaxTextureSlots, "Texture slot out of range!");
+
+		uint32_t firstChanged = UINT32_MAX;
+		uint32_t lastChanged = 0;
+		for (uint32_t i = 0; i < aCount; i++)
+		{
+			const uint32_t slot = aFirstSlot + i;
+			if (myTextures[slot] != aViews[i])
+			{
+				myTextures[slot] = aViews[i];
+				firstChanged = CU::Math::Min(firstChanged, slot);
+				lastChanged = slot;
+			}
+		}
+
+		if (firstChanged == UINT32_MAX)
+		{
+			myStats.skippedBinds++;
+			return false;
+		}
+
+		outFirstChangedSlot = firstChanged;
+		outChangedCount = lastChanged - firstChanged + 1;
+		myStats.textureBinds++;
+		return true;
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+namespace Epoch
+{
+	// Remembers what is bound to the pipeline so redundant binds can be skipped.
+	// The cache only compares opaque object pointers, the caller issues the actual backend calls when a Set function returns true.
+	// Anything bound without going through the cache has to be followed by an Invalidate call.
+	class RenderStateCache
+	{
+	public:
+		static constexpr uint32_t MaxConstantBufferSlots = 14;
+		static constexpr uint32_t MaxTextureSlots = 16;
+
+		struct Stats
+		{
+			uint32_t pipelineBinds = 0;
+			uint32_t constantBufferBinds = 0;
+			uint32_t textureBinds = 0;
+			uint32_t skippedBinds = 0;
+		};
+
+		RenderStateCache();
+		~RenderStateCache() = default;
+
+		// Forgets all bound state, the next bind of every slot goes through
+		void Invalidate();
+		void InvalidateTextures();
+
+		bool SetPipeline(const void* aPipeline);
+		void RemovePipeline() { myPipeline = nullptr; }
+
+		// aStages is a mask of PIPELINE_STAGE values, the buffer is bound if any of the stages has something else bound
+		bool SetConstantBuffer(uint32_t aStages, uint32_t aSlot, const void* aBuffer);
+
+		// Pixel shader textures. Returns false if all views are already bound, otherwise the smallest range of slots that changed.
+		bool SetTextures(uint32_t aFirstSlot, uint32_t aCount, const void* const* aViews, uint32_t& outFirstChangedSlot, uint32_t& outChangedCount);
+
+		const Stats& GetStats() const { return myStats; }
+		void ResetStats() { myStats = Stats(); }
+
+	private:
+		static constexpr uint32_t StageCount = 4;
+
+		// Stored for slots that haven't been bound through the cache, never equal to a real object
+		static const void* const UnknownBinding;
+
+		const void* myPipeline;
+		std::array<std::array<const void*, MaxConstantBufferSlots>, StageCount> myConstantBuffers;
+		std::array<const void*, MaxTextureSlots> myTextures;
+
+		Stats myStats;
+	};
+}
@@ -6,5 +6,8 @@ namespace Epoch
 	struct RendererConfig
 	{
 		std::string shaderPackPath;
+
+		// Memory the mips of cooked textures are streamed within, 0 loads every mip up front
+		uint64_t textureStreamingBudget = 512ull * 1024 * 1024;
 	};
 }
@@ -19,6 +19,13 @@ namespace Epoch
 		RG16F,
 		R32F,
 		R32UI,
+
+		// Block compressed, only produced by the texture cooker
+		BC1,
+		BC3,
+		BC4,
+		BC5,
+		BC7,
 		
 		DEPTH32
 	};
@@ -40,8 +47,42 @@ namespace Epoch
 		return false;
 	}
 
+	static bool IsBlockCompressedFormat(TextureFormat aFormat)
+	{
+		switch (aFormat)
+		{
+		case TextureFormat::BC1:
+		case TextureFormat::BC3:
+		case TextureFormat::BC4:
+		case TextureFormat::BC5:
+		case TextureFormat::BC7:
+			return true;
+		}
+		return false;
+	}
+
+	// Size in bytes of one 4x4 block
+	inline static size_t GetBlockSize(TextureFormat aFormat)
+	{
+		switch (aFormat)
+		{
+		case TextureFormat::BC1:			return 8;
+		case TextureFormat::BC4:			return 8;
+		case TextureFormat::BC3:			return 16;
+		case TextureFormat::BC5:			return 16;
+		case TextureFormat::BC7:			return 16;
+		}
+		EPOCH_ASSERT(false, "Not a block compressed format!");
+		return 0;
+	}
+
 	inline static size_t GetMemorySize(TextureFormat format, uint32_t width, uint32_t height)
 	{
+		if (IsBlockCompressedFormat(format))
+		{
+			return ((width + 3) / 4) * ((height + 3) / 4) * GetBlockSize(format);
+		}
+
 		switch (format)
 		{
 			//case TextureFormat::RGB:			return width * height * 3;
@@ -58,6 +99,33 @@ namespace Epoch
 		EPOCH_ASSERT(false, "Unknown texture format!");
 		return 0;
 	}
+
+	// Bytes between two rows of pixels, or two rows of blocks for block compressed formats
+	inline static size_t GetRowPitch(TextureFormat aFormat, uint32_t aWidth)
+	{
+		if (IsBlockCompressedFormat(aFormat))
+		{
+			return ((aWidth + 3) / 4) * GetBlockSize(aFormat);
+		}
+		return GetMemorySize(aFormat, aWidth, 1);
+	}
+
+	// Size of aMipCount tightly packed mips, starting with the full size one
+	inline static size_t GetMipChainMemorySize(TextureFormat aFormat, uint32_t aWidth, uint32_t aHeight, uint32_t aMipCount)
+	{
+		size_t size = 0;
+		for (uint32_t mip = 0; mip < aMipCount; mip++)
+		{
+			size += GetMemorySize(aFormat, CU::Math::Max(aWidth >> mip, 1u), CU::Math::Max(aHeight >> mip, 1u));
+		}
+		return size;
+	}
+
+	// Size of the mips from aFirstMip to the last one, the part of a cooked texture that is resident when streaming
+	inline static size_t GetMipTailMemorySize(TextureFormat aFormat, uint32_t aWidth, uint32_t aHeight, uint32_t aFirstMip, uint32_t aMipCount)
+	{
+		return GetMipChainMemorySize(aFormat, aWidth, aHeight, aMipCount) - GetMipChainMemorySize(aFormat, aWidth, aHeight, aFirstMip);
+	}
 	
 	struct TextureSpecification
 	{
@@ -68,6 +136,12 @@ namespace Epoch
 		
 		bool generateMips = false;
 
+		// Mips already present in the texture data, more than one means they were generated offline
+		uint32_t mipCount = 1;
+
+		// First mip in the texture data, the ones above it are streamed in later
+		uint32_t residentMip = 0;
+
 		std::string debugName;
 	};
 
@@ -104,6 +178,13 @@ namespace Epoch
 		uint32_t GetMipLevelCount() const { return CU::Math::FloorToUInt(log2f((float)CU::Math::Min(mySpecification.width, mySpecification.height)) + 1); }
 		std::pair<uint32_t, uint32_t> GetMipSize(uint32_t aMipLevel) const;
 
+		// Streaming of cooked textures, mips before the resident mip only exist in the asset pack
+		uint32_t GetMipCount() const { return mySpecification.mipCount; }
+		uint32_t GetResidentMip() const { return mySpecification.residentMip; }
+
+		// aMipData holds the mips from aFirstMip to the last one. It can be left empty when only dropping mips.
+		virtual void SetResidentMips(uint32_t aFirstMip, Buffer aMipData) = 0;
+
 		static AssetType GetStaticType() { return AssetType::Texture; }
 		AssetType GetAssetType() const override { return GetStaticType(); }
 
@@ -0,0 +1,334 @@
+#include "epch.h"
+#include "TextureStreamer.h"
+#include "Epoch/Core/Application.h"
+
+namespace Epoch
+{
+	TextureStreamer::TextureStreamer(std::unique_ptr<TextureStreamingDevice> aDevice, const TextureStreamingSettings& aSettings) : myDevice(std::move(aDevice)), mySettings(aSettings)
+	{
+		EPOCH_ASSERT(myDevice, "Texture streamer needs a device!");
+	}
+
+	TextureStreamer::~TextureStreamer()
+	{
+		// Reads that are still running use the device
+		for (PendingLoad& load : myPendingLoads)
+		{
+			if (load.data.wait_for(std::chrono::seconds(0)) != std::future_status::deferred)
+			{
+				load.data.get().Release();
+			}
+		}
+	}
+
+	uint32_t TextureStreamer::GetTailMip(TextureFormat aFormat, uint32_t aWidth, uint32_t aHeight, uint32_t aMipCount)
+	{
+		if (aMipCount <= 1)
+		{
+			return 0;
+		}
+
+		uint32_t tailMip = 0;
+		while (tailMip + 1 < aMipCount && CU::Math::Max(aWidth >> tailMip, aHeight >> tailMip) > TailSize)
+		{
+			tailMip++;
+		}
+
+		Entry entry;
+		entry.format = aFormat;
+		entry.width = aWidth;
+		entry.height = aHeight;
+		while (tailMip > 0 && !IsValidFirstMip(entry, tailMip))
+		{
+			tailMip--;
+		}
+
+		return tailMip;
+	}
+
+	void TextureStreamer::Register(AssetHandle aTexture, TextureFormat aFormat, uint32_t aWidth, uint32_t aHeight, uint32_t aMipCount, uint32_t aResidentMip)
+	{
+		const uint32_t tailMip = GetTailMip(aFormat, aWidth, aHeight, aMipCount);
+		if (tailMip == 0)
+		{
+			return;
+		}
+
+		Unregister(aTexture);
+
+		Entry& entry = myEntries[aTexture];
+		entry.format = aFormat;
+		entry.width = aWidth;
+		entry.height = aHeight;
+		entry.mipCount = aMipCount;
+		entry.tailMip = tailMip;
+		entry.residentMip = CU::Math::Min(aResidentMip, tailMip);
+
+		myResidentMemory += GetResidentSize(entry, entry.residentMip);
+	}
+
+	void TextureStreamer::Unregister(AssetHandle aTexture)
+	{
+		auto it = myEntries.find(aTexture);
+		if (it == myEntries.end())
+		{
+			return;
+		}
+
+		// A load that is still in flight is thrown away when it finishes
+		myResidentMemory -= GetResidentSize(it->second, it->second.residentMip);
+		myEntries.erase(it);
+	}
+
+	void TextureStreamer::RequestScreenSize(AssetHandle aTexture, float aScreenSize)
+	{
+		auto it = myEntries.find(aTexture);
+		if (it == myEntries.end())
+		{
+			return;
+		}
+
+		const float largestSide = (float)CU::Math::Max(it->second.width, it->second.height);
+
+		uint32_t mip = 0;
+		if (aScreenSize > 0.0f && aScreenSize < largestSide)
+		{
+			mip = CU::Math::FloorToUInt(log2f(largestSide / aScreenSize));
+		}
+		else if (aScreenSize <= 0.0f)
+		{
+			mip = it->second.tailMip;
+		}
+
+		RequestMip(aTexture, mip);
+	}
+
+	void TextureStreamer::RequestMip(AssetHandle aTexture, uint32_t aMip)
+	{
+		auto it = myEntries.find(aTexture);
+		if (it == myEntries.end())
+		{
+			return;
+		}
+
+		Entry& entry = it->second;
+
+		uint32_t mip = CU::Math::Min(aMip, entry.tailMip);
+		while (mip > 0 && !IsValidFirstMip(entry, mip))
+		{
+			mip--;
+		}
+
+		entry.requestedMip = entry.lastRequestedFrame == myFrame ? CU::Math::Min(entry.requestedMip, mip) : mip;
+		entry.lastRequestedFrame = myFrame;
+	}
+
+	void TextureStreamer::Update()
+	{
+		EPOCH_PROFILE_FUNC();
+
+		ApplyFinishedLoads();
+
+		// The budget can have shrunk since last frame
+		if (myResidentMemory + myReservedMemory > mySettings.memoryBudget)
+		{
+			EvictLeastRecentlyUsed(0);
+		}
+
+		StartLoads();
+
+		if (!mySettings.asyncLoading)
+		{
+			ApplyFinishedLoads();
+		}
+
+		myStats.textureCount = (uint32_t)myEntries.size();
+		myStats.loadsInFlight = (uint32_t)myPendingLoads.size();
+		myStats.residentMemory = myResidentMemory;
+		myStats.memoryBudget = mySettings.memoryBudget;
+
+		myFrame++;
+	}
+
+	uint32_t TextureStreamer::GetResidentMip(AssetHandle aTexture) const
+	{
+		auto it = myEntries.find(aTexture);
+		return it != myEntries.end() ? it->second.residentMip : 0;
+	}
+
+	uint64_t TextureStreamer::GetResidentSize(const Entry& aEntry, uint32_t aFirstMip) const
+	{
+		return GetMipTailMemorySize(aEntry.format, aEntry.width, aEntry.height, aFirstMip, aEntry.mipCount);
+	}
+
+	bool TextureStreamer::IsValidFirstMip(const Entry& aEntry, uint32_t aFirstMip)
+	{
+		// The largest mip of a block compressed texture has to be made of whole blocks
+		if (!IsBlockCompressedFormat(aEntry.format))
+		{
+			return true;
+		}
+
+		return ((aEntry.width >> aFirstMip) % 4) == 0 && ((aEntry.height >> aFirstMip) % 4) == 0;
+	}
+
+	void TextureStreamer::ApplyFinishedLoads()
+	{
+		for (size_t i = 0; i < myPendingLoads.size();)
+		{
+			PendingLoad& load = myPendingLoads[i];
+			if (load.data.wait_for(std::chrono::seconds(0)) == std::future_status::timeout)
+			{
+				i++;
+				continue;
+			}
+
+			Buffer data = load.data.get();
+			myReservedMemory -= load.reservedMemory;
+
+			auto it = myEntries.find(load.texture);
+			if (it != myEntries.end() && it->second.loadingMip == load.firstMip)
+			{
+				Entry& entry = it->second;
+				entry.loadingMip = NoMip;
+
+				if (data)
+				{
+					myDevice->SetResidentMips(load.texture, load.firstMip, data);
+
+					myResidentMemory -= GetResidentSize(entry, entry.residentMip);
+					entry.residentMip = load.firstMip;
+					myResidentMemory += GetResidentSize(entry, entry.residentMip);
+
+					myStats.loadsCompleted++;
+				}
+			}
+
+			data.Release();
+
+			myPendingLoads[i] = std::move(myPendingLoads.back());
+			myPendingLoads.pop_back();
+		}
+	}
+
+	bool TextureStreamer::EvictLeastRecentlyUsed(uint64_t aNeededMemory)
+	{
+		const auto fits = [&]() { return myResidentMemory + myReservedMemory + aNeededMemory <= mySettings.memoryBudget; };
+
+		if (fits())
+		{
+			return true;
+		}
+
+		// Textures that weren't requested this frame go back to their tail, the ones that were only drop the mips they don't need
+		std::vector<std::pair<uint64_t, AssetHandle>> candidates;
+		for (const auto& [handle, entry] : myEntries)
+		{
+			if (entry.loadingMip != NoMip || entry.residentMip >= entry.tailMip)
+			{
+				continue;
+			}
+
+			if (entry.lastRequestedFrame != myFrame || entry.requestedMip > entry.residentMip)
+			{
+				candidates.emplace_back(entry.lastRequestedFrame, handle);
+			}
+		}
+
+		std::sort(candidates.begin(), candidates.end(), [](const auto& aLhs, const auto& aRhs) { return aLhs.first < aRhs.first; });
+
+		for (const auto& [lastRequestedFrame, handle] : candidates)
+		{
+			Entry& entry = myEntries.at(handle);
+			const uint32_t targetMip = lastRequestedFrame != myFrame ? entry.tailMip : entry.requestedMip;
+
+			myDevice->SetResidentMips(handle, targetMip, Buffer());
+
+			myResidentMemory -= GetResidentSize(entry, entry.residentMip);
+			entry.residentMip = targetMip;
+			myResidentMemory += GetResidentSize(entry, entry.residentMip);
+
+			myStats.evictions++;
+
+			if (fits())
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void TextureStreamer::StartLoads()
+	{
+		if (myPendingLoads.size() >= mySettings.maxLoadsInFlight)
+		{
+			return;
+		}
+
+		std::vector<std::pair<AssetHandle, Entry*>> requests;
+		for (auto& [handle, entry] : myEntries)
+		{
+			if (entry.lastRequestedFrame == myFrame && entry.requestedMip < entry.residentMip && entry.loadingMip == NoMip)
+			{
+				requests.emplace_back(handle, &entry);
+			}
+		}
+
+		// The textures furthest from what they need go first
+		std::sort(requests.begin(), requests.end(), [](const auto& aLhs, const auto& aRhs)
+			{
+				return aLhs.second->residentMip - aLhs.second->requestedMip > aRhs.second->residentMip - aRhs.second->requestedMip;
+			});
+
+		for (auto& [handle, entry] : requests)
+		{
+			if (myPendingLoads.size() >= mySettings.maxLoadsInFlight)
+			{
+				break;
+			}
+
+			const uint64_t residentSize = GetResidentSize(*entry, entry->residentMip);
+
+			uint32_t targetMip = entry->requestedMip;
+			EvictLeastRecentlyUsed(GetResidentSize(*entry, targetMip) - residentSize);
+
+			// Settle for a coarser mip if the requested one doesn't fit
+			while (targetMip < entry->residentMip)
+			{
+				const uint64_t cost = GetResidentSize(*entry, targetMip) - residentSize;
+				if (IsValidFirstMip(*entry, targetMip) && myResidentMemory + myReservedMemory + cost <= mySettings.memoryBudget)
+				{
+					break;
+				}
+				targetMip++;
+			}
+
+			if (targetMip >= entry->residentMip)
+			{
+				continue;
+			}
+
+			PendingLoad& load = myPendingLoads.emplace_back();
+			load.texture = handle;
+			load.firstMip = targetMip;
+			load.reservedMemory = GetResidentSize(*entry, targetMip) - residentSize;
+
+			TextureStreamingDevice* device = myDevice.get();
+			const AssetHandle texture = handle;
+			auto read = [device, texture, targetMip]() { return device->ReadMips(texture, targetMip); };
+
+			if (mySettings.asyncLoading)
+			{
+				load.data = Application::Get().GetJobSystem().AddAJob(read);
+			}
+			else
+			{
+				load.data = std::async(std::launch::deferred, read);
+			}
+
+			entry->loadingMip = targetMip;
+			myReservedMemory += load.reservedMemory;
+		}
+	}
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include <future>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "Epoch/Core/Buffer.h"
+#include "Epoch/Assets/Asset.h"
+#include "Epoch/Rendering/Texture.h"
+
+namespace Epoch
+{
+	// Where the streamer gets mip data from and where it puts it, the streamer itself only does the bookkeeping
+	class TextureStreamingDevice
+	{
+	public:
+		virtual ~TextureStreamingDevice() = default;
+
+		// Returns the mips from aFirstMip to the last one tightly packed. Called from worker threads when loading asynchronously.
+		virtual Buffer ReadMips(AssetHandle aTexture, uint32_t aFirstMip) = 0;
+
+		// Called from TextureStreamer::Update. aMipData is empty when mips are only dropped, the device doesn't take ownership of it.
+		virtual void SetResidentMips(AssetHandle aTexture, uint32_t aFirstMip, Buffer aMipData) = 0;
+	};
+
+	struct TextureStreamingSettings
+	{
+		uint64_t memoryBudget = 512ull * 1024 * 1024;
+		uint32_t maxLoadsInFlight = 8;
+
+		// Reads mips on the job system, otherwise they are read and applied inside Update
+		bool asyncLoading = true;
+	};
+
+	// Keeps the mips of cooked textures resident based on how large they appear on screen.
+	// The smallest mips (the tail) are always resident, finer mips are loaded when requested and
+	// the least recently requested textures are dropped back to their tail to stay within the memory budget.
+	class TextureStreamer
+	{
+	public:
+		// Mips at or below this size are loaded with the texture and never evicted
+		static constexpr uint32_t TailSize = 64;
+
+		struct Stats
+		{
+			uint32_t textureCount = 0;
+			uint32_t loadsInFlight = 0;
+			uint32_t loadsCompleted = 0;
+			uint32_t evictions = 0;
+			uint64_t residentMemory = 0;
+			uint64_t memoryBudget = 0;
+		};
+
+		TextureStreamer(std::unique_ptr<TextureStreamingDevice> aDevice, const TextureStreamingSettings& aSettings = TextureStreamingSettings());
+		~TextureStreamer();
+
+		// The finest mip that is loaded with the texture, 0 when the texture is small enough to not be streamed
+		static uint32_t GetTailMip(TextureFormat aFormat, uint32_t aWidth, uint32_t aHeight, uint32_t aMipCount);
+
+		void Register(AssetHandle aTexture, TextureFormat aFormat, uint32_t aWidth, uint32_t aHeight, uint32_t aMipCount, uint32_t aResidentMip);
+		void Unregister(AssetHandle aTexture);
+		bool IsRegistered(AssetHandle aTexture) const { return myEntries.find(aTexture) != myEntries.end(); }
+
+		// aScreenSize is roughly how many pixels the texture covers along its largest side this frame
+		void RequestScreenSize(AssetHandle aTexture, float aScreenSize);
+		void RequestMip(AssetHandle aTexture, uint32_t aMip);
+
+		// Applies finished loads, evicts to the budget and starts loads for this frame's requests
+		void Update();
+
+		uint32_t GetResidentMip(AssetHandle aTexture) const;
+
+		void SetMemoryBudget(uint64_t aBudget) { mySettings.memoryBudget = aBudget; }
+		const Stats& GetStats() const { return myStats; }
+
+	private:
+		static constexpr uint32_t NoMip = UINT32_MAX;
+
+		struct Entry
+		{
+			TextureFormat format = TextureFormat::None;
+			uint32_t width = 0;
+			uint32_t height = 0;
+			uint32_t mipCount = 0;
+			uint32_t tailMip = 0;
+
+			uint32_t residentMip = 0;
+			uint32_t requestedMip = NoMip;
+			uint32_t loadingMip = NoMip;
+			uint64_t lastRequestedFrame = 0;
+		};
+
+		struct PendingLoad
+		{
+			AssetHandle texture;
+			uint32_t firstMip = 0;
+			uint64_t reservedMemory = 0;
+			std::future<Buffer> data;
+		};
+
+		uint64_t GetResidentSize(const Entry& aEntry, uint32_t aFirstMip) const;
+		static bool IsValidFirstMip(const Entry& aEntry, uint32_t aFirstMip);
+
+		void ApplyFinishedLoads();
+		bool EvictLeastRecentlyUsed(uint64_t aNeededMemory);
+		void StartLoads();
+
+	private:
+		std::unique_ptr<TextureStreamingDevice> myDevice;
+		TextureStreamingSettings mySettings;
+
+		std::unordered_map<AssetHandle, Entry> myEntries;
+		std::vector<PendingLoad> myPendingLoads;
+
+		uint64_t myResidentMemory = 0;
+		uint64_t myReservedMemory = 0;
+		uint64_t myFrame = 1;
+
+		Stats myStats;
+	};
+}
@@ -33,6 +33,11 @@ namespace Epoch
 		ActiveComponent(const ActiveComponent&) = default;
 	};
 
+	// Tag kept by the scene on entities that are inactive themselves or have an inactive ancestor, so views can exclude them
+	struct InactiveInHierarchyComponent
+	{
+	};
+
 	struct NameComponent
 	{
 		std::string name;
@@ -6,17 +6,18 @@ namespace Epoch
 {
 	bool Entity::IsActive(bool aCheckAncestor) const
 	{
-		if (!GetComponent<ActiveComponent>().isActive)
-		{
-			return false;
-		}
-
 		if (aCheckAncestor)
 		{
-			return IsAncestorActive();
+			// The scene propagates the state down the hierarchy whenever activation or parenting changes
+			return !HasComponent<InactiveInHierarchyComponent>();
 		}
 
-		return true;
+		return GetComponent<ActiveComponent>().isActive;
+	}
+
+	void Entity::SetIsActive(bool aState)
+	{
+		myScene->myRegistry.patch<ActiveComponent>(myEntityHandle, [&](ActiveComponent& aComponent) { aComponent.isActive = aState; });
 	}
 
 	bool Entity::IsAncestorActive() const
@@ -27,12 +28,7 @@ namespace Epoch
 		}
 
 		Entity parent = GetParent();
-		if (!parent.IsActive())
-		{
-			return false;
-		}
-
-		return true;
+		return !parent || parent.IsActive();
 	}
 
 	Entity Entity::GetParent() const
@@ -68,6 +64,19 @@ namespace Epoch
 		}
 	}
 
+	void Entity::SetName(const std::string& aName)
+	{
+		myScene->myRegistry.patch<NameComponent>(myEntityHandle, [&](NameComponent& aComponent) { aComponent.name = aName; });
+	}
+
+	void Entity::SetParentUUID(UUID aParent)
+	{
+		GetComponent<RelationshipComponent>().parentHandle = aParent;
+		myScene->myHierarchyVersion++;
+		myScene->RefreshActiveInHierarchy(myEntityHandle);
+		myScene->OnEntityReparented(myEntityHandle);
+	}
+
 	std::vector<Entity> Entity::GetChildren()
 	{
 		std::vector<Entity> entities;
@@ -89,6 +98,7 @@ namespace Epoch
 		if (it != children.end())
 		{
 			children.erase(it);
+			myScene->myHierarchyVersion++;
 			return true;
 		}
 
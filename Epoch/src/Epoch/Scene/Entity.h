@@ -45,16 +45,18 @@ namespace Epoch
 
 		UUID GetUUID() { return GetComponent<IDComponent>().id; }
 		const std::string& GetName() { return GetComponent<NameComponent>().name; }
+		// Goes through the registry so the name index of the scene sees the change
+		void SetName(const std::string& aName);
 
 		bool IsActive(bool aCheckAncestor = true) const;
-		void SetIsActive(bool aState) { GetComponent<ActiveComponent>().isActive = aState; }
+		void SetIsActive(bool aState);
 		bool IsAncestorActive() const;
 
 		bool HasParent() const { return GetComponent<RelationshipComponent>().parentHandle != 0; }
 		Entity GetParent() const;
 		void SetParent(Entity aParent);
 
-		void SetParentUUID(UUID aParent) { GetComponent<RelationshipComponent>().parentHandle = aParent; }
+		void SetParentUUID(UUID aParent);
 		UUID GetParentUUID() const { return GetComponent<RelationshipComponent>().parentHandle; }
 
 		std::vector<UUID>& Children() { return GetComponent<RelationshipComponent>().children; }
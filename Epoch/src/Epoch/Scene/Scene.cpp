@@ -1,7 +1,9 @@
 #include "epch.h"
 #include "Scene.h"
+#include <bit>
 #include <CommonUtilities/Timer.h>
 #include "Epoch/Core/Input.h"
+#include "Epoch/Core/Application.h"
 #include "Prefab.h"
 #include "SceneRenderer.h"
 #include "Epoch/Rendering/Font.h"
@@ -9,12 +11,145 @@
 #include "Epoch/Script/ScriptEngine.h"
 #include "Epoch/Rendering/Renderer.h"
 #include "Epoch/Rendering/DebugRenderer.h"
+#include "Epoch/Debug/MemoryTracker.h"
+#include "Epoch/Core/FrameAllocator.h"
 
 namespace Epoch
 {
+	static uint32_t GetEntityIndex(entt::entity aEntity)
+	{
+		return (uint32_t)entt::registry::entity(aEntity);
+	}
+
+	static uint64_t HashName(std::string_view aName)
+	{
+		return std::hash<std::string_view>()(aName);
+	}
+
+	static bool TestBit(const std::vector<uint64_t>& aBits, uint32_t aIndex)
+	{
+		const size_t word = aIndex / 64;
+		return word < aBits.size() && (aBits[word] >> (aIndex % 64)) & 1;
+	}
+
+	static void SetBit(std::vector<uint64_t>& aBits, uint32_t aIndex)
+	{
+		EPOCH_ASSERT(aIndex / 64 < aBits.size(), "Bit index out of range!");
+		aBits[aIndex / 64] |= 1ull << (aIndex % 64);
+	}
+
+	static void ClearBit(std::vector<uint64_t>& aBits, uint32_t aIndex)
+	{
+		if (aIndex / 64 < aBits.size())
+		{
+			aBits[aIndex / 64] &= ~(1ull << (aIndex % 64));
+		}
+	}
+
+	// Matches the quad SceneRenderer::SubmitQuad draws, which is stretched along the longer side of the texture
+	static CU::Vector2f GetSpriteHalfSize(AssetHandle aTexture)
+	{
+		CU::Vector2f halfSize = CU::Vector2f(50.0f, 50.0f);
+
+		std::shared_ptr<Texture2D> texture = AssetManager::GetAssetAsync<Texture2D>(aTexture);
+		if (texture && texture->GetWidth() > 0 && texture->GetHeight() > 0)
+		{
+			if (texture->GetWidth() < texture->GetHeight())
+			{
+				halfSize.y *= (float)texture->GetHeight() / (float)texture->GetWidth();
+			}
+			else
+			{
+				halfSize.x *= (float)texture->GetWidth() / (float)texture->GetHeight();
+			}
+		}
+
+		return halfSize;
+	}
+
+	// Moves the planes into the space aTransform maps to world space.
+	// Plane equations transform with the transpose of the point transform, the normals are left unnormalized since only the signs are tested.
+	static Frustum TransformFrustumToLocal(const Frustum& aFrustum, const CU::Matrix4x4f& aTransform)
+	{
+		Frustum localFrustum;
+		for (size_t i = 0; i < aFrustum.planes.size(); i++)
+		{
+			const Frustum::Plane& plane = aFrustum.planes[i];
+			const CU::Vector4f equation = CU::Vector4f(plane.normal, plane.distance);
+
+			localFrustum.planes[i] = Frustum::Plane
+			(
+				aTransform(1, 1) * equation.x + aTransform(1, 2) * equation.y + aTransform(1, 3) * equation.z + aTransform(1, 4) * equation.w,
+				aTransform(2, 1) * equation.x + aTransform(2, 2) * equation.y + aTransform(2, 3) * equation.z + aTransform(2, 4) * equation.w,
+				aTransform(3, 1) * equation.x + aTransform(3, 2) * equation.y + aTransform(3, 3) * equation.z + aTransform(3, 4) * equation.w,
+				aTransform(4, 1) * equation.x + aTransform(4, 2) * equation.y + aTransform(4, 3) * equation.z + aTransform(4, 4) * equation.w
+			);
+		}
+
+		return localFrustum;
+	}
+
+	static bool RaycastMesh(Mesh& aMesh, const CU::Matrix4x4f& aTransform, const CU::Vector3f& aOrigin, const CU::Vector3f& aDirection, float aMaxDistance, float& outDistance)
+	{
+		bool hit = false;
+		float closestDistance = aMaxDistance;
+
+		// Submeshes are drawn with their own transform on top of the entity one, so the ray is moved into the space of each one
+		const std::vector<Submesh>& submeshes = aMesh.GetSubmeshes();
+		for (uint32_t i = 0; i < (uint32_t)submeshes.size(); i++)
+		{
+			const CU::Matrix4x4f inverse = (aTransform * submeshes[i].transform).GetInverse();
+			const CU::Vector3f localOrigin = CU::Vector3f(CU::Vector4f(aOrigin, 1.0f) * inverse);
+			const CU::Vector3f localDirection = CU::Vector3f(CU::Vector4f(aDirection, 0.0f) * inverse);
+
+			float distance = 0.0f;
+			if (aMesh.GetSubmeshBVH(i).Raycast(localOrigin, localDirection, closestDistance, distance))
+			{
+				closestDistance = distance;
+				hit = true;
+			}
+		}
+
+		if (hit)
+		{
+			outDistance = closestDistance;
+		}
+
+		return hit;
+	}
+
+	static bool RaycastSprite(const CU::Vector2f& aHalfSize, const CU::Matrix4x4f& aTransform, const CU::Vector3f& aOrigin, const CU::Vector3f& aDirection, float aMaxDistance, float& outDistance)
+	{
+		const CU::Matrix4x4f inverse = aTransform.GetInverse();
+		const CU::Vector3f localOrigin = CU::Vector3f(CU::Vector4f(aOrigin, 1.0f) * inverse);
+		const CU::Vector3f localDirection = CU::Vector3f(CU::Vector4f(aDirection, 0.0f) * inverse);
+
+		// The quad lies in the local xy plane
+		if (localDirection.z == 0.0f)
+		{
+			return false;
+		}
+
+		const float distance = -localOrigin.z / localDirection.z;
+		if (distance < 0.0f || distance > aMaxDistance)
+		{
+			return false;
+		}
+
+		const CU::Vector3f point = localOrigin + localDirection * distance;
+		if (std::abs(point.x) > aHalfSize.x || std::abs(point.y) > aHalfSize.y)
+		{
+			return false;
+		}
+
+		outDistance = distance;
+		return true;
+	}
+
 	void Scene::CopyTo(std::shared_ptr<Scene> aCopy)
 	{
 		EPOCH_PROFILE_FUNC();
+		MemoryTagScope memoryTag(MemoryTag::ECS);
 
 		aCopy->myName = myName;
 
@@ -36,11 +171,14 @@ namespace Epoch
 
 		CopyComponent(AllComponents{}, dstSceneRegistry, srcSceneRegistry, enttMap);
 
+		aCopy->RefreshActiveInHierarchy();
 		aCopy->SortEntities();
 	}
 
 	void Scene::SortEntities()
 	{
+		myHierarchyVersion++;
+
 		myRegistry.sort<IDComponent>([&](const auto lhs, const auto rhs)
 			{
 				auto lhsEntity = myEntityMap.find(lhs.id);
@@ -56,6 +194,8 @@ namespace Epoch
 
 	Entity Scene::CreateChildEntity(Entity aParent, const std::string& aName)
 	{
+		MemoryTagScope memoryTag(MemoryTag::ECS);
+
 		auto entity = Entity{ myRegistry.create(), this };
 		UUID uuid = UUID();
 
@@ -71,14 +211,20 @@ namespace Epoch
 		}
 
 		myEntityMap[uuid] = entity;
+		myHierarchyVersion++;
 
-		SortEntities();
+		if (!myDeferEntitySorting)
+		{
+			SortEntities();
+		}
 
 		return entity;
 	}
 
 	Entity Scene::CreateEntityWithUUID(UUID aUUID, const std::string& aName)
 	{
+		MemoryTagScope memoryTag(MemoryTag::ECS);
+
 		Entity entity = { myRegistry.create(), this };
 
 		entity.AddComponent<IDComponent>(aUUID);
@@ -88,8 +234,12 @@ namespace Epoch
 		entity.AddComponent<TransformComponent>();
 
 		myEntityMap[aUUID] = entity;
+		myHierarchyVersion++;
 
-		SortEntities();
+		if (!myDeferEntitySorting)
+		{
+			SortEntities();
+		}
 
 		return entity;
 	}
@@ -113,6 +263,16 @@ namespace Epoch
 			myPhysicsScene->DestroyBody(aEntity);
 		}
 
+		if (auto it = myPooledInstances.find(aEntity.GetUUID()); it != myPooledInstances.end())
+		{
+			if (auto poolIt = myPrefabPools.find(it->second.prefab); poolIt != myPrefabPools.end())
+			{
+				auto& available = poolIt->second.available;
+				available.erase(std::remove(available.begin(), available.end(), aEntity.GetUUID()), available.end());
+			}
+			myPooledInstances.erase(it);
+		}
+
 		if (myOnEntityDestroyedCallback)
 		{
 			myOnEntityDestroyedCallback(aEntity);
@@ -133,10 +293,20 @@ namespace Epoch
 			}
 		}
 
+		// The index gets reused by the next entity created
+		const uint32_t entityIndex = GetEntityIndex(aEntity);
+		ClearBit(myFrustumCulledBits, entityIndex);
+		ClearBit(myLastFrustumCulledBits, entityIndex);
+		ClearBit(myFrustumTestedBits, entityIndex);
+
 		myEntityMap.erase(aEntity.GetUUID());
 		myRegistry.destroy(aEntity);
+		myHierarchyVersion++;
 
-		SortEntities();
+		if (!myDeferEntitySorting)
+		{
+			SortEntities();
+		}
 	}
 
 	void Scene::SubmitToDestroyEntity(Entity aEntity)
@@ -294,205 +464,483 @@ namespace Epoch
 		return rootEntity;
 	}
 
-	void Scene::UpdateEntityReferences(const std::unordered_map<UUID, UUID>& aEntityIDMap)
+	void Scene::CreatePrefabPool(std::shared_ptr<Prefab> aPrefab, uint32_t aCount)
 	{
-		for (auto [orgID, newID] : aEntityIDMap)
-		{
-			Entity entity = GetEntityWithUUID(newID);
+		EPOCH_PROFILE_FUNC();
 
-			if (entity.HasComponent<ScriptComponent>())
-			{
-				auto& sc = entity.GetComponent<ScriptComponent>();
+		if (!myIsPlaying)
+		{
+			LOG_WARNING("Prefab pools can only be created while the scene is playing!");
+			return;
+		}
 
-				if (!ScriptEngine::IsModuleValid(sc.scriptClassHandle))
-				{
-					continue;
-				}
+		if (!aPrefab || !aPrefab->myEntity)
+		{
+			LOG_ERROR("Cannot create a pool for an invalid prefab!");
+			return;
+		}
 
-				for (auto fieldID : sc.fieldIDs)
-				{
-					FieldInfo* field = ScriptCache::GetFieldByID(fieldID);
+		const AssetHandle handle = aPrefab->GetHandle();
+		myPrefabPools[handle].prefab = aPrefab;
 
-					if (field->type != FieldType::Entity)
-					{
-						continue;
-					}
+		// The registry is sorted once for the whole pool instead of once per created entity
+		const bool deferSorting = myDeferEntitySorting;
+		myDeferEntitySorting = true;
 
-					std::shared_ptr<FieldStorageBase> storage = ScriptEngine::GetFieldStorage(entity, field->id);
+		std::vector<UUID> instances;
+		instances.reserve(aCount);
+		for (uint32_t i = 0; i < aCount; i++)
+		{
+			instances.push_back(CreatePooledInstance(aPrefab).GetUUID());
+		}
 
-					if (field->IsArray())
-					{
-						auto fieldStorage = std::dynamic_pointer_cast<ArrayFieldStorage>(storage);
+		myDeferEntitySorting = deferSorting;
+		if (!myDeferEntitySorting)
+		{
+			SortEntities();
+		}
 
-						for (size_t i = 0; i < fieldStorage->GetLength(); i++)
-						{
-							UUID oldEntityID = fieldStorage->GetValue<UUID>((uint32_t)i);
+		// Looked up again since the scripts of the new instances can create pools of their own
+		auto& available = myPrefabPools[handle].available;
+		for (UUID id : instances)
+		{
+			if (myPooledInstances.find(id) != myPooledInstances.end())
+			{
+				available.push_back(id);
+			}
+		}
+	}
 
-							if (auto it = aEntityIDMap.find(oldEntityID); it != aEntityIDMap.end())
-							{
-								fieldStorage->SetValue((uint32_t)i, it->second);
-							}
-						}
-					}
-					else
-					{
-						auto fieldStorage = std::dynamic_pointer_cast<FieldStorage>(storage);
+	void Scene::DestroyPrefabPool(AssetHandle aPrefab)
+	{
+		auto it = myPrefabPools.find(aPrefab);
+		if (it == myPrefabPools.end())
+		{
+			return;
+		}
 
-						UUID oldEntityID = fieldStorage->GetValue<UUID>();
+		const std::vector<UUID> available = std::move(it->second.available);
+		myPrefabPools.erase(it);
 
-						if (auto it = aEntityIDMap.find(oldEntityID); it != aEntityIDMap.end())
-						{
-							fieldStorage->SetValue(it->second);
-						}
-					}
-				}
+		// Spawned instances are left in the scene as regular entities
+		for (auto instanceIt = myPooledInstances.begin(); instanceIt != myPooledInstances.end();)
+		{
+			if (instanceIt->second.prefab == aPrefab)
+			{
+				instanceIt = myPooledInstances.erase(instanceIt);
+			}
+			else
+			{
+				instanceIt++;
 			}
+		}
 
-			if (entity.HasComponent<CheckboxComponent>())
+		for (UUID id : available)
+		{
+			if (Entity entity = TryGetEntityWithUUID(id))
 			{
-				auto& cc = entity.GetComponent<CheckboxComponent>();
-				
-				if (auto it = aEntityIDMap.find(cc.checkmark); it != aEntityIDMap.end())
-				{
-					cc.checkmark = it->second;
-				}
+				DestroyEntity(entity);
 			}
 		}
 	}
 
-	void Scene::OnRuntimeStart()
+	Entity Scene::SpawnFromPool(std::shared_ptr<Prefab> aPrefab, const CU::Vector3f* aTranslation, const CU::Vector3f* aRotation, const CU::Vector3f* aScale)
 	{
-		myIsPlaying = true;
+		EPOCH_PROFILE_FUNC();
 
-		myPhysicsScene = PhysicsSystem::CreatePhysicsScene(this);
-		ScriptEngine::InitializeRuntime();
+		if (!myIsPlaying || !aPrefab || !aPrefab->myEntity)
+		{
+			return {};
+		}
 
-		for (const auto& [entityID, entityInstance] : ScriptEngine::GetEntityInstances())
+		const AssetHandle handle = aPrefab->GetHandle();
+
+		// An empty pool grows by one instead of failing the spawn
+		if (auto it = myPrefabPools.find(handle); it == myPrefabPools.end() || it->second.available.empty())
 		{
-			if (myEntityMap.find(entityID) != myEntityMap.end())
-			{
-				Entity entity{ myEntityMap[entityID], this };
+			CreatePrefabPool(aPrefab, 1);
+		}
 
-				if (ScriptEngine::IsEntityInstantiated(entity))
-				{
-					ScriptEngine::CallMethod(entityInstance, "OnStart");
-				}
-			}
+		auto& available = myPrefabPools[handle].available;
+		if (available.empty())
+		{
+			return {};
 		}
-	}
 
-	void Scene::OnRuntimeStop()
-	{
-		myPhysicsScene->Destroy();
-		myPhysicsScene = nullptr;
+		Entity root = GetEntityWithUUID(available.back());
+		available.pop_back();
+		myPooledInstances.at(root.GetUUID()).isSpawned = true;
 
-		for (const auto& [entityID, entityInstance] : ScriptEngine::GetEntityInstances())
+		auto& tc = root.GetComponent<TransformComponent>();
+		tc.transform = aPrefab->myEntity.GetComponent<TransformComponent>().transform;
+		if (aTranslation) tc.transform.SetTranslation(*aTranslation);
+		if (aRotation) tc.transform.SetRotation(*aRotation);
+		if (aScale) tc.transform.SetScale(*aScale);
+
+		root.SetIsActive(true);
+
+		// Collected up front since the scripts can destroy entities of the hierarchy
+		std::vector<Entity> hierarchy;
+		GetPooledHierarchy(root, hierarchy);
+		SetPooledBodiesEnabled(hierarchy, true);
+
+		for (Entity entity : hierarchy)
 		{
-			if (myEntityMap.find(entityID) != myEntityMap.end())
+			if (IsEntityValid(entity) && entity.HasComponent<ScriptComponent>() && ScriptEngine::IsEntityInstantiated(entity))
 			{
-				Entity entity{ myEntityMap[entityID], this };
-
-				if (ScriptEngine::IsEntityInstantiated(entity))
-				{
-					ScriptEngine::CallMethod(entityInstance, "OnEnd");
-				}
+				ScriptEngine::CallMethod(ScriptEngine::GetEntityInstance(entity.GetUUID()), "OnSpawn");
 			}
 		}
-		
-		ScriptEngine::ShutdownRuntime();
 
-		myIsPlaying = false;
+		return root;
 	}
 
-	void Scene::OnSimulationStart()
+	bool Scene::DespawnToPool(Entity aEntity)
 	{
-		myIsSimulating = true;
+		EPOCH_PROFILE_FUNC();
 
-		myPhysicsScene = PhysicsSystem::CreatePhysicsScene(this);
-	}
+		if (!aEntity)
+		{
+			return false;
+		}
 
-	void Scene::OnSimulationStop()
-	{
-		myPhysicsScene->Destroy();
-		myPhysicsScene = nullptr;
+		auto it = myPooledInstances.find(aEntity.GetUUID());
+		if (it == myPooledInstances.end())
+		{
+			return false;
+		}
 
-		myIsSimulating = false;
-	}
+		if (!it->second.isSpawned)
+		{
+			return true;
+		}
 
-	void Scene::OnUpdateRuntime()
-	{
-		EPOCH_PROFILE_FUNC();
+		// Cleared before the callbacks so despawning again from OnDespawn does nothing
+		it->second.isSpawned = false;
+		const AssetHandle prefab = it->second.prefab;
 
-		if (!myIsPaused || ShouldStep())
+		std::vector<Entity> hierarchy;
+		GetPooledHierarchy(aEntity, hierarchy);
+
+		for (Entity entity : hierarchy)
 		{
-			// Update scripts
+			if (IsEntityValid(entity) && entity.HasComponent<ScriptComponent>() && ScriptEngine::IsEntityInstantiated(entity))
 			{
-				ScriptEngine::UpdateDeltaTime();
+				ScriptEngine::CallMethod(ScriptEngine::GetEntityInstance(entity.GetUUID()), "OnDespawn");
+			}
+		}
 
-				{
-					EPOCH_PROFILE_SCOPE("Scene::OnUpdate - C# OnUpdate");
-					Timer timer;
+		if (!IsEntityValid(aEntity))
+		{
+			return true;
+		}
 
-					auto entities = GetAllEntitiesWith<ScriptComponent>();
-					for (auto id : entities)
-					{
-						Entity entity = Entity(id, this);
-						const auto& sc = entities.get<ScriptComponent>(id);
-						if (entity.IsActive() && sc.isActive && sc.IsFlagSet(ManagedClassMethodFlags::ShouldUpdate) && ScriptEngine::IsEntityInstantiated(entity))
-						{
-							ScriptEngine::CallMethod(ScriptEngine::GetEntityInstance(entity.GetUUID()), "OnUpdate");
-						}
-					}
+		GetPooledHierarchy(aEntity, hierarchy);
+		SetPooledBodiesEnabled(hierarchy, false);
+		aEntity.SetIsActive(false);
 
-					myPerformanceTimers.scriptUpdate = timer.ElapsedMillis();
-				}
+		if (auto poolIt = myPrefabPools.find(prefab); poolIt != myPrefabPools.end() && myPooledInstances.find(aEntity.GetUUID()) != myPooledInstances.end())
+		{
+			poolIt->second.available.push_back(aEntity.GetUUID());
+		}
 
-				{
-					EPOCH_PROFILE_SCOPE("Scene::OnLateUpdate - C# OnLateUpdate");
-					Timer timer;
+		return true;
+	}
 
-					auto entities = GetAllEntitiesWith<ScriptComponent>();
-					for (auto id : entities)
-					{
-						Entity entity = Entity(id, this);
-						const auto& sc = entities.get<ScriptComponent>(id);
-						if (entity.IsActive() && sc.isActive && sc.IsFlagSet(ManagedClassMethodFlags::ShouldLateUpdate) && ScriptEngine::IsEntityInstantiated(entity))
-						{
-							ScriptEngine::CallMethod(ScriptEngine::GetEntityInstance(entity.GetUUID()), "OnLateUpdate");
-						}
-					}
+	uint32_t Scene::GetPoolAvailableCount(AssetHandle aPrefab) const
+	{
+		auto it = myPrefabPools.find(aPrefab);
+		return it != myPrefabPools.end() ? (uint32_t)it->second.available.size() : 0;
+	}
 
-					myPerformanceTimers.scriptLateUpdate = timer.ElapsedMillis();
-				}
-			}
-			
-			// Update Physics
+	Entity Scene::CreatePooledInstance(std::shared_ptr<Prefab> aPrefab)
+	{
+		Entity root = Instantiate(aPrefab);
+		myPooledInstances[root.GetUUID()].prefab = aPrefab->GetHandle();
+		root.SetIsActive(false);
+
+		std::vector<Entity> hierarchy;
+		GetPooledHierarchy(root, hierarchy);
+		SetPooledBodiesEnabled(hierarchy, false);
+
+		// Scripts are created right away, the duplicated entity queue skips them later since they are already initialized
+		for (Entity entity : hierarchy)
+		{
+			if (!IsEntityValid(entity) || !entity.HasComponent<ScriptComponent>())
 			{
-				Timer timer;
-				myPhysicsScene->Simulate();
-				myPerformanceTimers.physicsSimulation = timer.ElapsedMillis();
+				continue;
 			}
 
-			// Update animation
-			// Update audio
-
-			// Update UI
+			ScriptEngine::RuntimeInitializeScriptEntity(entity);
+			if (ScriptEngine::IsEntityInstantiated(entity))
 			{
-				EPOCH_PROFILE_SCOPE("Scene::OnUpdate::UpdateUI");
+				ScriptEngine::CallMethod(ScriptEngine::GetEntityInstance(entity.GetUUID()), "OnStart");
+			}
+		}
+
+		return root;
+	}
+
+	void Scene::GetPooledHierarchy(Entity aRoot, std::vector<Entity>& outHierarchy)
+	{
+		outHierarchy.clear();
+		outHierarchy.push_back(aRoot);
+
+		for (size_t i = 0; i < outHierarchy.size(); i++)
+		{
+			const Entity entity = outHierarchy[i];
+			for (UUID childId : entity.Children())
+			{
+				if (Entity child = TryGetEntityWithUUID(childId))
+				{
+					outHierarchy.push_back(child);
+				}
+			}
+		}
+	}
+
+	void Scene::SetPooledBodiesEnabled(const std::vector<Entity>& aHierarchy, bool aState)
+	{
+		for (Entity entity : aHierarchy)
+		{
+			std::shared_ptr<PhysicsBody> body = myPhysicsScene->GetPhysicsBody(entity);
+			if (!body)
+			{
+				continue;
+			}
+
+			body->SetSimulationEnabled(aState);
+
+			// Bodies are moved to where the entity was spawned instead of simulating their way there
+			if (aState)
+			{
+				const CU::Transform worldTransform = entity.GetWorldSpaceTransform();
+				myPhysicsScene->Teleport(entity, worldTransform.GetTranslation(), worldTransform.GetRotationQuat());
+			}
+		}
+	}
+
+	void Scene::UpdateEntityReferences(const std::unordered_map<UUID, UUID>& aEntityIDMap)
+	{
+		for (auto [orgID, newID] : aEntityIDMap)
+		{
+			Entity entity = GetEntityWithUUID(newID);
+
+			if (entity.HasComponent<ScriptComponent>())
+			{
+				auto& sc = entity.GetComponent<ScriptComponent>();
+
+				if (!ScriptEngine::IsModuleValid(sc.scriptClassHandle))
+				{
+					continue;
+				}
+
+				ScriptEngine::UpdateEntityReferences(entity, aEntityIDMap);
+			}
+
+			if (entity.HasComponent<CheckboxComponent>())
+			{
+				auto& cc = entity.GetComponent<CheckboxComponent>();
+				
+				if (auto it = aEntityIDMap.find(cc.checkmark); it != aEntityIDMap.end())
+				{
+					cc.checkmark = it->second;
+				}
+			}
+		}
+	}
+
+	void Scene::OnRuntimeStart()
+	{
+		myIsPlaying = true;
+
+		myPhysicsScene = PhysicsSystem::CreatePhysicsScene(this);
+		ScriptEngine::InitializeRuntime();
+
+		CallScriptOnStart();
+	}
+
+	bool Scene::OnRuntimeStartSliced(float aBudgetMilliseconds)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		Timer timer;
+
+		if (!myIsPlaying)
+		{
+			myIsPlaying = true;
+			myPhysicsScene = PhysicsSystem::CreatePhysicsScene(this, true);
+
+			auto view = GetAllEntitiesWith<ScriptComponent>();
+			myStartingScriptEntities.assign(view.begin(), view.end());
+			myStartedScriptCount = 0;
+		}
+
+		if (!myPhysicsScene->CreateQueuedPhysicsBodies(aBudgetMilliseconds))
+		{
+			return false;
+		}
+
+		while (myStartedScriptCount < (uint32_t)myStartingScriptEntities.size())
+		{
+			// OnCreate of an earlier script may have destroyed it
+			const entt::entity enttID = myStartingScriptEntities[myStartedScriptCount++];
+			if (myRegistry.valid(enttID))
+			{
+				ScriptEngine::RuntimeInitializeScriptEntity(Entity(enttID, this));
+			}
+
+			if (timer.ElapsedMillis() >= aBudgetMilliseconds)
+			{
+				return false;
+			}
+		}
+
+		myStartingScriptEntities.clear();
+		myStartedScriptCount = 0;
+
+		CallScriptOnStart();
+		return true;
+	}
+
+	void Scene::OnRuntimeStop()
+	{
+		// Not created yet when a sliced start is stopped before its first slice
+		if (myPhysicsScene)
+		{
+			myPhysicsScene->Destroy();
+			myPhysicsScene = nullptr;
+		}
+
+		for (const auto& [entityID, entityInstance] : ScriptEngine::GetEntityInstances())
+		{
+			if (myEntityMap.find(entityID) != myEntityMap.end())
+			{
+				Entity entity{ myEntityMap[entityID], this };
+
+				if (ScriptEngine::IsEntityInstantiated(entity))
+				{
+					ScriptEngine::CallMethod(entityInstance, "OnEnd");
+				}
+			}
+		}
+		
+		ScriptEngine::ShutdownRuntime();
+
+		myPrefabPools.clear();
+		myPooledInstances.clear();
+		myStartingScriptEntities.clear();
+
+		myIsPlaying = false;
+	}
+
+	void Scene::CallScriptOnStart()
+	{
+		for (const auto& [entityID, entityInstance] : ScriptEngine::GetEntityInstances())
+		{
+			if (myEntityMap.find(entityID) != myEntityMap.end())
+			{
+				Entity entity{ myEntityMap[entityID], this };
+
+				if (ScriptEngine::IsEntityInstantiated(entity))
+				{
+					ScriptEngine::CallMethod(entityInstance, "OnStart");
+				}
+			}
+		}
+	}
+
+	void Scene::OnSimulationStart()
+	{
+		myIsSimulating = true;
+
+		myPhysicsScene = PhysicsSystem::CreatePhysicsScene(this);
+	}
+
+	void Scene::OnSimulationStop()
+	{
+		myPhysicsScene->Destroy();
+		myPhysicsScene = nullptr;
+
+		myIsSimulating = false;
+	}
+
+	void Scene::OnUpdateRuntime()
+	{
+		EPOCH_PROFILE_FUNC();
+
+		if (!myIsPaused || ShouldStep())
+		{
+			// Update scripts
+			{
+				ScriptEngine::UpdateDeltaTime();
 
-				if (MouseInViewport())
 				{
-					auto buttonView = GetAllEntitiesWith<RectComponent, ButtonComponent>();
-					for (auto id : buttonView)
+					EPOCH_PROFILE_SCOPE("Scene::OnUpdate - C# OnUpdate");
+					Timer timer;
+
+					auto entities = GetAllActiveEntitiesWith<ScriptComponent>();
+					for (auto id : entities)
 					{
 						Entity entity = Entity(id, this);
-						if (!entity.IsActive()) continue;
-				
-						const auto& [rc, bc] = buttonView.get<RectComponent, ButtonComponent>(id);
-						if (!bc.isActive) continue;
-				
+						const auto& sc = entities.get<ScriptComponent>(id);
+						if (sc.isActive && sc.IsFlagSet(ManagedClassMethodFlags::ShouldUpdate) && ScriptEngine::IsEntityInstantiated(entity))
+						{
+							ScriptEngine::CallMethod(ScriptEngine::GetEntityInstance(entity.GetUUID()), "OnUpdate");
+						}
+					}
+
+					myPerformanceTimers.scriptUpdate = timer.ElapsedMillis();
+				}
+
+				{
+					EPOCH_PROFILE_SCOPE("Scene::OnLateUpdate - C# OnLateUpdate");
+					Timer timer;
+
+					auto entities = GetAllActiveEntitiesWith<ScriptComponent>();
+					for (auto id : entities)
+					{
+						Entity entity = Entity(id, this);
+						const auto& sc = entities.get<ScriptComponent>(id);
+						if (sc.isActive && sc.IsFlagSet(ManagedClassMethodFlags::ShouldLateUpdate) && ScriptEngine::IsEntityInstantiated(entity))
+						{
+							ScriptEngine::CallMethod(ScriptEngine::GetEntityInstance(entity.GetUUID()), "OnLateUpdate");
+						}
+					}
+
+					myPerformanceTimers.scriptLateUpdate = timer.ElapsedMillis();
+				}
+			}
+			
+			// Update Physics
+			{
+				Timer timer;
+				myPhysicsScene->Simulate();
+				myPhysicsScene->ApplyInterpolatedTransforms();
+				myPerformanceTimers.physicsSimulation = timer.ElapsedMillis();
+			}
+
+			// Update animation
+			// Update audio
+
+			// Update UI
+			{
+				EPOCH_PROFILE_SCOPE("Scene::OnUpdate::UpdateUI");
+
+				UpdateUISpatialIndex();
+
+				if (MouseInViewport())
+				{
+					auto updateButton = [this](Entity entity)
+					{
+						if (!entity.IsActive()) return;
+			
+						auto& rc = entity.GetComponent<RectComponent>();
+						auto& bc = entity.GetComponent<ButtonComponent>();
+						if (!bc.isActive) return;
+			
 						CU::Matrix4x4f transform = entity.GetWorldSpaceTransform().GetMatrix();
-				
+			
 						const CU::Vector2f size = CU::Vector2f((float)rc.size.x, (float)rc.size.y);
 						const CU::Vector2f bl = (CU::Vector2f(0.0f, 0.0f) - rc.pivot) * size;
 						const CU::Vector2f tr = (CU::Vector2f(1.0f, 1.0f) - rc.pivot) * size;
@@ -549,19 +997,18 @@ namespace Epoch
 								}
 							}
 						}
-					}
+					};
 
-					auto checkboxView = GetAllEntitiesWith<RectComponent, CheckboxComponent>();
-					for (auto id : checkboxView)
+					auto updateCheckbox = [this](Entity entity)
 					{
-						Entity entity = Entity(id, this);
-						if (!entity.IsActive()) continue;
-				
-						const auto& [rc, cc] = checkboxView.get<RectComponent, CheckboxComponent>(id);
-						if (!cc.isActive) continue;
-				
+						if (!entity.IsActive()) return;
+			
+						auto& rc = entity.GetComponent<RectComponent>();
+						auto& cc = entity.GetComponent<CheckboxComponent>();
+						if (!cc.isActive) return;
+			
 						CU::Matrix4x4f transform = entity.GetWorldSpaceTransform().GetMatrix();
-				
+			
 						const CU::Vector2f size = CU::Vector2f((float)rc.size.x, (float)rc.size.y);
 						const CU::Vector2f bl = (CU::Vector2f(0.0f, 0.0f) - rc.pivot) * size;
 						const CU::Vector2f tr = (CU::Vector2f(1.0f, 1.0f) - rc.pivot) * size;
@@ -597,7 +1044,7 @@ namespace Epoch
 								if (entity.HasComponent<ScriptComponent>())
 								{
 									const auto& sc = entity.GetComponent<ScriptComponent>();
-								
+							
 									if (ScriptEngine::IsModuleValid(sc.scriptClassHandle) && ScriptEngine::IsEntityInstantiated(entity))
 									{
 										ScriptEngine::CallMethod(sc.managedInstance, "OnValueChanged", cc.isOn);
@@ -619,6 +1066,45 @@ namespace Epoch
 								}
 							}
 						}
+					};
+
+					// Only the interactables under the mouse and the ones that have to leave their hovered or pressed state need updating
+					mySpatialQueryResults.clear();
+					myUISpatialIndex.tree.QueryPoint(CU::Vector3f(myMousePos.x, myMousePos.y, 0.0f), (uint32_t)SpatialCategory::Interactable, [this](uint32_t aEntity)
+						{
+							mySpatialQueryResults.push_back((entt::entity)aEntity);
+							return true;
+						});
+					mySpatialQueryResults.insert(mySpatialQueryResults.end(), myActiveInteractables.begin(), myActiveInteractables.end());
+					std::sort(mySpatialQueryResults.begin(), mySpatialQueryResults.end());
+					mySpatialQueryResults.erase(std::unique(mySpatialQueryResults.begin(), mySpatialQueryResults.end()), mySpatialQueryResults.end());
+
+					for (auto id : mySpatialQueryResults)
+					{
+						if (!myRegistry.valid(id) || !myRegistry.has<RectComponent>(id)) continue;
+
+						if (myRegistry.has<ButtonComponent>(id))
+						{
+							updateButton(Entity(id, this));
+						}
+
+						if (myRegistry.has<CheckboxComponent>(id))
+						{
+							updateCheckbox(Entity(id, this));
+						}
+					}
+
+					myActiveInteractables.clear();
+					for (auto id : mySpatialQueryResults)
+					{
+						if (!myRegistry.valid(id)) continue;
+
+						const bool buttonActive = myRegistry.has<ButtonComponent>(id) && myRegistry.get<ButtonComponent>(id).state != InteractableState::Default;
+						const bool checkboxActive = myRegistry.has<CheckboxComponent>(id) && myRegistry.get<CheckboxComponent>(id).state != InteractableState::Default;
+						if (buttonActive || checkboxActive)
+						{
+							myActiveInteractables.push_back(id);
+						}
 					}
 				}
 			}
@@ -643,6 +1129,7 @@ namespace Epoch
 				{
 					Timer timer;
 					myPhysicsScene->Simulate();
+					myPhysicsScene->ApplyInterpolatedTransforms();
 					myPerformanceTimers.physicsSimulation = timer.ElapsedMillis();
 				}
 			}
@@ -651,6 +1138,8 @@ namespace Epoch
 
 	void Scene::OnRenderGame(std::shared_ptr<SceneRenderer> aRenderer)
 	{
+		MemoryTagScope memoryTag(MemoryTag::Renderer);
+
 		Entity cameraEntity = GetPrimaryCameraEntity();
 		if (!cameraEntity) return;
 		if (myViewportWidth == 0 || myViewportHeight == 0) return;
@@ -670,7 +1159,9 @@ namespace Epoch
 			camera.GetPerspectiveNearPlane(),
 			camera.GetPerspectiveFarPlane(),
 			camera.GetPerspectiveFOV(),
-			camera.GetAspectRatio()
+			camera.GetAspectRatio(),
+			camera.GetProjectionType() == SceneCamera::ProjectionType::Orthographic,
+			camera.GetOrthographicSize()
 		);
 		Render3DScene(aRenderer, renderCamera, renderCamera, true);
 		Render2DScene(aRenderer, renderCamera, true);
@@ -678,6 +1169,8 @@ namespace Epoch
 
 	void Scene::OnRenderEditor(std::shared_ptr<SceneRenderer> aRenderer, EditorCamera& aCamera, const EditorRenderSettings& aSettings)
 	{
+		MemoryTagScope memoryTag(MemoryTag::Renderer);
+
 		const SceneRendererCamera renderCamera
 		(
 			(Camera)aCamera,
@@ -712,7 +1205,9 @@ namespace Epoch
 					camera.GetPerspectiveNearPlane(),
 					camera.GetPerspectiveFarPlane(),
 					camera.GetPerspectiveFOV(),
-					camera.GetAspectRatio()
+					camera.GetAspectRatio(),
+					camera.GetProjectionType() == SceneCamera::ProjectionType::Orthographic,
+					camera.GetOrthographicSize()
 				);
 			}
 			else
@@ -733,112 +1228,859 @@ namespace Epoch
 		}
 	}
 
-	void Scene::OnSceneTransition(AssetHandle aScene)
+	void Scene::OnSceneTransition(AssetHandle aScene)
+	{
+		if (myOnSceneTransitionCallback)
+		{
+			myOnSceneTransitionCallback(aScene);
+		}
+		else
+		{
+			LOG_WARNING("Cannot transition scene - no callback set!");
+		}
+	}
+
+	static uint64_t GetSpatialProxyKey(entt::entity aEntity, SpatialCategory aCategory)
+	{
+		return ((uint64_t)aCategory << 32) | (uint64_t)(uint32_t)aEntity;
+	}
+
+	template<SpatialCategory Category>
+	void Scene::OnSpatialComponentConstructed(entt::registry& aRegistry, entt::entity aEntity)
+	{
+		AddSpatialProxy(Category == SpatialCategory::Interactable ? myUISpatialIndex : mySpatialIndex, aEntity, Category);
+	}
+
+	template<SpatialCategory Category>
+	void Scene::OnSpatialComponentDestroyed(entt::registry& aRegistry, entt::entity aEntity)
+	{
+		RemoveSpatialProxy(Category == SpatialCategory::Interactable ? myUISpatialIndex : mySpatialIndex, aEntity, Category);
+	}
+
+	void Scene::ConnectSignals()
+	{
+		myRegistry.on_construct<NameComponent>().connect<&Scene::OnNameConstructed>(this);
+		myRegistry.on_update<NameComponent>().connect<&Scene::OnNameUpdated>(this);
+		myRegistry.on_destroy<NameComponent>().connect<&Scene::OnNameDestroyed>(this);
+
+		myRegistry.on_construct<ActiveComponent>().connect<&Scene::OnActiveStateChanged>(this);
+		myRegistry.on_update<ActiveComponent>().connect<&Scene::OnActiveStateChanged>(this);
+		myRegistry.on_construct<RelationshipComponent>().connect<&Scene::OnActiveStateChanged>(this);
+		myRegistry.on_update<RelationshipComponent>().connect<&Scene::OnActiveStateChanged>(this);
+
+		myRegistry.on_destroy<SkinnedMeshRendererComponent>().connect<&Scene::OnSkinnedMeshRendererDestroyed>(this);
+
+		myRegistry.on_construct<MeshRendererComponent>().connect<&Scene::OnSpatialComponentConstructed<SpatialCategory::Mesh>>(this);
+		myRegistry.on_destroy<MeshRendererComponent>().connect<&Scene::OnSpatialComponentDestroyed<SpatialCategory::Mesh>>(this);
+		myRegistry.on_construct<SkinnedMeshRendererComponent>().connect<&Scene::OnSpatialComponentConstructed<SpatialCategory::SkinnedMesh>>(this);
+		myRegistry.on_destroy<SkinnedMeshRendererComponent>().connect<&Scene::OnSpatialComponentDestroyed<SpatialCategory::SkinnedMesh>>(this);
+		myRegistry.on_construct<SpriteRendererComponent>().connect<&Scene::OnSpatialComponentConstructed<SpatialCategory::Sprite>>(this);
+		myRegistry.on_destroy<SpriteRendererComponent>().connect<&Scene::OnSpatialComponentDestroyed<SpatialCategory::Sprite>>(this);
+		myRegistry.on_construct<PointLightComponent>().connect<&Scene::OnSpatialComponentConstructed<SpatialCategory::PointLight>>(this);
+		myRegistry.on_destroy<PointLightComponent>().connect<&Scene::OnSpatialComponentDestroyed<SpatialCategory::PointLight>>(this);
+		myRegistry.on_construct<SpotlightComponent>().connect<&Scene::OnSpatialComponentConstructed<SpatialCategory::Spotlight>>(this);
+		myRegistry.on_destroy<SpotlightComponent>().connect<&Scene::OnSpatialComponentDestroyed<SpatialCategory::Spotlight>>(this);
+
+		// An interactable needs both a rect and a button or checkbox, the proxy is skipped while one is missing
+		myRegistry.on_construct<RectComponent>().connect<&Scene::OnSpatialComponentConstructed<SpatialCategory::Interactable>>(this);
+		myRegistry.on_destroy<RectComponent>().connect<&Scene::OnSpatialComponentDestroyed<SpatialCategory::Interactable>>(this);
+		myRegistry.on_construct<ButtonComponent>().connect<&Scene::OnSpatialComponentConstructed<SpatialCategory::Interactable>>(this);
+		myRegistry.on_destroy<ButtonComponent>().connect<&Scene::OnSpatialComponentDestroyed<SpatialCategory::Interactable>>(this);
+		myRegistry.on_construct<CheckboxComponent>().connect<&Scene::OnSpatialComponentConstructed<SpatialCategory::Interactable>>(this);
+		myRegistry.on_destroy<CheckboxComponent>().connect<&Scene::OnSpatialComponentDestroyed<SpatialCategory::Interactable>>(this);
+	}
+
+	void Scene::OnNameConstructed(entt::registry& aRegistry, entt::entity aEntity)
+	{
+		AddToNameIndex(aEntity);
+	}
+
+	void Scene::OnNameUpdated(entt::registry& aRegistry, entt::entity aEntity)
+	{
+		RemoveFromNameIndex(aEntity);
+		AddToNameIndex(aEntity);
+		myNameVersion++;
+	}
+
+	void Scene::OnNameDestroyed(entt::registry& aRegistry, entt::entity aEntity)
+	{
+		RemoveFromNameIndex(aEntity);
+	}
+
+	void Scene::OnSkinnedMeshRendererDestroyed(entt::registry& aRegistry, entt::entity aEntity)
+	{
+		// Also covers destroying the entity, the resolved bone entities would otherwise stay around
+		mySkinningCaches.erase(aEntity);
+	}
+
+	void Scene::AddSpatialProxy(SpatialIndex& aIndex, entt::entity aEntity, SpatialCategory aCategory)
+	{
+		// The tree node is created by the next update, once the bounds can be computed
+		auto [it, inserted] = aIndex.proxyLookup.try_emplace(GetSpatialProxyKey(aEntity, aCategory), (uint32_t)aIndex.proxies.size());
+		if (!inserted)
+		{
+			return;
+		}
+
+		SpatialIndex::Proxy& proxy = aIndex.proxies.emplace_back();
+		proxy.entity = aEntity;
+		proxy.category = aCategory;
+	}
+
+	void Scene::RemoveSpatialProxy(SpatialIndex& aIndex, entt::entity aEntity, SpatialCategory aCategory)
+	{
+		auto it = aIndex.proxyLookup.find(GetSpatialProxyKey(aEntity, aCategory));
+		if (it == aIndex.proxyLookup.end())
+		{
+			return;
+		}
+
+		const uint32_t index = it->second;
+		aIndex.proxyLookup.erase(it);
+
+		if (aIndex.proxies[index].id != DynamicAABBTree::NullNode)
+		{
+			aIndex.tree.DestroyProxy(aIndex.proxies[index].id);
+		}
+
+		if (index != (uint32_t)aIndex.proxies.size() - 1)
+		{
+			aIndex.proxies[index] = aIndex.proxies.back();
+			aIndex.proxyLookup[GetSpatialProxyKey(aIndex.proxies[index].entity, aIndex.proxies[index].category)] = index;
+		}
+		aIndex.proxies.pop_back();
+	}
+
+	void Scene::AddToNameIndex(entt::entity aEntity)
+	{
+		const uint64_t hash = HashName(myRegistry.get<NameComponent>(aEntity).name);
+		myNameIndex[hash].push_back(aEntity);
+
+		const uint32_t entityIndex = GetEntityIndex(aEntity);
+		if (entityIndex >= myIndexedNameHashes.size())
+		{
+			myIndexedNameHashes.resize(entityIndex + 1);
+		}
+		myIndexedNameHashes[entityIndex] = hash;
+	}
+
+	void Scene::RemoveFromNameIndex(entt::entity aEntity)
+	{
+		const uint32_t entityIndex = GetEntityIndex(aEntity);
+		if (entityIndex >= myIndexedNameHashes.size())
+		{
+			return;
+		}
+
+		auto it = myNameIndex.find(myIndexedNameHashes[entityIndex]);
+		if (it == myNameIndex.end())
+		{
+			return;
+		}
+
+		// Erased in place to keep the remaining entities in the order they got their names
+		auto& entities = it->second;
+		entities.erase(std::remove(entities.begin(), entities.end(), aEntity), entities.end());
+		if (entities.empty())
+		{
+			myNameIndex.erase(it);
+		}
+	}
+
+	void Scene::OnActiveStateChanged(entt::registry& aRegistry, entt::entity aEntity)
+	{
+		RefreshActiveInHierarchy(aEntity);
+	}
+
+	void Scene::RefreshActiveInHierarchy(entt::entity aEntity, bool aForce)
+	{
+		// Walked with an explicit stack, deep hierarchies would otherwise recurse very deep
+		std::vector<entt::entity> stack = { aEntity };
+
+		while (!stack.empty())
+		{
+			const entt::entity entity = stack.back();
+			stack.pop_back();
+
+			const ActiveComponent* ac = myRegistry.try_get<ActiveComponent>(entity);
+			const RelationshipComponent* rc = myRegistry.try_get<RelationshipComponent>(entity);
+
+			bool isActive = !ac || ac->isActive;
+			if (isActive && rc && rc->parentHandle != 0)
+			{
+				auto parentIt = myEntityMap.find(rc->parentHandle);
+				isActive = parentIt == myEntityMap.end() || !myRegistry.has<InactiveInHierarchyComponent>(parentIt->second);
+			}
+
+			const bool wasActive = !myRegistry.has<InactiveInHierarchyComponent>(entity);
+			if (isActive != wasActive)
+			{
+				if (isActive)
+				{
+					myRegistry.remove<InactiveInHierarchyComponent>(entity);
+				}
+				else
+				{
+					myRegistry.emplace<InactiveInHierarchyComponent>(entity);
+				}
+			}
+			else if (!aForce)
+			{
+				// The descendants already agree with an unchanged state
+				continue;
+			}
+
+			if (!rc)
+			{
+				continue;
+			}
+
+			for (UUID childID : rc->children)
+			{
+				if (auto it = myEntityMap.find(childID); it != myEntityMap.end())
+				{
+					stack.push_back(it->second);
+				}
+			}
+		}
+	}
+
+	void Scene::RefreshActiveInHierarchy()
+	{
+		EPOCH_PROFILE_FUNC();
+
+		auto view = myRegistry.view<RelationshipComponent>();
+		for (auto entity : view)
+		{
+			const UUID parentID = view.get<RelationshipComponent>(entity).parentHandle;
+			if (parentID == 0 || !myEntityMap.contains(parentID))
+			{
+				RefreshActiveInHierarchy(entity, true);
+			}
+		}
+	}
+
+	Entity Scene::TryGetEntityByName(std::string_view aName)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		auto it = myNameIndex.find(HashName(aName));
+		if (it == myNameIndex.end())
+		{
+			return Entity{};
+		}
+
+		// Different names can share a hash
+		for (entt::entity entity : it->second)
+		{
+			if (myRegistry.get<NameComponent>(entity).name == aName)
+			{
+				return Entity{ entity, this };
+			}
+		}
+
+		return Entity{};
+	}
+
+	std::vector<Entity> Scene::GetEntitiesByName(std::string_view aName)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		std::vector<Entity> matches;
+
+		auto it = myNameIndex.find(HashName(aName));
+		if (it == myNameIndex.end())
+		{
+			return matches;
+		}
+
+		for (entt::entity entity : it->second)
+		{
+			if (myRegistry.get<NameComponent>(entity).name == aName)
+			{
+				matches.emplace_back(entity, this);
+			}
+		}
+
+		return matches;
+	}
+
+	Entity Scene::GetEntityWithUUID(UUID aUUID)
+	{
+		EPOCH_ASSERT(myEntityMap.find(aUUID) != myEntityMap.end(), "Entity doesn't exist in scene!");
+		return Entity{ myEntityMap.at(aUUID), this };
+	}
+
+	Entity Scene::TryGetEntityWithUUID(UUID aUUID)
+	{
+		if (myEntityMap.find(aUUID) != myEntityMap.end())
+		{
+			return Entity{ myEntityMap.at(aUUID), this };
+		}
+
+		return Entity{};
+	}
+
+	Entity Scene::TryGetDescendantEntityWithName(Entity aEntity, const std::string& aName)
+	{
+		if (!aEntity)
+		{
+			return {};
+		}
+
+		if (aEntity.GetName() == aName)
+		{
+			return aEntity;
+		}
+
+		auto it = myNameIndex.find(HashName(aName));
+		if (it == myNameIndex.end())
+		{
+			return {};
+		}
+
+		// Walking up from the few entities with the name is much cheaper than walking down the whole subtree
+		Entity match;
+		for (entt::entity candidate : it->second)
+		{
+			Entity entity{ candidate, this };
+			if (entity.GetName() != aName)
+			{
+				continue;
+			}
+
+			Entity ancestor = entity.GetParent();
+			while (ancestor && ancestor != aEntity)
+			{
+				ancestor = ancestor.GetParent();
+			}
+
+			if (!ancestor)
+			{
+				continue;
+			}
+
+			// With several matches in the subtree the first one in hierarchy order is returned, which only the walk knows
+			if (match)
+			{
+				return SearchDescendantEntityWithName(aEntity, aName);
+			}
+
+			match = entity;
+		}
+
+		return match;
+	}
+
+	Entity Scene::SearchDescendantEntityWithName(Entity aEntity, const std::string& aName)
+	{
+		if (aEntity)
+		{
+			if (aEntity.GetComponent<NameComponent>().name == aName)
+			{
+				return aEntity;
+			}
+
+			for (const auto childId : aEntity.Children())
+			{
+				Entity descendant = SearchDescendantEntityWithName(GetEntityWithUUID(childId), aName);
+				if (descendant)
+				{
+					return descendant;
+				}
+			}
+		}
+		return {};
+	}
+
+	void Scene::GetDescendantsByName(Entity aEntity, std::unordered_map<std::string_view, UUID>& outDescendants)
+	{
+		// The first entity with a name in hierarchy order keeps it, same as TryGetDescendantEntityWithName
+		outDescendants.emplace(aEntity.GetName(), aEntity.GetUUID());
+
+		for (const auto childId : aEntity.Children())
+		{
+			GetDescendantsByName(GetEntityWithUUID(childId), outDescendants);
+		}
+	}
+
+	bool Scene::IsEntityValid(Entity aEntity) const
+	{
+		return myRegistry.valid(aEntity);
+	}
+
+	bool Scene::WasEntityFrustumCulled(UUID aEntityID) const
+	{
+		auto it = myEntityMap.find(aEntityID);
+		return it != myEntityMap.end() && WasEntityFrustumCulled(it->second);
+	}
+
+	bool Scene::WasEntityFrustumCulled(entt::entity aEntity) const
+	{
+		return TestBit(myFrustumCulledBits, GetEntityIndex(aEntity));
+	}
+
+	Entity Scene::GetPrimaryCameraEntity()
+	{
+		// The camera found last time is checked first, the cameras are only scanned when it stopped being the primary camera
+		if (myPrimaryCameraEntity != entt::null && myRegistry.valid(myPrimaryCameraEntity) && myRegistry.has<CameraComponent>(myPrimaryCameraEntity))
+		{
+			Entity camEntity(myPrimaryCameraEntity, this);
+			const auto& camera = myRegistry.get<CameraComponent>(myPrimaryCameraEntity);
+			if (camera.primary && camera.isActive && camEntity.IsActive())
+			{
+				return camEntity;
+			}
+		}
+
+		myPrimaryCameraEntity = entt::null;
+
+		auto view = myRegistry.view<CameraComponent>();
+		for (auto entity : view)
+		{
+			Entity camEntity(entity, this);
+			if (!camEntity.IsActive()) continue;
+
+			const auto& camera = view.get<CameraComponent>(entity);
+			if (!camera.isActive) continue;
+
+			if (camera.primary)
+			{
+				myPrimaryCameraEntity = entity;
+				return camEntity;
+			}
+		}
+
+		return Entity{};
+	}
+
+	void Scene::UpdateSpatialIndex()
+	{
+		EPOCH_PROFILE_FUNC();
+
+		MarkSpatialTransformsDirty(mySpatialIndex);
+		UpdateSpatialProxies(mySpatialIndex);
+	}
+
+	void Scene::UpdateUISpatialIndex()
+	{
+		EPOCH_PROFILE_FUNC();
+
+		SpatialIndex& index = myUISpatialIndex;
+		MarkSpatialTransformsDirty(index);
+
+		// Rects are laid out relative to their parent rect or the viewport, so a changed rect moves its whole subtree
+		if (index.viewportWidth != myViewportWidth || index.viewportHeight != myViewportHeight)
+		{
+			index.viewportWidth = myViewportWidth;
+			index.viewportHeight = myViewportHeight;
+			index.isFullRefreshPending = true;
+		}
+
+		auto view = myRegistry.view<RectComponent>();
+		for (auto entity : view)
+		{
+			const RectComponent& rc = view.get<RectComponent>(entity);
+
+			uint64_t stamp = 0;
+			auto combine = [&stamp](uint32_t aX, uint32_t aY)
+				{
+					stamp ^= (((uint64_t)aX << 32) | aY) + 0x9e3779b97f4a7c15 + (stamp << 6) + (stamp >> 2);
+				};
+			combine(std::bit_cast<uint32_t>(rc.anchor.x), std::bit_cast<uint32_t>(rc.anchor.y));
+			combine(std::bit_cast<uint32_t>(rc.pivot.x), std::bit_cast<uint32_t>(rc.pivot.y));
+			combine(rc.size.x, rc.size.y);
+
+			const uint32_t entityIndex = GetEntityIndex(entity);
+			if (entityIndex >= index.rectStamps.size())
+			{
+				index.rectStamps.resize(entityIndex + 1, 0);
+			}
+
+			if (index.rectStamps[entityIndex] != stamp)
+			{
+				index.rectStamps[entityIndex] = stamp;
+				MarkSpatialSubtreeDirty(index, entity);
+			}
+		}
+
+		UpdateSpatialProxies(index);
+	}
+
+	void Scene::OnEntityReparented(entt::entity aEntity)
+	{
+		for (SpatialIndex* index : { &mySpatialIndex, &myUISpatialIndex })
+		{
+			if (index->isFullRefreshPending)
+			{
+				continue;
+			}
+
+			// An index that isn't being updated, like the UI one while editing, falls back to refreshing everything
+			if (index->reparentedEntities.size() >= 1024)
+			{
+				index->reparentedEntities.clear();
+				index->isFullRefreshPending = true;
+				continue;
+			}
+
+			index->reparentedEntities.push_back(aEntity);
+		}
+	}
+
+	void Scene::MarkSpatialTransformsDirty(SpatialIndex& aIndex)
+	{
+		aIndex.updateCount++;
+
+		// Read before the scan, anything modified during it is picked up by the next update
+		const uint64_t nextTransformVersion = CU::Transform::GetNextVersion();
+
+		// One version compare per transform, only the subtrees of the modified ones are walked
+		if (!aIndex.isFullRefreshPending)
+		{
+			auto view = myRegistry.view<TransformComponent>();
+			for (auto entity : view)
+			{
+				if (view.get<TransformComponent>(entity).transform.GetVersion() >= aIndex.nextTransformVersion)
+				{
+					MarkSpatialSubtreeDirty(aIndex, entity);
+				}
+			}
+		}
+		aIndex.nextTransformVersion = nextTransformVersion;
+
+		for (entt::entity entity : aIndex.reparentedEntities)
+		{
+			if (myRegistry.valid(entity))
+			{
+				MarkSpatialSubtreeDirty(aIndex, entity);
+			}
+		}
+		aIndex.reparentedEntities.clear();
+	}
+
+	void Scene::MarkSpatialSubtreeDirty(SpatialIndex& aIndex, entt::entity aEntity)
 	{
-		if (myOnSceneTransitionCallback)
-		{
-			myOnSceneTransitionCallback(aScene);
-		}
-		else
+		// Called for every modified transform, so the stack is kept around instead of allocated per call
+		std::vector<entt::entity>& stack = mySpatialDirtyStack;
+		stack.clear();
+		stack.push_back(aEntity);
+
+		while (!stack.empty())
 		{
-			LOG_WARNING("Cannot transition scene - no callback set!");
+			const entt::entity entity = stack.back();
+			stack.pop_back();
+
+			const uint32_t entityIndex = GetEntityIndex(entity);
+			if (entityIndex >= aIndex.transformDirtyStamps.size())
+			{
+				aIndex.transformDirtyStamps.resize(entityIndex + 1, 0);
+			}
+
+			// Already marked this update, along with everything below it
+			if (aIndex.transformDirtyStamps[entityIndex] == aIndex.updateCount)
+			{
+				continue;
+			}
+			aIndex.transformDirtyStamps[entityIndex] = aIndex.updateCount;
+
+			for (UUID childID : myRegistry.get<RelationshipComponent>(entity).children)
+			{
+				if (Entity child = TryGetEntityWithUUID(childID))
+				{
+					stack.push_back(child);
+				}
+			}
 		}
 	}
 
-	Entity Scene::TryGetEntityByName(std::string_view aName)
+	void Scene::UpdateSpatialProxies(SpatialIndex& aIndex)
 	{
-		EPOCH_PROFILE_FUNC();
+		const bool isFullRefresh = aIndex.isFullRefreshPending;
+		aIndex.isFullRefreshPending = false;
 
-		auto entities = GetAllEntitiesWith<NameComponent>();
-		for (auto entity : entities)
+		for (SpatialIndex::Proxy& proxy : aIndex.proxies)
 		{
-			if (entities.get<NameComponent>(entity).name == aName)
+			// Only the inputs of the bounds are read here, the bounds themselves are recomputed when one of them changed
+			bool isActive = !myRegistry.has<InactiveInHierarchyComponent>(proxy.entity);
+			uint64_t boundsSource = 0;
+			switch (proxy.category)
 			{
-				return Entity{ entity, this };
+			case SpatialCategory::Mesh:
+			{
+				const auto& mrc = myRegistry.get<MeshRendererComponent>(proxy.entity);
+				isActive = isActive && mrc.isActive;
+				boundsSource = mrc.mesh;
+				break;
+			}
+			case SpatialCategory::SkinnedMesh:
+			{
+				const auto& smrc = myRegistry.get<SkinnedMeshRendererComponent>(proxy.entity);
+				isActive = isActive && smrc.isActive;
+				boundsSource = smrc.mesh;
+				break;
+			}
+			case SpatialCategory::Sprite:
+			{
+				const auto& src = myRegistry.get<SpriteRendererComponent>(proxy.entity);
+				isActive = isActive && src.isActive;
+				boundsSource = src.texture;
+				break;
+			}
+			case SpatialCategory::PointLight:
+				boundsSource = std::bit_cast<uint32_t>(myRegistry.get<PointLightComponent>(proxy.entity).range);
+				break;
+			case SpatialCategory::Spotlight:
+				boundsSource = std::bit_cast<uint32_t>(myRegistry.get<SpotlightComponent>(proxy.entity).range);
+				break;
+			case SpatialCategory::Interactable:
+			{
+				// The rect is part of the transform stamp, so it doesn't need a bounds source
+				const auto* bc = myRegistry.try_get<ButtonComponent>(proxy.entity);
+				const auto* cc = myRegistry.try_get<CheckboxComponent>(proxy.entity);
+				isActive = isActive && myRegistry.has<RectComponent>(proxy.entity) && ((bc && bc->isActive) || (cc && cc->isActive));
+				break;
+			}
 			}
-		}
 
-		return Entity{};
-	}
+			if (!isActive)
+			{
+				if (proxy.id != DynamicAABBTree::NullNode)
+				{
+					aIndex.tree.DestroyProxy(proxy.id);
+					proxy.id = DynamicAABBTree::NullNode;
+				}
+				continue;
+			}
 
-	std::vector<Entity> Scene::GetEntitiesByName(std::string_view aName)
-	{
-		EPOCH_PROFILE_FUNC();
+			const uint32_t entityIndex = GetEntityIndex(proxy.entity);
+			const bool transformChanged = isFullRefresh || (entityIndex < aIndex.transformDirtyStamps.size() && aIndex.transformDirtyStamps[entityIndex] == aIndex.updateCount);
+			const bool boundsChanged = proxy.id == DynamicAABBTree::NullNode || proxy.isBoundsPending || boundsSource != proxy.boundsSource;
+			if (!boundsChanged && !transformChanged)
+			{
+				continue;
+			}
 
-		std::vector<Entity> matches;
+			Entity entity = Entity(proxy.entity, this);
 
-		auto entities = GetAllEntitiesWith<NameComponent>();
-		for (auto entity : entities)
-		{
-			if (entities.get<NameComponent>(entity).name == aName)
+			if (boundsChanged || proxy.category == SpatialCategory::Interactable)
 			{
-				matches.emplace_back(entity, this);
+				proxy.isBoundsPending = false;
+
+				switch (proxy.category)
+				{
+				case SpatialCategory::Mesh:
+				case SpatialCategory::SkinnedMesh:
+				{
+					// Meshes that are still loading get added once their bounds are known
+					std::shared_ptr<Mesh> mesh = AssetManager::GetAssetAsync<Mesh>(boundsSource);
+					if (!mesh)
+					{
+						if (proxy.id != DynamicAABBTree::NullNode)
+						{
+							aIndex.tree.DestroyProxy(proxy.id);
+							proxy.id = DynamicAABBTree::NullNode;
+						}
+						continue;
+					}
+
+					proxy.localBounds = mesh->GetBoundingBox();
+					break;
+				}
+				case SpatialCategory::Sprite:
+				{
+					// Sprites are indexed with the default size until their texture is loaded
+					proxy.isBoundsPending = boundsSource != 0 && !AssetManager::GetAssetAsync<Texture2D>(boundsSource);
+
+					const CU::Vector2f halfSize = GetSpriteHalfSize(boundsSource);
+					proxy.localBounds = AABB(CU::Vector3f(-halfSize.x, -halfSize.y, 0.0f), CU::Vector3f(halfSize.x, halfSize.y, 0.0f));
+					break;
+				}
+				case SpatialCategory::PointLight:
+				case SpatialCategory::Spotlight:
+				{
+					const float range = CU::Math::Max(std::bit_cast<float>((uint32_t)boundsSource), 0.0001f);
+					proxy.localBounds = AABB(CU::Vector3f::Zero, range, range, range);
+					break;
+				}
+				case SpatialCategory::Interactable:
+				{
+					const auto& rc = myRegistry.get<RectComponent>(proxy.entity);
+					const CU::Vector2f size = CU::Vector2f((float)rc.size.x, (float)rc.size.y);
+					const CU::Vector2f bl = (CU::Vector2f(0.0f, 0.0f) - rc.pivot) * size;
+					const CU::Vector2f tr = (CU::Vector2f(1.0f, 1.0f) - rc.pivot) * size;
+					proxy.localBounds = AABB(CU::Vector3f(bl.x, bl.y, 0.0f), CU::Vector3f(tr.x, tr.y, 0.0f));
+					break;
+				}
+				}
+
+				proxy.boundsSource = boundsSource;
+			}
+
+			// Lights are indexed by the sphere they reach, which isn't affected by the rotation or scale of the entity
+			const CU::Matrix4x4f worldTransform = GetWorldSpaceTransformMatrix(entity);
+			AABB worldBounds;
+			if (proxy.category == SpatialCategory::PointLight || proxy.category == SpatialCategory::Spotlight)
+			{
+				const CU::Vector3f position = CU::Vector3f(worldTransform * CU::Vector4f(0.0f, 0.0f, 0.0f, 1.0f));
+				worldBounds = AABB(position + proxy.localBounds.min, position + proxy.localBounds.max);
+			}
+			else
+			{
+				worldBounds = proxy.localBounds.GetGlobal(worldTransform);
+			}
+
+			if (proxy.id == DynamicAABBTree::NullNode)
+			{
+				proxy.id = aIndex.tree.CreateProxy(worldBounds, (uint32_t)proxy.entity, (uint32_t)proxy.category);
+			}
+			else
+			{
+				aIndex.tree.MoveProxy(proxy.id, worldBounds);
 			}
 		}
+	}
 
-		return matches;
+	void Scene::QueryEntitiesInFrustum(const Frustum& aFrustum, SpatialCategory aCategories, std::vector<Entity>& outEntities)
+	{
+		mySpatialIndex.tree.QueryFrustum(aFrustum, (uint32_t)aCategories, [&](uint32_t aEntity)
+			{
+				if (myRegistry.valid((entt::entity)aEntity))
+				{
+					outEntities.emplace_back((entt::entity)aEntity, this);
+				}
+				return true;
+			});
 	}
 
-	Entity Scene::GetEntityWithUUID(UUID aUUID)
+	void Scene::QueryEntitiesAtPoint(const CU::Vector3f& aPoint, SpatialCategory aCategories, std::vector<Entity>& outEntities)
 	{
-		EPOCH_ASSERT(myEntityMap.find(aUUID) != myEntityMap.end(), "Entity doesn't exist in scene!");
-		return Entity{ myEntityMap.at(aUUID), this };
+		mySpatialIndex.tree.QueryPoint(aPoint, (uint32_t)aCategories, [&](uint32_t aEntity)
+			{
+				if (myRegistry.valid((entt::entity)aEntity))
+				{
+					outEntities.emplace_back((entt::entity)aEntity, this);
+				}
+				return true;
+			});
 	}
 
-	Entity Scene::TryGetEntityWithUUID(UUID aUUID)
+	void Scene::QueryEntitiesInRadius(const CU::Vector3f& aCenter, float aRadius, SpatialCategory aCategories, std::vector<Entity>& outEntities)
 	{
-		if (myEntityMap.find(aUUID) != myEntityMap.end())
-		{
-			return Entity{ myEntityMap.at(aUUID), this };
-		}
+		mySpatialIndex.tree.QuerySphere(aCenter, aRadius, (uint32_t)aCategories, [&](uint32_t aEntity)
+			{
+				if (myRegistry.valid((entt::entity)aEntity))
+				{
+					outEntities.emplace_back((entt::entity)aEntity, this);
+				}
+				return true;
+			});
+	}
 
-		return Entity{};
+	void Scene::QueryEntitiesAlongRay(const CU::Vector3f& aOrigin, const CU::Vector3f& aDirection, float aMaxDistance, SpatialCategory aCategories, std::vector<std::pair<Entity, float>>& outEntities)
+	{
+		const size_t firstResult = outEntities.size();
+
+		mySpatialIndex.tree.QueryRay(aOrigin, aDirection, aMaxDistance, (uint32_t)aCategories, [&](uint32_t aEntity, float aDistance)
+			{
+				if (myRegistry.valid((entt::entity)aEntity))
+				{
+					outEntities.emplace_back(Entity((entt::entity)aEntity, this), aDistance);
+				}
+				return true;
+			});
+
+		std::sort(outEntities.begin() + firstResult, outEntities.end(), [](const auto& aLhs, const auto& aRhs) { return aLhs.second < aRhs.second; });
 	}
 
-	Entity Scene::TryGetDescendantEntityWithName(Entity aEntity, const std::string& aName)
+	Entity Scene::PickEntity(const CU::Vector3f& aOrigin, const CU::Vector3f& aDirection, float aMaxDistance)
 	{
-		if (aEntity)
+		EPOCH_PROFILE_FUNC();
+
+		std::vector<std::pair<Entity, float>> candidates;
+		QueryEntitiesAlongRay(aOrigin, aDirection, aMaxDistance, SpatialCategory::Pickable, candidates);
+
+		Entity closestEntity;
+		float closestDistance = aMaxDistance;
+
+		for (const auto& [entity, entryDistance] : candidates)
 		{
-			if (aEntity.GetComponent<NameComponent>().name == aName)
+			// Sorted on where the ray enters the bounds, nothing after this can be in front of the closest hit
+			if (entryDistance > closestDistance)
 			{
-				return aEntity;
+				break;
 			}
 
-			for (const auto childId : aEntity.Children())
+			const CU::Matrix4x4f transform = GetWorldSpaceTransformMatrix(entity);
+			float distance = 0.0f;
+
+			if (const auto* mrc = myRegistry.try_get<MeshRendererComponent>(entity); mrc && mrc->isActive)
 			{
-				Entity descendant = TryGetDescendantEntityWithName(GetEntityWithUUID(childId), aName);
-				if (descendant)
+				std::shared_ptr<Mesh> mesh = AssetManager::GetAssetAsync<Mesh>(mrc->mesh);
+				if (mesh && RaycastMesh(*mesh, transform, aOrigin, aDirection, closestDistance, distance))
 				{
-					return descendant;
+					closestDistance = distance;
+					closestEntity = entity;
+				}
+			}
+
+			if (const auto* src = myRegistry.try_get<SpriteRendererComponent>(entity); src && src->isActive)
+			{
+				if (RaycastSprite(GetSpriteHalfSize(src->texture), transform, aOrigin, aDirection, closestDistance, distance))
+				{
+					closestDistance = distance;
+					closestEntity = entity;
 				}
 			}
 		}
-		return {};
-	}
 
-	bool Scene::IsEntityValid(Entity aEntity) const
-	{
-		return myRegistry.valid(aEntity);
+		return closestEntity;
 	}
 
-	Entity Scene::GetPrimaryCameraEntity()
+	void Scene::PickEntitiesInFrustum(const Frustum& aFrustum, std::vector<Entity>& outEntities)
 	{
-		auto view = myRegistry.view<CameraComponent>();
-		for (auto entity : view)
+		EPOCH_PROFILE_FUNC();
+
+		std::vector<Entity> candidates;
+		QueryEntitiesInFrustum(aFrustum, SpatialCategory::Pickable, candidates);
+
+		// Entities with both a mesh and a sprite are found once per category
+		std::unordered_set<entt::entity> tested;
+
+		for (Entity entity : candidates)
 		{
-			Entity camEntity(entity, this);
-			if (!camEntity.IsActive()) continue;
+			if (!tested.insert((entt::entity)entity).second)
+			{
+				continue;
+			}
 
-			const auto& camera = view.get<CameraComponent>(entity);
-			if (!camera.isActive) continue;
+			const CU::Matrix4x4f transform = GetWorldSpaceTransformMatrix(entity);
+			bool overlaps = false;
 
-			if (camera.primary)
+			if (const auto* mrc = myRegistry.try_get<MeshRendererComponent>(entity); mrc && mrc->isActive)
 			{
-				return camEntity;
+				if (std::shared_ptr<Mesh> mesh = AssetManager::GetAssetAsync<Mesh>(mrc->mesh))
+				{
+					const std::vector<Submesh>& submeshes = mesh->GetSubmeshes();
+					for (uint32_t i = 0; i < (uint32_t)submeshes.size() && !overlaps; i++)
+					{
+						overlaps = mesh->GetSubmeshBVH(i).Overlaps(TransformFrustumToLocal(aFrustum, transform * submeshes[i].transform));
+					}
+				}
 			}
-		}
 
-		return Entity{};
+			if (const auto* src = myRegistry.try_get<SpriteRendererComponent>(entity); !overlaps && src && src->isActive)
+			{
+				const CU::Vector2f halfSize = GetSpriteHalfSize(src->texture);
+				const AABB quad = AABB(CU::Vector3f(-halfSize.x, -halfSize.y, 0.0f), CU::Vector3f(halfSize.x, halfSize.y, 0.0f));
+				overlaps = DynamicAABBTree::FrustumOverlaps(quad, TransformFrustumToLocal(aFrustum, transform));
+			}
+
+			if (overlaps)
+			{
+				outEntities.push_back(entity);
+			}
+		}
 	}
 
 	std::pair<uint32_t, uint32_t> Scene::GetPhysicsBodyCount()
@@ -1046,7 +2288,7 @@ namespace Epoch
 				for (auto fieldID : sc.fieldIDs)
 				{
 					FieldInfo* fieldInfo = ScriptCache::GetFieldByID(fieldID);
-					std::shared_ptr<FieldStorageBase> storage = ScriptEngine::GetFieldStorage(Entity{ entity, this }, fieldID);
+					FieldStorageBase storage = ScriptEngine::GetFieldStorage(Entity{ entity, this }, fieldID);
 					if (!FieldUtils::IsAsset(fieldInfo->type))
 					{
 						continue;
@@ -1054,8 +2296,8 @@ namespace Epoch
 
 					if (!fieldInfo->IsArray())
 					{
-						std::shared_ptr<FieldStorage> fieldStorage = std::static_pointer_cast<FieldStorage>(storage);
-						AssetHandle handle = fieldStorage->GetValue<UUID>();
+						FieldStorage fieldStorage = storage.AsField();
+						AssetHandle handle = fieldStorage.GetValue<UUID>();
 						if (AssetManager::IsMemoryAsset(handle) || Project::GetEditorAssetManager()->GetAssetType(handle) != AssetType::Scene)
 						{
 							continue;
@@ -1068,11 +2310,11 @@ namespace Epoch
 					}
 					else
 					{
-						std::shared_ptr<ArrayFieldStorage> arrayFieldStorage = std::static_pointer_cast<ArrayFieldStorage>(storage);
+						ArrayFieldStorage arrayFieldStorage = storage.AsArray();
 
-						for (uint32_t i = 0; i < arrayFieldStorage->GetLength(); i++)
+						for (uint32_t i = 0; i < arrayFieldStorage.GetLength(); i++)
 						{
-							AssetHandle handle = arrayFieldStorage->GetValue<UUID>(i);
+							AssetHandle handle = arrayFieldStorage.GetValue<UUID>(i);
 
 							if (AssetManager::IsMemoryAsset(handle))
 							{
@@ -1213,7 +2455,7 @@ namespace Epoch
 				for (auto fieldID : sc.fieldIDs)
 				{
 					FieldInfo* fieldInfo = ScriptCache::GetFieldByID(fieldID);
-					std::shared_ptr<FieldStorageBase> storage = ScriptEngine::GetFieldStorage(Entity{ entity, this }, fieldID);
+					FieldStorageBase storage = ScriptEngine::GetFieldStorage(Entity{ entity, this }, fieldID);
 					if (!FieldUtils::IsAsset(fieldInfo->type))
 					{
 						continue;
@@ -1221,8 +2463,8 @@ namespace Epoch
 
 					if (!fieldInfo->IsArray())
 					{
-						std::shared_ptr<FieldStorage> fieldStorage = std::static_pointer_cast<FieldStorage>(storage);
-						AssetHandle handle = fieldStorage->GetValue<UUID>();
+						FieldStorage fieldStorage = storage.AsField();
+						AssetHandle handle = fieldStorage.GetValue<UUID>();
 						if (AssetManager::IsMemoryAsset(handle) || !AssetManager::IsAssetHandleValid(handle))
 						{
 							continue;
@@ -1232,11 +2474,11 @@ namespace Epoch
 					}
 					else
 					{
-						std::shared_ptr<ArrayFieldStorage> arrayFieldStorage = std::static_pointer_cast<ArrayFieldStorage>(storage);
+						ArrayFieldStorage arrayFieldStorage = storage.AsArray();
 
-						for (uint32_t i = 0; i < arrayFieldStorage->GetLength(); i++)
+						for (uint32_t i = 0; i < arrayFieldStorage.GetLength(); i++)
 						{
-							AssetHandle handle = arrayFieldStorage->GetValue<UUID>(i);
+							AssetHandle handle = arrayFieldStorage.GetValue<UUID>(i);
 
 							if (AssetManager::IsMemoryAsset(handle) || !AssetManager::IsAssetHandleValid(handle))
 							{
@@ -1396,90 +2638,130 @@ namespace Epoch
 
 		const auto& bones = aMesh->GetSkeleton()->GetBones();
 
+		// One walk over the hierarchy for all the bones instead of one per bone
+		std::unordered_map<std::string_view, UUID> descendantsByName;
+		GetDescendantsByName(aRoot, descendantsByName);
+
 		for (const auto& bone : bones)
 		{
-			Entity boneEntity = TryGetDescendantEntityWithName(aRoot, bone.name);
-			if (boneEntity)
+			auto it = descendantsByName.find(bone.name);
+			if (it != descendantsByName.end())
 			{
-				boneEntityIds.emplace_back(boneEntity.GetUUID());
+				boneEntityIds.emplace_back(it->second);
 			}
 		}
 
 		return boneEntityIds;
 	}
 
-	std::vector<CU::Matrix4x4f> Scene::GetModelSpaceBoneTransforms(Entity aEntity, std::shared_ptr<Mesh> aMesh)
+	void Scene::PrepareSkinningCache(SkinningCache& aCache, SkinnedMeshRendererComponent& aSkinnedMeshRenderer, const std::shared_ptr<Skeleton>& aSkeleton)
 	{
-		EPOCH_PROFILE_FUNC();
-
-		std::vector<CU::Matrix4x4f> boneTransforms;
+		bool resolve = aCache.skeleton != aSkeleton || aCache.boneEntityIds != aSkinnedMeshRenderer.boneEntityIds;
+		if (!resolve)
+		{
+			// Destroying a bone entity, or recreating it with the same id, changes its handle
+			for (size_t i = 0; i < aCache.boneEntities.size(); i++)
+			{
+				if (!myRegistry.valid(aCache.boneEntities[i]) && myEntityMap.contains(aCache.boneEntityIds[i]))
+				{
+					resolve = true;
+					break;
+				}
+			}
+		}
 
-		if (aMesh->HasSkeleton())
+		if (!resolve)
 		{
-			auto skeleton = aMesh->GetSkeleton();
+			return;
+		}
 
-			auto& smrc = aEntity.GetComponent<SkinnedMeshRendererComponent>();
+		const uint32_t boneCount = aSkeleton->GetNumBones();
 
-			if (smrc.boneEntityIds.empty())
-			{
-				smrc.boneEntityIds = FindBoneEntityIds(aEntity, aMesh);
-			}
+		aCache.skeleton = aSkeleton;
+		aCache.boneEntityIds = aSkinnedMeshRenderer.boneEntityIds;
+		aCache.localTransforms.assign(boneCount, CU::Matrix4x4f::Identity);
+		aCache.modelTransforms.assign(boneCount, CU::Matrix4x4f::Identity);
+		aCache.palette.assign(boneCount, CU::Matrix4x4f::Identity);
+		aCache.isPaletteValid = false;
 
-			if (smrc.boneEntityIds.size() != skeleton->GetNumBones())
+		// Without an entity for every bone the mesh is drawn in its bind pose
+		aCache.boneEntities.clear();
+		if (aCache.boneEntityIds.size() == boneCount)
+		{
+			aCache.boneEntities.resize(boneCount, entt::null);
+			for (uint32_t i = 0; i < boneCount; i++)
 			{
-				boneTransforms.resize(skeleton->GetNumBones());
-				return boneTransforms;
+				if (auto it = myEntityMap.find(aCache.boneEntityIds[i]); it != myEntityMap.end())
+				{
+					aCache.boneEntities[i] = it->second;
+				}
 			}
-
-			boneTransforms.resize(smrc.boneEntityIds.size());
-			GetModelSpaceBoneTransform(smrc.boneEntityIds, boneTransforms, 0, CU::Matrix4x4f::Identity, skeleton);
 		}
-
-		return boneTransforms;
 	}
 
-	void Scene::GetModelSpaceBoneTransform(const std::vector<UUID>& aBoneEntityIds, std::vector<CU::Matrix4x4f>& outBoneTransforms, uint32_t aBoneIndex, const CU::Matrix4x4f& aParentTransform, std::shared_ptr<Skeleton> aSkeleton)
+	void Scene::ReadSkinningBoneTransforms(SkinningCache& aCache)
 	{
-		const Skeleton::Bone& bone = aSkeleton->GetBone(aBoneIndex);
+		for (size_t i = 0; i < aCache.boneEntities.size(); i++)
+		{
+			const entt::entity boneEntity = aCache.boneEntities[i];
+			const bool isBoneValid = boneEntity != entt::null && myRegistry.valid(boneEntity);
 
-		auto boneEntity = TryGetEntityWithUUID(aBoneEntityIds[aBoneIndex]);
-		const CU::Matrix4x4f localTransform = boneEntity ? boneEntity.GetComponent<TransformComponent>().GetMatrix() : CU::Matrix4x4f::Identity;
+			const CU::Matrix4x4f& localTransform = isBoneValid ? myRegistry.get<TransformComponent>(boneEntity).GetMatrix() : CU::Matrix4x4f::Identity;
+			if (memcmp(&localTransform, &aCache.localTransforms[i], sizeof(CU::Matrix4x4f)) != 0)
+			{
+				aCache.localTransforms[i] = localTransform;
+				aCache.isPaletteValid = false;
+			}
+		}
+	}
 
-		const CU::Matrix4x4f matrix = localTransform * aParentTransform;
+	void Scene::EvaluateSkinningPalette(SkinningCache& aCache)
+	{
+		if (aCache.boneEntities.empty() || aCache.isPaletteValid)
+		{
+			return;
+		}
 
-		for (size_t i = 0; i < bone.childrenIndices.size(); i++)
+		// Bones are stored parents first, so one pass in order sees every parent before its children
+		const auto& bones = aCache.skeleton->GetBones();
+		for (size_t i = 0; i < bones.size(); i++)
 		{
-			GetModelSpaceBoneTransform(aBoneEntityIds, outBoneTransforms, bone.childrenIndices[i], matrix, aSkeleton);
+			const Skeleton::Bone& bone = bones[i];
+			EPOCH_ASSERT(bone.parentIndex == Skeleton::NullIndex || bone.parentIndex < i, "Bone parent is stored after the bone!");
+
+			aCache.modelTransforms[i] = bone.parentIndex == Skeleton::NullIndex ? aCache.localTransforms[i] : aCache.localTransforms[i] * aCache.modelTransforms[bone.parentIndex];
+			aCache.palette[i] = bone.invBindPose * aCache.modelTransforms[i];
 		}
 
-		outBoneTransforms[aBoneIndex] = bone.invBindPose * matrix;
+		aCache.isPaletteValid = true;
 	}
 
 	void Scene::Render3DScene(std::shared_ptr<SceneRenderer> aRenderer, const SceneRendererCamera& aRenderCamera, const SceneRendererCamera& aCullingCamera, bool aIsGameView, bool aWithPostProccessing)
 	{
 		EPOCH_PROFILE_FUNC();
 
-		std::unordered_map<AssetHandle, std::shared_ptr<Asset>> assetAccelerationMap;
+		std::pmr::unordered_map<AssetHandle, std::shared_ptr<Asset>> assetAccelerationMap(FrameAllocator::Get());
 
 		const Frustum frustum = CreateFrustum(aCullingCamera);
 
-		std::unordered_set<UUID> lastFramesFrustumCulledEntities = myFrustumCulledEntities;
-		myFrustumCulledEntities.clear();
+		UpdateSpatialIndex();
 
-		std::unordered_set<UUID> enteredFrustum;
-		std::unordered_set<UUID> exitedFrustum;
+		const size_t frustumWordCount = (myRegistry.size() + 63) / 64;
+		std::swap(myFrustumCulledBits, myLastFrustumCulledBits);
+		myFrustumCulledBits.assign(frustumWordCount, 0);
+		myFrustumTestedBits.assign(frustumWordCount, 0);
+		myLastFrustumCulledBits.resize(frustumWordCount, 0);
 
 		// Lighting
 		{
 				EPOCH_PROFILE_SCOPE("Scene::RenderScene::UpdateLightEnvironment");
 
-				myLightEnvironment = LightEnvironment();
+				myLightEnvironment.Clear();
 				
-				auto directionalLights = GetAllEntitiesWith<DirectionalLightComponent>();
+				auto directionalLights = GetAllActiveEntitiesWith<DirectionalLightComponent>();
 				for (auto entityID : directionalLights)
 				{
 					Entity entity = Entity(entityID, this);
-					if (!entity.IsActive()) continue;
 
 					const auto& dlc = directionalLights.get<DirectionalLightComponent>(entityID);
 					if (!dlc.isActive && dlc.intensity > 0.0f) continue;
@@ -1493,11 +2775,10 @@ namespace Epoch
 					break;
 				}
 
-				auto skyLights = GetAllEntitiesWith<SkyLightComponent>();
+				auto skyLights = GetAllActiveEntitiesWith<SkyLightComponent>();
 				for (auto entityID : skyLights)
 				{
 					Entity entity = Entity(entityID, this);
-					if (!entity.IsActive()) continue;
 
 					const auto& slc = skyLights.get<SkyLightComponent>(entityID);
 					if (!slc.isActive && slc.intensity > 0.0f) continue;
@@ -1512,14 +2793,23 @@ namespace Epoch
 					break;
 				}
 
-				auto pointLights = GetAllEntitiesWith<PointLightComponent>();
-				myLightEnvironment.pointLights.reserve(pointLights.size());
-				for (auto entityID : pointLights)
+				// Only the lights reaching into the view are gathered
+				mySpatialQueryResults.clear();
+				mySpatialIndex.tree.QueryFrustum(frustum, (uint32_t)SpatialCategory::Light, [this](uint32_t aEntity)
+					{
+						mySpatialQueryResults.push_back((entt::entity)aEntity);
+						return true;
+					});
+				std::sort(mySpatialQueryResults.begin(), mySpatialQueryResults.end());
+				mySpatialQueryResults.erase(std::unique(mySpatialQueryResults.begin(), mySpatialQueryResults.end()), mySpatialQueryResults.end());
+
+				for (auto entityID : mySpatialQueryResults)
 				{
+					if (!myRegistry.valid(entityID) || !myRegistry.has<PointLightComponent>(entityID)) continue;
+
 					Entity entity = Entity(entityID, this);
-					if (!entity.IsActive()) continue;
 
-					const auto& plc = pointLights.get<PointLightComponent>(entityID);
+					const auto& plc = myRegistry.get<PointLightComponent>(entityID);
 					if (!plc.isActive && plc.intensity > 0.0f) continue;
 
 					CU::Transform transform = GetWorldSpaceTransform(entity);
@@ -1540,14 +2830,13 @@ namespace Epoch
 					pl.cookie = cookie;
 				}
 
-				auto spotlights = GetAllEntitiesWith<SpotlightComponent>();
-				myLightEnvironment.spotlights.reserve(spotlights.size());
-				for (auto entityID : spotlights)
+				for (auto entityID : mySpatialQueryResults)
 				{
+					if (!myRegistry.valid(entityID) || !myRegistry.has<SpotlightComponent>(entityID)) continue;
+
 					Entity entity = Entity(entityID, this);
-					if (!entity.IsActive()) continue;
 
-					const auto& slc = spotlights.get<SpotlightComponent>(entityID);
+					const auto& slc = myRegistry.get<SpotlightComponent>(entityID);
 					if (!slc.isActive && slc.intensity > 0.0f) continue;
 
 					CU::Transform transform = GetWorldSpaceTransform(entity);
@@ -1581,11 +2870,10 @@ namespace Epoch
 
 			if (aWithPostProccessing)
 			{
-				auto volumes = GetAllEntitiesWith<VolumeComponent>();
+				auto volumes = GetAllActiveEntitiesWith<VolumeComponent>();
 				for (auto entityID : volumes)
 				{
 					Entity entity = Entity(entityID, this);
-					if (!entity.IsActive()) continue;
 
 					const auto& vc = volumes.get<VolumeComponent>(entityID);
 					if (!vc.isActive) continue;
@@ -1646,11 +2934,10 @@ namespace Epoch
 				EPOCH_PROFILE_SCOPE("Scene::RenderScene::SubmitMeshes");
 
 				{
-					auto view = GetAllEntitiesWith<MeshRendererComponent>();
+					auto view = GetAllActiveEntitiesWith<MeshRendererComponent>();
 					for (auto id : view)
 					{
 						Entity entity = Entity(id, this);
-						if (!entity.IsActive()) continue;
 
 						const auto& mrc = view.get<MeshRendererComponent>(id);
 						if (!mrc.isActive) continue;
@@ -1670,21 +2957,16 @@ namespace Epoch
 						{
 							const CU::Matrix4x4f transform = GetWorldSpaceTransformMatrix(entity);
 
+							const uint32_t entityIndex = GetEntityIndex(id);
+							SetBit(myFrustumTestedBits, entityIndex);
+
 							if (!FrustumIntersection(frustum, mesh->GetBoundingBox().GetGlobal(transform)))
 							{
-								myFrustumCulledEntities.insert(entity.GetUUID());
-								if (!lastFramesFrustumCulledEntities.contains(entity.GetUUID()))
-								{
-									exitedFrustum.insert(entity.GetUUID());
-								}
+								SetBit(myFrustumCulledBits, entityIndex);
 							}
 							else
 							{
 								aRenderer->SubmitMesh(mesh, mrc.materialTable, transform, (uint32_t)entity);
-								if (lastFramesFrustumCulledEntities.contains(entity.GetUUID()))
-								{
-									enteredFrustum.insert(entity.GetUUID());
-								}
 							}
 							
 							if (mrc.castsShadows)
@@ -1696,13 +2978,14 @@ namespace Epoch
 				}
 
 				{
-					auto view = GetAllEntitiesWith<SkinnedMeshRendererComponent>();
+					mySkinnedMeshDraws.clear();
+
+					auto view = GetAllActiveEntitiesWith<SkinnedMeshRendererComponent>();
 					for (auto id : view)
 					{
 						Entity entity = Entity(id, this);
-						if (!entity.IsActive()) continue;
 
-						const auto& smrc = view.get<SkinnedMeshRendererComponent>(id);
+						auto& smrc = view.get<SkinnedMeshRendererComponent>(id);
 						if (!smrc.isActive) continue;
 
 						std::shared_ptr<Mesh> mesh;
@@ -1716,12 +2999,52 @@ namespace Epoch
 							assetAccelerationMap[smrc.mesh] = mesh;
 						}
 
-						if (mesh)
+						if (!mesh)
+						{
+							continue;
+						}
+
+						if (!mesh->HasSkeleton())
+						{
+							aRenderer->SubmitAnimatedMesh(mesh, GetWorldSpaceTransformMatrix(entity), {});
+							continue;
+						}
+
+						if (smrc.boneEntityIds.empty())
 						{
-							CU::Matrix4x4f transform = GetWorldSpaceTransformMatrix(entity);
-							aRenderer->SubmitAnimatedMesh(mesh, transform, GetModelSpaceBoneTransforms(entity, mesh));
+							smrc.boneEntityIds = FindBoneEntityIds(entity, mesh);
 						}
+
+						SkinningCache& cache = mySkinningCaches[id];
+						PrepareSkinningCache(cache, smrc, mesh->GetSkeleton());
+						ReadSkinningBoneTransforms(cache);
+
+						SkinnedMeshDraw& draw = mySkinnedMeshDraws.emplace_back();
+						draw.entity = id;
+						draw.mesh = mesh;
+						draw.cache = &cache;
+					}
+
+					{
+						EPOCH_PROFILE_SCOPE("Scene::RenderScene::EvaluateSkinning");
+
+						constexpr uint32_t SkinningBatchSize = 16;
+						Application::Get().GetJobSystem().ParallelFor((uint32_t)mySkinnedMeshDraws.size(), SkinningBatchSize, [this](uint32_t aBegin, uint32_t aEnd)
+							{
+								for (uint32_t i = aBegin; i < aEnd; i++)
+								{
+									EvaluateSkinningPalette(*mySkinnedMeshDraws[i].cache);
+								}
+							});
 					}
+
+					for (const SkinnedMeshDraw& draw : mySkinnedMeshDraws)
+					{
+						CU::Matrix4x4f transform = GetWorldSpaceTransformMatrix(Entity(draw.entity, this));
+						aRenderer->SubmitAnimatedMesh(draw.mesh, transform, draw.cache->palette);
+					}
+
+					mySkinnedMeshDraws.clear();
 				}
 			}
 		
@@ -1729,11 +3052,10 @@ namespace Epoch
 		{
 				EPOCH_PROFILE_SCOPE("Scene::RenderScene::SubmitSprites");
 
-				auto view = GetAllEntitiesWith<SpriteRendererComponent>();
+				auto view = GetAllActiveEntitiesWith<SpriteRendererComponent>();
 				for (auto id : view)
 				{
 					Entity entity = Entity(id, this);
-					if (!entity.IsActive()) continue;
 
 					const auto& src = view.get<SpriteRendererComponent>(id);
 					if (!src.isActive) continue;
@@ -1759,11 +3081,10 @@ namespace Epoch
 		{
 				EPOCH_PROFILE_SCOPE("Scene::RenderScene::SubmitText");
 
-				auto view = GetAllEntitiesWith<TextRendererComponent>();
+				auto view = GetAllActiveEntitiesWith<TextRendererComponent>();
 				for (auto id : view)
 				{
 					Entity entity = Entity(id, this);
-					if (!entity.IsActive()) continue;
 
 					const auto& trc = view.get<TextRendererComponent>(id);
 					if (!trc.isActive) continue;
@@ -1801,60 +3122,84 @@ namespace Epoch
 			{
 				EPOCH_PROFILE_SCOPE("Scene::RenderScene::OnFrustumEnter/Exit");
 
-				for (UUID entityID : enteredFrustum)
+				std::pmr::vector<entt::entity> enteredFrustum(FrameAllocator::Get());
+				std::pmr::vector<entt::entity> exitedFrustum(FrameAllocator::Get());
+
+				const entt::entity* entities = myRegistry.data();
+				for (size_t word = 0; word < frustumWordCount; word++)
 				{
-					Entity entity = TryGetEntityWithUUID(entityID);
-					if (!entity)
+					const uint64_t changed = myFrustumCulledBits[word] ^ myLastFrustumCulledBits[word];
+					if (changed == 0)
 					{
 						continue;
 					}
 
-					if (!entity.HasComponent<ScriptComponent>())
+					// Entities that weren't tested this frame count as visible, but only the tested ones entered the frustum
+					uint64_t entered = changed & myLastFrustumCulledBits[word] & myFrustumTestedBits[word];
+					uint64_t exited = changed & myFrustumCulledBits[word];
+
+					for (; entered != 0; entered &= entered - 1)
 					{
-						continue;
+						enteredFrustum.push_back(entities[word * 64 + std::countr_zero(entered)]);
 					}
 
-					const auto& sc = entity.GetComponent<ScriptComponent>();
-
-					if (!ScriptEngine::IsModuleValid(sc.scriptClassHandle) || !ScriptEngine::IsEntityInstantiated(entity))
+					for (; exited != 0; exited &= exited - 1)
 					{
-						continue;
+						exitedFrustum.push_back(entities[word * 64 + std::countr_zero(exited)]);
 					}
-
-					ScriptEngine::CallMethod(sc.managedInstance, "OnFrustumEnter");
 				}
 
+				DispatchFrustumEvents(enteredFrustum, "OnFrustumEnter");
+				DispatchFrustumEvents(exitedFrustum, "OnFrustumExit");
+			}
+	}
 
-				for (UUID entityID : exitedFrustum)
-				{
-					Entity entity = TryGetEntityWithUUID(entityID);
-					if (!entity)
-					{
-						continue;
-					}
+	void Scene::DispatchFrustumEvents(const std::pmr::vector<entt::entity>& aEntities, const char* aMethodName)
+	{
+		if (aEntities.empty())
+		{
+			return;
+		}
 
-					if (!entity.HasComponent<ScriptComponent>())
-					{
-						continue;
-					}
+		// Method pointers are only valid for the currently loaded assembly, so they are resolved again for every batch.
+		// Classes that don't override the callback resolve to the empty one on Entity and are skipped without calling into C#.
+		ManagedMethod* baseMethod = EPOCH_CACHED_METHOD("Epoch.Entity", aMethodName, 0);
+		std::pmr::unordered_map<uint32_t, ManagedMethod*> classMethods(FrameAllocator::Get());
 
-					const auto& sc = entity.GetComponent<ScriptComponent>();
+		for (entt::entity id : aEntities)
+		{
+			// Earlier callbacks in the batch can destroy entities
+			if (!myRegistry.valid(id) || !myRegistry.has<ScriptComponent>(id))
+			{
+				continue;
+			}
 
-					if (!ScriptEngine::IsModuleValid(sc.scriptClassHandle) || !ScriptEngine::IsEntityInstantiated(entity))
-					{
-						continue;
-					}
+			Entity entity = Entity(id, this);
+			const auto& sc = myRegistry.get<ScriptComponent>(id);
 
-					ScriptEngine::CallMethod(sc.managedInstance, "OnFrustumExit");
-				}
+			if (!ScriptEngine::IsModuleValid(sc.scriptClassHandle) || !ScriptEngine::IsEntityInstantiated(entity))
+			{
+				continue;
+			}
+
+			const uint32_t classID = ScriptEngine::GetScriptClassIDFromComponent(sc);
+			auto it = classMethods.find(classID);
+			if (it == classMethods.end())
+			{
+				ManagedClass* managedClass = ScriptCache::GetManagedClassByID(classID);
+				ManagedMethod* method = managedClass ? ScriptCache::GetSpecificManagedMethod(managedClass, aMethodName, 0) : nullptr;
+				it = classMethods.emplace(classID, method != baseMethod ? method : nullptr).first;
 			}
+
+			ScriptEngine::CallResolvedMethod(sc.managedInstance, it->second);
+		}
 	}
 
 	void Scene::Render2DScene(std::shared_ptr<SceneRenderer> aRenderer, const SceneRendererCamera& aRenderCamera, bool aIsGameView)
 	{
 		EPOCH_PROFILE_FUNC();
 
-		std::unordered_map<AssetHandle, std::shared_ptr<Asset>> assetAccelerationMap;
+		std::pmr::unordered_map<AssetHandle, std::shared_ptr<Asset>> assetAccelerationMap(FrameAllocator::Get());
 
 		auto screenSpaceRenderer = aRenderer->GetScreenSpaceRenderer();
 		if (screenSpaceRenderer)
@@ -1868,15 +3213,14 @@ namespace Epoch
 				screenSpaceRenderer->BeginScene(aRenderCamera.camera.GetProjectionMatrix(), aRenderCamera.viewMatrix);
 			}
 
-			std::map<entt::entity, CU::Color> imageTintMap;
-			std::set<entt::entity> imageToSkip;
+			std::pmr::map<entt::entity, CU::Color> imageTintMap(FrameAllocator::Get());
+			std::pmr::set<entt::entity> imageToSkip(FrameAllocator::Get());
 
 			{
-				auto buttonView = GetAllEntitiesWith<ButtonComponent>();
+				auto buttonView = GetAllActiveEntitiesWith<ButtonComponent>();
 				for (auto id : buttonView)
 				{
 					Entity entity = Entity(id, this);
-					if (!entity.IsActive()) continue;
 
 					const auto& bc = buttonView.get<ButtonComponent>(id);
 					if (!bc.isActive) continue;
@@ -1897,11 +3241,10 @@ namespace Epoch
 			}
 
 			{
-				auto checkboxView = GetAllEntitiesWith<CheckboxComponent>();
+				auto checkboxView = GetAllActiveEntitiesWith<CheckboxComponent>();
 				for (auto id : checkboxView)
 				{
 					Entity entity = Entity(id, this);
-					if (!entity.IsActive()) continue;
 
 					const auto& cc = checkboxView.get<CheckboxComponent>(id);
 					if (!cc.isActive) continue;
@@ -1934,13 +3277,12 @@ namespace Epoch
 			{
 				EPOCH_PROFILE_SCOPE("Scene::RenderScene::SubmitImages");
 
-				auto view = GetAllEntitiesWith<RectComponent, ImageComponent>();
+				auto view = GetAllActiveEntitiesWith<RectComponent, ImageComponent>();
 				for (auto id : view)
 				{
 					if (imageToSkip.contains(id)) continue;
 
 					Entity entity = Entity(id, this);
-					if (!entity.IsActive()) continue;
 
 					const auto& [rc, ic] = view.get<RectComponent, ImageComponent>(id);
 					if (!ic.isActive) continue;
@@ -1981,11 +3323,10 @@ namespace Epoch
 			{
 				EPOCH_PROFILE_SCOPE("Scene::RenderScene::SubmitImages");
 
-				auto view = GetAllEntitiesWith<RectComponent, Text2DComponent>();
+				auto view = GetAllActiveEntitiesWith<RectComponent, Text2DComponent>();
 				for (auto id : view)
 				{
 					Entity entity = Entity(id, this);
-					if (!entity.IsActive()) continue;
 
 					const auto& [rc, tc] = view.get<RectComponent, Text2DComponent>(id);
 					if (!tc.isActive) continue;
@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include <memory>
+#include <memory_resource>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -9,6 +10,7 @@
 #include "Epoch/Core/UUID.h"
 #include "Epoch/Assets/Asset.h"
 #include "Epoch/Math/Frustum.h"
+#include "Epoch/Math/DynamicAABBTree.h"
 #include "Epoch/Editor/EditorCamera.h"
 #include "Epoch/Physics/PhysicsSystem.h"
 
@@ -21,6 +23,22 @@ namespace Epoch
 	class SceneRenderer;
 	struct SceneRendererCamera;
 
+	enum class SpatialCategory : uint32_t
+	{
+		None = 0,
+		Mesh			= BIT(0),
+		SkinnedMesh		= BIT(1),
+		PointLight		= BIT(2),
+		Spotlight		= BIT(3),
+		Interactable	= BIT(4),
+		Sprite			= BIT(5),
+
+		Renderable = Mesh | SkinnedMesh,
+		Light = PointLight | Spotlight,
+		Pickable = Mesh | Sprite,
+		All = 0xFFFFFFFF
+	};
+
 	class Scene : public Asset
 	{
 	public:
@@ -33,8 +51,8 @@ namespace Epoch
 		};
 
 	public:
-		Scene(const std::string& aName = "New Scene") : myName(aName) {}
-		Scene(AssetHandle aHandle) { SetAssetHandle(aHandle); }
+		Scene(const std::string& aName = "New Scene") : myName(aName) { ConnectSignals(); }
+		Scene(AssetHandle aHandle) { SetAssetHandle(aHandle); ConnectSignals(); }
 		~Scene() = default;
 		
 		void SetSceneTransitionCallback(const std::function<void(AssetHandle)>& aCallback) { myOnSceneTransitionCallback = aCallback; }
@@ -60,9 +78,19 @@ namespace Epoch
 		Entity CreatePrefabEntity(Entity aEntity, Entity aParent);
 		Entity InstantiateMesh(std::shared_ptr<Mesh> aMesh);
 
+		// Pools keep deactivated prefab instances around so spawning during play doesn't have to create entities, bodies or scripts
+		void CreatePrefabPool(std::shared_ptr<Prefab> aPrefab, uint32_t aCount);
+		void DestroyPrefabPool(AssetHandle aPrefab);
+		Entity SpawnFromPool(std::shared_ptr<Prefab> aPrefab, const CU::Vector3f* aTranslation = nullptr, const CU::Vector3f* aRotation = nullptr, const CU::Vector3f* aScale = nullptr);
+		bool DespawnToPool(Entity aEntity);
+		uint32_t GetPoolAvailableCount(AssetHandle aPrefab) const;
+
 		void UpdateEntityReferences(const std::unordered_map<UUID, UUID>& aEntityIDMap);
 
 		void OnRuntimeStart();
+		// Time-sliced OnRuntimeStart for scene transitions, creates the physics bodies and script instances until the budget is used up.
+		// Called instead of OnRuntimeStart every frame until it returns true, the scene isn't updated before that.
+		bool OnRuntimeStartSliced(float aBudgetMilliseconds);
 		void OnRuntimeStop();
 
 		void OnSimulationStart();
@@ -88,16 +116,37 @@ namespace Epoch
 		unsigned GetViewportWidth() const { return myViewportWidth; }
 		unsigned GetViewportHeight() const { return myViewportHeight; }
 
+		// Looked up in the name index, entities renamed by assigning NameComponent::name directly instead of using Entity::SetName aren't found under their new name
 		Entity TryGetEntityByName(std::string_view aName);
 		std::vector<Entity> GetEntitiesByName(std::string_view aName);
 		Entity GetEntityWithUUID(UUID aUUID);
 		Entity TryGetEntityWithUUID(UUID aUUID);
 		Entity TryGetDescendantEntityWithName(Entity aEntity, const std::string& aName);
 		bool IsEntityValid(Entity aEntity) const;
-		bool WasEntityFrustumCulled(UUID aEntityID) const { return myFrustumCulledEntities.find(aEntityID) != myFrustumCulledEntities.end(); }
+
+		// Bumped whenever entities are created, destroyed, sorted or reparented, so editor views of the hierarchy know when to rebuild
+		uint64_t GetHierarchyVersion() const { return myHierarchyVersion; }
+		// Bumped whenever an entity is renamed
+		uint64_t GetNameVersion() const { return myNameVersion; }
+		bool WasEntityFrustumCulled(UUID aEntityID) const;
+		bool WasEntityFrustumCulled(entt::entity aEntity) const;
 
 		Entity GetPrimaryCameraEntity();
 
+		// Queries against the bounds of the meshes and lights in the scene.
+		// The spatial index is refreshed when the scene gets rendered, call UpdateSpatialIndex to see changes made since then.
+		void UpdateSpatialIndex();
+		void QueryEntitiesInFrustum(const Frustum& aFrustum, SpatialCategory aCategories, std::vector<Entity>& outEntities);
+		void QueryEntitiesAtPoint(const CU::Vector3f& aPoint, SpatialCategory aCategories, std::vector<Entity>& outEntities);
+		void QueryEntitiesInRadius(const CU::Vector3f& aCenter, float aRadius, SpatialCategory aCategories, std::vector<Entity>& outEntities);
+		// Sorted by the distance at which the ray enters the bounds of the entity
+		void QueryEntitiesAlongRay(const CU::Vector3f& aOrigin, const CU::Vector3f& aDirection, float aMaxDistance, SpatialCategory aCategories, std::vector<std::pair<Entity, float>>& outEntities);
+
+		// Picking against the triangles of the meshes and the quads of the sprites, using the spatial index to find the candidates.
+		// Skinned meshes, text and UI aren't pickable this way. Returns an invalid entity if the ray didn't hit anything.
+		Entity PickEntity(const CU::Vector3f& aOrigin, const CU::Vector3f& aDirection, float aMaxDistance);
+		void PickEntitiesInFrustum(const Frustum& aFrustum, std::vector<Entity>& outEntities);
+
 		std::shared_ptr<PhysicsScene> GetPhysicsScene() { return myPhysicsScene; }
 		std::pair<uint32_t, uint32_t> GetPhysicsBodyCount();
 
@@ -107,6 +156,13 @@ namespace Epoch
 			return myRegistry.view<ComponentTypse...>();
 		}
 
+		// Skips entities that are inactive themselves or have an inactive ancestor
+		template<typename... ComponentTypes>
+		auto GetAllActiveEntitiesWith()
+		{
+			return myRegistry.view<ComponentTypes...>(entt::exclude<InactiveInHierarchyComponent>);
+		}
+
 		CU::Matrix4x4f GetWorldSpaceTransformMatrix(Entity aEntity);
 		CU::Transform GetWorldSpaceTransform(Entity aEntity);
 
@@ -201,15 +257,63 @@ namespace Epoch
 			return false;
 		}
 
+		Entity CreatePooledInstance(std::shared_ptr<Prefab> aPrefab);
+		void GetPooledHierarchy(Entity aRoot, std::vector<Entity>& outHierarchy);
+		void SetPooledBodiesEnabled(const std::vector<Entity>& aHierarchy, bool aState);
+
+		void CallScriptOnStart();
+
+		void ConnectSignals();
+		void OnNameConstructed(entt::registry& aRegistry, entt::entity aEntity);
+		void OnNameUpdated(entt::registry& aRegistry, entt::entity aEntity);
+		void OnNameDestroyed(entt::registry& aRegistry, entt::entity aEntity);
+		void OnSkinnedMeshRendererDestroyed(entt::registry& aRegistry, entt::entity aEntity);
+		void AddToNameIndex(entt::entity aEntity);
+		void RemoveFromNameIndex(entt::entity aEntity);
+
+		void OnActiveStateChanged(entt::registry& aRegistry, entt::entity aEntity);
+		// Propagates the active state of the entity to its descendants, stopping at those whose state didn't change unless forced
+		void RefreshActiveInHierarchy(entt::entity aEntity, bool aForce = false);
+		// For after the hierarchy was built without going through Entity, like when deserializing
+		void RefreshActiveInHierarchy();
+
+		Entity SearchDescendantEntityWithName(Entity aEntity, const std::string& aName);
+		void GetDescendantsByName(Entity aEntity, std::unordered_map<std::string_view, UUID>& outDescendants);
+
 		void BuildMeshEntityHierarchy(Entity aParent, std::shared_ptr<Mesh> aMesh, const MeshNode& aNode);
 		void FindBoneEntityIds(Entity aRoot);
 		std::vector<UUID> FindBoneEntityIds(Entity aRoot, std::shared_ptr<Mesh> aMesh);
 
-		std::vector<CU::Matrix4x4f> GetModelSpaceBoneTransforms(Entity aEntity, std::shared_ptr<Mesh> aMesh);
-		void GetModelSpaceBoneTransform(const std::vector<UUID>& aBoneEntityIds, std::vector<CU::Matrix4x4f>& outBoneTransforms, uint32_t aBoneIndex, const CU::Matrix4x4f& aParentTransform, std::shared_ptr<Skeleton> aSkeleton);
+		// Bone entities resolved for one skinned mesh entity, along with its last evaluated palette
+		struct SkinningCache
+		{
+			std::shared_ptr<Skeleton> skeleton;
+			std::vector<UUID> boneEntityIds;
+			std::vector<entt::entity> boneEntities;
+			std::vector<CU::Matrix4x4f> localTransforms;
+			std::vector<CU::Matrix4x4f> modelTransforms;
+			std::vector<CU::Matrix4x4f> palette;
+			bool isPaletteValid = false;
+		};
+
+		struct SkinnedMeshDraw
+		{
+			entt::entity entity = entt::null;
+			std::shared_ptr<Mesh> mesh;
+			SkinningCache* cache = nullptr;
+		};
+
+		// Resolves the bone entities again if the skeleton, the bone ids or any of the bone entities changed
+		void PrepareSkinningCache(SkinningCache& aCache, SkinnedMeshRendererComponent& aSkinnedMeshRenderer, const std::shared_ptr<Skeleton>& aSkeleton);
+		// Reads the bone transforms and marks the palette for a rebuild if any of them changed.
+		// GetMatrix updates the cached matrix of the transform and bones can be shared between skinned meshes, so this stays on one thread.
+		void ReadSkinningBoneTransforms(SkinningCache& aCache);
+		// Rebuilds the palette from the bone transforms read last, only touches the cache so it's safe to run for different caches in parallel
+		void EvaluateSkinningPalette(SkinningCache& aCache);
 
 		void Render3DScene(std::shared_ptr<SceneRenderer> aRenderer, const SceneRendererCamera& aRenderCamera, const SceneRendererCamera& aCullingCamera, bool aIsGameView, bool aWithPostProccessing = true);
 		void Render2DScene(std::shared_ptr<SceneRenderer> aRenderer, const SceneRendererCamera& aRenderCamera, bool aIsGameView);
+		void DispatchFrustumEvents(const std::pmr::vector<entt::entity>& aEntities, const char* aMethodName);
 		Frustum CreateFrustum(const SceneRendererCamera& aCamera);
 		bool FrustumIntersection(const Frustum& aFrustum, const AABB aAABB);
 		
@@ -219,15 +323,75 @@ namespace Epoch
 		std::pair<float, float> GetMouseViewportSpace() const;
 		bool MouseInViewport();
 
+		struct SpatialIndex
+		{
+			struct Proxy
+			{
+				entt::entity entity = entt::null;
+				SpatialCategory category = SpatialCategory::None;
+				int32_t id = DynamicAABBTree::NullNode; // Null while the entity is inactive or its bounds aren't known yet
+				uint64_t boundsSource = 0;
+				AABB localBounds;
+				bool isBoundsPending = false; // Indexed with placeholder bounds until its asset is loaded
+			};
+
+			DynamicAABBTree tree;
+			// Added and removed by the component signals, removing swaps the last proxy into the hole
+			std::vector<Proxy> proxies;
+			// Keyed on the category and the entity, an entity can be in the index once per category
+			std::unordered_map<uint64_t, uint32_t> proxyLookup;
+
+			uint32_t updateCount = 0;
+			// Transforms with a version at or above this were modified since the last update
+			uint64_t nextTransformVersion = 0;
+			// Indexed by entity index, equal to updateCount when the world transform of the entity changed since the last update
+			std::vector<uint32_t> transformDirtyStamps;
+			// Reparenting moves the subtree without touching a transform, filled by OnEntityReparented
+			std::vector<entt::entity> reparentedEntities;
+			bool isFullRefreshPending = false;
+
+			// Only used by the UI index. The layout inputs of each rect by entity index, and the viewport the rects were laid out in.
+			std::vector<uint64_t> rectStamps;
+			uint32_t viewportWidth = 0;
+			uint32_t viewportHeight = 0;
+		};
+
+		template<SpatialCategory Category>
+		void OnSpatialComponentConstructed(entt::registry& aRegistry, entt::entity aEntity);
+		template<SpatialCategory Category>
+		void OnSpatialComponentDestroyed(entt::registry& aRegistry, entt::entity aEntity);
+		void AddSpatialProxy(SpatialIndex& aIndex, entt::entity aEntity, SpatialCategory aCategory);
+		void RemoveSpatialProxy(SpatialIndex& aIndex, entt::entity aEntity, SpatialCategory aCategory);
+
+		void UpdateUISpatialIndex();
+		void OnEntityReparented(entt::entity aEntity);
+		// Marks the subtrees of every transform modified or entity reparented since the last update
+		void MarkSpatialTransformsDirty(SpatialIndex& aIndex);
+		void MarkSpatialSubtreeDirty(SpatialIndex& aIndex, entt::entity aEntity);
+		// Moves the proxies that were marked dirty or whose bounds source changed since the last update
+		void UpdateSpatialProxies(SpatialIndex& aIndex);
+
 	private:
 		entt::registry myRegistry;
 		std::unordered_map<UUID, entt::entity> myEntityMap;
 
-		//This gets filled in Scene::RenderScene, so if this is used before Scene::RenderScene has been called the set contains the last frames culled entities.
-		std::unordered_set<UUID> myFrustumCulledEntities;
+		// One bit per entity index, filled in Scene::Render3DScene. Before the scene has been rendered this frame they hold the last frames culling.
+		// The culled bits are swapped every render so entering and leaving the frustum is an XOR of the two frames.
+		std::vector<uint64_t> myFrustumCulledBits;
+		std::vector<uint64_t> myLastFrustumCulledBits;
+		std::vector<uint64_t> myFrustumTestedBits;
+
+		// Entities by the hash of their name, in the order they got the name. Kept up to date by the NameComponent signals.
+		std::unordered_map<uint64_t, std::vector<entt::entity>> myNameIndex;
+		// The hash each entity is filed under, indexed by entity index
+		std::vector<uint64_t> myIndexedNameHashes;
 
 		std::shared_ptr<PhysicsScene> myPhysicsScene;
 
+		// Script entities still to be instantiated by OnRuntimeStartSliced
+		std::vector<entt::entity> myStartingScriptEntities;
+		uint32_t myStartedScriptCount = 0;
+
 		std::vector<std::function<void()>> myPostUpdateQueue;
 		
 		std::function<void(AssetHandle)> myOnSceneTransitionCallback;
@@ -237,12 +401,43 @@ namespace Epoch
 		uint32_t myViewportWidth = 0;
 		uint32_t myViewportHeight = 0;
 
+		SpatialIndex mySpatialIndex;
+		SpatialIndex myUISpatialIndex;
+		std::vector<entt::entity> mySpatialQueryResults;
+		std::vector<entt::entity> mySpatialDirtyStack;
+		std::vector<entt::entity> myActiveInteractables;
+
+		// Keyed on the skinned mesh entity. The draws point into the map, which stays valid as caches are added.
+		std::unordered_map<entt::entity, SkinningCache> mySkinningCaches;
+		std::vector<SkinnedMeshDraw> mySkinnedMeshDraws;
+
+		entt::entity myPrimaryCameraEntity = entt::null;
+
+		uint64_t myHierarchyVersion = 0;
+		uint64_t myNameVersion = 0;
+
+		struct PrefabPool
+		{
+			std::shared_ptr<Prefab> prefab;
+			std::vector<UUID> available;
+		};
+
+		struct PooledInstance
+		{
+			AssetHandle prefab = 0;
+			bool isSpawned = false;
+		};
+
+		std::unordered_map<AssetHandle, PrefabPool> myPrefabPools;
+		std::unordered_map<UUID, PooledInstance> myPooledInstances; //keyed by the root entity
+
 		LightEnvironment myLightEnvironment;
 		PostProcessingData myPostProcessingData;
 
 		bool myIsSimulating = false;
 		bool myIsPlaying = false;
 		bool myIsPaused = false;
+		bool myDeferEntitySorting = false;
 		unsigned myStepFrames = 0;
 
 		float myTimeScale = 1.0f;
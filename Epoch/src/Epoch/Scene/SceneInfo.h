@@ -59,6 +59,16 @@ namespace Epoch
 		DirectionalLight directionalLight;
 		std::vector<PointLight> pointLights;
 		std::vector<Spotlight> spotlights;
+
+		// Resets in place so the light vectors keep their capacity between frames
+		void Clear()
+		{
+			environment.reset();
+			environmentIntensity = 1.0f;
+			directionalLight = DirectionalLight();
+			pointLights.clear();
+			spotlights.clear();
+		}
 	};
 
 	struct PostProcessingData
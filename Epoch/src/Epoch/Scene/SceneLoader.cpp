@@ -0,0 +1,155 @@
+#include "epch.h"
+#include "SceneLoader.h"
+#include "Scene.h"
+#include "SceneSerializer.h"
+#include "Epoch/Core/Application.h"
+#include "Epoch/Assets/AssetPack/AssetPack.h"
+#include "Epoch/Assets/AssetManager/RuntimeAssetManager.h"
+#include "Epoch/Serialization/FileStream.h"
+#include "Epoch/Debug/MemoryTracker.h"
+
+namespace Epoch
+{
+	SceneLoader::SceneLoader(const std::shared_ptr<RuntimeAssetManager>& aAssetManager, const SceneLoadSettings& aSettings) : myAssetManager(aAssetManager), mySettings(aSettings)
+	{
+	}
+
+	SceneLoader::~SceneLoader()
+	{
+		// The job writes into the scene and serializer owned by the loader
+		if (myDeserializeJob.valid())
+		{
+			myDeserializeJob.wait();
+		}
+	}
+
+	bool SceneLoader::Start(AssetHandle aSceneHandle)
+	{
+		EPOCH_ASSERT(!IsLoading(), "Scene loader is already loading a scene!");
+
+		myAssetPack = myAssetManager->GetAssetPack();
+		const AssetPackFile::SceneInfo* sceneInfo = myAssetPack ? myAssetPack->FindSceneInfo(aSceneHandle) : nullptr;
+		if (!sceneInfo)
+		{
+			LOG_ERROR_TAG("Scene", "Scene {} isn't in the asset pack!", aSceneHandle);
+			myState = State::Failed;
+			return false;
+		}
+
+		mySceneHandle = aSceneHandle;
+		myScene = std::make_shared<Scene>(aSceneHandle);
+		mySerializer = std::make_unique<SceneSerializer>(myScene);
+		mySerializer->SetDeferScriptInitialization(true);
+
+		myAssetsToLoad.clear();
+		myLoadedAssetCount = 0;
+		for (const auto& [assetHandle, assetInfo] : sceneInfo->assets)
+		{
+			// Scenes referenced by the scene are loaded when transitioning to them
+			if ((AssetType)assetInfo.type != AssetType::Scene)
+			{
+				myAssetsToLoad.push_back(assetHandle);
+			}
+		}
+
+		myStats = Stats();
+		myStats.assetCount = (uint32_t)myAssetsToLoad.size();
+		myLoadTimer.Reset();
+
+		// Nothing else has access to the scene until the job is done, the script engine is left alone by deferring the scripts
+		myState = State::Deserializing;
+		myDeserializeJob = Application::Get().GetJobSystem().AddAJob([this, sceneInfo]()
+			{
+				MemoryTagScope memoryTag(MemoryTag::AssetScene);
+
+				FileStreamReader stream(myAssetPack->GetPath());
+				return mySerializer->DeserializeFromAssetPack(stream, *sceneInfo);
+			});
+
+		return true;
+	}
+
+	bool SceneLoader::Update()
+	{
+		EPOCH_PROFILE_FUNC();
+
+		if (!IsLoading())
+		{
+			return myState == State::Loaded;
+		}
+
+		Timer timer;
+
+		if (myState == State::Deserializing)
+		{
+			UpdateDeserializing();
+		}
+
+		if (myState == State::LoadingAssets)
+		{
+			UpdateLoadingAssets(timer);
+		}
+
+		const float updateTime = timer.ElapsedMillis();
+		myStats.updateCount++;
+		myStats.longestUpdate = CU::Math::Max(myStats.longestUpdate, updateTime);
+		myStats.mainThreadTime += updateTime;
+		myStats.totalTime = myLoadTimer.ElapsedMillis();
+
+		return myState == State::Loaded;
+	}
+
+	bool SceneLoader::InitializeScripts()
+	{
+		EPOCH_PROFILE_FUNC();
+		EPOCH_ASSERT(myState == State::Loaded, "Scripts are initialized after the scene has been loaded!");
+
+		Timer timer;
+		const bool initialized = mySerializer->InitializeDeferredScripts(mySettings.frameBudgetMilliseconds);
+
+		const float updateTime = timer.ElapsedMillis();
+		myStats.longestUpdate = CU::Math::Max(myStats.longestUpdate, updateTime);
+		myStats.mainThreadTime += updateTime;
+		myStats.totalTime = myLoadTimer.ElapsedMillis();
+
+		return initialized;
+	}
+
+	void SceneLoader::UpdateDeserializing()
+	{
+		if (myDeserializeJob.wait_for(std::chrono::seconds(0)) == std::future_status::timeout)
+		{
+			return;
+		}
+
+		if (!myDeserializeJob.get())
+		{
+			LOG_ERROR_TAG("Scene", "Failed to deserialize scene {}!", mySceneHandle);
+			myState = State::Failed;
+			return;
+		}
+
+		myStats.scriptCount = mySerializer->GetDeferredScriptCount();
+		myState = State::LoadingAssets;
+	}
+
+	void SceneLoader::UpdateLoadingAssets(Timer& aTimer)
+	{
+		while (myLoadedAssetCount < (uint32_t)myAssetsToLoad.size())
+		{
+			const AssetHandle assetHandle = myAssetsToLoad[myLoadedAssetCount++];
+			if (!myAssetManager->IsAssetLoaded(assetHandle))
+			{
+				// The previous scene is still the active one, so the asset pack is pointed at the scene being loaded
+				myAssetManager->GetAsset(mySceneHandle, assetHandle);
+			}
+
+			if (aTimer.ElapsedMillis() >= mySettings.frameBudgetMilliseconds)
+			{
+				return;
+			}
+		}
+
+		myState = State::Loaded;
+	}
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <future>
+#include <memory>
+#include <vector>
+#include "Epoch/Assets/Asset.h"
+#include "Epoch/Debug/Timer.h"
+
+namespace Epoch
+{
+	class Scene;
+	class SceneSerializer;
+	class AssetPack;
+	class RuntimeAssetManager;
+
+	struct SceneLoadSettings
+	{
+		// Main thread time spent per call on loading assets and initializing scripts
+		float frameBudgetMilliseconds = 4.0f;
+	};
+
+	// Loads a scene from the asset pack over several frames so a scene transition doesn't stall the game.
+	// The entities are deserialized into a scene of their own on the job system, then the assets the asset pack lists for the scene
+	// are loaded on the main thread, a frame budget's worth per Update. The scripts are initialized once the previous scene has stopped.
+	class SceneLoader
+	{
+	public:
+		enum class State
+		{
+			Idle,
+			Deserializing,
+			LoadingAssets,
+			Loaded,
+			Failed
+		};
+
+		struct Stats
+		{
+			uint32_t assetCount = 0;
+			uint32_t scriptCount = 0;
+			uint32_t updateCount = 0;
+			float longestUpdate = 0.0f;
+			float mainThreadTime = 0.0f;
+			float totalTime = 0.0f;
+		};
+
+		SceneLoader(const std::shared_ptr<RuntimeAssetManager>& aAssetManager, const SceneLoadSettings& aSettings = SceneLoadSettings());
+		~SceneLoader();
+
+		bool Start(AssetHandle aSceneHandle);
+		// Advances the load by at most the frame budget, returns true once the scene is loaded.
+		// The scene is only touched by this until then, the previous one keeps running alongside.
+		bool Update();
+
+		// Initializes the scripts of the loaded scene until the frame budget is used up, returns true once all of them are initialized.
+		// Script fields are stored per entity ID, so this has to wait until the previous scene is stopped in case the same scene is reloaded.
+		bool InitializeScripts();
+
+		State GetState() const { return myState; }
+		bool IsLoading() const { return myState == State::Deserializing || myState == State::LoadingAssets; }
+
+		AssetHandle GetSceneHandle() const { return mySceneHandle; }
+		std::shared_ptr<Scene> GetScene() const { return myScene; }
+
+		const SceneLoadSettings& GetSettings() const { return mySettings; }
+		const Stats& GetStats() const { return myStats; }
+
+	private:
+		void UpdateDeserializing();
+		void UpdateLoadingAssets(Timer& aTimer);
+
+	private:
+		std::shared_ptr<RuntimeAssetManager> myAssetManager;
+		std::shared_ptr<AssetPack> myAssetPack;
+		SceneLoadSettings mySettings;
+
+		State myState = State::Idle;
+		AssetHandle mySceneHandle = 0;
+
+		std::shared_ptr<Scene> myScene;
+		std::unique_ptr<SceneSerializer> mySerializer;
+		std::future<bool> myDeserializeJob;
+
+		std::vector<AssetHandle> myAssetsToLoad;
+		uint32_t myLoadedAssetCount = 0;
+
+		Timer myLoadTimer;
+		Stats myStats;
+	};
+}
@@ -1,7 +1,8 @@
 #include "epch.h"
 #include "SceneRenderer.h"
-#include <codecvt>
+#include "Epoch/Debug/MemoryTracker.h"
 #include "Epoch/Core/Application.h"
+#include "Epoch/Core/FrameAllocator.h"
 #include "Epoch/Rendering/Font.h"
 #include "Epoch/Rendering/Mesh.h"
 #include "Epoch/Rendering/Material.h"
@@ -16,6 +17,7 @@
 #include "Epoch/Rendering/Framebuffer.h"
 #include "Epoch/Rendering/RenderPipeline.h"
 #include "Epoch/Rendering/ComputePipeline.h"
+#include "Epoch/Rendering/TextureStreamer.h"
 #include "Epoch/Assets/AssetManager.h"
 
 #include "Epoch/Rendering/RHI.h" //TEMP
@@ -37,6 +39,7 @@ namespace Epoch
 	void SceneRenderer::Init()
 	{
 		EPOCH_PROFILE_FUNC();
+		MemoryTagScope memoryTag(MemoryTag::Renderer);
 
 		//Quad Data/Buffers
 		{
@@ -124,7 +127,6 @@ namespace Epoch
 		{
 			myCameraBuffer = ConstantBuffer::Create(sizeof(CameraBuffer));
 			myObjectBuffer = ConstantBuffer::Create(sizeof(ObjectBuffer));
-			myMaterialBuffer = ConstantBuffer::Create(sizeof(Material::Data));
 			myBoneBuffer = ConstantBuffer::Create(sizeof(BoneBuffer));
 			myLightBuffer = ConstantBuffer::Create(sizeof(LightBuffer));
 			myPointLightBuffer = ConstantBuffer::Create(sizeof(PointLight) - sizeof(std::shared_ptr<Texture2D>));
@@ -298,28 +300,58 @@ namespace Epoch
 
 	void SceneRenderer::GBufferPass()
 	{
-		Renderer::SetRenderPipeline(myGBufferPipeline);
+		SetPipeline(myGBufferPipeline);
+		RenderMeshQueue();
+		RemovePipeline(myGBufferPipeline);
+	}
 
-		AssetHandle currentMaterial = 0;
-		for (auto [k, dc] : myDrawList)
-		{
-			if (currentMaterial != dc.material->GetHandle())
-			{
-				SetMaterial(dc.material);
-				currentMaterial = dc.material->GetHandle();
-			}
+	void SceneRenderer::RenderMeshQueue()
+	{
+		EPOCH_PROFILE_FUNC();
+
+		const auto& items = myRenderQueue.GetItems();
 
-			auto& transformStorage = myMeshTransformMap[k];
-			for (uint32_t i = 0; i < dc.instanceCount; i += MaxInstanceCount)
+		uint32_t currentMaterial = UINT32_MAX;
+		myRenderQueue.ForEachRun([&](size_t aFirst, size_t aLast)
 			{
-				uint32_t instanceCount = CU::Math::Min(dc.instanceCount - i, MaxInstanceCount);
+				const uint64_t key = items[aFirst].key;
+
+				const uint32_t materialIndex = RenderQueue::GetMaterial(key);
+				if (currentMaterial != materialIndex)
+				{
+					SetMaterial(myFrameMaterials[materialIndex]);
+					currentMaterial = materialIndex;
+				}
+
+				myInstanceStaging.clear();
+				for (size_t i = aFirst; i < aLast; i++)
+				{
+					myInstanceStaging.push_back(myMeshInstances[items[i].index]);
+				}
 
-				myInstanceTransformBuffer->SetData(transformStorage.data(), instanceCount, i * sizeof(MeshInstanceData));
-				Renderer::RenderInstancedMesh(dc.mesh, dc.submeshIndex, myInstanceTransformBuffer, instanceCount);
+				const std::shared_ptr<Mesh>& mesh = myFrameMeshes[RenderQueue::GetMesh(key)];
+				const uint32_t submeshIndex = RenderQueue::GetSubmesh(key);
+				const uint32_t runInstanceCount = (uint32_t)myInstanceStaging.size();
+				for (uint32_t i = 0; i < runInstanceCount; i += MaxInstanceCount)
+				{
+					uint32_t instanceCount = CU::Math::Min(runInstanceCount - i, MaxInstanceCount);
+
+					myInstanceTransformBuffer->SetData(myInstanceStaging.data(), instanceCount, i * sizeof(MeshInstanceData));
+					Renderer::RenderInstancedMesh(mesh, submeshIndex, myInstanceTransformBuffer, instanceCount);
+				}
+			});
+
+		for (const UnsortedMeshDraw& draw : myUnsortedMeshDraws)
+		{
+			if (currentMaterial != draw.material)
+			{
+				SetMaterial(myFrameMaterials[draw.material]);
+				currentMaterial = draw.material;
 			}
-		}
 
-		Renderer::RemoveRenderPipeline(myGBufferPipeline);
+			myInstanceTransformBuffer->SetData(&myMeshInstances[draw.instance], 1, 0);
+			Renderer::RenderInstancedMesh(myFrameMeshes[draw.mesh], draw.submesh, myInstanceTransformBuffer, 1);
+		}
 	}
 
 	void SceneRenderer::EnvironmentPass()
@@ -333,7 +365,7 @@ namespace Epoch
 			lightBuffer.environmentIntensity = mySceneData.lightEnvironment.environmentIntensity;
 
 			myLightBuffer->SetData(&lightBuffer);
-			myLightBuffer->Bind(PIPELINE_STAGE_PIXEL_SHADER, 2);
+			BindConstantBuffer(myLightBuffer, PIPELINE_STAGE_PIXEL_SHADER, 2);
 
 			auto env = mySceneData.lightEnvironment.environment.lock();
 			std::shared_ptr<TextureCube> cubeMap;
@@ -347,111 +379,95 @@ namespace Epoch
 				cubeMap = Renderer::GetDefaultBlackCubemap();
 			}
 
-			std::vector<ID3D11ShaderResourceView*> SRVs(2);
-
-			auto dxTextureCube = std::dynamic_pointer_cast<DX11TextureCube>(cubeMap);
-			SRVs[0] = dxTextureCube->GetSRV().Get();
-
-			auto dxTexture = std::dynamic_pointer_cast<DX11Texture2D>(Renderer::GetBRDFLut());
-			SRVs[1] = dxTexture->GetSRV().Get();
-
-			RHI::GetContext()->PSSetShaderResources(10, 2, SRVs.data());
+			const void* views[] = { cubeMap->GetView(), Renderer::GetBRDFLut()->GetView() };
+			BindTextures(10, 2, views);
 		}
 
-		Renderer::SetRenderPipeline(myEnvironmentalLightPipeline);
+		SetPipeline(myEnvironmentalLightPipeline);
 		Renderer::RenderQuad();
-		Renderer::RemoveRenderPipeline(myEnvironmentalLightPipeline);
+		RemovePipeline(myEnvironmentalLightPipeline);
 
 		{
 			auto env = mySceneData.lightEnvironment.environment.lock();
 			if (env)
 			{
-				std::vector<ID3D11ShaderResourceView*> emptySRVs(2);
-				RHI::GetContext()->PSSetShaderResources(10, 2, emptySRVs.data());
+				const void* emptyViews[2] = {};
+				BindTextures(10, 2, emptyViews);
 			}
 			else
 			{
-				std::vector<ID3D11ShaderResourceView*> emptySRVs(1);
-				RHI::GetContext()->PSSetShaderResources(11, 1, emptySRVs.data());
+				const void* emptyViews[1] = {};
+				BindTextures(11, 1, emptyViews);
 			}
 		}
 	}
 
 	void SceneRenderer::PointLightPass()
 	{
-		Renderer::SetRenderPipeline(myPointLightPipeline);
+		SetPipeline(myPointLightPipeline);
 		for (PointLight& pointLight : mySceneData.lightEnvironment.pointLights)
 		{
 			myPointLightBuffer->SetData(&pointLight);
-			myPointLightBuffer->Bind(PIPELINE_STAGE_PIXEL_SHADER, 2);
+			BindConstantBuffer(myPointLightBuffer, PIPELINE_STAGE_PIXEL_SHADER, 2);
 
 			Renderer::RenderQuad();
 		}
-		Renderer::RemoveRenderPipeline(myPointLightPipeline);
+		RemovePipeline(myPointLightPipeline);
 	}
 
 	void SceneRenderer::SpotlightPass()
 	{
-		Renderer::SetRenderPipeline(mySpotlightPipeline);
+		SetPipeline(mySpotlightPipeline);
 		for (Spotlight& spotlight : mySceneData.lightEnvironment.spotlights)
 		{
-			//Set cookie
+			//Set cookie, skipped when the previous light used the same one
 			{
-				std::vector<ID3D11ShaderResourceView*> SRVs(1);
-				auto dxTexture = std::dynamic_pointer_cast<DX11Texture2D>(spotlight.cookie.lock());
-				SRVs[0] = dxTexture->GetSRV().Get();
-				RHI::GetContext()->PSSetShaderResources(5, 1, SRVs.data());
+				const void* views[] = { spotlight.cookie.lock()->GetView() };
+				BindTextures(5, 1, views);
 			}
 
 			mySpotlightBuffer->SetData(&spotlight);
-			mySpotlightBuffer->Bind(PIPELINE_STAGE_PIXEL_SHADER, 2);
+			BindConstantBuffer(mySpotlightBuffer, PIPELINE_STAGE_PIXEL_SHADER, 2);
 		
 			Renderer::RenderQuad();
+		}
 
-			//Remove cookie
-			{
-				std::vector<ID3D11ShaderResourceView*> SRVs(1);
-				RHI::GetContext()->PSSetShaderResources(5, 1, SRVs.data());
-			}
+		//Remove cookie
+		{
+			const void* emptyViews[1] = {};
+			BindTextures(5, 1, emptyViews);
 		}
-		Renderer::RemoveRenderPipeline(mySpotlightPipeline);
+		RemovePipeline(mySpotlightPipeline);
 	}
 
 	void SceneRenderer::PostProcessingPass()
 	{
 		{
-			std::vector<ID3D11ShaderResourceView*> SRVs(3);
-
-			auto texture = myEnvironmentalLightPipeline->GetSpecification().targetFramebuffer->GetTarget();
-			auto dxTexture = std::dynamic_pointer_cast<DX11Texture2D>(texture);
-			SRVs[0] = dxTexture->GetSRV().Get();
-			
-			texture = myGBufferPipeline->GetSpecification().targetFramebuffer->GetDepthAttachment();
-			dxTexture = std::dynamic_pointer_cast<DX11Texture2D>(texture);
-			SRVs[1] = dxTexture->GetSRV().Get();
-
-			dxTexture = std::dynamic_pointer_cast<DX11Texture2D>(mySceneData.postProcessingData.colorGradingLUT.lock());
-			SRVs[2] = dxTexture->GetSRV().Get();
-			
-			RHI::GetContext()->PSSetShaderResources(0, 3, SRVs.data());
+			const void* views[] =
+			{
+				myEnvironmentalLightPipeline->GetSpecification().targetFramebuffer->GetTarget()->GetView(),
+				myGBufferPipeline->GetSpecification().targetFramebuffer->GetDepthAttachment()->GetView(),
+				mySceneData.postProcessingData.colorGradingLUT.lock()->GetView()
+			};
+			BindTextures(0, 3, views);
 		}
 
 		myPostProcessingBuffer->SetData(&mySceneData.postProcessingData.bufferData);
-		myPostProcessingBuffer->Bind(PIPELINE_STAGE_PIXEL_SHADER, 1);
+		BindConstantBuffer(myPostProcessingBuffer, PIPELINE_STAGE_PIXEL_SHADER, 1);
 		
-		Renderer::SetRenderPipeline(myUberPipeline);
+		SetPipeline(myUberPipeline);
 		Renderer::RenderQuad();
-		Renderer::RemoveRenderPipeline(myUberPipeline);
+		RemovePipeline(myUberPipeline);
 
 		{
-			std::vector<ID3D11ShaderResourceView*> emptySRVs(3);
-			RHI::GetContext()->PSSetShaderResources(0, 3, emptySRVs.data());
+			const void* emptyViews[3] = {};
+			BindTextures(0, 3, emptyViews);
 		}
 	}
 
 	void SceneRenderer::SpritesPass()
 	{
-		Renderer::SetRenderPipeline(mySpritePipeline);
+		SetPipeline(mySpritePipeline);
 
 		for (const auto& [texture, vertexList] : myQuadVertices)
 		{
@@ -460,10 +476,8 @@ namespace Epoch
 				continue;
 			}
 
-			std::vector<ID3D11ShaderResourceView*> SRVs(1);
-			auto dxTexture = std::dynamic_pointer_cast<DX11Texture2D>(myTextures[texture]);
-			SRVs[0] = dxTexture->GetSRV().Get();
-			RHI::GetContext()->PSSetShaderResources(0, 1, SRVs.data());
+			const void* views[] = { myTextures[texture]->GetView() };
+			BindTextures(0, 1, views);
 
 			const uint32_t quadCount = (uint32_t)vertexList.size() / 4;
 			for (uint32_t i = 0; i < quadCount; i += MaxQuads)
@@ -473,17 +487,19 @@ namespace Epoch
 				myQuadVertexBuffer->SetData((void*)vertexList.data(), count * 4, i * 4 * sizeof(QuadVertex));
 				Renderer::RenderGeometry(myQuadVertexBuffer, myQuadIndexBuffer, count * 6);
 			}
+		}
 
-			std::vector<ID3D11ShaderResourceView*> emptySRVs(1);
-			RHI::GetContext()->PSSetShaderResources(0, 1, emptySRVs.data());
+		{
+			const void* emptyViews[1] = {};
+			BindTextures(0, 1, emptyViews);
 		}
 
-		Renderer::RemoveRenderPipeline(mySpritePipeline);
+		RemovePipeline(mySpritePipeline);
 	}
 
 	void SceneRenderer::TextPass()
 	{
-		Renderer::SetRenderPipeline(myTextPipeline);
+		SetPipeline(myTextPipeline);
 
 		for (const auto& [font, vertexList] : myTextVertices)
 		{
@@ -492,10 +508,8 @@ namespace Epoch
 				continue;
 			}
 
-			std::vector<ID3D11ShaderResourceView*> SRVs(1);
-			auto dxTexture = std::dynamic_pointer_cast<DX11Texture2D>(myFontAtlases[font]);
-			SRVs[0] = dxTexture->GetSRV().Get();
-			RHI::GetContext()->PSSetShaderResources(0, 1, SRVs.data());
+			const void* views[] = { myFontAtlases[font]->GetView() };
+			BindTextures(0, 1, views);
 
 			const uint32_t quadCount = (uint32_t)vertexList.size() / 4;
 			for (uint32_t i = 0; i < quadCount; i += MaxQuads)
@@ -505,12 +519,14 @@ namespace Epoch
 				myTextVertexBuffer->SetData((void*)vertexList.data(), count * 4, i * 4 * sizeof(TextVertex));
 				Renderer::RenderGeometry(myTextVertexBuffer, myTextIndexBuffer, count * 6);
 			}
+		}
 
-			std::vector<ID3D11ShaderResourceView*> emptySRVs(1);
-			RHI::GetContext()->PSSetShaderResources(0, 1, emptySRVs.data());
+		{
+			const void* emptyViews[1] = {};
+			BindTextures(0, 1, emptyViews);
 		}
 
-		Renderer::RemoveRenderPipeline(myTextPipeline);
+		RemovePipeline(myTextPipeline);
 	}
 
 	void SceneRenderer::UpdateStatistics()
@@ -519,6 +535,10 @@ namespace Epoch
 
 		myStats = Stats();
 
+		const RenderStateCache::Stats& stateStats = myStateCache.GetStats();
+		myStats.stateBinds = stateStats.pipelineBinds + stateStats.constantBufferBinds + stateStats.textureBinds;
+		myStats.skippedStateBinds = stateStats.skippedBinds;
+
 		struct SM
 		{
 			uint64_t mesh;
@@ -536,17 +556,37 @@ namespace Epoch
 		std::set<SM> submeshes;
 
 		//Instanced
-		for (auto [k, dc] : myDrawList)
+		const auto& items = myRenderQueue.GetItems();
+		myRenderQueue.ForEachRun([&](size_t aFirst, size_t aLast)
+			{
+				const uint64_t key = items[aFirst].key;
+				const std::shared_ptr<Mesh>& mesh = myFrameMeshes[RenderQueue::GetMesh(key)];
+				const uint32_t submeshIndex = RenderQueue::GetSubmesh(key);
+				const uint32_t instanceCount = (uint32_t)(aLast - aFirst);
+
+				const auto& submesh = mesh->GetSubmeshes()[submeshIndex];
+				myStats.instances += instanceCount;
+				myStats.drawCalls += CU::Math::CeilToUInt((float)instanceCount / MaxInstanceCount);
+				myStats.vertices += submesh.vertexCount * instanceCount;
+				myStats.indices += submesh.indexCount * instanceCount;
+				myStats.triangles += submesh.indexCount / 3 * instanceCount;
+
+				meshes.insert(mesh->GetHandle());
+				submeshes.insert({ mesh->GetHandle(), submeshIndex });
+			});
+
+		for (const UnsortedMeshDraw& draw : myUnsortedMeshDraws)
 		{
-			const auto& submesh = dc.mesh->GetSubmeshes()[dc.submeshIndex];
-			myStats.instances += dc.instanceCount;
-			myStats.drawCalls += CU::Math::CeilToUInt((float)dc.instanceCount / MaxInstanceCount);
-			myStats.vertices += submesh.vertexCount * dc.instanceCount;
-			myStats.indices += submesh.indexCount * dc.instanceCount;
-			myStats.triangles += (uint32_t)dc.mesh->GetTriangleCache(dc.submeshIndex).size() * dc.instanceCount;
-
-			meshes.insert(dc.mesh->GetHandle());
-			submeshes.insert({ dc.mesh->GetHandle(), dc.submeshIndex });
+			const std::shared_ptr<Mesh>& mesh = myFrameMeshes[draw.mesh];
+			const auto& submesh = mesh->GetSubmeshes()[draw.submesh];
+			myStats.instances++;
+			myStats.drawCalls++;
+			myStats.vertices += submesh.vertexCount;
+			myStats.indices += submesh.indexCount;
+			myStats.triangles += submesh.indexCount / 3;
+
+			meshes.insert(mesh->GetHandle());
+			submeshes.insert({ mesh->GetHandle(), draw.submesh });
 		}
 
 		////Animated
@@ -563,7 +603,7 @@ namespace Epoch
 
 		//Sprites
 		{
-			for (auto [_, vb] : myQuadVertices)
+			for (const auto& [_, vb] : myQuadVertices)
 			{
 				auto quadCount = (uint32_t)vb.size() / 4;
 
@@ -577,7 +617,7 @@ namespace Epoch
 
 		//Text
 		{
-			for (auto [_, vb] : myTextVertices)
+			for (const auto& [_, vb] : myTextVertices)
 			{
 				auto quadCount = (uint32_t)vb.size() / 4;
 
@@ -630,6 +670,10 @@ namespace Epoch
 		EPOCH_ASSERT(!myActive, "Can't call begin scene while rendering!");
 		myActive = true;
 
+		// Other renderers bind their own state between frames
+		myStateCache.Invalidate();
+		myStateCache.ResetStats();
+
 		mySceneData.sceneCamera = aCamera;
 		mySceneData.lightEnvironment = myScene->myLightEnvironment;
 		mySceneData.postProcessingData = myScene->myPostProcessingData;
@@ -662,7 +706,19 @@ namespace Epoch
 		camBuffer.fov = aCamera.fov;
 		camBuffer.viewportSize = { (float)myViewportWidth, (float)myViewportHeight };
 		myCameraBuffer->SetData(&camBuffer);
-		myCameraBuffer->Bind(PIPELINE_STAGE_VERTEX_SHADER | PIPELINE_STAGE_PIXEL_SHADER, 0);
+		BindConstantBuffer(myCameraBuffer, PIPELINE_STAGE_VERTEX_SHADER | PIPELINE_STAGE_PIXEL_SHADER, 0);
+
+		// Pixels covered by one unit at distance one, or at any distance for orthographic cameras.
+		// Used to estimate how large meshes end up on screen.
+		myTextureStreamer = AssetManager::GetTextureStreamer();
+		if (aCamera.isOrthographic)
+		{
+			myProjectionScale = aCamera.orthographicSize > 0.0f ? (float)myViewportHeight / aCamera.orthographicSize : 0.0f;
+		}
+		else
+		{
+			myProjectionScale = aCamera.camera.GetProjectionMatrix()(2, 2) * (float)myViewportHeight * 0.5f;
+		}
 	}
 
 	void SceneRenderer::EndScene()
@@ -672,6 +728,13 @@ namespace Epoch
 		EPOCH_ASSERT(myActive, "Can't call end scene if not rendering!");
 		myActive = false;
 
+		myRenderQueue.Sort();
+
+		if (myTextureStreamer)
+		{
+			RequestStreamedTextures();
+		}
+
 		if (myDrawMode == DrawMode::Shaded)
 		{
 			GBufferPass();
@@ -683,24 +746,15 @@ namespace Epoch
 				{
 					auto gBuffer = myGBufferPipeline->GetSpecification().targetFramebuffer;
 
-					std::vector<ID3D11ShaderResourceView*> SRVs(resourceCount);
-
-					auto dxTexture = std::dynamic_pointer_cast<DX11Texture2D>(gBuffer->GetTarget("Albedo"));
-					SRVs[0] = dxTexture->GetSRV().Get();
-
-					dxTexture = std::dynamic_pointer_cast<DX11Texture2D>(gBuffer->GetTarget("Material"));
-					SRVs[1] = dxTexture->GetSRV().Get();
-
-					dxTexture = std::dynamic_pointer_cast<DX11Texture2D>(gBuffer->GetTarget("Normal"));
-					SRVs[2] = dxTexture->GetSRV().Get();
-
-					dxTexture = std::dynamic_pointer_cast<DX11Texture2D>(gBuffer->GetTarget("Emission"));
-					SRVs[3] = dxTexture->GetSRV().Get();
-
-					dxTexture = std::dynamic_pointer_cast<DX11Texture2D>(gBuffer->GetDepthAttachment());
-					SRVs[4] = dxTexture->GetSRV().Get();
-
-					RHI::GetContext()->PSSetShaderResources(0, resourceCount, SRVs.data());
+					const void* views[] =
+					{
+						gBuffer->GetTarget("Albedo")->GetView(),
+						gBuffer->GetTarget("Material")->GetView(),
+						gBuffer->GetTarget("Normal")->GetView(),
+						gBuffer->GetTarget("Emission")->GetView(),
+						gBuffer->GetDepthAttachment()->GetView()
+					};
+					BindTextures(0, resourceCount, views);
 				}
 
 				EnvironmentPass();
@@ -709,8 +763,8 @@ namespace Epoch
 
 				//Remove GBuffer as resource
 				{
-					std::vector<ID3D11ShaderResourceView*> emptySRVs(resourceCount);
-					RHI::GetContext()->PSSetShaderResources(0, resourceCount, emptySRVs.data());
+					const void* emptyViews[5] = {};
+					BindTextures(0, resourceCount, emptyViews);
 				}
 			}
 
@@ -724,93 +778,252 @@ namespace Epoch
 		else
 		{
 			myDebugDrawModeBuffer->SetData(&myDrawMode, 4);
-			myDebugDrawModeBuffer->Bind(PIPELINE_STAGE_PIXEL_SHADER, 2);
+			BindConstantBuffer(myDebugDrawModeBuffer, PIPELINE_STAGE_PIXEL_SHADER, 2);
 			
-			Renderer::SetRenderPipeline(myDebugRenderPipeline);
-
-			for (auto [k, dc] : myDrawList)
-			{
-				SetMaterial(dc.material);
-
-				auto& transformStorage = myMeshTransformMap[k];
-				for (uint32_t i = 0; i < dc.instanceCount; i += MaxInstanceCount)
-				{
-					uint32_t instanceCount = CU::Math::Min(dc.instanceCount - i, MaxInstanceCount);
-
-					myInstanceTransformBuffer->SetData(transformStorage.data(), instanceCount, i * sizeof(MeshInstanceData));
-					Renderer::RenderInstancedMesh(dc.mesh, dc.submeshIndex, myInstanceTransformBuffer, instanceCount);
-				}
-			}
-
-			Renderer::RemoveRenderPipeline(myDebugRenderPipeline);
+			SetPipeline(myDebugRenderPipeline);
+			RenderMeshQueue();
+			RemovePipeline(myDebugRenderPipeline);
 		}
 
 #ifndef _RUNTIME
 		UpdateStatistics();
 #endif
 		
-		mySceneData = SceneInfo();
-
-		myDrawList.clear();
-		myMeshTransformMap.clear();
+		mySceneData.sceneCamera = SceneRendererCamera();
+		mySceneData.lightEnvironment.Clear();
+		mySceneData.postProcessingData = PostProcessingData();
+
+		myRenderQueue.Clear();
+		myMeshInstances.clear();
+		myUnsortedMeshDraws.clear();
+		myFrameMeshes.clear();
+		myFrameMeshIndices.Clear();
+		myFrameMaterials.clear();
+		myFrameMaterialIndices.Clear();
+		myFrameMaterialScreenSizes.clear();
 		myAnimatedDrawList.clear();
+		myAnimatedBoneTransforms.clear();
 
-		myQuadVertices.clear();
+		// The vertex lists keep their capacity for the next frame, only the ones that went unused this frame are dropped
+		std::erase_if(myQuadVertices, [](const auto& aPair) { return aPair.second.empty(); });
+		for (auto& [_, vertexList] : myQuadVertices)
+		{
+			vertexList.clear();
+		}
 		myQuadCount = 0;
 
-		myTextVertices.clear();
+		std::erase_if(myTextVertices, [](const auto& aPair) { return aPair.second.empty(); });
+		for (auto& [_, vertexList] : myTextVertices)
+		{
+			vertexList.clear();
+		}
 		myTextQuadCount = 0;
 
 		myTextures.clear();
 		myFontAtlases.clear();
 	}
 
+	uint32_t SceneRenderer::GetFrameMaterialIndex(AssetHandle aMaterialHandle)
+	{
+		if (const uint32_t* index = myFrameMaterialIndices.Find(aMaterialHandle))
+		{
+			return *index;
+		}
+
+		std::shared_ptr<Material> material;
+		if (aMaterialHandle != 0)
+		{
+			material = AssetManager::GetAssetAsync<Material>(aMaterialHandle);
+		}
+
+		if (!material)
+		{
+			static constexpr AssetHandle defaultMaterialHandle = Hash::GenerateFNVHash("Default-Material");
+			material = AssetManager::GetAsset<Material>(defaultMaterialHandle);
+		}
+
+		EPOCH_ASSERT(material, "No material found for rendering!");
+
+		// Materials that fall back to the default material share its index so they end up in the same runs
+		const AssetHandle resolvedHandle = material->GetHandle();
+		uint32_t index;
+		if (const uint32_t* resolvedIndex = myFrameMaterialIndices.Find(resolvedHandle))
+		{
+			index = *resolvedIndex;
+		}
+		else
+		{
+			index = (uint32_t)myFrameMaterials.size();
+			myFrameMaterials.push_back(material);
+			myFrameMaterialScreenSizes.push_back(0.0f);
+			myFrameMaterialIndices.Insert(resolvedHandle, index);
+		}
+
+		if (aMaterialHandle != resolvedHandle)
+		{
+			myFrameMaterialIndices.Insert(aMaterialHandle, index);
+		}
+		return index;
+	}
+
+	const uint32_t* SceneRenderer::FrameIndexTable::Find(AssetHandle aHandle) const
+	{
+		if (mySlots.empty())
+		{
+			return nullptr;
+		}
+
+		const Slot& slot = mySlots[FindSlot(aHandle)];
+		return slot.frame == myFrame ? &slot.index : nullptr;
+	}
+
+	void SceneRenderer::FrameIndexTable::Insert(AssetHandle aHandle, uint32_t aIndex)
+	{
+		// Kept at most half full so probe sequences stay short
+		if ((myCount + 1) * 2 > (uint32_t)mySlots.size())
+		{
+			Grow();
+		}
+
+		Slot& slot = mySlots[FindSlot(aHandle)];
+		if (slot.frame != myFrame)
+		{
+			slot.handle = aHandle;
+			slot.frame = myFrame;
+			myCount++;
+		}
+		slot.index = aIndex;
+	}
+
+	void SceneRenderer::FrameIndexTable::Clear()
+	{
+		myCount = 0;
+		myFrame++;
+
+		// Slots stamped before the wrap would look occupied again
+		if (myFrame == 0)
+		{
+			std::fill(mySlots.begin(), mySlots.end(), Slot());
+			myFrame = 1;
+		}
+	}
+
+	size_t SceneRenderer::FrameIndexTable::FindSlot(AssetHandle aHandle) const
+	{
+		// Handles that were generated from names aren't random, so they're mixed before picking the slot
+		const size_t mask = mySlots.size() - 1;
+		size_t slotIndex = (size_t)((aHandle * 0x9e3779b97f4a7c15ull) >> 32) & mask;
+		while (mySlots[slotIndex].frame == myFrame && mySlots[slotIndex].handle != aHandle)
+		{
+			slotIndex = (slotIndex + 1) & mask;
+		}
+		return slotIndex;
+	}
+
+	void SceneRenderer::FrameIndexTable::Grow()
+	{
+		std::vector<Slot> oldSlots = std::move(mySlots);
+		mySlots.assign(CU::Math::Max(oldSlots.size() * 2, (size_t)256), Slot());
+
+		for (const Slot& slot : oldSlots)
+		{
+			if (slot.frame == myFrame)
+			{
+				mySlots[FindSlot(slot.handle)] = slot;
+			}
+		}
+	}
+
+	void SceneRenderer::RequestStreamedTextures()
+	{
+		EPOCH_PROFILE_FUNC();
+
+		for (size_t i = 0; i < myFrameMaterials.size(); i++)
+		{
+			const std::shared_ptr<Material>& material = myFrameMaterials[i];
+			const float screenSize = myFrameMaterialScreenSizes[i];
+
+			myTextureStreamer->RequestScreenSize(material->GetAlbedoTexture(), screenSize);
+			myTextureStreamer->RequestScreenSize(material->GetNormalTexture(), screenSize);
+			myTextureStreamer->RequestScreenSize(material->GetMaterialTexture(), screenSize);
+		}
+
+		// Sprites are kept at full resolution
+		for (const auto& [handle, texture] : myTextures)
+		{
+			myTextureStreamer->RequestMip(handle, 0);
+		}
+	}
+
 	void SceneRenderer::SubmitMesh(std::shared_ptr<Mesh> aMesh, std::shared_ptr<MaterialTable> aMaterialTable, const CU::Matrix4x4f& aTransform, uint32_t aEntityID)
 	{
 		const auto& submeshData = aMesh->GetSubmeshes();
 
-		for (uint32_t submeshIndex = 0; submeshIndex < (uint32_t)submeshData.size(); submeshIndex++)
+		uint32_t meshIndex;
+		if (const uint32_t* index = myFrameMeshIndices.Find(aMesh->GetHandle()))
 		{
-			const Submesh& submesh = submeshData[submeshIndex];
-			const CU::Matrix4x4f submeshTransform = aTransform * submesh.transform;
-			uint32_t materialIndex = submesh.materialIndex;
-
-			//for (size_t i = submesh.baseVertex; i < submesh.baseVertex + submesh.vertexCount; i++)
-			//{
-			//	const auto& v = aMesh->myVertices[i];
-			//	const auto pos = CU::Vector3f(submeshTransform * CU::Vector4f(v.position, 1.0f));
-			//	const auto dir = (CU::Matrix3x3(submeshTransform) * v.normal).GetNormalized();
-			//	myDebugRenderer->DrawLine(pos, pos + dir * 15.0f, CU::Color::Magenta);
-			//}
-
-			AssetHandle materialHandle = aMaterialTable->GetMaterial(materialIndex);
-			std::shared_ptr<Material> material;
-			if (materialHandle != 0)
+			meshIndex = *index;
+		}
+		else
+		{
+			meshIndex = (uint32_t)myFrameMeshes.size();
+			myFrameMeshes.push_back(aMesh);
+			myFrameMeshIndices.Insert(aMesh->GetHandle(), meshIndex);
+		}
+
+		const CU::Vector3f& cameraPosition = mySceneData.sceneCamera.position;
+		const float farPlane = mySceneData.sceneCamera.farPlane;
+
+		// Assumes the UVs cover the texture about once across the mesh, which is good enough to pick a mip
+		float screenSize = 0.0f;
+		if (myTextureStreamer)
+		{
+			const AABB bounds = aMesh->GetBoundingBox().GetGlobal(aTransform);
+			const float diameter = 2.0f * bounds.GetExtents().Length();
+			if (mySceneData.sceneCamera.isOrthographic)
 			{
-				material = AssetManager::GetAssetAsync<Material>(materialHandle);
+				// The size on screen doesn't change with the distance
+				screenSize = diameter * myProjectionScale;
 			}
-
-			if (materialHandle == 0 || !material)
+			else
 			{
-				materialHandle = Hash::GenerateFNVHash("Default-Material");
-				material = AssetManager::GetAsset<Material>(materialHandle);
+				const float distance = CU::Math::Max((bounds.GetCenter() - cameraPosition).Length(), mySceneData.sceneCamera.nearPlane);
+				screenSize = diameter * myProjectionScale / distance;
 			}
+		}
 
-			EPOCH_ASSERT(material, "No material found for rendering!");
+		for (uint32_t submeshIndex = 0; submeshIndex < (uint32_t)submeshData.size(); submeshIndex++)
+		{
+			const Submesh& submesh = submeshData[submeshIndex];
+			const CU::Matrix4x4f submeshTransform = aTransform * submesh.transform;
 
-			MeshKey meshKey = { aMesh->GetHandle(), materialHandle, submeshIndex };
+			const uint32_t materialIndex = GetFrameMaterialIndex(aMaterialTable->GetMaterial(submesh.materialIndex));
+			myFrameMaterialScreenSizes[materialIndex] = CU::Math::Max(myFrameMaterialScreenSizes[materialIndex], screenSize);
 
-			auto& transformStorage = myMeshTransformMap[meshKey].emplace_back();
-			transformStorage.row[0] = { submeshTransform(1, 1), submeshTransform(1, 2), submeshTransform(1, 3), submeshTransform(4, 1) };
-			transformStorage.row[1] = { submeshTransform(2, 1), submeshTransform(2, 2), submeshTransform(2, 3), submeshTransform(4, 2) };
-			transformStorage.row[2] = { submeshTransform(3, 1), submeshTransform(3, 2), submeshTransform(3, 3), submeshTransform(4, 3) };
-			transformStorage.id = aEntityID;
+			// Instances within a run are drawn front to back
+			const CU::Vector3f position = CU::Vector3f(submeshTransform(4, 1), submeshTransform(4, 2), submeshTransform(4, 3));
+			const uint32_t depth = RenderQueue::QuantizeDepth((position - cameraPosition).Length(), farPlane);
 
-			auto& drawCall = myDrawList[meshKey];
-			drawCall.mesh = aMesh;
-			drawCall.submeshIndex = submeshIndex;
-			drawCall.material = material;
-			drawCall.instanceCount++;
+			if (RenderQueue::FitsKey(materialIndex, meshIndex, submeshIndex))
+			{
+				myRenderQueue.Submit(RenderQueue::MakeKey(RenderQueuePass::Opaque, materialIndex, meshIndex, submeshIndex, depth), (uint32_t)myMeshInstances.size());
+			}
+			else
+			{
+				if (!myHasLoggedQueueOverflow)
+				{
+					LOG_WARNING_TAG("Renderer", "Mesh '{}' has more submeshes or the frame more meshes or materials than a render queue key can hold, drawing the rest unsorted", aMesh->GetHandle());
+					myHasLoggedQueueOverflow = true;
+				}
+
+				myUnsortedMeshDraws.push_back({ materialIndex, meshIndex, submeshIndex, (uint32_t)myMeshInstances.size() });
+			}
+
+			auto& instance = myMeshInstances.emplace_back();
+			instance.row[0] = { submeshTransform(1, 1), submeshTransform(1, 2), submeshTransform(1, 3), submeshTransform(4, 1) };
+			instance.row[1] = { submeshTransform(2, 1), submeshTransform(2, 2), submeshTransform(2, 3), submeshTransform(4, 2) };
+			instance.row[2] = { submeshTransform(3, 1), submeshTransform(3, 2), submeshTransform(3, 3), submeshTransform(4, 3) };
+			instance.id = aEntityID;
 		}
 	}
 
@@ -819,7 +1032,9 @@ namespace Epoch
 		auto& drawCall = myAnimatedDrawList.emplace_back();
 		drawCall.mesh = aMesh;
 		drawCall.transform = aTransform;
-		drawCall.boneTransforms = aBoneTransforms;
+		drawCall.boneOffset = (uint32_t)myAnimatedBoneTransforms.size();
+		drawCall.boneCount = (uint32_t)aBoneTransforms.size();
+		myAnimatedBoneTransforms.insert(myAnimatedBoneTransforms.end(), aBoneTransforms.begin(), aBoneTransforms.end());
 	}
 
 	void SceneRenderer::SubmitQuad(const CU::Matrix4x4f aTransform, const CU::Color& aColor, uint32_t aEntityID)
@@ -862,7 +1077,7 @@ namespace Epoch
 		++myQuadCount;
 	}
 
-	static bool NextLine(int aIndex, const std::set<int>& aLines)
+	static bool NextLine(int aIndex, const std::pmr::set<int>& aLines)
 	{
 		if (aLines.contains(aIndex))
 		{
@@ -871,18 +1086,39 @@ namespace Epoch
 		return false;
 	}
 
-	// warning C4996: 'std::codecvt_utf8<char32_t,1114111,(std::codecvt_mode)0>': warning STL4017: std::wbuffer_convert, std::wstring_convert, and the <codecvt> header
-	// (containing std::codecvt_mode, std::codecvt_utf8, std::codecvt_utf16, and std::codecvt_utf8_utf16) are deprecated in C++17. (The std::codecvt class template is NOT deprecated.)
-	// The C++ Standard doesn't provide equivalent non-deprecated functionality; consider using MultiByteToWideChar() and WideCharToMultiByte() from <Windows.h> instead.
-	// You can define _SILENCE_CXX17_CODECVT_HEADER_DEPRECATION_WARNING or _SILENCE_ALL_CXX17_DEPRECATION_WARNINGS to acknowledge that you have received this warning.
-#pragma warning(disable : 4996)
-	// From https://stackoverflow.com/questions/31302506/stdu32string-conversion-to-from-stdstring-and-stdu16string
-	static std::u32string To_UTF32(const std::string& s)
+	// Decodes into the frame arena, invalid sequences become U+FFFD which is skipped like any other missing glyph
+	static std::pmr::u32string ToUTF32(const std::string& aString)
 	{
-		std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t> conv;
-		return conv.from_bytes(s);
+		std::pmr::u32string result(FrameAllocator::Get());
+		result.reserve(aString.size());
+
+		for (size_t i = 0; i < aString.size();)
+		{
+			const uint8_t lead = (uint8_t)aString[i];
+			const uint32_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+
+			bool valid = length > 0 && i + length <= aString.size();
+			char32_t codepoint = length == 1 ? lead : lead & (0x7F >> length);
+			for (uint32_t j = 1; valid && j < length; j++)
+			{
+				const uint8_t continuation = (uint8_t)aString[i + j];
+				valid = (continuation & 0xC0) == 0x80;
+				codepoint = (codepoint << 6) | (continuation & 0x3F);
+			}
+
+			if (!valid)
+			{
+				result.push_back(U'\uFFFD');
+				i++;
+				continue;
+			}
+
+			result.push_back(codepoint);
+			i += length;
+		}
+
+		return result;
 	}
-#pragma warning(default : 4996)
 
 	void SceneRenderer::SubmitText(const std::string& aString, const std::shared_ptr<Font>& aFont, const CU::Matrix4x4f& aTransform, const TextSettings& aSettings, uint32_t aEntityID)
 	{
@@ -899,9 +1135,9 @@ namespace Epoch
 		auto& fontGeometry = aFont->GetMSDFData()->fontGeometry;
 		const auto& metrics = fontGeometry.getMetrics();
 
-		std::u32string utf32string = To_UTF32(aString);
+		const std::pmr::u32string utf32string = ToUTF32(aString);
 
-		std::set<int> nextLines;
+		std::pmr::set<int> nextLines(FrameAllocator::Get());
 		{
 			double x = 0.0;
 			double fsScale = 1 / (metrics.ascenderY - metrics.descenderY);
@@ -1128,41 +1364,65 @@ namespace Epoch
 	//Temp
 	void SceneRenderer::SetMaterial(std::shared_ptr<Material> aMaterial)
 	{
-		myMaterialBuffer->SetData(&aMaterial->GetData());
-		myMaterialBuffer->Bind(PIPELINE_STAGE_PIXEL_SHADER, 1);
+		BindConstantBuffer(aMaterial->GetConstantBuffer(), PIPELINE_STAGE_PIXEL_SHADER, 1);
+
+		//auto texture = AssetManager::GetAssetAsync<Texture2D>(...); //TODO: Make async
+		std::shared_ptr<Texture2D> albedoTexture = AssetManager::GetAsset<Texture2D>(aMaterial->GetAlbedoTexture());
+		if (!albedoTexture)
+		{
+			albedoTexture = Renderer::GetWhiteTexture();
+		}
 
-		std::vector<ID3D11ShaderResourceView*> SRVs(3);
+		std::shared_ptr<Texture2D> normalTexture = AssetManager::GetAsset<Texture2D>(aMaterial->GetNormalTexture());
+		if (!normalTexture)
+		{
+			normalTexture = Renderer::GetFlatNormalTexture();
+		}
 
+		std::shared_ptr<Texture2D> materialTexture = AssetManager::GetAsset<Texture2D>(aMaterial->GetMaterialTexture());
+		if (!materialTexture)
 		{
-			//auto texture = AssetManager::GetAssetAsync<Texture2D>(aMaterial->GetAlbedoTexture());
-			auto texture = AssetManager::GetAsset<Texture2D>(aMaterial->GetAlbedoTexture()); //TODO: Make async
-			if (!texture)
-			{
-				texture = Renderer::GetWhiteTexture();
-			}
-			auto dxTexture = std::dynamic_pointer_cast<DX11Texture2D>(texture);
-			SRVs[0] = dxTexture->GetSRV().Get();
+			materialTexture = Renderer::GetDefaultMaterialTexture();
 		}
+
+		// Materials sharing textures only rebind the slots that differ
+		const void* views[] = { albedoTexture->GetView(), normalTexture->GetView(), materialTexture->GetView() };
+		BindTextures(0, 3, views);
+	}
+
+	void SceneRenderer::SetPipeline(const std::shared_ptr<RenderPipeline>& aPipeline)
+	{
+		if (myStateCache.SetPipeline(aPipeline.get()))
 		{
-			//auto texture = AssetManager::GetAssetAsync<Texture2D>(aMaterial->GetNormalTexture());
-			auto texture = AssetManager::GetAsset<Texture2D>(aMaterial->GetNormalTexture()); //TODO: Make async
-			if (!texture)
-			{
-				texture = Renderer::GetFlatNormalTexture();
-			}
-			auto dxTexture = std::dynamic_pointer_cast<DX11Texture2D>(texture);
-			SRVs[1] = dxTexture->GetSRV().Get();
+			Renderer::SetRenderPipeline(aPipeline);
+
+			// Changing render targets can make the backend unbind views of those targets
+			myStateCache.InvalidateTextures();
 		}
+	}
+
+	void SceneRenderer::RemovePipeline(const std::shared_ptr<RenderPipeline>& aPipeline)
+	{
+		Renderer::RemoveRenderPipeline(aPipeline);
+		myStateCache.RemovePipeline();
+	}
+
+	void SceneRenderer::BindConstantBuffer(const std::shared_ptr<ConstantBuffer>& aBuffer, uint32_t aStages, uint32_t aSlot)
+	{
+		if (myStateCache.SetConstantBuffer(aStages, aSlot, aBuffer.get()))
 		{
-			//auto texture = AssetManager::GetAssetAsync<Texture2D>(aMaterial->GetMaterialTexture());
-			auto texture = AssetManager::GetAsset<Texture2D>(aMaterial->GetMaterialTexture()); //TODO: Make async
-			if (!texture)
-			{
-				texture = Renderer::GetDefaultMaterialTexture();
-			}
-			auto dxTexture = std::dynamic_pointer_cast<DX11Texture2D>(texture);
-			SRVs[2] = dxTexture->GetSRV().Get();
+			aBuffer->Bind(aStages, aSlot);
+		}
+	}
+
+	void SceneRenderer::BindTextures(uint32_t aFirstSlot, uint32_t aCount, const void* const* aViews)
+	{
+		uint32_t firstChangedSlot = 0;
+		uint32_t changedCount = 0;
+		if (myStateCache.SetTextures(aFirstSlot, aCount, aViews, firstChangedSlot, changedCount))
+		{
+			ID3D11ShaderResourceView* const* SRVs = (ID3D11ShaderResourceView* const*)(aViews + (firstChangedSlot - aFirstSlot));
+			RHI::GetContext()->PSSetShaderResources(firstChangedSlot, changedCount, SRVs);
 		}
-		RHI::GetContext()->PSSetShaderResources(0, 3, SRVs.data());
 	}
 }
@@ -1,10 +1,11 @@
 #pragma once
-#include <map>
 #include <array>
 #include <vector>
 #include <memory>
 #include <CommonUtilities/Math/Transform.h>
 #include "Epoch/Rendering/RenderConstants.h"
+#include "Epoch/Rendering/RenderQueue.h"
+#include "Epoch/Rendering/RenderStateCache.h"
 #include "SceneRenderer2D.h"
 #include "Scene.h"
 #include "SceneInfo.h"
@@ -25,6 +26,7 @@ namespace Epoch
 	class ComputePipeline;
 
 	class DebugRenderer;
+	class TextureStreamer;
 
 	struct SceneRendererCamera
 	{
@@ -36,6 +38,8 @@ namespace Epoch
 		float farPlane = 0.0f;
 		float fov = 0.0f;
 		float aspect = 0.0f;
+		bool isOrthographic = false;
+		float orthographicSize = 0.0f; // Height of the view in world units
 	};
 
 	struct CameraBuffer
@@ -133,6 +137,10 @@ namespace Epoch
 			uint32_t triangles = 0;
 			uint32_t meshes = 0;
 			uint32_t submeshes = 0;
+
+			// Pipeline, constant buffer and texture binds sent to the backend and the ones skipped as redundant
+			uint32_t stateBinds = 0;
+			uint32_t skippedStateBinds = 0;
 		};
 		const Stats GetStats() const { return myStats; }
 
@@ -152,9 +160,18 @@ namespace Epoch
 
 		void UpdateStatistics();
 
+		uint32_t GetFrameMaterialIndex(AssetHandle aMaterialHandle);
+		void RenderMeshQueue();
+		void RequestStreamedTextures();
+
 		//TEMP
 		void SetMaterial(std::shared_ptr<Material> aMaterial);
 
+		void SetPipeline(const std::shared_ptr<RenderPipeline>& aPipeline);
+		void RemovePipeline(const std::shared_ptr<RenderPipeline>& aPipeline);
+		void BindConstantBuffer(const std::shared_ptr<ConstantBuffer>& aBuffer, uint32_t aStages, uint32_t aSlot);
+		void BindTextures(uint32_t aFirstSlot, uint32_t aCount, const void* const* aViews);
+
 	private:
 		std::shared_ptr<Scene> myScene;
 		std::shared_ptr<DebugRenderer> myDebugRenderer;
@@ -185,7 +202,6 @@ namespace Epoch
 
 		std::shared_ptr<ConstantBuffer> myCameraBuffer;
 		std::shared_ptr<ConstantBuffer> myObjectBuffer;
-		std::shared_ptr<ConstantBuffer> myMaterialBuffer;
 		std::shared_ptr<ConstantBuffer> myBoneBuffer;
 		std::shared_ptr<ConstantBuffer> myLightBuffer;
 		std::shared_ptr<ConstantBuffer> myPointLightBuffer;
@@ -193,48 +209,16 @@ namespace Epoch
 		std::shared_ptr<ConstantBuffer> myDebugDrawModeBuffer;
 		std::shared_ptr<ConstantBuffer> myPostProcessingBuffer;
 
-		// Meshes
-		struct MeshKey
-		{
-			AssetHandle meshHandle = 0;
-			AssetHandle materialHandle = 0;
-			unsigned submeshIndex = 0;
-
-			MeshKey(AssetHandle aMeshHandle, AssetHandle aMaterialHandle, unsigned aSubmeshIndex)
-				: meshHandle(aMeshHandle), materialHandle(aMaterialHandle), submeshIndex(aSubmeshIndex) {}
-
-			bool operator<(const MeshKey& other) const
-			{
-				if (materialHandle < other.materialHandle)
-					return true;
-
-				if (materialHandle > other.materialHandle)
-					return false;
-
-				if (meshHandle < other.meshHandle)
-					return true;
-
-				if (meshHandle > other.meshHandle)
-					return false;
-
-				return submeshIndex < other.submeshIndex;
-			}
-		};
-
-		struct DrawCommand
-		{
-			std::shared_ptr<Mesh> mesh;
-			uint32_t submeshIndex = 0;
-			std::shared_ptr<Material> material;
-
-			uint32_t instanceCount = 0;
-		};
+		RenderStateCache myStateCache;
 
+		// Meshes
 		struct AnimatedDrawCommand
 		{
 			std::shared_ptr<Mesh> mesh;
 			CU::Matrix4x4f transform;
-			std::vector<CU::Matrix4x4f> boneTransforms;
+			// Range in myAnimatedBoneTransforms
+			uint32_t boneOffset = 0;
+			uint32_t boneCount = 0;
 		};
 
 		struct MeshInstanceData
@@ -243,9 +227,61 @@ namespace Epoch
 			uint32_t id;
 		};
 		
-		std::map<MeshKey, std::vector<MeshInstanceData>> myMeshTransformMap;
-		std::map<MeshKey, DrawCommand> myDrawList;
+		// Instances whose indices don't fit in a queue key, drawn one by one after the queue
+		struct UnsortedMeshDraw
+		{
+			uint32_t material = 0;
+			uint32_t mesh = 0;
+			uint32_t submesh = 0;
+			uint32_t instance = 0;
+		};
+
+		// Open addressing map from asset handle to per frame index.
+		// Slots belong to the frame they were stamped with, so clearing is a stamp bump and refilling doesn't allocate.
+		class FrameIndexTable
+		{
+		public:
+			const uint32_t* Find(AssetHandle aHandle) const;
+			void Insert(AssetHandle aHandle, uint32_t aIndex);
+			void Clear();
+
+		private:
+			struct Slot
+			{
+				AssetHandle handle = 0;
+				uint32_t index = 0;
+				uint32_t frame = 0;
+			};
+
+			size_t FindSlot(AssetHandle aHandle) const;
+			void Grow();
+
+			std::vector<Slot> mySlots;
+			uint32_t myCount = 0;
+			uint32_t myFrame = 1;
+		};
+
+		// Every submitted submesh instance is one queue item, the key selects the mesh, submesh and material
+		RenderQueue myRenderQueue;
+		std::vector<MeshInstanceData> myMeshInstances;
+		std::vector<UnsortedMeshDraw> myUnsortedMeshDraws;
+		bool myHasLoggedQueueOverflow = false;
+
+		// Per frame lookup tables for the indices stored in the queue keys, cleared but not freed at the end of the frame
+		std::vector<std::shared_ptr<Mesh>> myFrameMeshes;
+		FrameIndexTable myFrameMeshIndices;
+		std::vector<std::shared_ptr<Material>> myFrameMaterials;
+		FrameIndexTable myFrameMaterialIndices;
+
+		// Largest on screen size in pixels of the meshes using each frame material, drives texture streaming
+		std::vector<float> myFrameMaterialScreenSizes;
+		TextureStreamer* myTextureStreamer = nullptr;
+		float myProjectionScale = 0.0f;
+
+		std::vector<MeshInstanceData> myInstanceStaging;
 		std::vector<AnimatedDrawCommand> myAnimatedDrawList;
+		// The bone palettes of all animated draws this frame, cleared but not freed at the end of the frame
+		std::vector<CU::Matrix4x4f> myAnimatedBoneTransforms;
 
 		std::shared_ptr<VertexBuffer> myInstanceTransformBuffer;
 
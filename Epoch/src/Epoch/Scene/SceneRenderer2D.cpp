@@ -8,6 +8,8 @@
 #include "Epoch/Rendering/Texture.h"
 #include "Epoch/Rendering/Font.h"
 #include "Epoch/Rendering/MSDFData.h"
+#include "Epoch/Rendering/TextureStreamer.h"
+#include "Epoch/Assets/AssetManager.h"
 
 #include "Epoch/Rendering/RHI.h"
 #include <codecvt>
@@ -151,6 +153,15 @@ namespace Epoch
 		QuadPass();
 		TextPass();
 
+		// UI images are kept at full resolution
+		if (TextureStreamer* textureStreamer = AssetManager::GetTextureStreamer())
+		{
+			for (const auto& [handle, texture] : myTextures)
+			{
+				textureStreamer->RequestMip(handle, 0);
+			}
+		}
+
 		myQuadVertices.clear();
 		myTextVertices.clear();
 		myTextures.clear();
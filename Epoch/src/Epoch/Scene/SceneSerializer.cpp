@@ -150,7 +150,7 @@ namespace Epoch
 							continue;
 						}
 
-						std::shared_ptr<FieldStorageBase> storage = ScriptEngine::GetFieldStorage(entity, fieldID);
+						FieldStorageBase storage = ScriptEngine::GetFieldStorage(entity, fieldID);
 
 						if (!storage)
 						{
@@ -168,84 +168,84 @@ namespace Epoch
 						{
 							aOut << YAML::BeginSeq;
 
-							std::shared_ptr<ArrayFieldStorage> arrayStorage = std::dynamic_pointer_cast<ArrayFieldStorage>(storage);
-							for (uint32_t i = 0; i < uint32_t(arrayStorage->GetLength()); i++)
+							ArrayFieldStorage arrayStorage = storage.AsArray();
+							for (uint32_t i = 0; i < uint32_t(arrayStorage.GetLength()); i++)
 							{
 								switch (fieldInfo->type)
 								{
 								case FieldType::Bool:
 								{
-									aOut << arrayStorage->GetValue<bool>(i);
+									aOut << arrayStorage.GetValue<bool>(i);
 									break;
 								}
 								case FieldType::Int8:
 								{
-									aOut << arrayStorage->GetValue<int8_t>(i);
+									aOut << arrayStorage.GetValue<int8_t>(i);
 									break;
 								}
 								case FieldType::Int16:
 								{
-									aOut << arrayStorage->GetValue<int16_t>(i);
+									aOut << arrayStorage.GetValue<int16_t>(i);
 									break;
 								}
 								case FieldType::Int32:
 								{
-									aOut << arrayStorage->GetValue<int32_t>(i);
+									aOut << arrayStorage.GetValue<int32_t>(i);
 									break;
 								}
 								case FieldType::Int64:
 								{
-									aOut << arrayStorage->GetValue<int64_t>(i);
+									aOut << arrayStorage.GetValue<int64_t>(i);
 									break;
 								}
 								case FieldType::UInt8:
 								{
-									aOut << arrayStorage->GetValue<uint8_t>(i);
+									aOut << arrayStorage.GetValue<uint8_t>(i);
 									break;
 								}
 								case FieldType::UInt16:
 								{
-									aOut << arrayStorage->GetValue<uint16_t>(i);
+									aOut << arrayStorage.GetValue<uint16_t>(i);
 									break;
 								}
 								case FieldType::UInt32:
 								{
-									aOut << arrayStorage->GetValue<uint32_t>(i);
+									aOut << arrayStorage.GetValue<uint32_t>(i);
 									break;
 								}
 								case FieldType::UInt64:
 								{
-									aOut << arrayStorage->GetValue<uint64_t>(i);
+									aOut << arrayStorage.GetValue<uint64_t>(i);
 									break;
 								}
 								case FieldType::Float:
 								{
-									aOut << arrayStorage->GetValue<float>(i);
+									aOut << arrayStorage.GetValue<float>(i);
 									break;
 								}
 								case FieldType::Double:
 								{
-									aOut << arrayStorage->GetValue<double>(i);
+									aOut << arrayStorage.GetValue<double>(i);
 									break;
 								}
 								case FieldType::String:
 								{
-									aOut << arrayStorage->GetValue<std::string>(i);
+									aOut << arrayStorage.GetValue<std::string>(i);
 									break;
 								}
 								case FieldType::Vector2:
 								{
-									aOut << arrayStorage->GetValue<CU::Vector2f>(i);
+									aOut << arrayStorage.GetValue<CU::Vector2f>(i);
 									break;
 								}
 								case FieldType::Vector3:
 								{
-									aOut << arrayStorage->GetValue<CU::Vector3f>(i);
+									aOut << arrayStorage.GetValue<CU::Vector3f>(i);
 									break;
 								}
 								case FieldType::Color:
 								{
-									aOut << arrayStorage->GetValue<CU::Vector4f>(i);
+									aOut << arrayStorage.GetValue<CU::Vector4f>(i);
 									break;
 								}
 								case FieldType::Scene:
@@ -255,7 +255,7 @@ namespace Epoch
 								case FieldType::Mesh:
 								case FieldType::Texture2D:
 								{
-									aOut << arrayStorage->GetValue<UUID>(i);
+									aOut << arrayStorage.GetValue<UUID>(i);
 									break;
 								}
 								default: EPOCH_ASSERT(false, "Field failed to be serialized!");
@@ -266,83 +266,83 @@ namespace Epoch
 						}
 						else
 						{
-							std::shared_ptr<FieldStorage> fieldStorage = std::dynamic_pointer_cast<FieldStorage>(storage);
+							FieldStorage fieldStorage = storage.AsField();
 							switch (fieldInfo->type)
 							{
 							case FieldType::Bool:
 							{
-								aOut << fieldStorage->GetValue<bool>();
+								aOut << fieldStorage.GetValue<bool>();
 								break;
 							}
 							case FieldType::Int8:
 							{
-								aOut << fieldStorage->GetValue<int8_t>();
+								aOut << fieldStorage.GetValue<int8_t>();
 								break;
 							}
 							case FieldType::Int16:
 							{
-								aOut << fieldStorage->GetValue<int16_t>();
+								aOut << fieldStorage.GetValue<int16_t>();
 								break;
 							}
 							case FieldType::Int32:
 							{
-								aOut << fieldStorage->GetValue<int32_t>();
+								aOut << fieldStorage.GetValue<int32_t>();
 								break;
 							}
 							case FieldType::Int64:
 							{
-								aOut << fieldStorage->GetValue<int64_t>();
+								aOut << fieldStorage.GetValue<int64_t>();
 								break;
 							}
 							case FieldType::UInt8:
 							{
-								aOut << fieldStorage->GetValue<uint8_t>();
+								aOut << fieldStorage.GetValue<uint8_t>();
 								break;
 							}
 							case FieldType::UInt16:
 							{
-								aOut << fieldStorage->GetValue<uint16_t>();
+								aOut << fieldStorage.GetValue<uint16_t>();
 								break;
 							}
 							case FieldType::LayerMask:
 							case FieldType::UInt32:
 							{
-								aOut << fieldStorage->GetValue<uint32_t>();
+								aOut << fieldStorage.GetValue<uint32_t>();
 								break;
 							}
 							case FieldType::UInt64:
 							{
-								aOut << fieldStorage->GetValue<uint64_t>();
+								aOut << fieldStorage.GetValue<uint64_t>();
 								break;
 							}
 							case FieldType::Float:
 							{
-								aOut << fieldStorage->GetValue<float>();
+								aOut << fieldStorage.GetValue<float>();
 								break;
 							}
 							case FieldType::Double:
 							{
-								aOut << fieldStorage->GetValue<double>();
+								aOut << fieldStorage.GetValue<double>();
 								break;
 							}
 							case FieldType::String:
 							{
-								aOut << fieldStorage->GetValue<std::string>();
+								aOut << fieldStorage.GetValue<std::string>();
 								break;
 							}
 							case FieldType::Vector2:
 							{
-								aOut << fieldStorage->GetValue<CU::Vector2f>();
+								aOut << fieldStorage.GetValue<CU::Vector2f>();
 								break;
 							}
 							case FieldType::Vector3:
 							{
-								aOut << fieldStorage->GetValue<CU::Vector3f>();
+								aOut << fieldStorage.GetValue<CU::Vector3f>();
 								break;
 							}
 							case FieldType::Color:
 							{
-								aOut << fieldStorage->GetValue<CU::Vector4f>();
+								aOut << fieldStorage.GetValue<CU::Vector4f>();
 								break;
 							}
 							case FieldType::Scene:
@@ -351,7 +351,7 @@ namespace Epoch
 							case FieldType::Material:
 							case FieldType::Mesh:
 							{
-								aOut << fieldStorage->GetValue<UUID>();
+								aOut << fieldStorage.GetValue<UUID>();
 								break;
 							}
 							default: EPOCH_ASSERT(false, "Field failed to be serialized!");
@@ -937,231 +937,14 @@ namespace Epoch
 				if (scriptAssetHandle != 0)
 				{
 					sc.scriptClassHandle = scriptAssetHandle;
-					ScriptEngine::InitializeScriptEntity(deserializedEntity);
 
-					if (sc.fieldIDs.size() > 0)
+					if (myDeferScriptInitialization)
 					{
-						auto storedFields = scriptComponent["StoredFields"];
-						if (storedFields)
-						{
-							for (auto field : storedFields)
-							{
-								uint32_t id = field["ID"].as<uint32_t>(0);
-								std::string fullName = field["Name"].as<std::string>();
-								std::string name = CU::SubStr(fullName, fullName.find(':') + 1);
-								std::string typeStr = field["Type"].as<std::string>("");
-								FieldInfo* fieldData = ScriptCache::GetFieldByID(id);
-								std::shared_ptr<FieldStorageBase> storage = ScriptEngine::GetFieldStorage(deserializedEntity, id);
-
-								if (fieldData == nullptr || storage == nullptr)
-								{
-									id = (uint32_t)Hash::GenerateFNVHash(name);
-									fieldData = ScriptCache::GetFieldByID(id);
-									storage = ScriptEngine::GetFieldStorage(deserializedEntity, id);
-								}
-
-								if (storage == nullptr)
-								{
-									CONSOLE_LOG_WARN("Serialized C# field '{}' which doesn't exist in script cache! This could be because the script field no longer exists or because it's been renamed.", name);
-								}
-								else
-								{
-									auto dataNode = field["Data"];
-
-									if (fieldData->IsArray() && dataNode.IsSequence())
-									{
-										std::shared_ptr<ArrayFieldStorage> arrayStorage = std::dynamic_pointer_cast<ArrayFieldStorage>(storage);
-										arrayStorage->Resize(uint32_t(dataNode.size()));
-										
-										for (uint32_t i = 0; i < uint32_t(dataNode.size()); i++)
-										{
-											switch (fieldData->type)
-											{
-												case FieldType::Bool:
-												{
-													arrayStorage->SetValue(i, dataNode[i].as<bool>());
-													break;
-												}
-												case FieldType::Int8:
-												{
-													arrayStorage->SetValue(i, static_cast<int8_t>(dataNode[i].as<int16_t>()));
-													break;
-												}
-												case FieldType::Int16:
-												{
-													arrayStorage->SetValue(i, dataNode[i].as<int16_t>());
-													break;
-												}
-												case FieldType::Int32:
-												{
-													arrayStorage->SetValue(i, dataNode[i].as<int32_t>());
-													break;
-												}
-												case FieldType::Int64:
-												{
-													arrayStorage->SetValue(i, dataNode[i].as<int64_t>());
-													break;
-												}
-												case FieldType::UInt8:
-												{
-													arrayStorage->SetValue(i, dataNode[i].as<uint8_t>());
-													break;
-												}
-												case FieldType::UInt16:
-												{
-													arrayStorage->SetValue(i, dataNode[i].as<uint16_t>());
-													break;
-												}
-												case FieldType::UInt32:
-												{
-													arrayStorage->SetValue(i, dataNode[i].as<uint32_t>());
-													break;
-												}
-												case FieldType::UInt64:
-												{
-													arrayStorage->SetValue(i, dataNode[i].as<uint64_t>());
-													break;
-												}
-												case FieldType::Float:
-												{
-													arrayStorage->SetValue(i, dataNode[i].as<float>());
-													break;
-												}
-												case FieldType::Double:
-												{
-													arrayStorage->SetValue(i, dataNode[i].as<double>());
-													break;
-												}
-												case FieldType::String:
-												{
-													arrayStorage->SetValue(i, dataNode[i].as<std::string>());
-													break;
-												}
-												case FieldType::Vector2:
-												{
-													arrayStorage->SetValue(i, dataNode[i].as<CU::Vector2f>());
-													break;
-												}
-												case FieldType::Vector3:
-												{
-													arrayStorage->SetValue(i, dataNode[i].as<CU::Vector3f>());
-													break;
-												}
-												case FieldType::Color:
-												{
-													arrayStorage->SetValue(i, dataNode[i].as<CU::Vector4f>());
-													break;
-												}
-												case FieldType::Scene:
-												case FieldType::Entity:
-												case FieldType::Prefab:
-												case FieldType::Material:
-												case FieldType::Mesh:
-												{
-													arrayStorage->SetValue(i, dataNode[i].as<UUID>());
-													break;
-												}
-												default: EPOCH_ASSERT(false, "Field failed to be deserialized!");
-											}
-										}
-									}
-									else
-									{
-										std::shared_ptr<FieldStorage> fieldStorage = std::dynamic_pointer_cast<FieldStorage>(storage);
-										switch (fieldData->type)
-										{
-										case FieldType::Bool:
-										{
-											fieldStorage->SetValue(dataNode.as<bool>());
-											break;
-										}
-										case FieldType::Int8:
-										{
-											fieldStorage->SetValue(static_cast<int8_t>(dataNode.as<int16_t>()));
-											break;
-										}
-										case FieldType::Int16:
-										{
-											fieldStorage->SetValue(dataNode.as<int16_t>());
-											break;
-										}
-										case FieldType::Int32:
-										{
-											fieldStorage->SetValue(dataNode.as<int32_t>());
-											break;
-										}
-										case FieldType::Int64:
-										{
-											fieldStorage->SetValue(dataNode.as<int64_t>());
-											break;
-										}
-										case FieldType::UInt8:
-										{
-											fieldStorage->SetValue(dataNode.as<uint8_t>());
-											break;
-										}
-										case FieldType::UInt16:
-										{
-											fieldStorage->SetValue(dataNode.as<uint16_t>());
-											break;
-										}
-										case FieldType::LayerMask:
-										case FieldType::UInt32:
-										{
-											fieldStorage->SetValue(dataNode.as<uint32_t>());
-											break;
-										}
-										case FieldType::UInt64:
-										{
-											fieldStorage->SetValue(dataNode.as<uint64_t>());
-											break;
-										}
-										case FieldType::Float:
-										{
-											fieldStorage->SetValue(dataNode.as<float>());
-											break;
-										}
-										case FieldType::Double:
-										{
-											fieldStorage->SetValue(dataNode.as<double>());
-											break;
-										}
-										case FieldType::String:
-										{
-											fieldStorage->SetValue(dataNode.as<std::string>());
-											break;
-										}
-										case FieldType::Vector2:
-										{
-											fieldStorage->SetValue(dataNode.as<CU::Vector2f>());
-											break;
-										}
-										case FieldType::Vector3:
-										{
-											fieldStorage->SetValue(dataNode.as<CU::Vector3f>());
-											break;
-										}
-										case FieldType::Color:
-										{
-											fieldStorage->SetValue(dataNode.as<CU::Vector4f>());
-											break;
-										}
-										case FieldType::Scene:
-										case FieldType::Entity:
-										case FieldType::Prefab:
-										case FieldType::Material:
-										case FieldType::Mesh:
-										case FieldType::Texture2D:
-										{
-											fieldStorage->SetValue(dataNode.as<UUID>());
-											break;
-										}
-										default: EPOCH_ASSERT(false, "Field failed to be deserialized!");
-										}
-									}
-								}
-							}
-						}
+						myDeferredScripts.push_back({ uuid, std::make_shared<YAML::Node>(scriptComponent["StoredFields"]) });
+					}
+					else
+					{
+						InitializeScript(deserializedEntity, scriptComponent["StoredFields"]);
 					}
 				}
 			}
@@ -1543,6 +1326,262 @@ namespace Epoch
 				cc.layerID = characterControllerComponent["Layer"].as<uint32_t>(0);
 			}
 		}
+
+		// Parents can come after their children, so the active state is propagated once everything is in place
+		myScene->RefreshActiveInHierarchy();
+	}
+
+	void SceneSerializer::InitializeScript(Entity aEntity, const YAML::Node& aStoredFields)
+	{
+		ScriptEngine::InitializeScriptEntity(aEntity);
+
+		const ScriptComponent& sc = aEntity.GetComponent<ScriptComponent>();
+		if (sc.fieldIDs.empty() || !aStoredFields)
+		{
+			return;
+		}
+
+		for (auto field : aStoredFields)
+		{
+			uint32_t id = field["ID"].as<uint32_t>(0);
+			std::string fullName = field["Name"].as<std::string>();
+			std::string name = CU::SubStr(fullName, fullName.find(':') + 1);
+			std::string typeStr = field["Type"].as<std::string>("");
+			FieldInfo* fieldData = ScriptCache::GetFieldByID(id);
+			FieldStorageBase storage = ScriptEngine::GetFieldStorage(aEntity, id);
+
+			if (fieldData == nullptr || !storage)
+			{
+				id = (uint32_t)Hash::GenerateFNVHash(name);
+				fieldData = ScriptCache::GetFieldByID(id);
+				storage = ScriptEngine::GetFieldStorage(aEntity, id);
+			}
+
+			if (!storage)
+			{
+				CONSOLE_LOG_WARN("Serialized C# field '{}' which doesn't exist in script cache! This could be because the script field no longer exists or because it's been renamed.", name);
+			}
+			else
+			{
+				auto dataNode = field["Data"];
+
+				if (fieldData->IsArray() && dataNode.IsSequence())
+				{
+					ArrayFieldStorage arrayStorage = storage.AsArray();
+					arrayStorage.Resize(uint32_t(dataNode.size()));
+					
+					for (uint32_t i = 0; i < uint32_t(dataNode.size()); i++)
+					{
+						switch (fieldData->type)
+						{
+							case FieldType::Bool:
+							{
+								arrayStorage.SetValue(i, dataNode[i].as<bool>());
+								break;
+							}
+							case FieldType::Int8:
+							{
+								arrayStorage.SetValue(i, static_cast<int8_t>(dataNode[i].as<int16_t>()));
+								break;
+							}
+							case FieldType::Int16:
+							{
+								arrayStorage.SetValue(i, dataNode[i].as<int16_t>());
+								break;
+							}
+							case FieldType::Int32:
+							{
+								arrayStorage.SetValue(i, dataNode[i].as<int32_t>());
+								break;
+							}
+							case FieldType::Int64:
+							{
+								arrayStorage.SetValue(i, dataNode[i].as<int64_t>());
+								break;
+							}
+							case FieldType::UInt8:
+							{
+								arrayStorage.SetValue(i, dataNode[i].as<uint8_t>());
+								break;
+							}
+							case FieldType::UInt16:
+							{
+								arrayStorage.SetValue(i, dataNode[i].as<uint16_t>());
+								break;
+							}
+							case FieldType::UInt32:
+							{
+								arrayStorage.SetValue(i, dataNode[i].as<uint32_t>());
+								break;
+							}
+							case FieldType::UInt64:
+							{
+								arrayStorage.SetValue(i, dataNode[i].as<uint64_t>());
+								break;
+							}
+							case FieldType::Float:
+							{
+								arrayStorage.SetValue(i, dataNode[i].as<float>());
+								break;
+							}
+							case FieldType::Double:
+							{
+								arrayStorage.SetValue(i, dataNode[i].as<double>());
+								break;
+							}
+							case FieldType::String:
+							{
+								arrayStorage.SetValue(i, dataNode[i].as<std::string>());
+								break;
+							}
+							case FieldType::Vector2:
+							{
+								arrayStorage.SetValue(i, dataNode[i].as<CU::Vector2f>());
+								break;
+							}
+							case FieldType::Vector3:
+							{
+								arrayStorage.SetValue(i, dataNode[i].as<CU::Vector3f>());
+								break;
+							}
+							case FieldType::Color:
+							{
+								arrayStorage.SetValue(i, dataNode[i].as<CU::Vector4f>());
+								break;
+							}
+							case FieldType::Scene:
+							case FieldType::Entity:
+							case FieldType::Prefab:
+							case FieldType::Material:
+							case FieldType::Mesh:
+							{
+								arrayStorage.SetValue(i, dataNode[i].as<UUID>());
+								break;
+							}
+							default: EPOCH_ASSERT(false, "Field failed to be deserialized!");
+						}
+					}
+				}
+				else
+				{
+					FieldStorage fieldStorage = storage.AsField();
+					switch (fieldData->type)
+					{
+					case FieldType::Bool:
+					{
+						fieldStorage.SetValue(dataNode.as<bool>());
+						break;
+					}
+					case FieldType::Int8:
+					{
+						fieldStorage.SetValue(static_cast<int8_t>(dataNode.as<int16_t>()));
+						break;
+					}
+					case FieldType::Int16:
+					{
+						fieldStorage.SetValue(dataNode.as<int16_t>());
+						break;
+					}
+					case FieldType::Int32:
+					{
+						fieldStorage.SetValue(dataNode.as<int32_t>());
+						break;
+					}
+					case FieldType::Int64:
+					{
+						fieldStorage.SetValue(dataNode.as<int64_t>());
+						break;
+					}
+					case FieldType::UInt8:
+					{
+						fieldStorage.SetValue(dataNode.as<uint8_t>());
+						break;
+					}
+					case FieldType::UInt16:
+					{
+						fieldStorage.SetValue(dataNode.as<uint16_t>());
+						break;
+					}
+					case FieldType::LayerMask:
+					case FieldType::UInt32:
+					{
+						fieldStorage.SetValue(dataNode.as<uint32_t>());
+						break;
+					}
+					case FieldType::UInt64:
+					{
+						fieldStorage.SetValue(dataNode.as<uint64_t>());
+						break;
+					}
+					case FieldType::Float:
+					{
+						fieldStorage.SetValue(dataNode.as<float>());
+						break;
+					}
+					case FieldType::Double:
+					{
+						fieldStorage.SetValue(dataNode.as<double>());
+						break;
+					}
+					case FieldType::String:
+					{
+						fieldStorage.SetValue(dataNode.as<std::string>());
+						break;
+					}
+					case FieldType::Vector2:
+					{
+						fieldStorage.SetValue(dataNode.as<CU::Vector2f>());
+						break;
+					}
+					case FieldType::Vector3:
+					{
+						fieldStorage.SetValue(dataNode.as<CU::Vector3f>());
+						break;
+					}
+					case FieldType::Color:
+					{
+						fieldStorage.SetValue(dataNode.as<CU::Vector4f>());
+						break;
+					}
+					case FieldType::Scene:
+					case FieldType::Entity:
+					case FieldType::Prefab:
+					case FieldType::Material:
+					case FieldType::Mesh:
+					case FieldType::Texture2D:
+					{
+						fieldStorage.SetValue(dataNode.as<UUID>());
+						break;
+					}
+					default: EPOCH_ASSERT(false, "Field failed to be deserialized!");
+					}
+				}
+			}
+		}
+	}
+
+	bool SceneSerializer::InitializeDeferredScripts(float aBudgetMilliseconds)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		Timer timer;
+		while (myInitializedScriptCount < (uint32_t)myDeferredScripts.size())
+		{
+			const DeferredScript& deferredScript = myDeferredScripts[myInitializedScriptCount++];
+
+			Entity entity = myScene->TryGetEntityWithUUID(deferredScript.entityID);
+			if (entity)
+			{
+				InitializeScript(entity, *deferredScript.storedFields);
+			}
+
+			if (timer.ElapsedMillis() >= aBudgetMilliseconds)
+			{
+				break;
+			}
+		}
+
+		return myInitializedScriptCount == (uint32_t)myDeferredScripts.size();
 	}
 
 	bool SceneSerializer::SerializeToAssetPack(FileStreamWriter& aStream, AssetSerializationInfo& outInfo)
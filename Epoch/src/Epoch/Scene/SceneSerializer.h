@@ -30,11 +30,30 @@ namespace Epoch
 		bool SerializeToAssetPack(FileStreamWriter& aStream, AssetSerializationInfo& outInfo);
 		bool DeserializeFromAssetPack(FileStreamReader& aStream, const AssetPackFile::SceneInfo& aSceneInfo);
 
+		// The script engine isn't thread safe, deferring leaves the scripts uninitialized so the scene can be deserialized on a worker thread.
+		// Their stored fields are kept until InitializeDeferredScripts is called on the main thread.
+		void SetDeferScriptInitialization(bool aDefer) { myDeferScriptInitialization = aDefer; }
+		uint32_t GetDeferredScriptCount() const { return (uint32_t)myDeferredScripts.size(); }
+		// Initializes deferred scripts until the budget is used up, returns true once all of them are initialized
+		bool InitializeDeferredScripts(float aBudgetMilliseconds = FLT_MAX);
+
 	private:
 		void SerializeToYAML(YAML::Emitter& out);
 		bool DeserializeFromYAML(const std::string& aYamlString);
 
+		void InitializeScript(Entity aEntity, const YAML::Node& aStoredFields);
+
 	private:
+		struct DeferredScript
+		{
+			UUID entityID;
+			std::shared_ptr<YAML::Node> storedFields;
+		};
+
 		std::shared_ptr<Scene> myScene;
+
+		bool myDeferScriptInitialization = false;
+		std::vector<DeferredScript> myDeferredScripts;
+		uint32_t myInitializedScriptCount = 0;
 	};
 }
@@ -11,71 +11,520 @@
 
 namespace Epoch
 {
-	bool FieldStorage::GetValueRuntime(Buffer& outBuffer) const
+	FieldStorageBlock::FieldStorageBlock(const ManagedClass& aClass)
 	{
-		if (myRuntimeInstance == nullptr)
+		for (uint32_t fieldID : aClass.fields)
 		{
-			return false;
+			FieldInfo* fieldInfo = ScriptCache::GetFieldByID(fieldID);
+
+			if (!fieldInfo->HasFlag(FieldFlag::Public))
+			{
+				continue;
+			}
+
+			FieldLayout& field = myFields.emplace_back();
+			field.fieldInfo = fieldInfo;
+			field.id = fieldID;
+			field.size = fieldInfo->size;
+			field.type = fieldInfo->type;
+			field.isArray = fieldInfo->IsArray();
+			field.isVariable = field.isArray || field.type == FieldType::String;
 		}
 
-		MonoObject* runtimeObject = GCManager::GetReferencedObject(myRuntimeInstance);
-		if (runtimeObject == nullptr)
+		// Widest alignment first so every value ends up naturally aligned without any padding
+		const auto getAlignment = [](const FieldLayout& aField) -> uint32_t
 		{
-			return false;
+			const uint32_t size = aField.isVariable ? (uint32_t)sizeof(uint32_t) : aField.size;
+			if (size % 8 == 0) return 8;
+			if (size % 4 == 0) return 4;
+			if (size % 2 == 0) return 2;
+			return 1;
+		};
+
+		std::stable_sort(myFields.begin(), myFields.end(), [&getAlignment](const FieldLayout& aLhs, const FieldLayout& aRhs)
+			{
+				return getAlignment(aLhs) > getAlignment(aRhs);
+			});
+
+		uint32_t offset = 0;
+		for (uint32_t i = 0; i < (uint32_t)myFields.size(); i++)
+		{
+			FieldLayout& field = myFields[i];
+			field.offset = offset;
+			offset += field.isVariable ? (uint32_t)sizeof(uint32_t) : field.size;
+
+			if (field.type == FieldType::Entity)
+			{
+				myEntityFields.push_back(i);
+			}
 		}
 
-		outBuffer = ScriptUtils::GetFieldValue(runtimeObject, myFieldInfo->name, myFieldInfo->type, myFieldInfo->isProperty);
-		return true;
+		myStride = (offset + 7) & ~7u;
+
+		myDefaultRow.resize(myStride, 0);
+		for (const FieldLayout& field : myFields)
+		{
+			const Buffer& defaultValue = field.fieldInfo->defaultValueBuffer;
+			if (field.isVariable || !defaultValue)
+			{
+				continue;
+			}
+
+			memcpy(myDefaultRow.data() + field.offset, defaultValue.data, defaultValue.size < field.size ? defaultValue.size : field.size);
+		}
 	}
 
-	void FieldStorage::SetValueRuntime(const void* aData)
+	FieldStorageBlock::~FieldStorageBlock()
 	{
-		if (myRuntimeInstance == nullptr)
+		for (Buffer& data : myVariableData)
 		{
-			return;
+			data.Release();
 		}
+	}
 
-		MonoObject* runtimeObject = GCManager::GetReferencedObject(myRuntimeInstance);
-		ScriptUtils::SetFieldValue(runtimeObject, myFieldInfo, aData);
+	uint32_t FieldStorageBlock::AllocateRow()
+	{
+		uint32_t row = 0;
+
+		if (!myFreeRows.empty())
+		{
+			row = myFreeRows.back();
+			myFreeRows.pop_back();
+		}
+		else
+		{
+			row = (uint32_t)myRuntimeInstances.size();
+			myRows.resize(myRows.size() + myStride);
+			myRuntimeInstances.push_back(nullptr);
+		}
+
+		WriteDefaults(row);
+		return row;
+	}
+
+	void FieldStorageBlock::FreeRow(uint32_t aRow)
+	{
+		ReleaseVariableData(aRow);
+		myRuntimeInstances[aRow] = nullptr;
+		myFreeRows.push_back(aRow);
 	}
 
+	void FieldStorageBlock::ResetRow(uint32_t aRow)
+	{
+		ReleaseVariableData(aRow);
+		myRuntimeInstances[aRow] = nullptr;
+		WriteDefaults(aRow);
+	}
 
-	void ArrayFieldStorage::Resize(uint32_t aNewLength)
+	void FieldStorageBlock::CopyRow(uint32_t aDstRow, uint32_t aSrcRow)
 	{
-		if (myFieldInfo->type == FieldType::String)
+		if (aDstRow == aSrcRow)
+		{
+			return;
+		}
+
+		ReleaseVariableData(aDstRow);
+		memcpy(myRows.data() + (size_t)aDstRow * myStride, myRows.data() + (size_t)aSrcRow * myStride, myStride);
+
+		for (const FieldLayout& field : myFields)
+		{
+			if (!field.isVariable)
+			{
+				continue;
+			}
+
+			const uint32_t srcSlot = *(const uint32_t*)GetFieldData(aSrcRow, field);
+			const uint32_t dstSlot = AllocateVariableSlot();
+			*(uint32_t*)GetFieldData(aDstRow, field) = dstSlot;
+
+			if (myVariableData[srcSlot])
+			{
+				myVariableData[dstSlot] = Buffer::Copy(myVariableData[srcSlot]);
+			}
+		}
+	}
+
+	void FieldStorageBlock::SetRuntimeInstance(uint32_t aRow, GCHandle aInstance)
+	{
+		myRuntimeInstances[aRow] = aInstance;
+
+		if (aInstance == nullptr)
 		{
 			return;
 		}
 
-		if (myRuntimeInstance == nullptr)
+		for (const FieldLayout& field : myFields)
 		{
-			if (!myDataBuffer)
+			if (field.isArray)
+			{
+				ArrayFieldStorage(this, aRow, &field).UploadToRuntime();
+			}
+			else
+			{
+				FieldStorage(this, aRow, &field).UploadToRuntime();
+			}
+		}
+	}
+
+	void FieldStorageBlock::RemapEntityReferences(uint32_t aRow, const std::unordered_map<UUID, UUID>& aEntityIDMap)
+	{
+		for (uint32_t fieldIndex : myEntityFields)
+		{
+			const FieldLayout& field = myFields[fieldIndex];
+
+			if (myRuntimeInstances[aRow] != nullptr)
+			{
+				if (field.isArray)
+				{
+					ArrayFieldStorage storage(this, aRow, &field);
+					for (uint32_t i = 0; i < storage.GetLength(); i++)
+					{
+						if (auto it = aEntityIDMap.find(storage.GetValue<UUID>(i)); it != aEntityIDMap.end())
+						{
+							storage.SetValue(i, it->second);
+						}
+					}
+				}
+				else
+				{
+					FieldStorage storage(this, aRow, &field);
+					if (auto it = aEntityIDMap.find(storage.GetValue<UUID>()); it != aEntityIDMap.end())
+					{
+						storage.SetValue(it->second);
+					}
+				}
+
+				continue;
+			}
+
+			byte* ids = nullptr;
+			uint32_t count = 0;
+
+			if (field.isArray)
 			{
-				myDataBuffer.Allocate(aNewLength * myFieldInfo->size);
-				myDataBuffer.ZeroInitialize();
+				Buffer& data = GetVariableData(aRow, field);
+				ids = (byte*)data.data;
+				count = (uint32_t)(data.size / sizeof(UUID));
 			}
 			else
 			{
-				Buffer newBuffer;
-				newBuffer.Allocate(aNewLength * myFieldInfo->size);
+				ids = GetFieldData(aRow, field);
+				count = 1;
+			}
 
-				uint32_t copyLength = aNewLength < myLength ? aNewLength : myLength;
-				memcpy(newBuffer.data, myDataBuffer.data, copyLength * myFieldInfo->size);
+			for (uint32_t i = 0; i < count; i++)
+			{
+				UUID id;
+				memcpy(&id, ids + i * sizeof(UUID), sizeof(UUID));
 
-				if (aNewLength > myLength)
+				if (auto it = aEntityIDMap.find(id); it != aEntityIDMap.end())
 				{
-					memset((byte*)newBuffer.data + (myLength * myFieldInfo->size), 0, (aNewLength - myLength) * myFieldInfo->size);
+					memcpy(ids + i * sizeof(UUID), &it->second, sizeof(UUID));
 				}
+			}
+		}
+	}
+
+	const FieldStorageBlock::FieldLayout* FieldStorageBlock::FindField(uint32_t aFieldID) const
+	{
+		for (const FieldLayout& field : myFields)
+		{
+			if (field.id == aFieldID)
+			{
+				return &field;
+			}
+		}
+
+		return nullptr;
+	}
+
+	void FieldStorageBlock::WriteDefaults(uint32_t aRow)
+	{
+		if (myStride == 0)
+		{
+			return;
+		}
+
+		memcpy(myRows.data() + (size_t)aRow * myStride, myDefaultRow.data(), myStride);
+
+		for (const FieldLayout& field : myFields)
+		{
+			if (!field.isVariable)
+			{
+				continue;
+			}
+
+			const uint32_t slot = AllocateVariableSlot();
+			*(uint32_t*)GetFieldData(aRow, field) = slot;
+
+			if (field.fieldInfo->defaultValueBuffer)
+			{
+				myVariableData[slot] = Buffer::Copy(field.fieldInfo->defaultValueBuffer);
+			}
+		}
+	}
+
+	void FieldStorageBlock::ReleaseVariableData(uint32_t aRow)
+	{
+		for (const FieldLayout& field : myFields)
+		{
+			if (!field.isVariable)
+			{
+				continue;
+			}
+
+			const uint32_t slot = *(const uint32_t*)GetFieldData(aRow, field);
+			myVariableData[slot].Release();
+			myFreeVariableSlots.push_back(slot);
+		}
+	}
+
+	uint32_t FieldStorageBlock::AllocateVariableSlot()
+	{
+		if (!myFreeVariableSlots.empty())
+		{
+			const uint32_t slot = myFreeVariableSlots.back();
+			myFreeVariableSlots.pop_back();
+			return slot;
+		}
+
+		myVariableData.emplace_back();
+		return (uint32_t)myVariableData.size() - 1;
+	}
+
+	Buffer FieldStorageBase::GetValueBuffer() const
+	{
+		return myField->isArray ? AsArray().GetValueBuffer() : AsField().GetValueBuffer();
+	}
+
+	void FieldStorageBase::SetValueBuffer(const Buffer& aBuffer)
+	{
+		if (myField->isArray)
+		{
+			AsArray().SetValueBuffer(aBuffer);
+		}
+		else
+		{
+			AsField().SetValueBuffer(aBuffer);
+		}
+	}
+
+	Buffer FieldStorage::GetValueBuffer() const
+	{
+		if (GetRuntimeInstance() == nullptr)
+		{
+			return myField->isVariable ? GetVariableData() : Buffer(GetData(), myField->size);
+		}
+
+		Buffer result;
+		MonoObject* runtimeObject = GCManager::GetReferencedObject(GetRuntimeInstance());
+		if (runtimeObject != nullptr)
+		{
+			result = ScriptUtils::GetFieldValue(runtimeObject, myFieldInfo->name, myFieldInfo->type, myFieldInfo->isProperty);
+		}
+		return result;
+	}
+
+	void FieldStorage::SetValueBuffer(const Buffer& aBuffer)
+	{
+		if (GetRuntimeInstance() != nullptr)
+		{
+			SetValueRuntime(aBuffer.data);
+			return;
+		}
+
+		if (!aBuffer)
+		{
+			return;
+		}
+
+		if (myField->isVariable)
+		{
+			SetStoredString((const char*)aBuffer.data, strnlen((const char*)aBuffer.data, aBuffer.size));
+		}
+		else
+		{
+			memcpy(GetData(), aBuffer.data, aBuffer.size < myField->size ? aBuffer.size : myField->size);
+		}
+	}
+
+	void FieldStorage::UploadToRuntime()
+	{
+		if (myField->isVariable)
+		{
+			const Buffer& stringBuffer = GetVariableData();
+			SetValueRuntime(stringBuffer ? (const char*)stringBuffer.data : "");
+		}
+		else
+		{
+			SetValueRuntime(GetData());
+		}
+	}
+
+	void FieldStorage::SetStoredString(const char* aString, size_t aLength)
+	{
+		Buffer& stringBuffer = GetVariableData();
+		if (stringBuffer.size <= aLength)
+		{
+			stringBuffer.Release();
+			stringBuffer.Allocate((aLength * 2 + 1) * sizeof(char));
+		}
+
+		stringBuffer.ZeroInitialize();
+		memcpy(stringBuffer.data, aString, aLength * sizeof(char));
+	}
+
+	void FieldStorage::GetValueRuntime(void* outData, uint32_t aSize) const
+	{
+		MonoObject* runtimeObject = GCManager::GetReferencedObject(GetRuntimeInstance());
+		if (runtimeObject == nullptr)
+		{
+			return;
+		}
+
+		// Plain value fields are read straight into outData, anything else has to go through the boxed object
+		if (!myFieldInfo->isProperty && FieldUtils::IsPrimitiveType(myFieldInfo->type) && aSize == myFieldInfo->size)
+		{
+			MonoClassField* field = mono_class_get_field_from_name(mono_object_get_class(runtimeObject), myFieldInfo->name.c_str());
+			mono_field_get_value(runtimeObject, field, outData);
+			return;
+		}
+
+		if (aSize < FieldUtils::GetFieldTypeSize(myFieldInfo->type))
+		{
+			return;
+		}
+
+		ScriptUtils::MonoObjectToValue(ScriptUtils::GetFieldValueObject(runtimeObject, myFieldInfo->name, myFieldInfo->isProperty), myFieldInfo->type, outData);
+	}
+
+	std::string FieldStorage::GetStringRuntime() const
+	{
+		MonoObject* runtimeObject = GCManager::GetReferencedObject(GetRuntimeInstance());
+		if (runtimeObject == nullptr)
+		{
+			return std::string();
+		}
+
+		MonoObject* stringObject = ScriptUtils::GetFieldValueObject(runtimeObject, myFieldInfo->name, myFieldInfo->isProperty);
+		if (stringObject == nullptr)
+		{
+			return std::string();
+		}
+
+		return ScriptUtils::MonoStringToUTF8((MonoString*)stringObject);
+	}
+
+	void FieldStorage::SetValueRuntime(const void* aData)
+	{
+		if (GetRuntimeInstance() == nullptr)
+		{
+			return;
+		}
+
+		MonoObject* runtimeObject = GCManager::GetReferencedObject(GetRuntimeInstance());
+		ScriptUtils::SetFieldValue(runtimeObject, myFieldInfo, aData);
+	}
+
+
+	uint32_t ArrayFieldStorage::GetLength() const
+	{
+		if (GetRuntimeInstance() != nullptr)
+		{
+			return GetLengthRuntime();
+		}
+
+		if (myFieldInfo->type == FieldType::String)
+		{
+			return 0;
+		}
+
+		return (uint32_t)(GetVariableData().size / myFieldInfo->size);
+	}
+
+	Buffer ArrayFieldStorage::GetValueBuffer() const
+	{
+		if (myFieldInfo->type == FieldType::String)
+		{
+			return Buffer();
+		}
+
+		if (GetRuntimeInstance() == nullptr)
+		{
+			return GetVariableData();
+		}
+
+		Buffer result;
+		GetRuntimeArray(result);
+		return result;
+	}
+
+	void ArrayFieldStorage::SetValueBuffer(const Buffer& aBuffer)
+	{
+		if (myFieldInfo->type == FieldType::String)
+		{
+			return;
+		}
+
+		if (GetRuntimeInstance() != nullptr)
+		{
+			SetRuntimeArray(aBuffer);
+			return;
+		}
+
+		Buffer& dataBuffer = GetVariableData();
+		dataBuffer.Release();
+		dataBuffer = Buffer::Copy(myFieldInfo->defaultValueBuffer);
 
-				myDataBuffer.Release();
-				myDataBuffer = newBuffer;
+		if (dataBuffer.size < aBuffer.size)
+		{
+			dataBuffer.Release();
+			dataBuffer = Buffer::Copy(aBuffer);
+		}
+		else if (aBuffer)
+		{
+			dataBuffer.Write(aBuffer.data, aBuffer.size);
+		}
+	}
+
+	void ArrayFieldStorage::UploadToRuntime()
+	{
+		if (myFieldInfo->type == FieldType::String)
+		{
+			return;
+		}
+
+		SetRuntimeArray(GetVariableData());
+	}
+
+	void ArrayFieldStorage::Resize(uint32_t aNewLength)
+	{
+		if (myFieldInfo->type == FieldType::String)
+		{
+			return;
+		}
+
+		if (GetRuntimeInstance() == nullptr)
+		{
+			Buffer& dataBuffer = GetVariableData();
+			const uint32_t length = (uint32_t)(dataBuffer.size / myFieldInfo->size);
+
+			Buffer newBuffer;
+			newBuffer.Allocate(aNewLength * myFieldInfo->size);
+			newBuffer.ZeroInitialize();
+
+			if (dataBuffer)
+			{
+				uint32_t copyLength = aNewLength < length ? aNewLength : length;
+				memcpy(newBuffer.data, dataBuffer.data, copyLength * myFieldInfo->size);
 			}
 
-			myLength = aNewLength;
+			dataBuffer.Release();
+			dataBuffer = newBuffer;
 		}
 		else
 		{
-			MonoObject* runtimeObject = GCManager::GetReferencedObject(myRuntimeInstance);
+			MonoObject* runtimeObject = GCManager::GetReferencedObject(GetRuntimeInstance());
 			MonoClassField* field = mono_class_get_field_from_name(mono_object_get_class(runtimeObject), myFieldInfo->name.c_str());
 			MonoClass* elementClass = mono_class_get_element_class(mono_type_get_class(mono_field_get_type(field)));
 			MonoArray* arrayObject = (MonoArray*)mono_field_get_value_object(ScriptEngine::GetScriptDomain(), field, runtimeObject);
@@ -97,28 +546,24 @@ namespace Epoch
 
 	void ArrayFieldStorage::RemoveAt(uint32_t aIndex)
 	{
-		if (myRuntimeInstance == nullptr)
+		if (GetRuntimeInstance() == nullptr)
 		{
+			Buffer& dataBuffer = GetVariableData();
+			const uint32_t length = (uint32_t)(dataBuffer.size / myFieldInfo->size);
+			EPOCH_ASSERT(aIndex < length, "Index out of range");
+
 			Buffer newBuffer;
-			newBuffer.Allocate((myLength - 1) * myFieldInfo->size);
+			newBuffer.Allocate((length - 1) * myFieldInfo->size);
 
-			if (aIndex != 0)
-			{
-				memcpy(newBuffer.data, myDataBuffer.data, aIndex * myFieldInfo->size);
-				memcpy((byte*)newBuffer.data + (aIndex * myFieldInfo->size), (byte*)myDataBuffer.data + ((aIndex + 1) * myFieldInfo->size), (myLength - aIndex - 1) * myFieldInfo->size);
-			}
-			else
-			{
-				memcpy(newBuffer.data, (byte*)myDataBuffer.data + myFieldInfo->size, (myLength - 1) * myFieldInfo->size);
-			}
+			memcpy(newBuffer.data, dataBuffer.data, aIndex * myFieldInfo->size);
+			memcpy((byte*)newBuffer.data + (aIndex * myFieldInfo->size), (byte*)dataBuffer.data + ((aIndex + 1) * myFieldInfo->size), (length - aIndex - 1) * myFieldInfo->size);
 
-			myDataBuffer.Release();
-			myDataBuffer = Buffer::Copy(newBuffer);
-			myLength--;
+			dataBuffer.Release();
+			dataBuffer = newBuffer;
 		}
 		else
 		{
-			MonoObject* runtimeObject = GCManager::GetReferencedObject(myRuntimeInstance);
+			MonoObject* runtimeObject = GCManager::GetReferencedObject(GetRuntimeInstance());
 			MonoClassField* field = mono_class_get_field_from_name(mono_object_get_class(runtimeObject), myFieldInfo->name.c_str());
 			MonoArray* arrayObject = (MonoArray*)mono_field_get_value_object(ScriptEngine::GetScriptDomain(), field, runtimeObject);
 			uint32_t length = (uint32_t)mono_array_length(arrayObject);
@@ -158,12 +603,12 @@ namespace Epoch
 
 	bool ArrayFieldStorage::GetRuntimeArray(Buffer& outData) const
 	{
-		if (myRuntimeInstance == nullptr)
+		if (GetRuntimeInstance() == nullptr)
 		{
 			return false;
 		}
 
-		MonoObject* runtimeObject = GCManager::GetReferencedObject(myRuntimeInstance);
+		MonoObject* runtimeObject = GCManager::GetReferencedObject(GetRuntimeInstance());
 		MonoClassField* field = mono_class_get_field_from_name(mono_object_get_class(runtimeObject), myFieldInfo->name.c_str());
 		MonoArray* arrayObject = (MonoArray*)mono_field_get_value_object(ScriptEngine::GetScriptDomain(), field, runtimeObject);
 		
@@ -206,7 +651,7 @@ namespace Epoch
 
 	void ArrayFieldStorage::SetRuntimeArray(const Buffer& aData)
 	{
-		if (myRuntimeInstance == nullptr)
+		if (GetRuntimeInstance() == nullptr)
 		{
 			return;
 		}
@@ -216,7 +661,7 @@ namespace Epoch
 			return;
 		}
 
-		MonoObject* runtimeObject = GCManager::GetReferencedObject(myRuntimeInstance);
+		MonoObject* runtimeObject = GCManager::GetReferencedObject(GetRuntimeInstance());
 
 		if (runtimeObject == nullptr)
 		{
@@ -230,11 +675,12 @@ namespace Epoch
 		MonoClass* fieldElementClass = mono_class_get_element_class(fieldTypeClass);
 		MonoType* elementType = mono_class_get_type(fieldElementClass);
 
-		MonoArray* arr = mono_array_new(ScriptEngine::GetScriptDomain(), fieldElementClass, myLength);
+		const uint32_t length = (uint32_t)(aData.size / myFieldInfo->size);
+		MonoArray* arr = mono_array_new(ScriptEngine::GetScriptDomain(), fieldElementClass, length);
 
 		if (mono_type_is_reference(elementType) || mono_type_is_byref(elementType))
 		{
-			for (uint32_t i = 0; i < myLength; i++)
+			for (uint32_t i = 0; i < length; i++)
 			{
 				if (myFieldInfo->type == FieldType::String)
 				{
@@ -252,7 +698,7 @@ namespace Epoch
 		}
 		else
 		{
-			for (uint32_t i = 0; i < myLength; i++)
+			for (uint32_t i = 0; i < length; i++)
 			{
 				char* dst = mono_array_addr_with_size(arr, (int)myFieldInfo->size, i);
 				memcpy(dst, static_cast<std::byte*>(aData.data) + i * myFieldInfo->size, myFieldInfo->size);
@@ -264,12 +710,12 @@ namespace Epoch
 
 	void ArrayFieldStorage::GetValueRuntime(uint32_t aIndex, void* aData) const
 	{
-		if (myRuntimeInstance == nullptr)
+		if (GetRuntimeInstance() == nullptr)
 		{
 			return;
 		}
 
-		MonoObject* runtimeObject = GCManager::GetReferencedObject(myRuntimeInstance);
+		MonoObject* runtimeObject = GCManager::GetReferencedObject(GetRuntimeInstance());
 		MonoClassField* field = mono_class_get_field_from_name(mono_object_get_class(runtimeObject), myFieldInfo->name.c_str());
 		MonoArray* arrayObject = (MonoArray*)mono_field_get_value_object(ScriptEngine::GetScriptDomain(), field, runtimeObject);
 
@@ -302,12 +748,12 @@ namespace Epoch
 
 	void ArrayFieldStorage::SetValueRuntime(uint32_t aIndex, const void* aData)
 	{
-		if (myRuntimeInstance == nullptr)
+		if (GetRuntimeInstance() == nullptr)
 		{
 			return;
 		}
 
-		MonoObject* runtimeObject = GCManager::GetReferencedObject(myRuntimeInstance);
+		MonoObject* runtimeObject = GCManager::GetReferencedObject(GetRuntimeInstance());
 		MonoClassField* field = mono_class_get_field_from_name(mono_object_get_class(runtimeObject), myFieldInfo->name.c_str());
 		MonoArray* arrayObject = (MonoArray*)mono_field_get_value_object(ScriptEngine::GetScriptDomain(), field, runtimeObject);
 
@@ -330,12 +776,12 @@ namespace Epoch
 
 	uint32_t ArrayFieldStorage::GetLengthRuntime() const
 	{
-		if (myRuntimeInstance == nullptr)
+		if (GetRuntimeInstance() == nullptr)
 		{
 			return 0;
 		}
 
-		MonoObject* runtimeObject = GCManager::GetReferencedObject(myRuntimeInstance);
+		MonoObject* runtimeObject = GCManager::GetReferencedObject(GetRuntimeInstance());
 		MonoClassField* field = mono_class_get_field_from_name(mono_object_get_class(runtimeObject), myFieldInfo->name.c_str());
 		MonoArray* arrayObject = (MonoArray*)mono_field_get_value_object(ScriptEngine::GetScriptDomain(), field, runtimeObject);
 
@@ -201,82 +201,143 @@ namespace Epoch
 		}
 	}
 
+	// The stored field values of every entity using one script class.
+	// Each entity gets a row where the fixed size values sit at offsets laid out from the FieldInfo sizes,
+	// strings and arrays are kept in a side arena and their row entry is the slot in that arena.
+	class FieldStorageBlock
+	{
+	public:
+		struct FieldLayout
+		{
+			FieldInfo* fieldInfo = nullptr;
+			uint32_t id = 0;
+			uint32_t offset = 0;
+			uint32_t size = 0;
+			FieldType type = FieldType::Void;
+			bool isArray = false;
+
+			// Strings and arrays, the row only holds a uint32_t slot in the arena
+			bool isVariable = false;
+		};
+
+		FieldStorageBlock(const ManagedClass& aClass);
+		~FieldStorageBlock();
+
+		FieldStorageBlock(const FieldStorageBlock&) = delete;
+		FieldStorageBlock& operator=(const FieldStorageBlock&) = delete;
+
+		uint32_t AllocateRow();
+		void FreeRow(uint32_t aRow);
+		void ResetRow(uint32_t aRow);
+		void CopyRow(uint32_t aDstRow, uint32_t aSrcRow);
+
+		// Pushes the stored values to the instance, stored values aren't updated when the instance goes away
+		void SetRuntimeInstance(uint32_t aRow, GCHandle aInstance);
+		GCHandle GetRuntimeInstance(uint32_t aRow) const { return myRuntimeInstances[aRow]; }
+
+		void RemapEntityReferences(uint32_t aRow, const std::unordered_map<UUID, UUID>& aEntityIDMap);
+
+		const FieldLayout* FindField(uint32_t aFieldID) const;
+		const std::vector<FieldLayout>& GetFields() const { return myFields; }
+
+		byte* GetFieldData(uint32_t aRow, const FieldLayout& aField) { return myRows.data() + (size_t)aRow * myStride + aField.offset; }
+		const byte* GetFieldData(uint32_t aRow, const FieldLayout& aField) const { return myRows.data() + (size_t)aRow * myStride + aField.offset; }
+
+		Buffer& GetVariableData(uint32_t aRow, const FieldLayout& aField) { return myVariableData[*(const uint32_t*)GetFieldData(aRow, aField)]; }
+		const Buffer& GetVariableData(uint32_t aRow, const FieldLayout& aField) const { return myVariableData[*(const uint32_t*)GetFieldData(aRow, aField)]; }
+
+		uint32_t GetRowCount() const { return (uint32_t)(myRuntimeInstances.size() - myFreeRows.size()); }
+
+	private:
+		void WriteDefaults(uint32_t aRow);
+		void ReleaseVariableData(uint32_t aRow);
+		uint32_t AllocateVariableSlot();
+
+	private:
+		std::vector<FieldLayout> myFields;
+		std::vector<uint32_t> myEntityFields;
+		uint32_t myStride = 0;
+
+		std::vector<byte> myRows;
+		std::vector<byte> myDefaultRow;
+		std::vector<GCHandle> myRuntimeInstances;
+		std::vector<uint32_t> myFreeRows;
+
+		std::vector<Buffer> myVariableData;
+		std::vector<uint32_t> myFreeVariableSlots;
+	};
+
+	class FieldStorage;
+	class ArrayFieldStorage;
+
+	// Field storages are views of a row in a FieldStorageBlock, they are only valid as long as the entity keeps its script.
+	// They are small values meant to be passed around by copy, a default constructed view refers to no field.
 	class FieldStorageBase
 	{
 	public:
-		FieldStorageBase(FieldInfo* aFieldInfo) : myFieldInfo(aFieldInfo) {}
+		FieldStorageBase() = default;
+		FieldStorageBase(FieldStorageBlock* aBlock, uint32_t aRow, const FieldStorageBlock::FieldLayout* aField) : myFieldInfo(aField->fieldInfo), myBlock(aBlock), myRow(aRow), myField(aField) {}
 
-		virtual void SetRuntimeInstance(GCHandle aInstance) = 0;
-		virtual void CopyFrom(const std::shared_ptr<FieldStorageBase>& aOther) = 0;
+		explicit operator bool() const { return myField != nullptr; }
 
-		virtual Buffer GetValueBuffer() const = 0;
-		virtual void SetValueBuffer(const Buffer& aBuffer) = 0;
+		bool IsArray() const { return myField->isArray; }
+		FieldStorage AsField() const;
+		ArrayFieldStorage AsArray() const;
+
+		// Forwards to the field or array version depending on the field
+		Buffer GetValueBuffer() const;
+		void SetValueBuffer(const Buffer& aBuffer);
 
 		const FieldInfo* GetFieldInfo() const { return myFieldInfo; }
 
+	protected:
+		GCHandle GetRuntimeInstance() const { return myBlock->GetRuntimeInstance(myRow); }
+		byte* GetData() const { return myBlock->GetFieldData(myRow, *myField); }
+		Buffer& GetVariableData() const { return myBlock->GetVariableData(myRow, *myField); }
+
 	protected:
 		FieldInfo* myFieldInfo = nullptr;
+		FieldStorageBlock* myBlock = nullptr;
+		uint32_t myRow = 0;
+		const FieldStorageBlock::FieldLayout* myField = nullptr;
 	};
 
 	class FieldStorage : public FieldStorageBase
 	{
 	public:
-		FieldStorage(FieldInfo* aFieldInfo) : FieldStorageBase(aFieldInfo)
-		{
-			myDataBuffer = Buffer::Copy(aFieldInfo->defaultValueBuffer);
-		}
+		FieldStorage() = default;
+		FieldStorage(FieldStorageBlock* aBlock, uint32_t aRow, const FieldStorageBlock::FieldLayout* aField) : FieldStorageBase(aBlock, aRow, aField) {}
 
 		template<typename T>
 		T GetValue() const
 		{
-			if (myRuntimeInstance != nullptr)
-			{
-				Buffer valueBuffer;
-				bool success = GetValueRuntime(valueBuffer);
-
-				if (!success)
-				{
-					return T();
-				}
-
-				T value = T();
-				memcpy(&value, valueBuffer.data, valueBuffer.size);
-				valueBuffer.Release();
-				return value;
-			}
+			T value = T();
 
-			if (!myDataBuffer)
+			if (GetRuntimeInstance() != nullptr)
 			{
-				return T();
+				GetValueRuntime(&value, sizeof(T));
+				return value;
 			}
 
-			return *(myDataBuffer.As<T>());
+			memcpy(&value, GetData(), sizeof(T) < myField->size ? sizeof(T) : myField->size);
+			return value;
 		}
 
 		template<>
 		std::string GetValue() const
 		{
-			if (myRuntimeInstance != nullptr)
+			if (GetRuntimeInstance() != nullptr)
 			{
-				Buffer valueBuffer;
-				bool success = GetValueRuntime(valueBuffer);
-
-				if (!success)
-				{
-					return std::string();
-				}
-
-				std::string value((char*)valueBuffer.data, valueBuffer.size / sizeof(char));
-				valueBuffer.Release();
-				return value;
+				return GetStringRuntime();
 			}
 
-			if (!myDataBuffer)
+			const Buffer& stringBuffer = GetVariableData();
+			if (!stringBuffer)
 			{
 				return std::string();
 			}
 
-			return std::string((char*)myDataBuffer.data);
+			return std::string((char*)stringBuffer.data);
 		}
 
 		template<typename T>
@@ -284,137 +345,67 @@ namespace Epoch
 		{
 			EPOCH_ASSERT(sizeof(T) == myFieldInfo->size, "Not same size!");
 
-			if (myRuntimeInstance != nullptr)
+			if (GetRuntimeInstance() != nullptr)
 			{
 				SetValueRuntime(&aValue);
 			}
 			else
 			{
-				if (!myDataBuffer)
-				{
-					myDataBuffer.Allocate(myFieldInfo->size);
-				}
-				myDataBuffer.Write(&aValue, sizeof(T));
+				memcpy(GetData(), &aValue, sizeof(T));
 			}
 		}
 
 		template<>
 		void SetValue<std::string>(const std::string& aValue)
 		{
-			if (myRuntimeInstance != nullptr)
+			if (GetRuntimeInstance() != nullptr)
 			{
-				SetValueRuntime(&aValue);
+				SetValueRuntime(aValue.c_str());
 			}
 			else
 			{
-				if (myDataBuffer.size <= aValue.length() * sizeof(char))
-				{
-					myDataBuffer.Release();
-					myDataBuffer.Allocate((aValue.length() * 2) * sizeof(char));
-				}
-				
-				myDataBuffer.ZeroInitialize();
-				strcpy((char*)myDataBuffer.data, aValue.c_str());
+				SetStoredString(aValue.c_str(), aValue.length());
 			}
 		}
 
-		virtual void SetRuntimeInstance(GCHandle aInstance) override
-		{
-			myRuntimeInstance = aInstance;
-
-			if (myRuntimeInstance)
-			{
-				if (myFieldInfo->type == FieldType::String)
-				{
-					std::string str((char*)myDataBuffer.data, myDataBuffer.size / sizeof(char));
-					SetValueRuntime(&str);
-				}
-				else
-				{
-					SetValueRuntime(myDataBuffer.data);
-				}
-			}
-		}
-
-		virtual void CopyFrom(const std::shared_ptr<FieldStorageBase>& aOther)
-		{
-			std::shared_ptr<FieldStorage> fieldStorage = std::dynamic_pointer_cast<FieldStorage>(aOther);
+		Buffer GetValueBuffer() const;
+		void SetValueBuffer(const Buffer& aBuffer);
 
-			if (myRuntimeInstance != nullptr)
-			{
-				Buffer valueBuffer;
-				if (fieldStorage->GetValueRuntime(valueBuffer))
-				{
-					SetValueRuntime(valueBuffer.data);
-					valueBuffer.Release();
-				}
-			}
-			else
-			{
-				myDataBuffer.Release();
-				myDataBuffer = Buffer::Copy(fieldStorage->myDataBuffer);
-			}
-		}
-
-		virtual Buffer GetValueBuffer() const override
-		{
-			if (myRuntimeInstance == nullptr)
-			{
-				return myDataBuffer;
-			}
+	private:
+		friend class FieldStorageBlock;
 
-			Buffer result;
-			GetValueRuntime(result);
-			return result;
-		}
+		void UploadToRuntime();
+		void SetStoredString(const char* aString, size_t aLength);
 
-		virtual void SetValueBuffer(const Buffer& aBuffer)
-		{
-			if (myRuntimeInstance != nullptr)
-			{
-				SetValueRuntime(aBuffer.data);
-			}
-			else
-			{
-				myDataBuffer = Buffer::Copy(aBuffer);
-			}
-		}
-
-	private:
-		bool GetValueRuntime(Buffer& outBuffer) const;
+		void GetValueRuntime(void* outData, uint32_t aSize) const;
+		std::string GetStringRuntime() const;
 		void SetValueRuntime(const void* aData);
-
-	private:
-		Buffer myDataBuffer;
-		GCHandle myRuntimeInstance = nullptr;
 	};
 
 	class ArrayFieldStorage : public FieldStorageBase
 	{
 	public:
-		ArrayFieldStorage(FieldInfo* fieldInfo) : FieldStorageBase(fieldInfo)
-		{
-			myDataBuffer = Buffer::Copy(fieldInfo->defaultValueBuffer);
-			myLength = (uint32_t)(myDataBuffer.size / myFieldInfo->size);
-		}
+		ArrayFieldStorage() = default;
+		ArrayFieldStorage(FieldStorageBlock* aBlock, uint32_t aRow, const FieldStorageBlock::FieldLayout* aField) : FieldStorageBase(aBlock, aRow, aField) {}
 
 		template<typename T>
 		T GetValue(uint32_t aIndex) const
 		{
-			if (myRuntimeInstance != nullptr)
+			if (GetRuntimeInstance() != nullptr)
 			{
 				T value = T();
 				GetValueRuntime(aIndex, &value);
 				return value;
 			}
 
-			if (!myDataBuffer)
+			const Buffer& dataBuffer = GetVariableData();
+			if (!dataBuffer)
 			{
 				return T();
 			}
 
 			uint32_t offset = aIndex * sizeof(T);
-			return myDataBuffer.Read<T>(offset);
+			return dataBuffer.Read<T>(offset);
 		}
 
 		template<>
@@ -428,137 +419,55 @@ namespace Epoch
 		{
 			EPOCH_ASSERT(sizeof(T) == myFieldInfo->size);
 
-			if (myRuntimeInstance != nullptr)
+			if (GetRuntimeInstance() != nullptr)
 			{
 				SetValueRuntime(aIndex, &aValue);
 			}
 			else
 			{
-				myDataBuffer.Write(&aValue, sizeof(T), aIndex * sizeof(T));
+				GetVariableData().Write(&aValue, sizeof(T), aIndex * sizeof(T));
 			}
 		}
 
+		// String arrays are only supported on the runtime instance
 		template<>
 		void SetValue<std::string>(uint32_t aIndex, const std::string& aValue)
 		{
-			if (myRuntimeInstance != nullptr)
-			{
-				SetValueRuntime(aIndex, &aValue);
-			}
-			else
+			if (GetRuntimeInstance() != nullptr)
 			{
-				auto& stringBuffer = (Buffer&)myDataBuffer[aIndex * sizeof(Buffer)];
-				if (stringBuffer.size != aValue.size())
-				{
-					stringBuffer.Release();
-					stringBuffer.Allocate((aValue.length() * 2) * sizeof(char));
-				}
-
-				stringBuffer.ZeroInitialize();
-				memcpy(stringBuffer.data, aValue.c_str(), aValue.length() * sizeof(char));
-			}
-		}
-
-		virtual void SetRuntimeInstance(GCHandle aInstance) override
-		{
-			myRuntimeInstance = aInstance;
-
-			if (myFieldInfo->type == FieldType::String)
-				return;
-
-			if (myRuntimeInstance)
-			{
-				SetRuntimeArray(myDataBuffer);
-			}
-		}
-
-		virtual void CopyFrom(const std::shared_ptr<FieldStorageBase>& aOther)
-		{
-			std::shared_ptr<ArrayFieldStorage> fieldStorage = std::dynamic_pointer_cast<ArrayFieldStorage>(aOther);
-
-			if (myFieldInfo->type == FieldType::String)
-			{
-				return;
-			}
-
-			if (myRuntimeInstance != nullptr)
-			{
-				Buffer valueBuffer;
-				if (fieldStorage->GetRuntimeArray(valueBuffer))
-				{
-					SetRuntimeArray(valueBuffer);
-					valueBuffer.Release();
-				}
-			}
-			else
-			{
-				myDataBuffer.Release();
-				myDataBuffer = Buffer::Copy(fieldStorage->myDataBuffer);
+				SetValueRuntime(aIndex, aValue.c_str());
 			}
 		}
 
 		void Resize(uint32_t aNewLength);
 		void RemoveAt(uint32_t aIndex);
 
-		uint32_t GetLength() const { return myRuntimeInstance != nullptr ? GetLengthRuntime() : myLength; }
-
-		virtual Buffer GetValueBuffer() const override
-		{
-			if (myFieldInfo->type == FieldType::String)
-			{
-				return Buffer();
-			}
-
-			if (myRuntimeInstance == nullptr)
-			{
-				return myDataBuffer;
-			}
+		uint32_t GetLength() const;
 
-			Buffer result;
-			GetRuntimeArray(result);
-			return result;
-		}
-
-		virtual void SetValueBuffer(const Buffer& aBuffer)
-		{
-			if (myFieldInfo->type == FieldType::String)
-			{
-				return;
-			}
-
-			if (myRuntimeInstance != nullptr)
-			{
-				SetRuntimeArray(aBuffer);
-				myLength = (uint32_t)(aBuffer.size / myFieldInfo->size);
-			}
-			else
-			{
-				myDataBuffer = Buffer::Copy(myFieldInfo->defaultValueBuffer);
-
-				if (myDataBuffer.size < aBuffer.size)
-				{
-					myDataBuffer.Release();
-					myDataBuffer = Buffer::Copy(aBuffer);
-				}
-				else
-				{
-					myDataBuffer.Write(aBuffer.data, aBuffer.size);
-				}
-
-				myLength = (uint32_t)(myDataBuffer.size / myFieldInfo->size);
-			}
-		}
+		Buffer GetValueBuffer() const;
+		void SetValueBuffer(const Buffer& aBuffer);
 		
 	private:
+		friend class FieldStorageBlock;
+
+		void UploadToRuntime();
+
 		bool GetRuntimeArray(Buffer& outData) const;
 		void SetRuntimeArray(const Buffer& aData);
 		void GetValueRuntime(uint32_t aIndex, void* aData) const;
 		void SetValueRuntime(uint32_t aIndex, const void* aData);
 		uint32_t GetLengthRuntime() const;
-
-	private:
-		Buffer myDataBuffer;
-		uint32_t myLength = 0;
-		GCHandle myRuntimeInstance = nullptr;
 	};
+
+	inline FieldStorage FieldStorageBase::AsField() const
+	{
+		EPOCH_ASSERT(!myField || !myField->isArray, "Field is an array!");
+		return myField ? FieldStorage(myBlock, myRow, myField) : FieldStorage();
+	}
+
+	inline ArrayFieldStorage FieldStorageBase::AsArray() const
+	{
+		EPOCH_ASSERT(!myField || myField->isArray, "Field is not an array!");
+		return myField ? ArrayFieldStorage(myBlock, myRow, myField) : ArrayFieldStorage();
+	}
 }
@@ -18,6 +18,7 @@
 #include "ScriptAsset.h"
 #include "ScriptBuilder.h"
 #include "ScriptUtils.h"
+#include "Epoch/Debug/MemoryTracker.h"
 
 namespace Epoch
 {
@@ -52,7 +53,15 @@ namespace Epoch
 		ScriptInstanceMap scriptInstances;
 		std::stack<Entity> runtimeDuplicatedScriptEntities;
 
-		std::unordered_map<UUID, std::unordered_map<uint32_t, std::shared_ptr<FieldStorageBase>>> fieldMap;
+		struct FieldStorageRow
+		{
+			FieldStorageBlock* block = nullptr;
+			uint32_t row = 0;
+		};
+
+		// One block of stored field values per script class, every script entity has a row in the block of its class
+		std::unordered_map<uint32_t, std::unique_ptr<FieldStorageBlock>> fieldStorageBlocks;
+		std::unordered_map<UUID, FieldStorageRow> fieldStorageRows;
 		
 		std::unique_ptr<filewatch::FileWatch<std::wstring>> watcherHandle = nullptr;
 	};
@@ -101,7 +110,8 @@ namespace Epoch
 		}
 
 		staticData->scriptEntities.clear();
-		staticData->fieldMap.clear();
+		staticData->fieldStorageRows.clear();
+		staticData->fieldStorageBlocks.clear();
 
 		staticData->sceneContext = nullptr;
 
@@ -351,21 +361,21 @@ namespace Epoch
 			
 			for (auto fieldID : sc.fieldIDs)
 			{
-				std::shared_ptr<FieldStorageBase> storage = staticData->fieldMap[entityID][fieldID];
+				FieldStorageBase storage = GetFieldStorage(entity, fieldID);
 			
 				if (!storage)
 				{
 					continue;
 				}
 			
-				const FieldInfo* fieldInfo = storage->GetFieldInfo();
+				const FieldInfo* fieldInfo = storage.GetFieldInfo();
 			
 				if (!fieldInfo->IsWritable())
 				{
 					continue;
 				}
 			
-				oldFieldValues[entityID][fieldID] = Buffer::Copy(storage->GetValueBuffer());
+				oldFieldValues[entityID][fieldID] = Buffer::Copy(storage.GetValueBuffer());
 			}
 
 			ShutdownScriptEntity(entity, false);
@@ -375,6 +385,10 @@ namespace Epoch
 
 		staticData->scriptEntities.clear();
 
+		// The field layout of the classes can change with the new assembly
+		staticData->fieldStorageRows.clear();
+		staticData->fieldStorageBlocks.clear();
+
 		bool loaded = LoadAppAssembly();
 
 		
@@ -387,14 +401,14 @@ namespace Epoch
 		
 			for (auto& [fieldID, fieldValue] : fieldMap)
 			{
-				std::shared_ptr<FieldStorageBase> storage = staticData->fieldMap[entityID][fieldID];
+				FieldStorageBase storage = GetFieldStorage(entity, fieldID);
 		
 				if (!storage)
 				{
 					continue;
 				}
 		
-				storage->SetValueBuffer(fieldValue);
+				storage.SetValueBuffer(fieldValue);
 				fieldValue.Release();
 			}
 		}
@@ -426,6 +440,8 @@ namespace Epoch
 		}
 		staticData->scriptEntities.clear();
 		staticData->scriptInstances.clear();
+		staticData->fieldStorageRows.clear();
+		staticData->fieldStorageBlocks.clear();
 
 		ScriptCache::ClearCache();
 		UnloadAssembly(staticData->appAssemblyInfo);
@@ -470,34 +486,43 @@ namespace Epoch
 			return;
 		}
 
+		std::unique_ptr<FieldStorageBlock>& block = staticData->fieldStorageBlocks[managedClass->id];
+		if (!block)
+		{
+			block = std::make_unique<FieldStorageBlock>(*managedClass);
+		}
+
 		for (auto fieldID : managedClass->fields)
 		{
-			FieldInfo* fieldInfo = ScriptCache::GetFieldByID(fieldID);
-		
-			if (!fieldInfo->HasFlag(FieldFlag::Public))
+			if (ScriptCache::GetFieldByID(fieldID)->HasFlag(FieldFlag::Public))
 			{
-				continue;
+				sc.fieldIDs.push_back(fieldID);
 			}
-			
-			if (fieldInfo->IsArray())
+		}
+
+		sc.methodFlags = managedClass->methodFlags;
+
+		// Entities with a row are already in scriptEntities
+		auto rowIt = staticData->fieldStorageRows.find(entityID);
+		if (rowIt != staticData->fieldStorageRows.end())
+		{
+			ScriptEngineData::FieldStorageRow& storageRow = rowIt->second;
+			if (storageRow.block == block.get())
 			{
-				staticData->fieldMap[entityID][fieldID] = std::make_shared<ArrayFieldStorage>(fieldInfo);
+				storageRow.block->ResetRow(storageRow.row);
 			}
 			else
 			{
-				staticData->fieldMap[entityID][fieldID] = std::make_shared<FieldStorage>(fieldInfo);
+				storageRow.block->FreeRow(storageRow.row);
+				storageRow.block = block.get();
+				storageRow.row = block->AllocateRow();
 			}
-		
-			sc.fieldIDs.push_back(fieldID);
-		}
 
-		sc.methodFlags = managedClass->methodFlags;
-
-		if (std::find(staticData->scriptEntities.begin(), staticData->scriptEntities.end(), entityID) != staticData->scriptEntities.end())
-		{
 			//LOG_WARNING_TAG("ScriptEngine", "Initializing a script entity that already is initialized!");
 			return;
 		}
+
+		staticData->fieldStorageRows[entityID] = { block.get(), block->AllocateRow() };
 		staticData->scriptEntities.push_back(entityID);
 	}
 
@@ -533,14 +558,9 @@ namespace Epoch
 		aEntity.GetComponent<ScriptComponent>().managedInstance = instanceHandle;
 		staticData->scriptInstances[aEntity.GetUUID()] = instanceHandle;
 
-		for (auto fieldID : scriptComponent.fieldIDs)
+		if (auto it = staticData->fieldStorageRows.find(aEntity.GetUUID()); it != staticData->fieldStorageRows.end())
 		{
-			UUID entityID = aEntity.GetUUID();
-		
-			if (staticData->fieldMap.find(entityID) != staticData->fieldMap.end())
-			{
-				staticData->fieldMap[entityID][fieldID]->SetRuntimeInstance(instanceHandle);
-			}
+			it->second.block->SetRuntimeInstance(it->second.row, instanceHandle);
 		}
 
 		CallMethod(instanceHandle, "OnCreate");
@@ -563,7 +583,11 @@ namespace Epoch
 
 		if (aErase)
 		{
-			staticData->fieldMap.erase(entityID);
+			if (auto it = staticData->fieldStorageRows.find(entityID); it != staticData->fieldStorageRows.end())
+			{
+				it->second.block->FreeRow(it->second.row);
+				staticData->fieldStorageRows.erase(it);
+			}
 			sc.fieldIDs.clear();
 
 			staticData->scriptEntities.erase(std::remove(staticData->scriptEntities.begin(), staticData->scriptEntities.end(), entityID), staticData->scriptEntities.end());
@@ -578,10 +602,9 @@ namespace Epoch
 
 		CallMethod(scriptComponent.managedInstance, "OnDestroyInternal");
 
-		for (auto fieldID : scriptComponent.fieldIDs)
+		if (auto it = staticData->fieldStorageRows.find(aEntity.GetUUID()); it != staticData->fieldStorageRows.end())
 		{
-			std::shared_ptr<FieldStorageBase> fieldStorage = staticData->fieldMap[aEntity.GetUUID()][fieldID];
-			fieldStorage->SetRuntimeInstance(nullptr);
+			it->second.block->SetRuntimeInstance(it->second.row, nullptr);
 		}
 
 		GCManager::ReleaseObjectReference(scriptComponent.managedInstance);
@@ -607,22 +630,12 @@ namespace Epoch
 		ShutdownScriptEntity(aTargetEntity);
 		InitializeScriptEntity(aTargetEntity);
 		
-		UUID targetEntityID = aTargetEntity.GetUUID();
-		UUID srcEntityID = aEntity.GetUUID();
-
-		for (auto fieldID : srcScriptComp.fieldIDs)
+		// Both entities use the same class so the stored values are a straight row copy
+		auto srcIt = staticData->fieldStorageRows.find(aEntity.GetUUID());
+		auto dstIt = staticData->fieldStorageRows.find(aTargetEntity.GetUUID());
+		if (srcIt != staticData->fieldStorageRows.end() && dstIt != staticData->fieldStorageRows.end() && srcIt->second.block == dstIt->second.block)
 		{
-			if (staticData->fieldMap.find(srcEntityID) == staticData->fieldMap.end())
-			{
-				break;
-			}
-		
-			if (staticData->fieldMap.at(srcEntityID).find(fieldID) == staticData->fieldMap.at(srcEntityID).end())
-			{
-				continue;
-			}
-		
-			staticData->fieldMap[targetEntityID][fieldID]->CopyFrom(staticData->fieldMap[srcEntityID][fieldID]);
+			dstIt->second.block->CopyRow(dstIt->second.row, srcIt->second.row);
 		}
 
 		if (staticData->sceneContext && staticData->sceneContext->IsPlaying())
@@ -635,42 +648,58 @@ namespace Epoch
 	{
 		while (staticData->runtimeDuplicatedScriptEntities.size() > 0)
 		{
-			Entity& entity = staticData->runtimeDuplicatedScriptEntities.top();
+			// Popped before initializing since OnCreate and OnStart can duplicate more entities
+			Entity entity = staticData->runtimeDuplicatedScriptEntities.top();
+			staticData->runtimeDuplicatedScriptEntities.pop();
 
 			if (!entity)
 			{
-				staticData->runtimeDuplicatedScriptEntities.pop();
 				continue;
 			}
 
 			if (!entity.HasComponent<IDComponent>())
 			{
 				CONSOLE_LOG_ERROR("Trying to initialize an invalid entity!");
-				staticData->runtimeDuplicatedScriptEntities.pop();
+				continue;
+			}
+
+			// Pooled prefab instances are initialized when the pool is created
+			if (entity.HasComponent<ScriptComponent>() && entity.GetComponent<ScriptComponent>().isRuntimeInitialized)
+			{
 				continue;
 			}
 
 			RuntimeInitializeScriptEntity(entity);
 			ScriptEngine::CallMethod(staticData->scriptInstances[entity.GetUUID()], "OnStart");
-
-			staticData->runtimeDuplicatedScriptEntities.pop();
 		}
 	}
 
-	std::shared_ptr<FieldStorageBase> ScriptEngine::GetFieldStorage(Entity aEntity, uint32_t aFieldID)
+	FieldStorageBase ScriptEngine::GetFieldStorage(Entity aEntity, uint32_t aFieldID)
 	{
-		UUID entityID = aEntity.GetUUID();
-		if (staticData->fieldMap.find(entityID) == staticData->fieldMap.end())
+		auto it = staticData->fieldStorageRows.find(aEntity.GetUUID());
+		if (it == staticData->fieldStorageRows.end())
 		{
-			return nullptr;
+			return FieldStorageBase();
 		}
 
-		if (staticData->fieldMap[entityID].find(aFieldID) == staticData->fieldMap[entityID].end())
+		const FieldStorageBlock::FieldLayout* field = it->second.block->FindField(aFieldID);
+		if (field == nullptr)
 		{
-			return nullptr;
+			return FieldStorageBase();
 		}
 
-		return staticData->fieldMap.at(entityID).at(aFieldID);
+		return FieldStorageBase(it->second.block, it->second.row, field);
+	}
+
+	void ScriptEngine::UpdateEntityReferences(Entity aEntity, const std::unordered_map<UUID, UUID>& aEntityIDMap)
+	{
+		auto it = staticData->fieldStorageRows.find(aEntity.GetUUID());
+		if (it == staticData->fieldStorageRows.end())
+		{
+			return;
+		}
+
+		it->second.block->RemapEntityReferences(it->second.row, aEntityIDMap);
 	}
 
 	std::shared_ptr<AssemblyInfo> ScriptEngine::GetCoreAssemblyInfo()
@@ -1105,7 +1134,12 @@ namespace Epoch
 	
 	void ScriptEngine::CallMethod(MonoObject* aMonoObject, ManagedMethod* aManagedMethod, const void** aParameters)
 	{
-		EPOCH_PROFILE_SCOPE(fmt::format("{}", aManagedMethod->fullName).c_str());
+		if (aManagedMethod->profilerZone == 0)
+		{
+			aManagedMethod->profilerZone = FrameProfiler::InternZone(aManagedMethod->fullName);
+		}
+		EPOCH_PROFILE_SCOPE_ID(aManagedMethod->profilerZone, aManagedMethod->fullName);
+		MemoryTagScope memoryTag(MemoryTag::Scripting);
 
 		MonoObject* exception = NULL;
 		mono_runtime_invoke(aManagedMethod->method, aMonoObject, const_cast<void**>(aParameters), &exception);
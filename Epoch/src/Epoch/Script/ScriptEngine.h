@@ -69,7 +69,11 @@ namespace Epoch
 			return CreateManagedObject_Internal(ScriptCache::GetManagedClassByID(aClassID), std::forward<TConstructorArgs>(aArgs)...);
 		}
 
-		static std::shared_ptr<FieldStorageBase> GetFieldStorage(Entity aEntity, uint32_t aFieldID);
+		// Returns a view of the stored field, don't hold on to it past the lifetime of the entity's script
+		// Returns a view of the stored field, empty if the entity has no such field
+		static FieldStorageBase GetFieldStorage(Entity aEntity, uint32_t aFieldID);
+		// Points the Entity fields of aEntity's script at the new entities of aEntityIDMap
+		static void UpdateEntityReferences(Entity aEntity, const std::unordered_map<UUID, UUID>& aEntityIDMap);
 		
 		static std::shared_ptr<AssemblyInfo> GetCoreAssemblyInfo();
 		static std::shared_ptr<AssemblyInfo> GetAppAssemblyInfo();
@@ -124,6 +128,26 @@ namespace Epoch
 			CallMethod(GCManager::GetReferencedObject(aInstance), aMethodName, std::forward<TArgs>(aArgs)...);
 		}
 
+		// Calls an already resolved method, skipping the class and method lookups done by the name based overloads
+		template<typename... TArgs>
+		static void CallResolvedMethod(GCHandle aInstance, ManagedMethod* aManagedMethod, TArgs&&... aArgs)
+		{
+			if (aInstance == nullptr || aManagedMethod == nullptr)
+			{
+				return;
+			}
+
+			if constexpr (sizeof...(aArgs) > 0)
+			{
+				const void* data[] = { &aArgs... };
+				CallMethod(GCManager::GetReferencedObject(aInstance), aManagedMethod, data);
+			}
+			else
+			{
+				CallMethod(GCManager::GetReferencedObject(aInstance), aManagedMethod, (const void**)nullptr);
+			}
+		}
+
 	private:
 		static void InitMono();
 		static void ShutdownMono();
@@ -132,6 +132,12 @@ namespace Epoch
 		EPOCH_ADD_INTERNAL_CALL(Scene_InstantiatePrefabWithTranslationAndRotationWithParent);
 		EPOCH_ADD_INTERNAL_CALL(Scene_InstantiatePrefabWithTransformWithParent);
 
+		EPOCH_ADD_INTERNAL_CALL(Scene_CreatePrefabPool);
+		EPOCH_ADD_INTERNAL_CALL(Scene_SpawnFromPool);
+		EPOCH_ADD_INTERNAL_CALL(Scene_SpawnFromPoolWithTranslation);
+		EPOCH_ADD_INTERNAL_CALL(Scene_SpawnFromPoolWithTranslationAndRotation);
+		EPOCH_ADD_INTERNAL_CALL(Scene_DespawnToPool);
+
 		
 		EPOCH_ADD_INTERNAL_CALL(Entity_GetIsActive);
 		EPOCH_ADD_INTERNAL_CALL(Entity_SetIsActive);
@@ -270,6 +276,10 @@ namespace Epoch
 		EPOCH_ADD_INTERNAL_CALL(Physics_SphereCast);
 		EPOCH_ADD_INTERNAL_CALL(Physics_OverlapSphere);
 
+		EPOCH_ADD_INTERNAL_CALL(Physics_RaycastBatch);
+		EPOCH_ADD_INTERNAL_CALL(Physics_ShapeCastBatch);
+		EPOCH_ADD_INTERNAL_CALL(Physics_OverlapShapeBatch);
+
 		EPOCH_ADD_INTERNAL_CALL(Physics_GetGravity);
 		EPOCH_ADD_INTERNAL_CALL(Physics_SetGravity);
 		
@@ -603,6 +613,67 @@ namespace Epoch
 			return scene->InstantiateChild(prefab, parent, aTranslation, aRotation, aScale).GetUUID();
 		}
 
+		void Scene_CreatePrefabPool(AssetHandle* aPrefabHandle, uint32_t aCount)
+		{
+			std::shared_ptr<Scene> scene = ScriptEngine::GetSceneContext();
+			EPOCH_ASSERT(scene, "No active scene!");
+
+			std::shared_ptr<Prefab> prefab = AssetManager::GetAsset<Prefab>(*aPrefabHandle);
+			if (prefab == nullptr)
+			{
+				LOG_ERROR_TAG("C#", "Cannot create prefab pool. No prefab with handle {} found.", *aPrefabHandle);
+				return;
+			}
+
+			scene->CreatePrefabPool(prefab, aCount);
+		}
+
+		static uint64_t SpawnFromPool(AssetHandle* aPrefabHandle, CU::Vector3f* aTranslation, CU::Vector3f* aRotation)
+		{
+			std::shared_ptr<Scene> scene = ScriptEngine::GetSceneContext();
+			EPOCH_ASSERT(scene, "No active scene!");
+
+			std::shared_ptr<Prefab> prefab = AssetManager::GetAsset<Prefab>(*aPrefabHandle);
+			if (prefab == nullptr)
+			{
+				LOG_ERROR_TAG("C#", "Cannot spawn from prefab pool. No prefab with handle {} found.", *aPrefabHandle);
+				return 0;
+			}
+
+			Entity entity = scene->SpawnFromPool(prefab, aTranslation, aRotation);
+			return entity ? (uint64_t)entity.GetUUID() : 0;
+		}
+
+		uint64_t Scene_SpawnFromPool(AssetHandle* aPrefabHandle)
+		{
+			return SpawnFromPool(aPrefabHandle, nullptr, nullptr);
+		}
+
+		uint64_t Scene_SpawnFromPoolWithTranslation(AssetHandle* aPrefabHandle, CU::Vector3f* aTranslation)
+		{
+			return SpawnFromPool(aPrefabHandle, aTranslation, nullptr);
+		}
+
+		uint64_t Scene_SpawnFromPoolWithTranslationAndRotation(AssetHandle* aPrefabHandle, CU::Vector3f* aTranslation, CU::Vector3f* aRotation)
+		{
+			return SpawnFromPool(aPrefabHandle, aTranslation, aRotation);
+		}
+
+		bool Scene_DespawnToPool(uint64_t aEntityID)
+		{
+			std::shared_ptr<Scene> scene = ScriptEngine::GetSceneContext();
+			EPOCH_ASSERT(scene, "No active scene!");
+
+			Entity entity = scene->TryGetEntityWithUUID(aEntityID);
+			if (!entity)
+			{
+				LOG_ERROR_TAG("C#", "Cannot despawn entity. No entity with ID {} found.", aEntityID);
+				return false;
+			}
+
+			return scene->DespawnToPool(entity);
+		}
+
 #pragma endregion
 		
 #pragma region Entity
@@ -790,8 +861,7 @@ namespace Epoch
 			auto entity = GetEntity(aEntityID);
 			if (!entity) return;
 
-			auto& nameComponent = entity.GetComponent<NameComponent>();
-			nameComponent.name = ScriptUtils::MonoStringToUTF8(aName);
+			entity.SetName(ScriptUtils::MonoStringToUTF8(aName));
 		}
 		
 #pragma endregion
@@ -1813,6 +1883,143 @@ namespace Epoch
 			return result;
 		}
 
+		uint32_t Physics_RaycastBatch(MonoArray* aQueries, MonoArray* outHits)
+		{
+			if (!aQueries || !outHits)
+			{
+				return 0;
+			}
+
+			std::shared_ptr<Scene> scene = ScriptEngine::GetSceneContext();
+
+			const uint32_t queryCount = (uint32_t)CU::Math::Min(ManagedArrayUtils::Length(aQueries), ManagedArrayUtils::Length(outHits));
+			const auto* queries = (const RaycastQuery*)mono_array_addr_with_size(aQueries, sizeof(RaycastQuery), 0);
+			auto* hits = (HitInfo*)mono_array_addr_with_size(outHits, sizeof(HitInfo), 0);
+
+			return scene->GetPhysicsScene()->RaycastBatch(queries, queryCount, hits);
+		}
+
+		// Only boxes and spheres can be swept or overlapped, the shape comes straight from managed memory so it can be anything
+		static bool IsBatchQueryShapeValid(Physics::ShapeType aShape)
+		{
+			return aShape == Physics::ShapeType::Box || aShape == Physics::ShapeType::Sphere;
+		}
+
+		// Returns the number of queries with a valid shape, the invalid ones are reported once per batch
+		template<typename T>
+		static uint32_t ValidateBatchQueryShapes(const T* aQueries, uint32_t aQueryCount, const char* aFunctionName)
+		{
+			uint32_t validCount = 0;
+			for (uint32_t i = 0; i < aQueryCount; ++i)
+			{
+				validCount += IsBatchQueryShapeValid(aQueries[i].shape) ? 1 : 0;
+			}
+
+			if (validCount != aQueryCount)
+			{
+				CONSOLE_LOG_WARN("{}: {} of {} queries use a shape other than a box or sphere, they won't hit anything", aFunctionName, aQueryCount - validCount, aQueryCount);
+			}
+
+			return validCount;
+		}
+
+		uint32_t Physics_ShapeCastBatch(MonoArray* aQueries, MonoArray* outHits)
+		{
+			if (!aQueries || !outHits)
+			{
+				return 0;
+			}
+
+			std::shared_ptr<Scene> scene = ScriptEngine::GetSceneContext();
+
+			const uint32_t queryCount = (uint32_t)CU::Math::Min(ManagedArrayUtils::Length(aQueries), ManagedArrayUtils::Length(outHits));
+			const auto* queries = (const ShapeCastQuery*)mono_array_addr_with_size(aQueries, sizeof(ShapeCastQuery), 0);
+			auto* hits = (HitInfo*)mono_array_addr_with_size(outHits, sizeof(HitInfo), 0);
+
+			// The queries run on the job system, so unsupported shapes are filtered out here instead of failing on a worker
+			const uint32_t validCount = ValidateBatchQueryShapes(queries, queryCount, "Physics.ShapeCastBatch");
+			if (validCount == queryCount)
+			{
+				return scene->GetPhysicsScene()->ShapeCastBatch(queries, queryCount, hits);
+			}
+
+			std::vector<ShapeCastQuery> validQueries;
+			validQueries.reserve(validCount);
+			for (uint32_t i = 0; i < queryCount; ++i)
+			{
+				if (IsBatchQueryShapeValid(queries[i].shape))
+				{
+					validQueries.push_back(queries[i]);
+				}
+			}
+
+			std::vector<HitInfo> validHits(validCount);
+			const uint32_t hitCount = scene->GetPhysicsScene()->ShapeCastBatch(validQueries.data(), validCount, validHits.data());
+
+			for (uint32_t i = 0, validIndex = 0; i < queryCount; ++i)
+			{
+				hits[i] = IsBatchQueryShapeValid(queries[i].shape) ? validHits[validIndex++] : HitInfo();
+			}
+
+			return hitCount;
+		}
+
+		uint32_t Physics_OverlapShapeBatch(MonoArray* aQueries, MonoArray* outEntityIDs, MonoArray* outHitCounts, uint32_t aMaxHitsPerQuery)
+		{
+			if (!aQueries || !outEntityIDs || !outHitCounts)
+			{
+				return 0;
+			}
+
+			std::shared_ptr<Scene> scene = ScriptEngine::GetSceneContext();
+
+			uint32_t queryCount = (uint32_t)CU::Math::Min(ManagedArrayUtils::Length(aQueries), ManagedArrayUtils::Length(outHitCounts));
+			if (aMaxHitsPerQuery > 0)
+			{
+				queryCount = CU::Math::Min(queryCount, (uint32_t)(ManagedArrayUtils::Length(outEntityIDs) / aMaxHitsPerQuery));
+			}
+
+			const auto* queries = (const ShapeOverlapQuery*)mono_array_addr_with_size(aQueries, sizeof(ShapeOverlapQuery), 0);
+			auto* entityIDs = (UUID*)mono_array_addr_with_size(outEntityIDs, sizeof(UUID), 0);
+			auto* hitCounts = (uint32_t*)mono_array_addr_with_size(outHitCounts, sizeof(uint32_t), 0);
+
+			// The queries run on the job system, so unsupported shapes are filtered out here instead of failing on a worker
+			const uint32_t validCount = ValidateBatchQueryShapes(queries, queryCount, "Physics.OverlapShapeBatch");
+			if (validCount == queryCount)
+			{
+				return scene->GetPhysicsScene()->OverlapShapeBatch(queries, queryCount, entityIDs, hitCounts, aMaxHitsPerQuery);
+			}
+
+			std::vector<ShapeOverlapQuery> validQueries;
+			validQueries.reserve(validCount);
+			for (uint32_t i = 0; i < queryCount; ++i)
+			{
+				if (IsBatchQueryShapeValid(queries[i].shape))
+				{
+					validQueries.push_back(queries[i]);
+				}
+			}
+
+			std::vector<UUID> validEntityIDs((size_t)validCount * aMaxHitsPerQuery);
+			std::vector<uint32_t> validHitCounts(validCount);
+			const uint32_t hitCount = scene->GetPhysicsScene()->OverlapShapeBatch(validQueries.data(), validCount, validEntityIDs.data(), validHitCounts.data(), aMaxHitsPerQuery);
+
+			for (uint32_t i = 0, validIndex = 0; i < queryCount; ++i)
+			{
+				if (!IsBatchQueryShapeValid(queries[i].shape))
+				{
+					hitCounts[i] = 0;
+					continue;
+				}
+
+				hitCounts[i] = validHitCounts[validIndex];
+				std::copy_n(validEntityIDs.data() + (size_t)validIndex * aMaxHitsPerQuery, validHitCounts[validIndex], entityIDs + (size_t)i * aMaxHitsPerQuery);
+				validIndex++;
+			}
+
+			return hitCount;
+		}
+
 		void Physics_GetGravity(CU::Vector3f* outGravity)
 		{
 			std::shared_ptr<Scene> scene = ScriptEngine::GetSceneContext();
@@ -97,6 +97,12 @@ namespace Epoch
 		uint64_t Scene_InstantiatePrefabWithTranslationAndRotationWithParent(AssetHandle* aPrefabHandle, uint64_t aParentID, CU::Vector3f* aTranslation, CU::Vector3f* aRotation);
 		uint64_t Scene_InstantiatePrefabWithTransformWithParent(AssetHandle* aPrefabHandle, uint64_t aParentID, CU::Vector3f* aTranslation, CU::Vector3f* aRotation, CU::Vector3f* aScale);
 
+		void Scene_CreatePrefabPool(AssetHandle* aPrefabHandle, uint32_t aCount);
+		uint64_t Scene_SpawnFromPool(AssetHandle* aPrefabHandle);
+		uint64_t Scene_SpawnFromPoolWithTranslation(AssetHandle* aPrefabHandle, CU::Vector3f* aTranslation);
+		uint64_t Scene_SpawnFromPoolWithTranslationAndRotation(AssetHandle* aPrefabHandle, CU::Vector3f* aTranslation, CU::Vector3f* aRotation);
+		bool Scene_DespawnToPool(uint64_t aEntityID);
+
 #pragma endregion
 		
 #pragma region Entity
@@ -313,6 +319,10 @@ namespace Epoch
 		bool Physics_SphereCast(CU::Vector3f* aOrigin, CU::Vector3f* aDirection, float aRadius, float aMaxDistance, HitInfo* outHitInfo);
 		MonoArray* Physics_OverlapSphere(CU::Vector3f* aOrigin, float aRadius);
 
+		uint32_t Physics_RaycastBatch(MonoArray* aQueries, MonoArray* outHits);
+		uint32_t Physics_ShapeCastBatch(MonoArray* aQueries, MonoArray* outHits);
+		uint32_t Physics_OverlapShapeBatch(MonoArray* aQueries, MonoArray* outEntityIDs, MonoArray* outHitCounts, uint32_t aMaxHitsPerQuery);
+
 		void Physics_GetGravity(CU::Vector3f* outGravity);
 		void Physics_SetGravity(CU::Vector3f* aGravity);
 
@@ -86,6 +86,9 @@ namespace Epoch
 
 		MonoMethod* method = nullptr;
 
+		// Registered the first time the method is called
+		uint32_t profilerZone = 0;
+
 		~ManagedMethod()
 		{
 			method = nullptr;
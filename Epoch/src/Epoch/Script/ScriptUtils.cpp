@@ -154,115 +154,130 @@ namespace Epoch
 		}
 
 		Buffer result;
+
+		if (aFieldType == FieldType::String)
+		{
+			std::string str = MonoStringToUTF8((MonoString*)aObj);
+			result.Allocate(str.size() + 1);
+			result.ZeroInitialize();
+			result.Write(str.data(), str.size());
+			return result;
+		}
+
 		result.Allocate(FieldUtils::GetFieldTypeSize(aFieldType));
 		result.ZeroInitialize();
+		MonoObjectToValue(aObj, aFieldType, result.data);
+		return result;
+	}
+
+	bool ScriptUtils::MonoObjectToValue(MonoObject* aObj, FieldType aFieldType, void* outValue)
+	{
+		if (aObj == nullptr)
+		{
+			return false;
+		}
 
 		switch (aFieldType)
 		{
 			case FieldType::Bool:
 			{
 				bool value = (bool)Unbox<MonoBoolean>(aObj);
-				result.Write(&value, sizeof(bool));
+				memcpy(outValue, &value, sizeof(bool));
 				break;
 			}
 			case FieldType::Int8:
 			{
 				int8_t value = Unbox<int8_t>(aObj);
-				result.Write(&value, sizeof(int8_t));
+				memcpy(outValue, &value, sizeof(int8_t));
 				break;
 			}
 			case FieldType::Int16:
 			{
 				int16_t value = Unbox<int16_t>(aObj);
-				result.Write(&value, sizeof(int16_t));
+				memcpy(outValue, &value, sizeof(int16_t));
 				break;
 			}
 			case FieldType::Int32:
 			{
 				int32_t value = Unbox<int32_t>(aObj);
-				result.Write(&value, sizeof(int32_t));
+				memcpy(outValue, &value, sizeof(int32_t));
 				break;
 			}
 			case FieldType::Int64:
 			{
 				int64_t value = Unbox<int64_t>(aObj);
-				result.Write(&value, sizeof(int64_t));
+				memcpy(outValue, &value, sizeof(int64_t));
 				break;
 			}
 			case FieldType::UInt8:
 			{
 				uint8_t value = Unbox<uint8_t>(aObj);
-				result.Write(&value, sizeof(uint8_t));
+				memcpy(outValue, &value, sizeof(uint8_t));
 				break;
 			}
 			case FieldType::UInt16:
 			{
 				uint16_t value = Unbox<uint16_t>(aObj);
-				result.Write(&value, sizeof(uint16_t));
+				memcpy(outValue, &value, sizeof(uint16_t));
 				break;
 			}
 			case FieldType::LayerMask:
 			case FieldType::UInt32:
 			{
 				uint32_t value = Unbox<uint32_t>(aObj);
-				result.Write(&value, sizeof(uint32_t));
+				memcpy(outValue, &value, sizeof(uint32_t));
 				break;
 			}
 			case FieldType::UInt64:
 			{
 				uint64_t value = Unbox<uint64_t>(aObj);
-				result.Write(&value, sizeof(uint64_t));
+				memcpy(outValue, &value, sizeof(uint64_t));
 				break;
 			}
 			case FieldType::Float:
 			{
 				float value = Unbox<float>(aObj);
-				result.Write(&value, sizeof(float));
+				memcpy(outValue, &value, sizeof(float));
 				break;
 			}
 			case FieldType::Double:
 			{
 				double value = Unbox<double>(aObj);
-				result.Write(&value, sizeof(double));
+				memcpy(outValue, &value, sizeof(double));
 				break;
 			}
 			case FieldType::String:
 			{
-				std::string str = MonoStringToUTF8((MonoString*)aObj);
-				result.Allocate(str.size() + 1);
-				result.ZeroInitialize();
-				result.Write(str.data(), str.size());
-				break;
+				// Strings don't have a fixed size, use the Buffer version
+				return false;
 			}
 			case FieldType::AssetHandle:
 			{
 				AssetHandle value = Unbox<AssetHandle>(aObj);
-				result.Write(&value, sizeof(AssetHandle));
+				memcpy(outValue, &value, sizeof(AssetHandle));
 				break;
 			}
 			case FieldType::Vector2:
 			{
 				CU::Vector2f value = Unbox<CU::Vector2f>(aObj);
-				result.Write(&value.x, sizeof(CU::Vector2f));
+				memcpy(outValue, &value, sizeof(CU::Vector2f));
 				break;
 			}
 			case FieldType::Vector3:
 			{
 				CU::Vector3f value = Unbox<CU::Vector3f>(aObj);
-				result.Write(&value.x, sizeof(CU::Vector3f));
+				memcpy(outValue, &value, sizeof(CU::Vector3f));
 				break;
 			}
 			case FieldType::Color:
 			{
 				CU::Color value = Unbox<CU::Color>(aObj);
-				result.Write(&value.r, sizeof(CU::Color));
+				memcpy(outValue, &value, sizeof(CU::Color));
 				break;
 			}
 			case FieldType::Entity:
 			{
-				Buffer idBuffer = GetFieldValue(aObj, "id", FieldType::UInt64, false);
-				result.Write(idBuffer.data, sizeof(UUID));
-				idBuffer.Release();
+				MonoObjectToValue(GetFieldValueObject(aObj, "id", false), FieldType::UInt64, outValue);
 				break;
 			}
 			case FieldType::Scene:
@@ -271,14 +286,12 @@ namespace Epoch
 			case FieldType::Mesh:
 			case FieldType::Texture2D:
 			{
-				Buffer handleBuffer = GetFieldValue(aObj, "myHandle", FieldType::AssetHandle, false);
-				result.Write(handleBuffer.data, sizeof(AssetHandle));
-				handleBuffer.Release();
+				MonoObjectToValue(GetFieldValueObject(aObj, "myHandle", false), FieldType::AssetHandle, outValue);
 				break;
 			}
 		}
 
-		return result;
+		return true;
 	}
 
 	MonoObject* ScriptUtils::ValueToMonoObject(const void* aData, FieldType aDataType)
@@ -32,6 +32,8 @@ namespace Epoch
 		static void SetFieldValue(MonoObject* aClassInstance, const FieldInfo* aFieldInfo, const void* aData);
 		
 		static Buffer MonoObjectToValue(MonoObject* aObj, FieldType aFieldType);
+		// Writes the unboxed value to outValue which has to fit the field type, doesn't support strings
+		static bool MonoObjectToValue(MonoObject* aObj, FieldType aFieldType, void* outValue);
 		static MonoObject* ValueToMonoObject(const void* aData, FieldType aDataType);
 		static FieldType GetFieldTypeFromMonoType(MonoType* aMonoType);
 